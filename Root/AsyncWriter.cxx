@@ -0,0 +1,135 @@
+#include "SusyNtuple/AsyncWriter.h"
+#include "SusyNtuple/StageTimer.h"
+
+#include "TROOT.h"
+
+#include <iostream>
+#include <system_error>
+
+using Susy::AsyncWriter;
+
+using std::cout;
+using std::endl;
+
+//----------------------------------------------------------
+AsyncWriter::AsyncWriter(size_t capacity) :
+    m_capacity(capacity>0 ? capacity : 1),
+    m_imtThreads(0),
+    m_stop(false),
+    m_nTasks(0),
+    m_nStalls(0),
+    m_stallNs(0)
+{
+    // handed out from the back: slot 0 first
+    for(size_t i=m_capacity; i>0; --i) m_free.push_back(i-1);
+}
+//----------------------------------------------------------
+AsyncWriter::~AsyncWriter()
+{
+    finish();
+}
+//----------------------------------------------------------
+bool AsyncWriter::start()
+{
+    if(running()) return true;
+    ROOT::EnableThreadSafety();
+    if(m_imtThreads>0) {
+#ifdef R__USE_IMT
+        ROOT::EnableImplicitMT(m_imtThreads);
+#else
+        cout<<"AsyncWriter::start: ROOT built without implicit multithreading, compressing on the writer thread"<<endl;
+#endif
+    }
+    m_stop = false;
+    try {
+        m_thread = std::thread(&AsyncWriter::run, this);
+    } catch(const std::system_error &e) {
+        cout<<"AsyncWriter::start: cannot start the writer thread ("<<e.what()<<"), writing synchronously"<<endl;
+        return false;
+    }
+    return true;
+}
+//----------------------------------------------------------
+size_t AsyncWriter::acquire()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if(m_free.empty()) {
+        const uint64_t start = StageTimer::now();
+        m_freed.wait(lock, [this]() { return !m_free.empty(); });
+        m_nStalls++;
+        m_stallNs += StageTimer::now() - start;
+    }
+    const size_t slot = m_free.back();
+    m_free.pop_back();
+    return slot;
+}
+//----------------------------------------------------------
+void AsyncWriter::submit(size_t slot, Task task)
+{
+    if(!running()) {
+        task();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_nTasks++;
+        m_free.push_back(slot);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::make_pair(slot, task));
+    }
+    m_queued.notify_one();
+}
+//----------------------------------------------------------
+void AsyncWriter::finish()
+{
+    if(!running()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_queued.notify_one();
+    m_thread.join();
+}
+//----------------------------------------------------------
+void AsyncWriter::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while(true) {
+        m_queued.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+        if(m_queue.empty()) break; // stop, and nothing left to write
+        std::pair<size_t, Task> next = std::move(m_queue.front());
+        m_queue.pop_front();
+        lock.unlock();
+        next.second();
+        lock.lock();
+        m_nTasks++;
+        m_free.push_back(next.first);
+        m_freed.notify_one();
+    }
+}
+//----------------------------------------------------------
+uint64_t AsyncWriter::nTasks() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nTasks;
+}
+//----------------------------------------------------------
+uint64_t AsyncWriter::nStalls() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nStalls;
+}
+//----------------------------------------------------------
+uint64_t AsyncWriter::stallNs() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stallNs;
+}
+//----------------------------------------------------------
+void AsyncWriter::print(std::ostream &out) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    out<<"AsyncWriter: "<<m_nTasks<<" entries written, "<<m_capacity<<" slots, "
+       <<m_nStalls<<" waits for a free slot ("<<1.0e-6*m_stallNs<<" ms)"<<endl;
+}
+//----------------------------------------------------------
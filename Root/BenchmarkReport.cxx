@@ -0,0 +1,273 @@
+#include "SusyNtuple/BenchmarkReport.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+
+using Susy::BenchmarkReport;
+
+using std::endl;
+using std::setw;
+using std::string;
+using std::vector;
+
+namespace {
+string quote(const string &s)
+{
+    string result = "\"";
+    for(size_t i=0; i<s.size(); ++i) {
+        const char c = s[i];
+        if(c=='"' || c=='\\') { result += '\\'; result += c; }
+        else if(static_cast<unsigned char>(c)<0x20) {
+            char buffer[8];
+            snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+            result += buffer;
+        }
+        else result += c;
+    }
+    return result + "\"";
+}
+string number(double value)
+{
+    if(!std::isfinite(value)) return "null";
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.6g", value);
+    return buffer;
+}
+/// minimal reader for the JSON written by writeJson: objects, arrays, strings, numbers, null
+class JsonReader {
+public:
+    explicit JsonReader(const string &text) : m_text(text), m_pos(0) {}
+    bool expect(char c) { skipSpace(); if(m_pos<m_text.size() && m_text[m_pos]==c) { ++m_pos; return true; } return false; }
+    bool readString(string &value)
+    {
+        if(!expect('"')) return false;
+        value.clear();
+        while(m_pos<m_text.size()) {
+            char c = m_text[m_pos++];
+            if(c=='"') return true;
+            if(c=='\\') {
+                if(m_pos>=m_text.size()) return false;
+                c = m_text[m_pos++];
+                if(c=='u') {
+                    if(m_pos+4>m_text.size()) return false;
+                    value += static_cast<char>(strtol(m_text.substr(m_pos, 4).c_str(), 0, 16));
+                    m_pos += 4;
+                    continue;
+                }
+                if(c=='n') c = '\n';
+                else if(c=='t') c = '\t';
+            }
+            value += c;
+        }
+        return false;
+    }
+    bool readNumber(double &value)
+    {
+        skipSpace();
+        if(m_text.compare(m_pos, 4, "null")==0) {
+            m_pos += 4;
+            value = std::numeric_limits<double>::quiet_NaN();
+            return true;
+        }
+        const char *begin = m_text.c_str() + m_pos;
+        char *end = 0;
+        value = strtod(begin, &end);
+        if(end==begin) return false;
+        m_pos += end - begin;
+        return true;
+    }
+private:
+    void skipSpace() { while(m_pos<m_text.size() && isspace(static_cast<unsigned char>(m_text[m_pos]))) ++m_pos; }
+    const string &m_text;
+    size_t m_pos;
+};
+}
+//----------------------------------------------------------
+const double* BenchmarkReport::Result::value(const std::string &metric) const
+{
+    for(size_t i=0; i<metrics.size(); ++i)
+        if(metrics[i].first==metric) return &metrics[i].second;
+    return 0;
+}
+//----------------------------------------------------------
+void BenchmarkReport::add(const std::string &name, const std::string &metric, double value)
+{
+    Result *result = const_cast<Result*>(find(name));
+    if(!result) {
+        m_results.push_back(Result(name));
+        result = &m_results.back();
+    }
+    for(size_t i=0; i<result->metrics.size(); ++i) {
+        if(result->metrics[i].first==metric) {
+            result->metrics[i].second = value;
+            return;
+        }
+    }
+    result->metrics.push_back(Metric(metric, value));
+}
+//----------------------------------------------------------
+const BenchmarkReport::Result* BenchmarkReport::find(const std::string &name) const
+{
+    for(size_t i=0; i<m_results.size(); ++i)
+        if(m_results[i].name==name) return &m_results[i];
+    return 0;
+}
+//----------------------------------------------------------
+void BenchmarkReport::print(std::ostream &out) const
+{
+    vector<string> columns;
+    size_t width = 4;
+    for(size_t i=0; i<m_results.size(); ++i) {
+        width = std::max(width, m_results[i].name.size());
+        for(size_t j=0; j<m_results[i].metrics.size(); ++j)
+            if(std::find(columns.begin(), columns.end(), m_results[i].metrics[j].first)==columns.end())
+                columns.push_back(m_results[i].metrics[j].first);
+    }
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out<<std::left<<setw(width)<<"name"<<std::right;
+    for(size_t c=0; c<columns.size(); ++c) out<<" "<<setw(std::max<size_t>(12, columns[c].size()))<<columns[c];
+    out<<endl;
+    out<<std::setprecision(6);
+    for(size_t i=0; i<m_results.size(); ++i) {
+        const Result &result = m_results[i];
+        out<<std::left<<setw(width)<<result.name<<std::right;
+        for(size_t c=0; c<columns.size(); ++c) {
+            out<<" "<<setw(std::max<size_t>(12, columns[c].size()));
+            vector<Metric>::const_iterator it = std::find_if(result.metrics.begin(), result.metrics.end(),
+                                                             [&](const Metric &m) { return m.first==columns[c]; });
+            if(it!=result.metrics.end()) out<<it->second;
+            else out<<"-";
+        }
+        out<<endl;
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+//----------------------------------------------------------
+void BenchmarkReport::writeJson(std::ostream &out) const
+{
+    out<<"{"<<endl
+       <<"  \"suite\": "<<quote(m_suite)<<","<<endl
+       <<"  \"label\": "<<quote(m_label)<<","<<endl
+       <<"  \"results\": ["<<endl;
+    for(size_t i=0; i<m_results.size(); ++i) {
+        const Result &result = m_results[i];
+        out<<"    {\"name\": "<<quote(result.name);
+        for(size_t j=0; j<result.metrics.size(); ++j)
+            out<<", "<<quote(result.metrics[j].first)<<": "<<number(result.metrics[j].second);
+        out<<"}"<<(i+1<m_results.size() ? "," : "")<<endl;
+    }
+    out<<"  ]"<<endl
+       <<"}"<<endl;
+}
+//----------------------------------------------------------
+bool BenchmarkReport::writeJson(const std::string &filename) const
+{
+    std::ofstream out(filename.c_str());
+    if(out) writeJson(out);
+    if(!out) {
+        std::cout<<"BenchmarkReport::writeJson: cannot write '"<<filename<<"'"<<endl;
+        return false;
+    }
+    return true;
+}
+//----------------------------------------------------------
+bool BenchmarkReport::readJson(std::istream &in)
+{
+    const string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    JsonReader json(text);
+    BenchmarkReport report;
+    bool valid = json.expect('{');
+    bool first = true;
+    while(valid && !json.expect('}')) {
+        string key;
+        valid = (first || json.expect(',')) && json.readString(key) && json.expect(':');
+        first = false;
+        if(!valid) break;
+        if(key=="suite") valid = json.readString(report.m_suite);
+        else if(key=="label") valid = json.readString(report.m_label);
+        else if(key=="results") {
+            valid = json.expect('[');
+            bool firstResult = true;
+            while(valid && !json.expect(']')) {
+                valid = (firstResult || json.expect(',')) && json.expect('{');
+                firstResult = false;
+                Result result;
+                bool firstMetric = true;
+                while(valid && !json.expect('}')) {
+                    string metric;
+                    valid = (firstMetric || json.expect(',')) && json.readString(metric) && json.expect(':');
+                    firstMetric = false;
+                    if(!valid) break;
+                    if(metric=="name") {
+                        valid = json.readString(result.name);
+                    } else {
+                        double value = 0;
+                        valid = json.readNumber(value);
+                        result.metrics.push_back(Metric(metric, value));
+                    }
+                }
+                if(valid) report.m_results.push_back(result);
+            }
+        }
+        else valid = false;
+    }
+    if(valid) *this = report;
+    return valid;
+}
+//----------------------------------------------------------
+bool BenchmarkReport::readJson(const std::string &filename)
+{
+    std::ifstream in(filename.c_str());
+    if(!in) {
+        std::cout<<"BenchmarkReport::readJson: cannot open '"<<filename<<"'"<<endl;
+        return false;
+    }
+    if(!readJson(in)) {
+        std::cout<<"BenchmarkReport::readJson: cannot parse '"<<filename<<"'"<<endl;
+        return false;
+    }
+    return true;
+}
+//----------------------------------------------------------
+vector<BenchmarkReport::Regression> BenchmarkReport::compare(const BenchmarkReport &baseline,
+                                                             const Tolerances &tolerances) const
+{
+    vector<Regression> regressions;
+    for(size_t i=0; i<m_results.size(); ++i) {
+        const Result &result = m_results[i];
+        const Result *reference = baseline.find(result.name);
+        if(!reference) continue;
+        for(size_t j=0; j<result.metrics.size(); ++j) {
+            const Metric &metric = result.metrics[j];
+            Tolerances::const_iterator tolerance = tolerances.find(metric.first);
+            const double *before = reference->value(metric.first);
+            if(tolerance==tolerances.end() || !before) continue;
+            if(!std::isfinite(*before) || !std::isfinite(metric.second) || *before==0) continue;
+            const double change = (metric.second - *before)/std::fabs(*before);
+            const bool worse = (tolerance->second.higherIsBetter ?
+                                change < -tolerance->second.fraction :
+                                change > tolerance->second.fraction);
+            if(worse) {
+                Regression r;
+                r.name = result.name;
+                r.metric = metric.first;
+                r.baseline = *before;
+                r.value = metric.second;
+                r.change = change;
+                regressions.push_back(r);
+            }
+        }
+    }
+    return regressions;
+}
+//----------------------------------------------------------
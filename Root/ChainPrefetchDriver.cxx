@@ -0,0 +1,233 @@
+#include "SusyNtuple/ChainPrefetchDriver.h"
+#include "SusyNtuple/StageTimer.h"
+
+#include "TBranch.h"
+#include "TChain.h"
+#include "TFile.h"
+#include "TH1.h"
+#include "TLeaf.h"
+#include "TObjArray.h"
+#include "TROOT.h"
+#include "TSelector.h"
+#include "TTree.h"
+#include "TTreeCache.h"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <set>
+#include <system_error>
+
+using Susy::ChainPrefetchDriver;
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+//----------------------------------------------------------
+ChainPrefetchDriver::ChainPrefetchDriver(TChain* chain) :
+    m_chain(chain),
+    m_cacheSize(30*1024*1024),
+    m_prefetch(true),
+    m_verbose(false),
+    m_warmDone(false),
+    m_nWarmed(0),
+    m_nWaits(0),
+    m_waitNs(0),
+    m_warmNs(0),
+    m_bytesPrefetched(0),
+    m_nTriggerMismatches(0)
+{
+}
+//----------------------------------------------------------
+ChainPrefetchDriver::~ChainPrefetchDriver()
+{
+    finishWarmup();
+    releaseWarmup();
+}
+//----------------------------------------------------------
+Long64_t ChainPrefetchDriver::process(TSelector* selector, const char* option, Long64_t nEntries)
+{
+    m_nWarmed = m_nWaits = m_nTriggerMismatches = 0;
+    m_waitNs = m_warmNs = 0;
+    m_bytesPrefetched = 0;
+    m_firstTriggerLabels.clear();
+    const Long64_t nChainEntries = m_chain->GetEntries(); // also fills the tree offsets
+    if(nEntries<0 || nEntries>nChainEntries) nEntries = nChainEntries;
+    // as TChain::Process, start on the first file (GetEntries may have loaded the last one), before SetNotify
+    if(m_chain->LoadTree(0)<0) return 0;
+    m_chain->SetCacheSize(m_cacheSize);
+    if(m_prefetch) ROOT::EnableThreadSafety();
+
+    selector->SetOption(option);
+    selector->Begin(m_chain);
+    selector->SlaveBegin(m_chain);
+    selector->Init(m_chain);
+    selector->Notify();
+    TObject* previousNotify = m_chain->GetNotify();
+    m_chain->SetNotify(selector);
+
+    Long64_t nProcessed = 0;
+    bool firstFile = true;
+    const TObjArray* files = m_chain->GetListOfFiles();
+    const Long64_t* offsets = m_chain->GetTreeOffset();
+    const Int_t nTrees = files->GetEntries();
+    for(Int_t iTree=0; iTree<nTrees; ++iTree) {
+        if(selector->GetAbort()!=TSelector::kContinue) break;
+        const Long64_t first = offsets[iTree];
+        const Long64_t end = std::min(offsets[iTree+1], nEntries);
+        if(first>=nEntries) break;
+        if(end<=first) continue;
+        // the chain opens the file, and calls Notify
+        const bool warmed = (finishWarmup()==iTree);
+        if(m_chain->LoadTree(first)<0) break;
+        const vector<string> labels = (warmed ? m_warm.triggerLabels : triggerLabels(m_chain->GetCurrentFile()));
+        releaseWarmup();
+        if(firstFile) {
+            m_firstTriggerLabels = labels;
+            firstFile = false;
+        } else if(labels!=m_firstTriggerLabels) {
+            m_nTriggerMismatches++;
+            cout<<"ChainPrefetchDriver::process: WARNING the trigger histogram of "<<files->At(iTree)->GetTitle()
+                <<" differs from the one of the first file"<<endl;
+        }
+        // the next file is warmed up once the TTreeCache knows the branches that are read
+        Int_t next = iTree+1;
+        while(next<nTrees && offsets[next+1]<=offsets[next]) ++next;
+        const bool warmNext = m_prefetch && next<nTrees && offsets[next]<nEntries;
+        const Long64_t warmAt = first + std::min<Long64_t>(end-first-1, TTreeCache::GetLearnEntries());
+        for(Long64_t entry=first; entry<end; ++entry) {
+            if(selector->GetAbort()!=TSelector::kContinue) break;
+            Long64_t localEntry = m_chain->LoadTree(entry);
+            if(localEntry<0) break;
+            if(warmNext && entry==warmAt) startWarmup(next);
+            selector->Process(localEntry);
+            nProcessed++;
+        }
+    }
+    finishWarmup();
+    releaseWarmup();
+    m_chain->SetNotify(previousNotify);
+
+    selector->SlaveTerminate();
+    selector->Terminate();
+    if(m_verbose) print(cout);
+    return nProcessed;
+}
+//----------------------------------------------------------
+void ChainPrefetchDriver::startWarmup(Int_t treeNumber)
+{
+    finishWarmup();
+    releaseWarmup();
+    m_warm = WarmFile();
+    m_warm.treeNumber = treeNumber;
+    m_warm.name = m_chain->GetListOfFiles()->At(treeNumber)->GetTitle();
+    m_warm.branches = cachedBranches();
+    m_warmDone = false;
+    try {
+        m_thread = std::thread(&ChainPrefetchDriver::warmup, std::ref(m_warm), string(m_chain->GetName()),
+                               std::ref(m_warmDone));
+    } catch(const std::system_error &e) {
+        cout<<"ChainPrefetchDriver::startWarmup: cannot start the background thread ("<<e.what()<<"),"
+            <<" opening the next files synchronously"<<endl;
+        m_prefetch = false;
+        m_warm = WarmFile();
+    }
+}
+//----------------------------------------------------------
+Int_t ChainPrefetchDriver::finishWarmup()
+{
+    if(!m_thread.joinable()) return -1;
+    const bool done = m_warmDone;
+    const uint64_t start = StageTimer::now();
+    m_thread.join();
+    if(!done) {
+        m_nWaits++;
+        m_waitNs += StageTimer::now() - start;
+    }
+    m_warmNs += m_warm.ns;
+    m_bytesPrefetched += m_warm.bytes;
+    if(!m_warm.ok) {
+        if(m_verbose) cout<<"ChainPrefetchDriver: cannot warm up "<<m_warm.name<<endl;
+        return -1;
+    }
+    m_nWarmed++;
+    return m_warm.treeNumber;
+}
+//----------------------------------------------------------
+void ChainPrefetchDriver::releaseWarmup()
+{
+    if(!m_warm.file) return;
+    m_warm.file->Close();
+    delete m_warm.file;
+    m_warm.file = 0;
+}
+//----------------------------------------------------------
+std::vector<std::string> ChainPrefetchDriver::cachedBranches() const
+{
+    vector<string> names;
+    TFile* file = m_chain->GetCurrentFile();
+    if(!file) return names;
+    TFileCacheRead* cacheRead = file->GetCacheRead(m_chain);
+    if(!cacheRead) cacheRead = file->GetCacheRead(m_chain->GetTree());
+    TTreeCache* treeCache = dynamic_cast<TTreeCache*>(cacheRead);
+    const TObjArray* branches = (treeCache && !treeCache->IsLearning() ? treeCache->GetCachedBranches() : 0);
+    for(Int_t i=0; branches && i<branches->GetEntriesFast(); ++i)
+        names.push_back(branches->UncheckedAt(i)->GetName());
+    return names;
+}
+//----------------------------------------------------------
+void ChainPrefetchDriver::warmup(WarmFile &warm, const std::string &treeName, std::atomic<bool> &done)
+{
+    const uint64_t start = StageTimer::now();
+    warm.file = TFile::Open(warm.name.c_str());
+    TTree* tree = 0;
+    if(warm.file && !warm.file->IsZombie()) {
+        warm.triggerLabels = triggerLabels(warm.file);
+        tree = dynamic_cast<TTree*>(warm.file->Get(treeName.c_str()));
+    }
+    if(tree) {
+        warm.ok = true;
+        TTree::TClusterIterator clusterIter = tree->GetClusterIterator(0);
+        clusterIter();
+        const Long64_t clusterEnd = clusterIter.GetNextEntry();
+        // the baskets of the first cluster, one terminal branch at the time
+        vector<char> buffer;
+        std::set<TBranch*> seen;
+        const TObjArray* leaves = tree->GetListOfLeaves();
+        for(Int_t iLeaf=0; iLeaf<leaves->GetEntriesFast(); ++iLeaf) {
+            TBranch* branch = static_cast<TLeaf*>(leaves->UncheckedAt(iLeaf))->GetBranch();
+            if(!seen.insert(branch).second) continue;
+            if(!warm.branches.empty() &&
+               std::find(warm.branches.begin(), warm.branches.end(), branch->GetName())==warm.branches.end()) continue;
+            const Int_t nBaskets = branch->GetWriteBasket();
+            const Long64_t* basketEntry = branch->GetBasketEntry();
+            const Int_t* basketBytes = branch->GetBasketBytes();
+            for(Int_t iBasket=0; iBasket<nBaskets && basketEntry[iBasket]<clusterEnd; ++iBasket) {
+                const Long64_t seek = branch->GetBasketSeek(iBasket);
+                if(seek<=0 || basketBytes[iBasket]<=0) continue;
+                buffer.resize(basketBytes[iBasket]);
+                if(!warm.file->ReadBuffer(&buffer[0], seek, basketBytes[iBasket])) warm.bytes += basketBytes[iBasket];
+            }
+        }
+    }
+    warm.ns = StageTimer::now() - start;
+    done = true;
+}
+//----------------------------------------------------------
+std::vector<std::string> ChainPrefetchDriver::triggerLabels(TFile* file)
+{
+    vector<string> labels;
+    TH1* h = (file ? dynamic_cast<TH1*>(file->Get("trig")) : 0);
+    for(Int_t bin=1; h && bin<=h->GetNbinsX(); ++bin) labels.push_back(h->GetXaxis()->GetBinLabel(bin));
+    return labels;
+}
+//----------------------------------------------------------
+void ChainPrefetchDriver::print(std::ostream &out) const
+{
+    out<<"ChainPrefetchDriver: "<<m_nWarmed<<" files warmed up in the background ("<<1.0e-6*m_warmNs<<" ms, "
+       <<m_bytesPrefetched/1048576.0<<" MB of first clusters), "<<m_nWaits<<" waits at the file boundaries ("
+       <<1.0e-6*m_waitNs<<" ms), "<<m_nTriggerMismatches<<" trigger histograms differing from the first file"<<endl;
+}
+//----------------------------------------------------------
@@ -0,0 +1,481 @@
+#include "SusyNtuple/Cutflow.h"
+
+#include "TH1.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using Susy::Cutflow;
+using Susy::RegionSet;
+
+using std::endl;
+using std::setw;
+using std::string;
+using std::vector;
+
+namespace {
+const string defaultColumn = "nominal";
+/// value with enough digits to be read back exactly
+string number(double value)
+{
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.17g", value);
+    return buffer;
+}
+/// split a line at the tabs
+vector<string> fields(const string &line)
+{
+    vector<string> result;
+    size_t begin = 0;
+    for(size_t end=line.find('\t'); end!=string::npos; begin=end+1, end=line.find('\t', begin))
+        result.push_back(line.substr(begin, end-begin));
+    result.push_back(line.substr(begin));
+    return result;
+}
+bool toUnsigned(const string &s, uint64_t &value)
+{
+    char *end = 0;
+    value = strtoull(s.c_str(), &end, 10);
+    return !s.empty() && *end=='\0';
+}
+bool toDouble(const string &s, double &value)
+{
+    char *end = 0;
+    value = strtod(s.c_str(), &end);
+    return !s.empty() && *end=='\0';
+}
+}
+//----------------------------------------------------------
+Cutflow::Cutflow(const std::string &name) :
+    m_name(name)
+{
+}
+//----------------------------------------------------------
+size_t Cutflow::addCut(const std::string &name, size_t stage)
+{
+    if(m_cuts.size()>=maxCuts) {
+        std::cout<<"Cutflow::addCut: '"<<m_name<<"' already has "<<maxCuts<<" cuts, cannot add '"<<name<<"'"<<endl;
+        return maxCuts;
+    }
+    resize(m_cuts.size()+1, nColumns());
+    m_cuts.push_back(name);
+    m_stages.push_back(stage);
+    return m_cuts.size()-1;
+}
+//----------------------------------------------------------
+size_t Cutflow::addColumn(const std::string &name)
+{
+    // the first column replaces the default one, keeping its counts
+    if(!m_columns.empty()) resize(m_cuts.size(), m_columns.size()+1);
+    m_columns.push_back(name);
+    return m_columns.size()-1;
+}
+//----------------------------------------------------------
+const std::string& Cutflow::column(size_t i) const
+{
+    return m_columns.empty() ? defaultColumn : m_columns[i];
+}
+//----------------------------------------------------------
+size_t Cutflow::findCut(const std::string &name) const
+{
+    size_t i = 0;
+    while(i<m_cuts.size() && m_cuts[i]!=name) ++i;
+    return i;
+}
+//----------------------------------------------------------
+size_t Cutflow::nPassed(Mask pass)
+{
+    // trailing ones
+    return ~pass==0 ? maxCuts : __builtin_ctzll(~pass);
+}
+//----------------------------------------------------------
+void Cutflow::resize(size_t nCuts, size_t nColumns)
+{
+    const size_t oldCuts = m_cuts.size();
+    const size_t oldColumns = m_raw.empty() ? 0 : m_raw.size()/(oldCuts ? oldCuts : 1);
+    vector<uint64_t> raw(nCuts*nColumns, 0);
+    vector<double> sumw(nCuts*nColumns, 0.0), sumw2(nCuts*nColumns, 0.0);
+    for(size_t column=0; column<oldColumns && column<nColumns; ++column) {
+        for(size_t cut=0; cut<oldCuts && cut<nCuts; ++cut) {
+            raw[column*nCuts + cut] = m_raw[column*oldCuts + cut];
+            sumw[column*nCuts + cut] = m_sumw[column*oldCuts + cut];
+            sumw2[column*nCuts + cut] = m_sumw2[column*oldCuts + cut];
+        }
+    }
+    m_raw.swap(raw);
+    m_sumw.swap(sumw);
+    m_sumw2.swap(sumw2);
+}
+//----------------------------------------------------------
+void Cutflow::add(size_t n, const double *weights, size_t nWeights, size_t column)
+{
+    if(column>=nColumns()) {
+        std::cout<<"Cutflow::fill: '"<<m_name<<"' has no column "<<column<<endl;
+        return;
+    }
+    if(n>m_cuts.size()) n = m_cuts.size();
+    if(n==0) return;
+    uint64_t *raw = &m_raw[0] + index(0, column);
+    double *sumw = &m_sumw[0] + index(0, column);
+    double *sumw2 = &m_sumw2[0] + index(0, column);
+    for(size_t cut=0; cut<n; ++cut) {
+        const size_t stage = m_stages[cut];
+        const double w = weights[stage<nWeights ? stage : nWeights-1];
+        raw[cut] += 1;
+        sumw[cut] += w;
+        sumw2[cut] += w*w;
+    }
+}
+//----------------------------------------------------------
+void Cutflow::fill(Mask pass, double weight, size_t column)
+{
+    add(nPassed(pass), &weight, 1, column);
+}
+//----------------------------------------------------------
+void Cutflow::fill(Mask pass, std::initializer_list<double> weights, size_t column)
+{
+    if(weights.size()==0) fill(pass, 1.0, column);
+    else add(nPassed(pass), weights.begin(), weights.size(), column);
+}
+//----------------------------------------------------------
+void Cutflow::clear()
+{
+    std::fill(m_raw.begin(), m_raw.end(), 0);
+    std::fill(m_sumw.begin(), m_sumw.end(), 0.0);
+    std::fill(m_sumw2.begin(), m_sumw2.end(), 0.0);
+}
+//----------------------------------------------------------
+bool Cutflow::merge(const Cutflow &other)
+{
+    if(other.m_cuts!=m_cuts || other.m_stages!=m_stages || other.m_columns!=m_columns) {
+        std::cout<<"Cutflow::merge: cannot merge '"<<other.m_name<<"' into '"<<m_name<<"',"
+                 <<" the cuts, stages or columns differ"<<endl;
+        return false;
+    }
+    for(size_t i=0; i<m_raw.size(); ++i) {
+        m_raw[i] += other.m_raw[i];
+        m_sumw[i] += other.m_sumw[i];
+        m_sumw2[i] += other.m_sumw2[i];
+    }
+    return true;
+}
+//----------------------------------------------------------
+void Cutflow::print(std::ostream &out, int width) const
+{
+    size_t cutWidth = 10;
+    for(size_t i=0; i<m_cuts.size(); ++i) if(m_cuts[i].size()>cutWidth) cutWidth = m_cuts[i].size();
+    out<<std::left<<setw(cutWidth+2)<<(m_name.empty() ? string("Selection") : m_name)<<std::right;
+    for(size_t column=0; column<nColumns(); ++column) out<<setw(width)<<this->column(column);
+    out<<endl;
+    for(size_t cut=0; cut<m_cuts.size(); ++cut) {
+        out<<std::left<<setw(cutWidth+2)<<m_cuts[cut]<<std::right;
+        for(size_t column=0; column<nColumns(); ++column) {
+            std::ostringstream count;
+            count<<weighted(cut, column)<<" ["<<raw(cut, column)<<"]";
+            out<<setw(width)<<count.str();
+        }
+        out<<endl;
+    }
+}
+//----------------------------------------------------------
+void Cutflow::write(std::ostream &out) const
+{
+    out<<"cutflow\t"<<m_name<<endl;
+    for(size_t column=0; column<m_columns.size(); ++column) out<<"column\t"<<m_columns[column]<<endl;
+    for(size_t cut=0; cut<m_cuts.size(); ++cut) out<<"cut\t"<<m_stages[cut]<<"\t"<<m_cuts[cut]<<endl;
+    for(size_t column=0; column<nColumns(); ++column)
+        for(size_t cut=0; cut<m_cuts.size(); ++cut)
+            out<<"count\t"<<column<<"\t"<<cut<<"\t"<<raw(cut, column)
+               <<"\t"<<number(weighted(cut, column))<<"\t"<<number(sumw2(cut, column))<<endl;
+    out<<"end"<<endl;
+}
+//----------------------------------------------------------
+bool Cutflow::write(const std::string &filename) const
+{
+    std::ofstream out(filename.c_str());
+    if(out) write(out);
+    if(!out) {
+        std::cout<<"Cutflow::write: cannot write '"<<filename<<"'"<<endl;
+        return false;
+    }
+    return true;
+}
+//----------------------------------------------------------
+bool Cutflow::read(std::istream &in)
+{
+    Cutflow cutflow;
+    string line;
+    bool valid = std::getline(in, line) && line.compare(0, 8, "cutflow\t")==0;
+    if(valid) cutflow.m_name = line.substr(8);
+    bool complete = false;
+    while(valid && !complete && std::getline(in, line)) {
+        const vector<string> f = fields(line);
+        uint64_t column = 0, cut = 0, stage = 0, raw = 0;
+        double sumw = 0, sumw2 = 0;
+        if(f[0]=="end" && f.size()==1) complete = true;
+        else if(f[0]=="column" && f.size()==2) cutflow.addColumn(f[1]);
+        else if(f[0]=="cut" && f.size()==3 && toUnsigned(f[1], stage))
+            valid = cutflow.addCut(f[2], stage)<maxCuts;
+        else if(f[0]=="count" && f.size()==6 && toUnsigned(f[1], column) && toUnsigned(f[2], cut)
+                && toUnsigned(f[3], raw) && toDouble(f[4], sumw) && toDouble(f[5], sumw2)
+                && column<cutflow.nColumns() && cut<cutflow.nCuts()) {
+            const size_t i = cutflow.index(cut, column);
+            cutflow.m_raw[i] = raw;
+            cutflow.m_sumw[i] = sumw;
+            cutflow.m_sumw2[i] = sumw2;
+        }
+        else valid = false;
+    }
+    if(!(valid && complete)) return false;
+    *this = cutflow;
+    return true;
+}
+//----------------------------------------------------------
+bool Cutflow::read(const std::string &filename)
+{
+    std::ifstream in(filename.c_str());
+    if(!in || !read(in)) {
+        std::cout<<"Cutflow::read: cannot read a cutflow from '"<<filename<<"'"<<endl;
+        return false;
+    }
+    return true;
+}
+//----------------------------------------------------------
+RegionSet::RegionSet(const std::string &name) :
+    m_name(name)
+{
+}
+//----------------------------------------------------------
+size_t RegionSet::addCut(const std::string &name)
+{
+    if(m_cuts.size()>=maxCuts) {
+        std::cout<<"RegionSet::addCut: '"<<m_name<<"' already has "<<maxCuts<<" cuts, cannot add '"<<name<<"'"<<endl;
+        return maxCuts;
+    }
+    m_cuts.push_back(name);
+    return m_cuts.size()-1;
+}
+//----------------------------------------------------------
+size_t RegionSet::findCut(const std::string &name) const
+{
+    size_t i = 0;
+    while(i<m_cuts.size() && m_cuts[i]!=name) ++i;
+    return i;
+}
+//----------------------------------------------------------
+size_t RegionSet::addRegion(const std::string &name, Mask required, size_t stage)
+{
+    resize(m_regions.size()+1, nColumns());
+    m_regions.push_back(name);
+    m_required.push_back(required);
+    m_stages.push_back(stage);
+    return m_regions.size()-1;
+}
+//----------------------------------------------------------
+size_t RegionSet::addRegion(const std::string &name, const std::vector<std::string> &cuts, size_t stage)
+{
+    Mask required = 0;
+    for(size_t i=0; i<cuts.size(); ++i) {
+        const size_t cut = findCut(cuts[i]);
+        if(cut==m_cuts.size()) {
+            std::cout<<"RegionSet::addRegion: '"<<m_name<<"' has no cut '"<<cuts[i]<<"', region '"<<name<<"' not added"<<endl;
+            return m_regions.size();
+        }
+        required |= bit(cut);
+    }
+    return addRegion(name, required, stage);
+}
+//----------------------------------------------------------
+size_t RegionSet::addColumn(const std::string &name)
+{
+    // the first column replaces the default one, keeping its yields
+    if(!m_columns.empty()) resize(m_regions.size(), m_columns.size()+1);
+    m_columns.push_back(name);
+    return m_columns.size()-1;
+}
+//----------------------------------------------------------
+const std::string& RegionSet::column(size_t i) const
+{
+    return m_columns.empty() ? defaultColumn : m_columns[i];
+}
+//----------------------------------------------------------
+void RegionSet::addNMinusOne(size_t region, size_t cut, TH1 *histogram)
+{
+    if(region>=m_regions.size() || cut>=m_cuts.size() || !(m_required[region] & bit(cut)) || !histogram) {
+        std::cout<<"RegionSet::addNMinusOne: '"<<m_name<<"' has no region "<<region<<" with cut "<<cut<<endl;
+        return;
+    }
+    NMinusOne n = {m_required[region] & ~bit(cut), cut, m_stages[region], histogram};
+    m_nMinusOne.push_back(n);
+}
+//----------------------------------------------------------
+void RegionSet::resize(size_t nRegions, size_t nColumns)
+{
+    const size_t oldRegions = m_regions.size();
+    const size_t oldColumns = m_raw.empty() ? 0 : m_raw.size()/(oldRegions ? oldRegions : 1);
+    vector<uint64_t> raw(nRegions*nColumns, 0);
+    vector<double> sumw(nRegions*nColumns, 0.0), sumw2(nRegions*nColumns, 0.0);
+    for(size_t column=0; column<oldColumns && column<nColumns; ++column) {
+        for(size_t region=0; region<oldRegions && region<nRegions; ++region) {
+            raw[column*nRegions + region] = m_raw[column*oldRegions + region];
+            sumw[column*nRegions + region] = m_sumw[column*oldRegions + region];
+            sumw2[column*nRegions + region] = m_sumw2[column*oldRegions + region];
+        }
+    }
+    m_raw.swap(raw);
+    m_sumw.swap(sumw);
+    m_sumw2.swap(sumw2);
+}
+//----------------------------------------------------------
+void RegionSet::add(Mask pass, const double *weights, size_t nWeights, size_t column, const double *values)
+{
+    if(column>=nColumns()) {
+        std::cout<<"RegionSet::fill: '"<<m_name<<"' has no column "<<column<<endl;
+        return;
+    }
+    const size_t n = m_regions.size();
+    if(n>0) {
+        const Mask *required = &m_required[0];
+        uint64_t *raw = &m_raw[0] + index(0, column);
+        double *sumw = &m_sumw[0] + index(0, column);
+        double *sumw2 = &m_sumw2[0] + index(0, column);
+        for(size_t region=0; region<n; ++region) {
+            if((pass & required[region])!=required[region]) continue;
+            const size_t stage = m_stages[region];
+            const double w = weights[stage<nWeights ? stage : nWeights-1];
+            raw[region] += 1;
+            sumw[region] += w;
+            sumw2[region] += w*w;
+        }
+    }
+    if(!values) return;
+    for(size_t i=0; i<m_nMinusOne.size(); ++i) {
+        const NMinusOne &n = m_nMinusOne[i];
+        if((pass & n.required)!=n.required) continue;
+        n.histogram->Fill(values[n.cut], weights[n.stage<nWeights ? n.stage : nWeights-1]);
+    }
+}
+//----------------------------------------------------------
+void RegionSet::fill(Mask pass, double weight, size_t column, const double *values)
+{
+    add(pass, &weight, 1, column, values);
+}
+//----------------------------------------------------------
+void RegionSet::fill(Mask pass, std::initializer_list<double> weights, size_t column, const double *values)
+{
+    if(weights.size()==0) fill(pass, 1.0, column, values);
+    else add(pass, weights.begin(), weights.size(), column, values);
+}
+//----------------------------------------------------------
+void RegionSet::clear()
+{
+    std::fill(m_raw.begin(), m_raw.end(), 0);
+    std::fill(m_sumw.begin(), m_sumw.end(), 0.0);
+    std::fill(m_sumw2.begin(), m_sumw2.end(), 0.0);
+}
+//----------------------------------------------------------
+bool RegionSet::merge(const RegionSet &other)
+{
+    if(other.m_cuts!=m_cuts || other.m_regions!=m_regions || other.m_required!=m_required ||
+       other.m_stages!=m_stages || other.m_columns!=m_columns) {
+        std::cout<<"RegionSet::merge: cannot merge '"<<other.m_name<<"' into '"<<m_name<<"',"
+                 <<" the cuts, regions, stages or columns differ"<<endl;
+        return false;
+    }
+    for(size_t i=0; i<m_raw.size(); ++i) {
+        m_raw[i] += other.m_raw[i];
+        m_sumw[i] += other.m_sumw[i];
+        m_sumw2[i] += other.m_sumw2[i];
+    }
+    return true;
+}
+//----------------------------------------------------------
+void RegionSet::print(std::ostream &out, int width) const
+{
+    size_t regionWidth = 10;
+    for(size_t i=0; i<m_regions.size(); ++i) if(m_regions[i].size()>regionWidth) regionWidth = m_regions[i].size();
+    out<<std::left<<setw(regionWidth+2)<<(m_name.empty() ? string("Region") : m_name)<<std::right;
+    for(size_t column=0; column<nColumns(); ++column) out<<setw(width)<<this->column(column);
+    out<<endl;
+    for(size_t region=0; region<m_regions.size(); ++region) {
+        out<<std::left<<setw(regionWidth+2)<<m_regions[region]<<std::right;
+        for(size_t column=0; column<nColumns(); ++column) {
+            std::ostringstream count;
+            count<<weighted(region, column)<<" ["<<raw(region, column)<<"]";
+            out<<setw(width)<<count.str();
+        }
+        out<<endl;
+    }
+}
+//----------------------------------------------------------
+void RegionSet::write(std::ostream &out) const
+{
+    out<<"regions\t"<<m_name<<endl;
+    for(size_t column=0; column<m_columns.size(); ++column) out<<"column\t"<<m_columns[column]<<endl;
+    for(size_t cut=0; cut<m_cuts.size(); ++cut) out<<"cut\t"<<m_cuts[cut]<<endl;
+    for(size_t region=0; region<m_regions.size(); ++region)
+        out<<"region\t"<<m_stages[region]<<"\t"<<m_required[region]<<"\t"<<m_regions[region]<<endl;
+    for(size_t column=0; column<nColumns(); ++column)
+        for(size_t region=0; region<m_regions.size(); ++region)
+            out<<"count\t"<<column<<"\t"<<region<<"\t"<<raw(region, column)
+               <<"\t"<<number(weighted(region, column))<<"\t"<<number(sumw2(region, column))<<endl;
+    out<<"end"<<endl;
+}
+//----------------------------------------------------------
+bool RegionSet::write(const std::string &filename) const
+{
+    std::ofstream out(filename.c_str());
+    if(out) write(out);
+    if(!out) {
+        std::cout<<"RegionSet::write: cannot write '"<<filename<<"'"<<endl;
+        return false;
+    }
+    return true;
+}
+//----------------------------------------------------------
+bool RegionSet::read(std::istream &in)
+{
+    RegionSet regions;
+    string line;
+    bool valid = std::getline(in, line) && line.compare(0, 8, "regions\t")==0;
+    if(valid) regions.m_name = line.substr(8);
+    bool complete = false;
+    while(valid && !complete && std::getline(in, line)) {
+        const vector<string> f = fields(line);
+        uint64_t column = 0, region = 0, stage = 0, required = 0, raw = 0;
+        double sumw = 0, sumw2 = 0;
+        if(f[0]=="end" && f.size()==1) complete = true;
+        else if(f[0]=="column" && f.size()==2) regions.addColumn(f[1]);
+        else if(f[0]=="cut" && f.size()==2) valid = regions.addCut(f[1])<maxCuts;
+        else if(f[0]=="region" && f.size()==4 && toUnsigned(f[1], stage) && toUnsigned(f[2], required))
+            regions.addRegion(f[3], required, stage);
+        else if(f[0]=="count" && f.size()==6 && toUnsigned(f[1], column) && toUnsigned(f[2], region)
+                && toUnsigned(f[3], raw) && toDouble(f[4], sumw) && toDouble(f[5], sumw2)
+                && column<regions.nColumns() && region<regions.nRegions()) {
+            const size_t i = regions.index(region, column);
+            regions.m_raw[i] = raw;
+            regions.m_sumw[i] = sumw;
+            regions.m_sumw2[i] = sumw2;
+        }
+        else valid = false;
+    }
+    if(!(valid && complete)) return false;
+    *this = regions;
+    return true;
+}
+//----------------------------------------------------------
+bool RegionSet::read(const std::string &filename)
+{
+    std::ifstream in(filename.c_str());
+    if(!in || !read(in)) {
+        std::cout<<"RegionSet::read: cannot read regions from '"<<filename<<"'"<<endl;
+        return false;
+    }
+    return true;
+}
+//----------------------------------------------------------
@@ -148,3 +148,37 @@ void Electron::print() const
   cout.precision(6);
   cout.unsetf(ios_base::fixed);
 }
+/*--------------------------------------------------------------------------------*/
+// Systematic payloads
+/*--------------------------------------------------------------------------------*/
+bool Electron::hasSys(NtSys::SusyNtSys sys) const
+{
+  if     ( sys == NtSys::EL_EFF_ID_TOTAL_Uncorr_UP ) return !errEffSF_id_up.empty();
+  else if( sys == NtSys::EL_EFF_ID_TOTAL_Uncorr_DN ) return !errEffSF_id_dn.empty();
+  else if( sys == NtSys::EL_EFF_Reco_TOTAL_Uncorr_UP ) return !errEffSF_reco_up.empty();
+  else if( sys == NtSys::EL_EFF_Reco_TOTAL_Uncorr_DN ) return !errEffSF_reco_dn.empty();
+  else if( sys == NtSys::EL_EFF_Iso_TOTAL_Uncorr_UP ) return !errEffSF_iso_up.empty();
+  else if( sys == NtSys::EL_EFF_Iso_TOTAL_Uncorr_DN ) return !errEffSF_iso_dn.empty();
+  else if( sys == NtSys::EL_EFF_Trigger_TOTAL_UP ) return !errEffSF_trig_up_single.empty();
+  else if( sys == NtSys::EL_EFF_Trigger_TOTAL_DN ) return !errEffSF_trig_dn_single.empty();
+  return true;
+}
+void Electron::stripSys(const std::set<NtSys::SusyNtSys> &keep)
+{
+  if( !keep.count(NtSys::EL_EFF_ID_TOTAL_Uncorr_UP) ) errEffSF_id_up.clear();
+  if( !keep.count(NtSys::EL_EFF_ID_TOTAL_Uncorr_DN) ) errEffSF_id_dn.clear();
+  if( !keep.count(NtSys::EL_EFF_Reco_TOTAL_Uncorr_UP) ) errEffSF_reco_up.clear();
+  if( !keep.count(NtSys::EL_EFF_Reco_TOTAL_Uncorr_DN) ) errEffSF_reco_dn.clear();
+  if( !keep.count(NtSys::EL_EFF_Iso_TOTAL_Uncorr_UP) ) errEffSF_iso_up.clear();
+  if( !keep.count(NtSys::EL_EFF_Iso_TOTAL_Uncorr_DN) ) errEffSF_iso_dn.clear();
+  if( !keep.count(NtSys::EL_EFF_Trigger_TOTAL_UP) ) {
+    errEffSF_trig_up_single.clear();
+    errEffSF_trig_up_double.clear();
+    errEffSF_trig_up_mixed.clear();
+  }
+  if( !keep.count(NtSys::EL_EFF_Trigger_TOTAL_DN) ) {
+    errEffSF_trig_dn_single.clear();
+    errEffSF_trig_dn_double.clear();
+    errEffSF_trig_dn_mixed.clear();
+  }
+}
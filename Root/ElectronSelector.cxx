@@ -70,14 +70,7 @@ ElectronSelector::ElectronSelector() :
 //---------------------------------------------------------
 bool ElectronSelector::isBaseline(const Electron* el)
 {
-    bool pass = false;
-    if(el) {
-        pass = (el->looseLLHBLayer && // good for all
-                el->passOQBadClusElectron &&
-                el->Pt()  > 10.0 &&
-                std::abs(el->clusEta) < 2.47 ); // SUSYTools uses CaloCluster::eta() for this but CaloCluster::etaBE(2) for crack region...
-    }
-    return pass;
+    return (el && ElectronPolicy::isBaseline(*el));
 }
 //----------------------------------------------------------
 bool ElectronSelector::isSignal(const Electron* el)
@@ -107,6 +100,10 @@ float ElectronSelector::errEffSF(const Electron& ele, const SusyNtSys sys)
 {
     // return the error on the electron SF associated with systematic sys
     float err = 0.0;
+    if(!ele.hasSys(sys)) {
+        // stripped from the input (see SusyNtSlimmer::setSystematicsToKeep): no shift
+        return err;
+    }
     if     (sys == NtSys::EL_EFF_ID_TOTAL_Uncorr_UP) {
         err = ele.errEffSF_id_up[m_signalId];
     }
@@ -143,172 +140,36 @@ float ElectronSelector::errEffSF(const Electron& ele, const SusyNtSys sys)
 //----------------------------------------------------------
 bool ElectronSelector::passIpCut(const Electron &el)
 {
-    return (std::abs(el.d0sigBSCorr)  < 5.0 &&
-            std::abs(el.z0SinTheta()) < 0.5 );
+    return ElectronPolicy::passIpCut(el);
 }
 //----------------------------------------------------------
 bool ElectronSelector::outsideCrackRegion(const Electron &el)
 {
-    return (std::abs(el.clusEtaBE) < 1.37 ||
-            std::abs(el.clusEtaBE) > 1.52 );
-}
-
-//----------------------------------------------------------
-// begin ElectronSelector_2Lep Ana_2Lep
-//----------------------------------------------------------
-bool ElectronSelector_2Lep::isBaseline(const Electron* el)
-{
-    bool pass = false;
-    if(el) {
-        pass = (el->looseLLHBLayer && 
-                el->passOQBadClusElectron &&
-                el->Pt()  > 10.0 && 
-                std::abs(el->clusEta) < 2.47);
-    }
-    return pass;
-}
-//----------------------------------------------------------
-bool ElectronSelector_2Lep::passIpCut(const Electron &el)
-{
-    return (std::abs(el.d0sigBSCorr)  < 5.0 &&
-            std::abs(el.z0SinTheta()) < 0.5 );
-
-}
-//----------------------------------------------------------
-bool ElectronSelector_2Lep::isSignal(const Electron* el)
-{
-    bool pass = false;
-    if(el) {
-        pass = (isBaseline(el)       &&
-                el->mediumLLH        &&
-                el->isoGradientLoose &&
-                passIpCut(*el));
-    }
-    return pass;
-}
-
-//----------------------------------------------------------
-// begin ElectronSelector_3Lep Ana_3Lep
-//----------------------------------------------------------
-
-//----------------------------------------------------------
-// begin ElectronSelector_4Lep Ana_4Lep
-//----------------------------------------------------------
-
-bool ElectronSelector_4Lep::isSignal(const Electron* el)
-{
-    bool pass = false;
-    if(el) {
-        pass = (isBaseline(el) &&
-                el->mediumLLH &&
-                el->isoGradientLoose &&
-                passIpCut(*el));
-    }
-    return pass;
-}
-
-//----------------------------------------------------------
-// begin ElectronSelector_2LepWH Ana_2LepWH
-//----------------------------------------------------------
-bool ElectronSelector_2LepWH::passIpCut(const Electron &el)
-{
-    return (std::abs(el.d0sigBSCorr)  < 3.0 && // tighter than default
-            std::abs(el.z0SinTheta()) < 0.4 );
-
-}
-
-//----------------------------------------------------------
-// begin ElectronSelector_SS3L Ana_SS3L
-//----------------------------------------------------------
-bool ElectronSelector_SS3L::isBaseline(const Electron* el)
-{
-    bool pass = false;
-    if(el) {
-        pass = (el->looseLLH &&
-                el->passOQBadClusElectron &&
-                el->Pt()             > 10.0  &&
-                std::abs(el->clusEta)    <  2.47 &&
-                abs(el->d0sigBSCorr) <  5.0  &&
-                outsideCrackRegion(*el));
-    }
-    return pass;
+    return ElectronPolicy::outsideCrackRegion(el);
 }
 //----------------------------------------------------------
-bool ElectronSelector_SS3L::isSignal(const Electron* el)
+void ElectronSelector::selectBaseline(const ElectronVector &in, ElectronVector &out)
 {
-    bool pass = false;
-    if(el) {
-        bool isIsolated = ((el->ptvarcone20/el->Pt()  < 0.06) &&
-                           (el->etconetopo20/el->Pt() < 0.06) );
-
-        bool passLH = false;
-        if (el->Pt() < 300) {
-            if(el->tightLLH) passLH = true;
-        } else {
-            if(el->mediumLLH) passLH = true;
-        }
-        pass = (isBaseline(el) &&
-                isIsolated &&
-                passLH &&
-                std::abs(el->trackEta)     <  2.0 &&
-                std::abs(el->z0SinTheta()) <  0.5 );
-    }
-    return pass;
+    for(size_t i=0; i<in.size(); ++i)
+        if(isBaseline(in[i])) out.push_back(in[i]);
 }
-
-//----------------------------------------------------------
-// begin ElectronSelector_Stop2L Ana_Stop2L
 //----------------------------------------------------------
-bool ElectronSelector_Stop2L::passIpCut(const Electron &el)
+void ElectronSelector::selectSignal(const ElectronVector &in, ElectronVector &out)
 {
-    return (std::abs(el.d0sigBSCorr)  < 3.0 &&
-            std::abs(el.z0SinTheta()) < 0.5 );
-
+    for(size_t i=0; i<in.size(); ++i)
+        if(isSignal(in[i])) out.push_back(in[i]);
 }
 //----------------------------------------------------------
-bool ElectronSelector_Stop2L::isSignal(const Electron* el)
+void ElectronSelector::classify(ObjectStatus::Collection<Electron> &status)
 {
-    bool pass = false;
-    if(el) {
-        pass = (isBaseline(el) &&
-                el->mediumLLH &&
-                el->isoGradientLoose &&
-                passIpCut(*el));
+    const ElectronVector &in = status.objects();
+    std::vector<uint8_t> &bits = status.bits();
+    for(size_t i=0; i<in.size(); ++i) {
+        if(isBaseline(in[i])) bits[i] |= ObjectStatus::Baseline;
+        if(isSignal(in[i])) bits[i] |= ObjectStatus::PassSignal;
     }
-    return pass;
-}
-//----------------------------------------------------------
-//----------------------------------------------------------
-// begin ElectronSelector_Stop2L Ana_WWBB
-//----------------------------------------------------------
-bool ElectronSelector_WWBB::passIpCut(const Electron &el)
-{
-    return (std::abs(el.d0sigBSCorr) < 3.0 && std::abs(el.z0SinTheta()) < 0.5);
 }
 //----------------------------------------------------------
-bool ElectronSelector_WWBB::isBaseline(const Electron* el)
-{
-    bool pass = false;
-    if(el) {
-        pass = (el->looseLLHBLayer &&
-                el->passOQBadClusElectron &&
-                el->Pt() > 10.0 &&
-                std::abs(el->clusEta) < 2.47);// &&
-                //outsideCrackRegion(el));
-    }
-    return pass;
-}
+// the analysis-specific selectors are the policies in ElectronSelector.h
 //----------------------------------------------------------
-bool ElectronSelector_WWBB::isSignal(const Electron* el)
-{
-    bool pass = false;
-    if(el) {
-        pass = (ElectronSelector_WWBB::isBaseline(el) &&
-                el->mediumLLH &&
-                el->isoFixedCutTightTrackOnly &&
-                ElectronSelector_WWBB::passIpCut(*el) &&
-                outsideCrackRegion(*el));
-    }
-    return pass; 
-}
 } // namespace Susy
@@ -0,0 +1,212 @@
+#include "SusyNtuple/EntryRangeDriver.h"
+#include "SusyNtuple/Event.h"
+
+#include "TBranch.h"
+#include "TChain.h"
+#include "TFile.h"
+#include "TObjArray.h"
+#include "TSelector.h"
+#include "TTree.h"
+#include "TTreeCache.h"
+
+#include <algorithm>
+#include <iostream>
+
+using Susy::EntryRange;
+using Susy::EntryRangeDriver;
+using Susy::EventlistCache;
+using Susy::PickEventList;
+
+using std::cout;
+using std::endl;
+using std::vector;
+
+//----------------------------------------------------------
+EntryRangeDriver::EntryRangeDriver(TChain* chain, const EventlistCache &cache) :
+    m_chain(chain),
+    m_cache(cache),
+    m_cacheSize(30*1024*1024),
+    m_prefetch(true),
+    m_verbose(false),
+    m_nClustersRead(0),
+    m_nClustersTotal(0)
+{
+}
+//----------------------------------------------------------
+Long64_t EntryRangeDriver::process(TSelector* selector, const char* option, Long64_t nEntries, Long64_t firstEntry)
+{
+    m_nClustersRead = m_nClustersTotal = 0;
+    m_chain->GetEntries(); // fill the tree offsets
+    m_chain->SetCacheSize(m_cacheSize);
+
+    selector->SetOption(option);
+    selector->Begin(m_chain);
+    selector->SlaveBegin(m_chain);
+    selector->Init(m_chain);
+    selector->Notify();
+    TObject* previousNotify = m_chain->GetNotify();
+    m_chain->SetNotify(selector);
+
+    Long64_t nProcessed = 0;
+    const TObjArray* files = m_chain->GetListOfFiles();
+    const Long64_t* offsets = m_chain->GetTreeOffset();
+    for(Int_t iTree=0; iTree<files->GetEntries(); ++iTree) {
+        if(nEntries>=0 && nProcessed>=nEntries) break;
+        if(selector->GetAbort()!=TSelector::kContinue) break;
+        const Long64_t offset = offsets[iTree];
+        const Long64_t nTreeEntries = offsets[iTree+1] - offset;
+        if(offset + nTreeEntries <= firstEntry) continue;
+        EventlistCache::FileSelection sel;
+        if(nTreeEntries<=0 ||
+           !m_cache.find(EventlistCache::fileKey(files->At(iTree)->GetTitle(), nTreeEntries), sel)) {
+            if(m_verbose)
+                cout<<"EntryRangeDriver: no cached entries for "<<files->At(iTree)->GetTitle()<<endl;
+            continue;
+        }
+        if(sel.nSelected()==0) continue;
+        if(m_chain->LoadTree(offset + sel.begin()->first)<0) continue;
+        TTree* tree = m_chain->GetTree();
+        vector<ClusterBlock> blocks = clusterBlocks(tree, sel);
+        m_nClustersTotal += countClusters(tree, 0, nTreeEntries);
+        for(size_t iBlock=0; iBlock<blocks.size(); ++iBlock) {
+            const ClusterBlock &block = blocks[iBlock];
+            if(offset + block.end <= firstEntry) continue;
+            m_nClustersRead += countClusters(tree, block.first, block.end);
+            m_chain->LoadTree(offset + block.ranges.front().first);
+            m_chain->SetCacheEntryRange(offset + block.first, offset + block.end - 1);
+            if(m_prefetch && iBlock+1<blocks.size()) prefetch(tree, blocks[iBlock+1]);
+            for(size_t iRange=0; iRange<block.ranges.size(); ++iRange) {
+                const EntryRange &range = block.ranges[iRange];
+                for(Long64_t entry=std::max<Long64_t>(range.first, firstEntry - offset);
+                    entry<static_cast<Long64_t>(range.end); ++entry) {
+                    if(nEntries>=0 && nProcessed>=nEntries) break;
+                    if(selector->GetAbort()!=TSelector::kContinue) break;
+                    Long64_t localEntry = m_chain->LoadTree(offset + entry);
+                    if(localEntry<0) break;
+                    selector->Process(localEntry);
+                    nProcessed++;
+                }
+            }
+        }
+    }
+    m_chain->SetNotify(previousNotify);
+
+    selector->SlaveTerminate();
+    selector->Terminate();
+    if(m_verbose)
+        cout<<"EntryRangeDriver: processed "<<nProcessed<<" entries,"
+            <<" read "<<m_nClustersRead<<" of "<<m_nClustersTotal<<" clusters"<<endl;
+    return nProcessed;
+}
+//----------------------------------------------------------
+Long64_t EntryRangeDriver::selectEvents(TChain* chain, const PickEventList &pick, EventlistCache &cache,
+                                        bool verbose)
+{
+    Long64_t nFound = 0;
+    if(pick.empty()) return nFound;
+    // a chain of its own, so that the branch status, addresses and cache of chain are left as they are
+    TChain scan(chain->GetName());
+    scan.Add(chain);
+    const Long64_t nChainEntries = scan.GetEntries(); // also fills the tree offsets
+    const TObjArray* files = scan.GetListOfFiles();
+    const Long64_t* offsets = scan.GetTreeOffset();
+    Susy::Event* evt = 0;
+    scan.SetBranchStatus("*", 0);
+    scan.SetBranchStatus("event", 1);
+    scan.SetBranchAddress("event", &evt);
+    scan.SetCacheSize(10*1024*1024);
+    scan.AddBranchToCache("event", kTRUE);
+    scan.StopCacheLearningPhase();
+    Int_t treeNumber = -1;
+    TBranch* branch = 0;
+    uint64_t key = 0, nTreeEntries = 0;
+    for(Long64_t iEntry=0; iEntry<nChainEntries; ++iEntry) {
+        Long64_t localEntry = scan.LoadTree(iEntry);
+        if(localEntry<0) break;
+        if(scan.GetTreeNumber()!=treeNumber) {
+            treeNumber = scan.GetTreeNumber();
+            branch = scan.GetTree()->GetBranch("event");
+            nTreeEntries = offsets[treeNumber+1] - offsets[treeNumber];
+            key = EventlistCache::fileKey(files->At(treeNumber)->GetTitle(), nTreeEntries);
+            if(!branch) {
+                cout<<"EntryRangeDriver::selectEvents: no 'event' branch in "
+                    <<files->At(treeNumber)->GetTitle()<<", skipping it"<<endl;
+                iEntry = offsets[treeNumber+1] - 1;
+                continue;
+            }
+        }
+        if(branch->GetEntry(localEntry)<=0 || !evt) continue;
+        if(pick.contains(evt->run, evt->eventNumber)) {
+            cache.add(key, nTreeEntries, localEntry);
+            nFound++;
+            if(verbose)
+                cout<<"EntryRangeDriver::selectEvents: run "<<evt->run<<" event "<<evt->eventNumber
+                    <<" is entry "<<localEntry<<" of "<<files->At(treeNumber)->GetTitle()<<endl;
+        }
+    }
+    scan.ResetBranchAddresses();
+    delete evt;
+    if(verbose || nFound<static_cast<Long64_t>(pick.size()))
+        cout<<"EntryRangeDriver::selectEvents: found "<<nFound<<" entries for "<<pick.size()<<" picked events"<<endl;
+    return nFound;
+}
+//----------------------------------------------------------
+std::vector<EntryRangeDriver::ClusterBlock> EntryRangeDriver::clusterBlocks(TTree* tree,
+                                                                          const EventlistCache::FileSelection &sel)
+{
+    vector<ClusterBlock> blocks;
+    const Long64_t nTreeEntries = tree->GetEntries();
+    for(const EntryRange* r=sel.begin(); r!=sel.end(); ++r) {
+        Long64_t entry = r->first;
+        const Long64_t rangeEnd = std::min(static_cast<Long64_t>(r->end), nTreeEntries);
+        while(entry<rangeEnd) {
+            TTree::TClusterIterator clusterIter = tree->GetClusterIterator(entry);
+            Long64_t clusterStart = clusterIter();
+            Long64_t clusterEnd = clusterIter.GetNextEntry();
+            if(blocks.empty() || clusterStart>blocks.back().end)
+                blocks.push_back(ClusterBlock(clusterStart, clusterEnd));
+            ClusterBlock &block = blocks.back();
+            block.end = std::max(block.end, clusterEnd);
+            Long64_t last = std::min(rangeEnd, clusterEnd);
+            if(!block.ranges.empty() && static_cast<Long64_t>(block.ranges.back().end)==entry)
+                block.ranges.back().end = last;
+            else
+                block.ranges.push_back(EntryRange(entry, last));
+            entry = last;
+        }
+    }
+    return blocks;
+}
+//----------------------------------------------------------
+void EntryRangeDriver::prefetch(TTree* tree, const ClusterBlock &block)
+{
+    TFile* file = tree->GetCurrentFile();
+    if(!file) return;
+    TFileCacheRead* cacheRead = file->GetCacheRead(m_chain);
+    if(!cacheRead) cacheRead = file->GetCacheRead(tree);
+    TTreeCache* treeCache = dynamic_cast<TTreeCache*>(cacheRead);
+    const TObjArray* branches = (treeCache ? treeCache->GetCachedBranches() : 0);
+    if(!branches) return; // still learning which branches are used
+    for(Int_t iBranch=0; iBranch<branches->GetEntriesFast(); ++iBranch) {
+        TBranch* branch = static_cast<TBranch*>(branches->UncheckedAt(iBranch));
+        const Int_t nBaskets = branch->GetWriteBasket();
+        const Long64_t* basketEntry = branch->GetBasketEntry();
+        const Int_t* basketBytes = branch->GetBasketBytes();
+        for(Int_t iBasket=0; iBasket<nBaskets; ++iBasket) {
+            Long64_t basketEnd = (iBasket+1<nBaskets ? basketEntry[iBasket+1] : branch->GetEntries());
+            if(basketEnd<=block.first) continue;
+            if(basketEntry[iBasket]>=block.end) break;
+            Long64_t seek = branch->GetBasketSeek(iBasket);
+            if(seek>0) file->ReadBufferAsync(seek, basketBytes[iBasket]);
+        }
+    }
+}
+//----------------------------------------------------------
+Long64_t EntryRangeDriver::countClusters(TTree* tree, Long64_t first, Long64_t end)
+{
+    Long64_t nClusters = 0;
+    TTree::TClusterIterator clusterIter = tree->GetClusterIterator(first);
+    while(clusterIter()<end) nClusters++;
+    return nClusters;
+}
+//----------------------------------------------------------
@@ -0,0 +1,258 @@
+#include "SusyNtuple/EventlistCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using Susy::EntryRange;
+using Susy::EventlistCache;
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+const char EventlistCache::s_magic[8] = {'S','N','T','E','V','L','S','\0'};
+
+namespace {
+bool rangeBefore(const EntryRange &r, uint64_t entry) { return r.end <= entry; }
+}
+//----------------------------------------------------------
+bool EventlistCache::FileSelection::contains(uint64_t entry) const
+{
+    // first range that does not end before entry
+    const EntryRange* r = std::lower_bound(m_begin, m_end, entry, rangeBefore);
+    return r!=m_end && r->first<=entry;
+}
+//----------------------------------------------------------
+EventlistCache::EventlistCache() :
+    m_mapAddress(0),
+    m_mapSize(0),
+    m_header(0),
+    m_records(0),
+    m_ranges(0)
+{
+}
+//----------------------------------------------------------
+EventlistCache::~EventlistCache()
+{
+    unmap();
+}
+//----------------------------------------------------------
+uint64_t EventlistCache::fileKey(const std::string &filename, uint64_t nEntries)
+{
+    // FNV-1a over the basename and the number of entries
+    size_t pos = filename.find_last_of('/');
+    string name = (pos==string::npos ? filename : filename.substr(pos+1));
+    uint64_t hash = 14695981039346656037ULL;
+    const uint64_t prime = 1099511628211ULL;
+    for(size_t i=0; i<name.size(); ++i) {
+        hash ^= static_cast<unsigned char>(name[i]);
+        hash *= prime;
+    }
+    for(int i=0; i<8; ++i) {
+        hash ^= (nEntries >> (8*i)) & 0xff;
+        hash *= prime;
+    }
+    return hash;
+}
+//----------------------------------------------------------
+bool EventlistCache::isCacheFile(const std::string &filename)
+{
+    char magic[sizeof(s_magic)];
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    return (file.read(magic, sizeof(magic)) &&
+            0==memcmp(magic, s_magic, sizeof(s_magic)));
+}
+//----------------------------------------------------------
+EventlistCache& EventlistCache::add(uint64_t key, uint64_t nEntries, uint64_t entry)
+{
+    if(isMapped()) materialize();
+    FileBuilder &file = m_files[key];
+    file.nEntries = nEntries;
+    vector<EntryRange> &ranges = file.ranges;
+    if(ranges.empty() || entry>ranges.back().end) {
+        ranges.push_back(EntryRange(entry, entry+1));
+    } else if(entry==ranges.back().end) {
+        ranges.back().end++;
+    } else {
+        // out-of-order entry: insert it, merging with the neighbouring ranges
+        vector<EntryRange>::iterator r = std::lower_bound(ranges.begin(), ranges.end(), entry, rangeBefore);
+        if(r->first<=entry) return *this; // already selected
+        bool joinsPrevious = (r!=ranges.begin() && (r-1)->end==entry);
+        bool joinsNext = (r->first==entry+1);
+        if(joinsPrevious && joinsNext) { (r-1)->end = r->end; ranges.erase(r); }
+        else if(joinsPrevious)         { (r-1)->end++; }
+        else if(joinsNext)             { r->first--; }
+        else                           { ranges.insert(r, EntryRange(entry, entry+1)); }
+    }
+    file.nSelected++;
+    return *this;
+}
+//----------------------------------------------------------
+bool EventlistCache::write(const std::string &filename) const
+{
+    vector<uint64_t> fileKeys = keys();
+    vector<FileRecord> records;
+    uint64_t nRanges = 0;
+    for(size_t i=0; i<fileKeys.size(); ++i) {
+        FileSelection sel;
+        find(fileKeys[i], sel);
+        FileRecord rec = {fileKeys[i], sel.nEntries(), nRanges, sel.nRanges(), sel.nSelected()};
+        records.push_back(rec);
+        nRanges += sel.nRanges();
+    }
+    Header header;
+    memcpy(header.magic, s_magic, sizeof(s_magic));
+    header.version = s_version;
+    header.nFiles = records.size();
+    header.nRanges = nRanges;
+    header.reserved = 0;
+
+    std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if(!records.empty())
+        file.write(reinterpret_cast<const char*>(&records[0]), records.size()*sizeof(FileRecord));
+    for(size_t i=0; i<fileKeys.size(); ++i) {
+        FileSelection sel;
+        find(fileKeys[i], sel);
+        if(sel.nRanges())
+            file.write(reinterpret_cast<const char*>(sel.begin()), sel.nRanges()*sizeof(EntryRange));
+    }
+    bool success = file.good();
+    file.close();
+    if(!success)
+        cout<<"EventlistCache::write: failed to write '"<<filename<<"'"<<endl;
+    return success;
+}
+//----------------------------------------------------------
+bool EventlistCache::read(const std::string &filename)
+{
+    clear();
+    int fd = open(filename.c_str(), O_RDONLY);
+    if(fd<0) {
+        cout<<"EventlistCache::read: cannot open '"<<filename<<"'"<<endl;
+        return false;
+    }
+    struct stat st;
+    bool valid = (0==fstat(fd, &st) && static_cast<size_t>(st.st_size)>=sizeof(Header));
+    void* address = (valid ? mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED);
+    close(fd);
+    if(address==MAP_FAILED) {
+        cout<<"EventlistCache::read: cannot map '"<<filename<<"'"<<endl;
+        return false;
+    }
+    const Header* header = static_cast<const Header*>(address);
+    size_t expectedSize = (sizeof(Header) +
+                           header->nFiles*sizeof(FileRecord) +
+                           header->nRanges*sizeof(EntryRange));
+    valid = (0==memcmp(header->magic, s_magic, sizeof(s_magic)) &&
+             header->version==s_version &&
+             static_cast<size_t>(st.st_size)==expectedSize);
+    if(!valid) {
+        cout<<"EventlistCache::read: '"<<filename<<"' is not a valid cache file"<<endl;
+        munmap(address, st.st_size);
+        return false;
+    }
+    m_mapAddress = address;
+    m_mapSize = st.st_size;
+    m_header = header;
+    m_records = reinterpret_cast<const FileRecord*>(header+1);
+    m_ranges = reinterpret_cast<const EntryRange*>(m_records + header->nFiles);
+    return true;
+}
+//----------------------------------------------------------
+void EventlistCache::clear()
+{
+    unmap();
+    m_files.clear();
+}
+//----------------------------------------------------------
+bool EventlistCache::find(uint64_t key, FileSelection &sel) const
+{
+    if(isMapped()) {
+        const FileRecord* end = m_records + m_header->nFiles;
+        const FileRecord* rec = m_records;
+        for(size_t n=m_header->nFiles; n>0; ) { // binary search on the sorted keys
+            size_t half = n/2;
+            if(rec[half].key<key) { rec += half+1; n -= half+1; }
+            else                  { n = half; }
+        }
+        if(rec==end || rec->key!=key) return false;
+        const EntryRange* first = m_ranges + rec->firstRange;
+        sel = FileSelection(first, first + rec->nRanges, rec->nEntries, rec->nSelected);
+        return true;
+    }
+    std::map<uint64_t, FileBuilder>::const_iterator it = m_files.find(key);
+    if(it==m_files.end()) return false;
+    const FileBuilder &file = it->second;
+    const EntryRange* first = file.ranges.empty() ? 0 : &file.ranges[0];
+    sel = FileSelection(first, first + file.ranges.size(), file.nEntries, file.nSelected);
+    return true;
+}
+//----------------------------------------------------------
+bool EventlistCache::contains(uint64_t key, uint64_t entry) const
+{
+    FileSelection sel;
+    return find(key, sel) && sel.contains(entry);
+}
+//----------------------------------------------------------
+std::vector<uint64_t> EventlistCache::keys() const
+{
+    vector<uint64_t> result;
+    if(isMapped()) {
+        for(size_t i=0; i<m_header->nFiles; ++i) result.push_back(m_records[i].key);
+    } else {
+        for(std::map<uint64_t, FileBuilder>::const_iterator it=m_files.begin(); it!=m_files.end(); ++it)
+            result.push_back(it->first);
+    }
+    return result;
+}
+//----------------------------------------------------------
+size_t EventlistCache::nFiles() const
+{
+    return isMapped() ? m_header->nFiles : m_files.size();
+}
+//----------------------------------------------------------
+uint64_t EventlistCache::nSelected() const
+{
+    uint64_t n = 0;
+    if(isMapped()) {
+        for(size_t i=0; i<m_header->nFiles; ++i) n += m_records[i].nSelected;
+    } else {
+        for(std::map<uint64_t, FileBuilder>::const_iterator it=m_files.begin(); it!=m_files.end(); ++it)
+            n += it->second.nSelected;
+    }
+    return n;
+}
+//----------------------------------------------------------
+void EventlistCache::unmap()
+{
+    if(m_mapAddress) munmap(m_mapAddress, m_mapSize);
+    m_mapAddress = 0;
+    m_mapSize = 0;
+    m_header = 0;
+    m_records = 0;
+    m_ranges = 0;
+}
+//----------------------------------------------------------
+void EventlistCache::materialize()
+{
+    std::map<uint64_t, FileBuilder> files;
+    for(size_t i=0; i<m_header->nFiles; ++i) {
+        const FileRecord &rec = m_records[i];
+        FileBuilder &file = files[rec.key];
+        file.nEntries = rec.nEntries;
+        file.nSelected = rec.nSelected;
+        file.ranges.assign(m_ranges + rec.firstRange, m_ranges + rec.firstRange + rec.nRanges);
+    }
+    unmap();
+    m_files.swap(files);
+}
+//----------------------------------------------------------
@@ -1,6 +1,9 @@
 #include "SusyNtuple/EventlistHandler.h"
 
+#include "TChain.h"
 #include "TFile.h"
+#include "TObjArray.h"
+#include "TTree.h"
 
 #include <iostream>
 #include <fstream>
@@ -8,6 +11,8 @@
 #include <sys/types.h>
 
 
+using Susy::EntryRange;
+using Susy::EventlistCache;
 using Susy::EventlistHandler;
 
 using std::cout;
@@ -57,7 +62,10 @@ std::string mkdirIfNeeded(const std::string &dirname)
 //----------------------------------------------------------
 EventlistHandler::EventlistHandler() :
     m_firstEventHasBeenProcessed(false),
-    m_cacheFile(NULL),
+    m_tree(NULL),
+    m_treeNumber(-1),
+    m_fileKey(0),
+    m_fileEntries(0),
     m_verbose(false)
 {
     setDefaultValues();
@@ -65,7 +73,7 @@ EventlistHandler::EventlistHandler() :
 //----------------------------------------------------------
 EventlistHandler::~EventlistHandler()
 {
-    if(m_cacheFile) { closeOutputFile(); }
+    if(m_firstEventHasBeenProcessed) { saveCache(); }
 }
 //----------------------------------------------------------
 bool EventlistHandler::cacheDoesExists() const
@@ -73,12 +81,20 @@ bool EventlistHandler::cacheDoesExists() const
     return fileExists(m_cacheFilename);
 }
 //----------------------------------------------------------
+EventlistHandler& EventlistHandler::setInputTree(TTree* tree)
+{
+    m_tree = tree;
+    m_treeNumber = -1;
+    return *this;
+}
+//----------------------------------------------------------
 EventlistHandler& EventlistHandler::addEvent(Long64_t entry)
 {
-    if(!m_firstEventHasBeenProcessed){
-        initOutputFile();
+    if(!m_firstEventHasBeenProcessed && m_verbose){
+        cout<<"EventlistHandler::addEvent: will save the list to "<<m_cacheFilename<<endl;
     }
-    m_eventlist.Enter(entry);
+    updateCurrentFile();
+    m_cache.add(m_fileKey, m_fileEntries, entry);
     m_firstEventHasBeenProcessed = true;
     return *this;
 }
@@ -97,52 +113,94 @@ EventlistHandler& EventlistHandler::setCacheFilename(const std::string value)
     return *this;
 }
 //----------------------------------------------------------
+bool EventlistHandler::fetchCache()
+{
+    bool success = m_cache.read(m_cacheFilename);
+    if(success && m_verbose)
+        cout<<"EventlistHandler: fetched "<<m_cache.nSelected()<<" entries"
+            <<" from "<<m_cache.nFiles()<<" files"
+            <<" ('"<<m_cacheFilename<<"')"<<endl;
+    return success;
+}
+//----------------------------------------------------------
+bool EventlistHandler::isSelected(Long64_t entry)
+{
+    updateCurrentFile();
+    return m_cache.contains(m_fileKey, entry);
+}
+//----------------------------------------------------------
+bool EventlistHandler::saveCache()
+{
+    bool success = m_cache.write(m_cacheFilename);
+    if(success) m_firstEventHasBeenProcessed = false; // nothing left to save
+    return success;
+}
+//----------------------------------------------------------
 TEventList* EventlistHandler::fetchEventList()
 {
-    m_cacheFile = TFile::Open(m_cacheFilename.c_str(), "read");
-    if(m_cacheFile){
-        TDirectory *pwd = gDirectory;
-        m_cacheFile->cd();
-        m_eventlist.Read(m_listName.c_str());
-        m_eventlist.SetDirectory(0);
-        m_cacheFile->Close();
-        m_cacheFile->Delete();
-        m_cacheFile = NULL;
-        pwd->cd();
+    m_eventlist.Reset();
+    if(!EventlistCache::isCacheFile(m_cacheFilename)) {
+        fetchLegacyEventList();
+        return &m_eventlist;
+    }
+    if(!m_cache.isMapped() && !fetchCache()) return &m_eventlist;
+    if(TChain *chain = dynamic_cast<TChain*>(m_tree)) {
+        chain->GetEntries(); // make sure the tree offsets are known
+        TObjArray *files = chain->GetListOfFiles();
+        for(Int_t iTree=0; iTree<files->GetEntries(); ++iTree) {
+            const Long64_t offset = chain->GetTreeOffset()[iTree];
+            const Long64_t nEntries = chain->GetTreeOffset()[iTree+1] - offset;
+            EventlistCache::FileSelection sel;
+            if(!m_cache.find(EventlistCache::fileKey(files->At(iTree)->GetTitle(), nEntries), sel)) continue;
+            for(const EntryRange* r=sel.begin(); r!=sel.end(); ++r)
+                for(uint64_t entry=r->first; entry<r->end; ++entry)
+                    m_eventlist.Enter(offset + entry);
+        }
     } else {
-        cout<<"EventlistHandler: cannot fetch event list '"<<m_listName<<"'"
-            <<" from '"<<m_cacheFilename<<"' ("<<m_cacheFile<<")"
-            <<endl;
+        updateCurrentFile();
+        EventlistCache::FileSelection sel;
+        if(m_cache.find(m_fileKey, sel))
+            for(const EntryRange* r=sel.begin(); r!=sel.end(); ++r)
+                for(uint64_t entry=r->first; entry<r->end; ++entry)
+                    m_eventlist.Enter(entry);
     }
     return &m_eventlist;
 }
 //----------------------------------------------------------
-bool EventlistHandler::initOutputFile()
+bool EventlistHandler::fetchLegacyEventList()
 {
-    cout<<"EventlistHandler::initOutputFile "<<m_cacheFilename<<endl;
-    m_cacheFile = TFile::Open(m_cacheFilename.c_str(), "recreate");
-    if(m_cacheFile){
-        m_eventlist.SetDirectory(m_cacheFile);
+    bool success = false;
+    TFile *cacheFile = TFile::Open(m_cacheFilename.c_str(), "read");
+    if(cacheFile){
+        TDirectory *pwd = gDirectory;
+        cacheFile->cd();
+        m_eventlist.Read(m_listName.c_str());
+        m_eventlist.SetDirectory(0);
+        cacheFile->Close();
+        cacheFile->Delete();
+        pwd->cd();
+        success = true;
     } else {
-        cout<<"EventlistHandler: cannot init output file '"<<m_cacheFilename<<"'"<<endl;
+        cout<<"EventlistHandler: cannot fetch event list '"<<m_listName<<"'"
+            <<" from '"<<m_cacheFilename<<"' ("<<cacheFile<<")"
+            <<endl;
     }
-    return m_cacheFile;
+    return success;
 }
 //----------------------------------------------------------
-bool EventlistHandler::closeOutputFile()
+void EventlistHandler::updateCurrentFile()
 {
-    bool fileClosed = false;
-    if(m_cacheFile){
-        TDirectory *pwd = gDirectory;
-        m_cacheFile->cd();
-        m_eventlist.Write(m_listName.c_str());
-        m_cacheFile->Close();
-        m_cacheFile->Delete();
-        m_cacheFile = NULL;
-        pwd->cd();
-        fileClosed = true;
+    // without an input tree all entries go under the same (null) key
+    if(!m_tree) return;
+    Int_t treeNumber = m_tree->GetTreeNumber();
+    if(treeNumber==m_treeNumber) return;
+    TTree *tree = m_tree->GetTree();
+    TFile *file = m_tree->GetCurrentFile();
+    if(tree && file) {
+        m_fileEntries = tree->GetEntries();
+        m_fileKey = EventlistCache::fileKey(file->GetName(), m_fileEntries);
+        m_treeNumber = treeNumber;
     }
-    return fileClosed;
 }
 //----------------------------------------------------------
 void EventlistHandler::setDefaultValues()
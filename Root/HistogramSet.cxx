@@ -0,0 +1,211 @@
+#include "SusyNtuple/HistogramSet.h"
+
+#include "TH1F.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+
+using Susy::HistogramSet;
+
+using std::cout;
+using std::endl;
+
+//----------------------------------------------------------
+HistogramSet::Definition::Definition(const std::string &n, const std::string &t, int nb, double l, double h,
+                                     const std::string &tx, const std::string &ty) :
+    name(n), title(t), titleX(tx), titleY(ty), nBins(nb), low(l), high(h)
+{
+    if(nBins<1 || !(high>low)) {
+        cout<<"HistogramSet::Definition: invalid binning for '"<<name<<"' ("<<nBins<<" bins in ["
+            <<low<<", "<<high<<"]), using one bin"<<endl;
+        nBins = 1;
+        if(!(high>low)) high = low + 1.0;
+    }
+}
+//----------------------------------------------------------
+HistogramSet::Definition::Definition(const std::string &n, const std::string &t, const std::vector<double> &e,
+                                     const std::string &tx, const std::string &ty) :
+    name(n), title(t), titleX(tx), titleY(ty), nBins(1), low(0.0), high(1.0)
+{
+    const bool increasing = e.size()>=2 && std::adjacent_find(e.begin(), e.end(),
+                                                              std::greater_equal<double>())==e.end();
+    if(increasing) {
+        nBins = e.size()-1;
+        low = e.front();
+        high = e.back();
+        edges = e;
+    } else {
+        cout<<"HistogramSet::Definition: the bin edges of '"<<name<<"' are not increasing, using one bin in [0, 1]"<<endl;
+    }
+}
+//----------------------------------------------------------
+int HistogramSet::Definition::findBin(double x) const
+{
+    if(std::isnan(x)) return nBins+1;
+    if(x<low) return 0;
+    if(x>=high) return nBins+1;
+    if(edges.empty()) {
+        const int bin = 1 + static_cast<int>(nBins*(x - low)/(high - low));
+        return std::min(bin, nBins);
+    }
+    return std::upper_bound(edges.begin(), edges.end(), x) - edges.begin();
+}
+//----------------------------------------------------------
+TH1F* HistogramSet::Definition::makeTH1F(const std::string &suffix) const
+{
+    const std::string n = name + suffix;
+    TH1F* result = edges.empty() ?
+        new TH1F(n.c_str(), title.c_str(), nBins, low, high) :
+        new TH1F(n.c_str(), title.c_str(), nBins, &edges[0]);
+    result->SetDirectory(0);
+    result->Sumw2();
+    if(!titleX.empty()) result->GetXaxis()->SetTitle(titleX.c_str());
+    if(!titleY.empty()) result->GetYaxis()->SetTitle(titleY.c_str());
+    for(size_t i=0; i<labels.size(); ++i)
+        result->GetXaxis()->SetBinLabel(labels[i].first, labels[i].second.c_str());
+    return result;
+}
+//----------------------------------------------------------
+HistogramSet::Filler::Filler(const HistogramSet &set) :
+    m_set(set)
+{
+    resize();
+}
+//----------------------------------------------------------
+void HistogramSet::Filler::resize()
+{
+    m_sumw.resize(m_set.nCells(), 0.0);
+    m_sumw2.resize(m_set.nCells(), 0.0);
+    m_entries.resize(m_set.nHistograms(), 0);
+}
+//----------------------------------------------------------
+void HistogramSet::Filler::add(size_t id, double x, double weight)
+{
+    if(id>=m_entries.size()) {
+        if(id>=m_set.nHistograms()) return;
+        resize();
+    }
+    const size_t cell = m_set.m_histograms[id].offset + m_set.findBin(id, x);
+    m_sumw[cell] += weight;
+    m_sumw2[cell] += weight*weight;
+    m_entries[id]++;
+}
+//----------------------------------------------------------
+void HistogramSet::Filler::flush()
+{
+    for(size_t i=0; i<m_buffer.size(); ++i) add(m_buffer[i].id, m_buffer[i].x, m_buffer[i].weight);
+    m_buffer.clear();
+}
+//----------------------------------------------------------
+void HistogramSet::Filler::clear()
+{
+    m_buffer.clear();
+    std::fill(m_sumw.begin(), m_sumw.end(), 0.0);
+    std::fill(m_sumw2.begin(), m_sumw2.end(), 0.0);
+    std::fill(m_entries.begin(), m_entries.end(), 0);
+}
+//----------------------------------------------------------
+HistogramSet::HistogramSet() :
+    m_batchSize(0),
+    m_first(0)
+{
+    m_fillers.push_back(std::unique_ptr<Filler>(new Filler(*this)));
+    m_first = m_fillers.front().get();
+}
+//----------------------------------------------------------
+HistogramSet::~HistogramSet()
+{
+}
+//----------------------------------------------------------
+size_t HistogramSet::book(const std::string &name, const std::string &title, int nBins, double low, double high,
+                          const std::string &titleX, const std::string &titleY)
+{
+    return add(Definition(name, title, nBins, low, high, titleX, titleY));
+}
+//----------------------------------------------------------
+size_t HistogramSet::book(const std::string &name, const std::string &title, const std::vector<double> &edges,
+                          const std::string &titleX, const std::string &titleY)
+{
+    return add(Definition(name, title, edges, titleX, titleY));
+}
+//----------------------------------------------------------
+size_t HistogramSet::add(const Definition &d)
+{
+    m_histograms.push_back(Histogram(d, m_sumw.size()));
+    m_sumw.resize(m_sumw.size() + d.nBins + 2, 0.0);
+    m_sumw2.resize(m_sumw.size(), 0.0);
+    m_entries.resize(m_histograms.size(), 0);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(size_t i=0; i<m_fillers.size(); ++i) m_fillers[i]->resize();
+    return m_histograms.size()-1;
+}
+//----------------------------------------------------------
+HistogramSet& HistogramSet::setBinLabel(size_t id, int bin, const std::string &label)
+{
+    if(id<m_histograms.size() && bin>=1 && bin<=m_histograms[id].nBins)
+        m_histograms[id].labels.push_back(std::make_pair(bin, label));
+    else
+        cout<<"HistogramSet::setBinLabel: no bin "<<bin<<" in histogram "<<id<<", label '"<<label<<"' ignored"<<endl;
+    return *this;
+}
+//----------------------------------------------------------
+size_t HistogramSet::find(const std::string &name) const
+{
+    for(size_t i=0; i<m_histograms.size(); ++i)
+        if(m_histograms[i].name==name) return i;
+    return m_histograms.size();
+}
+//----------------------------------------------------------
+HistogramSet::Filler& HistogramSet::filler(size_t slot)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    while(m_fillers.size()<=slot) m_fillers.push_back(std::unique_ptr<Filler>(new Filler(*this)));
+    return *m_fillers[slot];
+}
+//----------------------------------------------------------
+size_t HistogramSet::nFillers() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_fillers.size();
+}
+//----------------------------------------------------------
+void HistogramSet::merge()
+{
+    std::fill(m_sumw.begin(), m_sumw.end(), 0.0);
+    std::fill(m_sumw2.begin(), m_sumw2.end(), 0.0);
+    std::fill(m_entries.begin(), m_entries.end(), 0);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(size_t slot=0; slot<m_fillers.size(); ++slot) {
+        Filler &f = *m_fillers[slot];
+        f.flush();
+        f.resize();
+        for(size_t i=0; i<m_sumw.size(); ++i) {
+            m_sumw[i] += f.m_sumw[i];
+            m_sumw2[i] += f.m_sumw2[i];
+        }
+        for(size_t i=0; i<m_entries.size(); ++i) m_entries[i] += f.m_entries[i];
+    }
+}
+//----------------------------------------------------------
+TH1F* HistogramSet::toTH1F(size_t id) const
+{
+    TH1F* result = m_histograms[id].makeTH1F();
+    for(int bin=0; bin<=nBins(id)+1; ++bin) {
+        result->SetBinContent(bin, content(id, bin));
+        result->SetBinError(bin, std::sqrt(sumw2(id, bin)));
+    }
+    result->SetEntries(entries(id));
+    return result;
+}
+//----------------------------------------------------------
+void HistogramSet::clear()
+{
+    std::fill(m_sumw.begin(), m_sumw.end(), 0.0);
+    std::fill(m_sumw2.begin(), m_sumw2.end(), 0.0);
+    std::fill(m_entries.begin(), m_entries.end(), 0);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(size_t i=0; i<m_fillers.size(); ++i) m_fillers[i]->clear();
+}
+//----------------------------------------------------------
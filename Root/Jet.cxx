@@ -114,6 +114,7 @@ void Jet::setState(int sys)
 {
   resetTLV();
   if(sys == NtSys::NOM) return;
+  if(!hasSys(static_cast<NtSys::SusyNtSys>(sys))) return; // stripped, stay at nominal
   
   float sf = 0;
   if     ( sys == NtSys::JER) sf = jer;
@@ -173,6 +174,7 @@ void Jet::setState(int sys)
 /*--------------------------------------------------------------------------------*/
 float Jet::getFTSys(Susy::NtSys::SusyNtSys sys)
 {
+    if(!hasSys(sys)) return 0; // stripped, no shift w.r.t. the nominal SF
     float s= 1;
 
     if      ( sys == NtSys::FT_EFF_B_systematics_DN ) s= FTSys[0];
@@ -247,6 +249,7 @@ float Jet::getFTSys(Susy::NtSys::SusyNtSys sys)
 
 void Jet::setFTSys(Susy::NtSys::SusyNtSys sys, double scale=0.)
 {
+    if(!hasSys(sys)) return;
     if      ( sys == NtSys::FT_EFF_B_systematics_DN ) FTSys[0] =scale;
     else if ( sys == NtSys::FT_EFF_B_systematics_UP ) FTSys[1] =scale;
     else if ( sys == NtSys::FT_EFF_C_systematics_DN ) FTSys[2] =scale;
@@ -316,6 +319,35 @@ void Jet::setFTSys(Susy::NtSys::SusyNtSys sys, double scale=0.)
     */
     return;
 }
+/*--------------------------------------------------------------------------------*/
+// Systematic payloads
+/*--------------------------------------------------------------------------------*/
+namespace {
+bool isGroupedNPSys(Susy::NtSys::SusyNtSys sys)
+{
+    return (sys >= Susy::NtSys::JET_GroupedNP_1_UP && sys <= Susy::NtSys::JET_GroupedNP_3_DN);
+}
+bool isFTSys(Susy::NtSys::SusyNtSys sys)
+{
+    return (sys >= Susy::NtSys::FT_EFF_B_systematics_UP && sys <= Susy::NtSys::FT_EFF_extrapolation_charm_DN);
+}
+}
+bool Jet::hasSys(Susy::NtSys::SusyNtSys sys) const
+{
+    if(isGroupedNPSys(sys)) return !groupedNP.empty();
+    if(isFTSys(sys)) return !FTSys.empty();
+    return true;
+}
+void Jet::stripSys(const std::set<Susy::NtSys::SusyNtSys> &keep)
+{
+    bool keepGroupedNP = false, keepFTSys = false;
+    for(std::set<NtSys::SusyNtSys>::const_iterator it = keep.begin(); it != keep.end(); ++it) {
+        keepGroupedNP |= isGroupedNPSys(*it);
+        keepFTSys |= isFTSys(*it);
+    }
+    if(!keepGroupedNP) groupedNP.clear();
+    if(!keepFTSys) FTSys.clear();
+}
 
 
 /*--------------------------------------------------------------------------------*/
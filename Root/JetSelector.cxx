@@ -46,7 +46,7 @@ JetSelector& JetSelector::setSystematic(const NtSys::SusyNtSys &s)
 //----------------------------------------------------------
 bool JetSelector::isBaseline(const Jet* jet)
 {
-    return (jet->Pt() > 20.0);
+    return (jet && JetPolicy::isBaseline(*jet));
 }
 //----------------------------------------------------------
 bool JetSelector::isSignal(const Jet* jet)
@@ -58,10 +58,7 @@ bool JetSelector::isSignal(const Jet* jet)
 //----------------------------------------------------------
 bool JetSelector::isB(const Jet* jet)
 {
-    return ((jet->Pt()        > 20.0   ) &&
-            (fabs(jet->Eta()) <  2.5   ) &&
-            (jet->mv2c10      > mv2c10_77efficiency()) &&
-            (passJvt(jet)));
+    return (jet && JetPolicy::isB(*jet));
 }
 //----------------------------------------------------------
 bool JetSelector::isCentralLight(const Jet* jet)
@@ -90,13 +87,7 @@ bool JetSelector::isCentralB(const Jet* jet)
 //----------------------------------------------------------
 bool JetSelector::isForward(const Jet* jet)
 {
-    bool pass = false;
-    if(jet) {
-        pass = (jet->Pt()         > 30.0 &&
-                fabs(jet->detEta) >  2.4 &&
-                fabs(jet->detEta) <  4.5 );
-    }
-    return pass;
+    return (jet && JetPolicy::isForward(*jet));
 }
 //----------------------------------------------------------
 /*
@@ -105,13 +96,7 @@ bool JetSelector::isForward(const Jet* jet)
 */
 bool JetSelector::passJvt(const Jet* jet)
 {
-    bool pass = false;
-    if(jet) {
-        pass = ((jet->jvt         >  0.59) ||
-                (fabs(jet->Eta()) >  2.4)  ||
-                (jet->Pt()         > 60.0) );
-    }
-    return pass;
+    return (jet && JetPolicy::passJvt(*jet));
 }
 //----------------------------------------------------------
 size_t JetSelector::count_CL_jets(const JetVector &jets)
@@ -132,133 +117,37 @@ size_t JetSelector::count_F_jets(const JetVector &jets)
                             std::bind1st(std::mem_fun(&JetSelector::isForward), this));
 }
 //----------------------------------------------------------
-
-//----------------------------------------------------------
-// begin JetSelector_2Lep Ana_2Lep
-//----------------------------------------------------------
-
-//----------------------------------------------------------
-// begin JetSelector_3Lep Ana_3Lep
-//----------------------------------------------------------
-
-//----------------------------------------------------------
-// begin JetSelector_2LepWH Ana_2LepWH
-//----------------------------------------------------------
-
-//----------------------------------------------------------
-// begin JetSelector_4Lep Ana_4Lep
-//----------------------------------------------------------
-bool JetSelector_4Lep::isBaseline(const Jet* jet)
-{
-  return (jet->Pt() > 20.0);
-}
-//----------------------------------------------------------
-
-//----------------------------------------------------------
-// begin JetSelector_SS3L Ana_SS3L
-//----------------------------------------------------------
-bool JetSelector_SS3L::isBaseline(const Jet* jet)
-{
-    bool pass = false;
-    if(jet){
-        pass = jet->Pt() > 20.0;
-        // Note: abs(eta) < 2.8 criterion moved to `isSignal` so that
-        //       overlap removal can be performed using baseline jets
-    }
-    return pass;
-}
-//----------------------------------------------------------
-bool JetSelector_SS3L::isSignal(const Jet* jet)
-{
-    bool pass = false;
-    if(jet) {
-        pass = (isBaseline(jet) &&
-                jet->Pt()        > 20.0 &&
-                fabs(jet->Eta()) <  2.8 &&
-                passJvt(jet)            );
-    }
-    return pass;
-}
-//----------------------------------------------------------
-bool JetSelector_SS3L::isB(const Jet* jet)
+void JetSelector::selectBaseline(const JetVector &in, JetVector &out)
 {
-    bool pass = false;
-    if(jet) {
-        pass = (jet->Pt()        > 20.0    &&
-                fabs(jet->Eta()) <  2.5    &&
-                passJvt(jet)               &&
-                jet->mv2c10      > mv2c10_70efficiency());
-    }
-    return pass;
+    for(size_t i=0; i<in.size(); ++i)
+        if(isBaseline(in[i])) out.push_back(in[i]);
 }
 //----------------------------------------------------------
-bool JetSelector_SS3L::isB_for_OR(const Jet* jet)
+void JetSelector::selectSignal(const JetVector &in, JetVector &out)
 {
-    bool pass = false;
-    if(jet) {
-        pass = (jet->Pt()        > 20.0    &&
-                fabs(jet->Eta()) <  2.5    &&
-                passJvt(jet)               &&
-                jet->mv2c10      > mv2c10_85efficiency());
-    }
-    return pass;
+    for(size_t i=0; i<in.size(); ++i)
+        if(isSignal(in[i])) out.push_back(in[i]);
 }
 //----------------------------------------------------------
-// begin JetSelector_Stop2L Ana_Stop2L
-//----------------------------------------------------------
-bool JetSelector_Stop2L::isBaseline(const Jet* jet)
+void JetSelector::classify(ObjectStatus::Collection<Jet> &status)
 {
-    bool pass = false;
-    if(jet) {
-        pass = (jet->Pt() > 20.0 );
+    const JetVector &in = status.objects();
+    std::vector<uint8_t> &bits = status.bits();
+    for(size_t i=0; i<in.size(); ++i) {
+        if(isBaseline(in[i])) bits[i] |= ObjectStatus::Baseline;
+        if(isSignal(in[i])) bits[i] |= ObjectStatus::PassSignal;
+        if(isCentralLight(in[i])) bits[i] |= ObjectStatus::CentralLight;
+        if(isCentralB(in[i])) bits[i] |= ObjectStatus::CentralB;
+        if(isForward(in[i])) bits[i] |= ObjectStatus::Forward;
     }
-    return pass;
 }
 //----------------------------------------------------------
-bool JetSelector_Stop2L::isSignal(const Jet* jet)
-{
-    bool pass = false;
-    if(jet) {
-        pass =(jet->Pt()        > 20.0 &&
-               fabs(jet->Eta()) <  2.8 &&
-               passJvt(jet));
-    }
-    return pass;
-}
+// the analysis-specific selectors are the policies in JetSelector.h
 //----------------------------------------------------------
+
 //----------------------------------------------------------
 // begin JetSelector_WWBB Ana_WWBB
 //----------------------------------------------------------
-bool JetSelector_WWBB::isBaseline(const Jet* jet)
-{
-    bool pass = false;
-    if(jet) {
-        pass = (jet->Pt() > 20.0);
-    }
-    return pass;
-}
-bool JetSelector_WWBB::isSignal(const Jet* jet)
-{
-    bool pass = false;
-    if(jet) {
-        pass = (jet->Pt() > 20.0 &&
-                fabs(jet->Eta()) < 2.8 &&
-                passJvt(jet));
-    }
-    return pass;
-}
-bool JetSelector_WWBB::isB(const Jet* jet)
-{
-    bool pass = false;
-    if(jet) {
-        pass = (jet->Pt() > 20.0 &&
-                fabs(jet->Eta()) < 2.5 &&
-                passJvt(jet) &&
-                jet->mv2c10 > mv2c10_85efficiency());
-    }
-    return pass;
-}
-
 bool JetSelector_WWBB::isBMod(const Jet* jet, int wp, float pt_cut)
 {
     bool pass = false;
@@ -44,6 +44,22 @@ bool eventHasSusyPropagators(const std::vector<int>& pdgs,
 
      return false;
 }
+//////////////////////////////////////////////////////////////////
+bool eventHasSusyPropagators(const Susy::mc::TruthGraph& graph)
+{
+     const int  kPgam(+22), kPz(+23), kPw(+24), kPchargino1(1000024);
+     const int nParticles(graph.size());
+     for (int ii = 0; ii < nParticles; ++ii) {
+         if (TMath::Abs(graph.pdg(ii)) != kPchargino1) continue;
+         const Susy::mc::TruthGraph::Range parents = graph.parents(ii);
+         for (size_t jj = 0; jj < parents.size(); ++jj) {
+             int parenPdg(TMath::Abs(graph.pdg(parents[jj])));
+             if (parenPdg == kPchargino1) break; // Self-copy
+             if (parenPdg != kPgam && parenPdg != kPz && parenPdg != kPw) return true;
+         }
+     }
+     return false;
+}
 
 /* ------------------------------------------------------------------------------- */
 /*  Kinematic calculations [begin]                                                 */
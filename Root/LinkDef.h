@@ -52,10 +52,15 @@
 #pragma link C++ class Susy::Met+;
 #pragma link C++ class Susy::TrackMet+;
 #pragma link C++ class Susy::Event+;
+#pragma link C++ class Susy::TriggerBits+;
 #pragma link C++ class Susy::TruthParticle+;
 #pragma link C++ class Susy::TruthJet+;
 #pragma link C++ class Susy::TruthMet+;
 
+// trigger bits were stored as TBits up to Event v39 and Lepton v25
+#pragma read sourceClass="Susy::Event" targetClass="Susy::Event" version="[-39]" include="TBits.h" source="TBits trigBits" target="trigBits" code="{ trigBits.fromTBits(onfile.trigBits); }"
+#pragma read sourceClass="Susy::Lepton" targetClass="Susy::Lepton" version="[-25]" include="TBits.h" source="TBits trigBits" target="trigBits" code="{ trigBits.fromTBits(onfile.trigBits); }"
+
 // STL
 #pragma link C++ class std::vector< Susy::Particle >+;
 #pragma link C++ class std::vector< Susy::Lepton >+;
@@ -215,6 +215,12 @@ double MCWeighter::getMCWeight(const Susy::Event* evt, const float lumi,
     return weight;
 }
 // ------------------------------------------------------------------------- //
+bool MCWeighter::affectsMCWeight(Susy::NtSys::SusyNtSys sys)
+{
+    return (sys == Susy::NtSys::PILEUP_UP || sys == Susy::NtSys::PILEUP_DN ||
+            sys == Susy::NtSys::XS_UP || sys == Susy::NtSys::XS_DN);
+}
+// ------------------------------------------------------------------------- //
 double MCWeighter::getSumw(const Susy::Event* evt)
 {
     double sumw = -1.0;
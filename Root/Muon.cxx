@@ -200,3 +200,74 @@ void Muon::print() const
   cout.unsetf(ios_base::fixed);
 }
 
+/*--------------------------------------------------------------------------------*/
+// Systematic payloads
+/*--------------------------------------------------------------------------------*/
+bool Muon::hasSys(NtSys::SusyNtSys sys) const
+{
+  if     ( sys == NtSys::MUON_EFF_STAT_UP ) return !errEffSF_stat_up.empty();
+  else if( sys == NtSys::MUON_EFF_STAT_DN ) return !errEffSF_stat_dn.empty();
+  else if( sys == NtSys::MUON_EFF_SYS_UP ) return !errEffSF_syst_up.empty();
+  else if( sys == NtSys::MUON_EFF_SYS_DN ) return !errEffSF_syst_dn.empty();
+  else if( sys == NtSys::MUON_EFF_STAT_LOWPT_UP ) return !errEffSF_stat_lowpt_up.empty();
+  else if( sys == NtSys::MUON_EFF_STAT_LOWPT_DN ) return !errEffSF_stat_lowpt_dn.empty();
+  else if( sys == NtSys::MUON_EFF_SYS_LOWPT_UP ) return !errEffSF_syst_lowpt_up.empty();
+  else if( sys == NtSys::MUON_EFF_SYS_LOWPT_DN ) return !errEffSF_syst_lowpt_dn.empty();
+  else if( sys == NtSys::MUON_ISO_STAT_UP ) return !errIso_stat_up.empty();
+  else if( sys == NtSys::MUON_ISO_STAT_DN ) return !errIso_stat_dn.empty();
+  else if( sys == NtSys::MUON_ISO_SYS_UP ) return !errIso_syst_up.empty();
+  else if( sys == NtSys::MUON_ISO_SYS_DN ) return !errIso_syst_dn.empty();
+  else if( sys == NtSys::MUON_TTVA_STAT_UP ) return !errTTVA_stat_up.empty();
+  else if( sys == NtSys::MUON_TTVA_STAT_DN ) return !errTTVA_stat_dn.empty();
+  else if( sys == NtSys::MUON_TTVA_SYS_UP ) return !errTTVA_syst_up.empty();
+  else if( sys == NtSys::MUON_TTVA_SYS_DN ) return !errTTVA_syst_dn.empty();
+  else if( sys == NtSys::MUON_BADMUON_STAT_UP ) return !errBadMu_stat_up.empty();
+  else if( sys == NtSys::MUON_BADMUON_STAT_DN ) return !errBadMu_stat_dn.empty();
+  else if( sys == NtSys::MUON_BADMUON_SYS_UP ) return !errBadMu_syst_up.empty();
+  else if( sys == NtSys::MUON_BADMUON_SYS_DN ) return !errBadMu_syst_dn.empty();
+  // the trigger efficiency maps are empty also when no trigger was stored: use the MC ones as a flag
+  else if( sys == NtSys::MUON_EFF_TRIG_STAT_UP ) return muoTrigEffErrMC_stat_up_medium.size() == muoTrigEffMC_medium.size();
+  else if( sys == NtSys::MUON_EFF_TRIG_STAT_DN ) return muoTrigEffErrMC_stat_dn_medium.size() == muoTrigEffMC_medium.size();
+  else if( sys == NtSys::MUON_EFF_TRIG_SYST_UP ) return muoTrigEffErrMC_syst_up_medium.size() == muoTrigEffMC_medium.size();
+  else if( sys == NtSys::MUON_EFF_TRIG_SYST_DN ) return muoTrigEffErrMC_syst_dn_medium.size() == muoTrigEffMC_medium.size();
+  return true;
+}
+void Muon::stripSys(const std::set<NtSys::SusyNtSys> &keep)
+{
+  if( !keep.count(NtSys::MUON_EFF_STAT_UP) ) errEffSF_stat_up.clear();
+  if( !keep.count(NtSys::MUON_EFF_STAT_DN) ) errEffSF_stat_dn.clear();
+  if( !keep.count(NtSys::MUON_EFF_SYS_UP) ) errEffSF_syst_up.clear();
+  if( !keep.count(NtSys::MUON_EFF_SYS_DN) ) errEffSF_syst_dn.clear();
+  if( !keep.count(NtSys::MUON_EFF_STAT_LOWPT_UP) ) errEffSF_stat_lowpt_up.clear();
+  if( !keep.count(NtSys::MUON_EFF_STAT_LOWPT_DN) ) errEffSF_stat_lowpt_dn.clear();
+  if( !keep.count(NtSys::MUON_EFF_SYS_LOWPT_UP) ) errEffSF_syst_lowpt_up.clear();
+  if( !keep.count(NtSys::MUON_EFF_SYS_LOWPT_DN) ) errEffSF_syst_lowpt_dn.clear();
+  if( !keep.count(NtSys::MUON_ISO_STAT_UP) ) errIso_stat_up.clear();
+  if( !keep.count(NtSys::MUON_ISO_STAT_DN) ) errIso_stat_dn.clear();
+  if( !keep.count(NtSys::MUON_ISO_SYS_UP) ) errIso_syst_up.clear();
+  if( !keep.count(NtSys::MUON_ISO_SYS_DN) ) errIso_syst_dn.clear();
+  if( !keep.count(NtSys::MUON_TTVA_STAT_UP) ) errTTVA_stat_up.clear();
+  if( !keep.count(NtSys::MUON_TTVA_STAT_DN) ) errTTVA_stat_dn.clear();
+  if( !keep.count(NtSys::MUON_TTVA_SYS_UP) ) errTTVA_syst_up.clear();
+  if( !keep.count(NtSys::MUON_TTVA_SYS_DN) ) errTTVA_syst_dn.clear();
+  if( !keep.count(NtSys::MUON_BADMUON_STAT_UP) ) errBadMu_stat_up.clear();
+  if( !keep.count(NtSys::MUON_BADMUON_STAT_DN) ) errBadMu_stat_dn.clear();
+  if( !keep.count(NtSys::MUON_BADMUON_SYS_UP) ) errBadMu_syst_up.clear();
+  if( !keep.count(NtSys::MUON_BADMUON_SYS_DN) ) errBadMu_syst_dn.clear();
+  if( !keep.count(NtSys::MUON_EFF_TRIG_STAT_UP) ) {
+    muoTrigEffErrData_stat_up_medium.clear();
+    muoTrigEffErrMC_stat_up_medium.clear();
+  }
+  if( !keep.count(NtSys::MUON_EFF_TRIG_STAT_DN) ) {
+    muoTrigEffErrData_stat_dn_medium.clear();
+    muoTrigEffErrMC_stat_dn_medium.clear();
+  }
+  if( !keep.count(NtSys::MUON_EFF_TRIG_SYST_UP) ) {
+    muoTrigEffErrData_syst_up_medium.clear();
+    muoTrigEffErrMC_syst_up_medium.clear();
+  }
+  if( !keep.count(NtSys::MUON_EFF_TRIG_SYST_DN) ) {
+    muoTrigEffErrData_syst_dn_medium.clear();
+    muoTrigEffErrMC_syst_dn_medium.clear();
+  }
+}
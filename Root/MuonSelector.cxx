@@ -68,13 +68,7 @@ MuonSelector::MuonSelector():
 //----------------------------------------------------------
 bool MuonSelector::isBaseline(const Muon* mu)
 {
-    bool pass = false;
-    if(mu) {
-        pass = (mu->medium &&
-                mu->Pt()        > 10.0 &&
-                fabs(mu->Eta()) <  2.4 );
-    }
-    return pass;
+    return (mu && MuonPolicy::isBaseline(*mu));
 }
 //----------------------------------------------------------
 bool MuonSelector::isSignal(const Muon* mu)
@@ -91,12 +85,29 @@ bool MuonSelector::isSignal(const Muon* mu)
 //----------------------------------------------------------
 bool MuonSelector::passIpCut(const Muon* mu)
 {
-    bool pass = false;
-    if(mu) {
-        pass = (fabs(mu->d0sigBSCorr)  < 3.0 &&
-                fabs(mu->z0SinTheta()) < 0.5 );
+    return (mu && MuonPolicy::passIpCut(*mu));
+}
+//----------------------------------------------------------
+void MuonSelector::selectBaseline(const MuonVector &in, MuonVector &out)
+{
+    for(size_t i=0; i<in.size(); ++i)
+        if(isBaseline(in[i])) out.push_back(in[i]);
+}
+//----------------------------------------------------------
+void MuonSelector::selectSignal(const MuonVector &in, MuonVector &out)
+{
+    for(size_t i=0; i<in.size(); ++i)
+        if(isSignal(in[i])) out.push_back(in[i]);
+}
+//----------------------------------------------------------
+void MuonSelector::classify(ObjectStatus::Collection<Muon> &status)
+{
+    const MuonVector &in = status.objects();
+    std::vector<uint8_t> &bits = status.bits();
+    for(size_t i=0; i<in.size(); ++i) {
+        if(isBaseline(in[i])) bits[i] |= ObjectStatus::Baseline;
+        if(isSignal(in[i])) bits[i] |= ObjectStatus::PassSignal;
     }
-    return pass;
 }
 //----------------------------------------------------------
 float MuonSelector::effSF(const Muon& mu, const NtSys::SusyNtSys sys)
@@ -116,6 +127,10 @@ float MuonSelector::errEffSF(const Muon& mu, const SusyNtSys sys)
 {
     // return the error on the muon SF associated with systematc sys
     float err = 0.0;
+    if(!mu.hasSys(sys)) {
+        // stripped from the input (see SusyNtSlimmer::setSystematicsToKeep): no shift
+        return err;
+    }
     if       (sys == NtSys::MUON_EFF_STAT_UP) {
         err = mu.errEffSF_stat_up[m_signalId];
     }
@@ -161,143 +176,6 @@ float MuonSelector::errEffSF(const Muon& mu, const SusyNtSys sys)
     return err;
 }
 //----------------------------------------------------------
-// begin MuonSelector_2Lep Ana_2Lep
-//----------------------------------------------------------
-bool MuonSelector_2Lep::isBaseline(const Muon* mu)
-{
-    bool pass = false;
-    if(mu) {
-        pass = (mu->medium &&
-                mu->Pt()        > 10.0 && 
-                fabs(mu->Eta()) <  2.4); // I don't think this is the best ASM 9/6/16
-    }
-    return pass;
-}
+// the analysis-specific selectors are the policies in MuonSelector.h
 //----------------------------------------------------------
-bool MuonSelector_2Lep::isSignal(const Muon* mu)
-{
-    bool pass = false;
-    if(mu) {
-        pass = (isBaseline(mu)       &&
-                mu->isoGradientLoose &&
-                passIpCut(mu)        );
-    }
-    return pass;
-}
-//----------------------------------------------------------
-// begin MuonSelector_3Lep Ana_3Lep
-//----------------------------------------------------------
-bool MuonSelector_3Lep::isSignal(const Muon* mu)
-{
-    bool pass = false;
-    if(mu) {
-        pass = (isBaseline(mu) &&
-                mu->isoFixedCutTightTrackOnly &&
-                passIpCut(mu));
-    }
-    return pass;
-}
-
-//----------------------------------------------------------
-// begin MuonSelector_4Lep
-//----------------------------------------------------------
-bool MuonSelector_4Lep::isBaseline(const Muon* mu)
-{    
-    bool pass = false;
-    if(mu) {
-        pass = (mu->medium &&
-                mu->Pt()        > 10.0 &&
-                fabs(mu->Eta()) <  2.5 );
-    }
-    return pass;
-}
-
-//----------------------------------------------------------
-// begin MuonSelector_2LepWH Ana_2LepWH
-//----------------------------------------------------------
-bool MuonSelector_2LepWH::isSignal(const Muon* mu)
-{
-    bool pass = false;
-    if(mu) {
-        pass = (isBaseline(mu) &&
-                mu->ptvarcone30/mu->Pt() < 0.06 &&
-                mu->etconetopo30/mu->Pt() < 0.14 &&
-                passIpCut(mu));
-    }
-    return pass;
-}
-//----------------------------------------------------------
-// begin MuonSelector_SS3L Ana_SS3L
-//----------------------------------------------------------
-bool MuonSelector_SS3L::isBaseline(const Muon* mu)
-{
-    bool pass = false;
-    if(mu) {
-        pass = (mu->medium &&
-                mu->Pt()        > 10.0 &&
-                fabs(mu->Eta()) <  2.5 );
-    }
-    return pass;
-}
-//----------------------------------------------------------
-bool MuonSelector_SS3L::isSignal(const Muon* mu)
-{
-    bool pass = false;
-    if(mu) {
-        pass = (isBaseline(mu) &&
-                mu->ptvarcone30/mu->Pt() < 0.06 &&
-                passIpCut(mu));
-    }
-    return pass;
-}
-//----------------------------------------------------------
-// begin MuonSelector_Stop2L Ana_Stop2L
-//----------------------------------------------------------
-bool MuonSelector_Stop2L::isBaseline(const Muon* mu)
-{
-    bool pass = false;
-    if(mu) {
-        pass = (mu->medium &&
-                mu->Pt()        > 10.0 &&
-                fabs(mu->Eta()) <  2.4 );
-    }
-    return pass;
-}
-//----------------------------------------------------------
-bool MuonSelector_Stop2L::isSignal(const Muon* mu)
-{
-    bool pass = false;
-    if(mu) {
-        pass = (mu->Pt() > 10.0 &&
-                isBaseline(mu) &&
-                mu->isoGradientLoose &&
-                passIpCut(mu));
-    }
-    return pass;
-}
-//----------------------------------------------------------
-//----------------------------------------------------------
-// begin MuonSelector_WWBB Ana_WWBB
-//----------------------------------------------------------
-bool MuonSelector_WWBB::isBaseline(const Muon* mu)
-{
-    bool pass = false;
-    if(mu) {
-        pass = (mu->medium &&
-                mu->Pt() > 10.0 &&
-                fabs(mu->Eta()) < 2.4);
-    }
-    return pass;
-}
-//----------------------------------------------------------
-bool MuonSelector_WWBB::isSignal(const Muon* mu)
-{
-    bool pass = false;
-    if(mu) {
-        pass = (MuonSelector_WWBB::isBaseline(mu) &&
-                mu->isoFixedCutTightTrackOnly &&
-                passIpCut(mu));
-    }
-    return pass;
-}
 }; // namespace Susy
@@ -697,18 +697,12 @@ void OverlapTools_SS3L::j_e_overlap(ElectronVector& electrons, JetVector& jets,
     //       --> if bjet: keep the jet, remove electron
     //       --> if not bjet: remove the jet, keep the electron
     if(electrons.size()==0 || jets.size()==0) return;
-    JetSelector_SS3L* jetSelector = static_cast<JetSelector_SS3L*>(JetSelector::build(AnalysisType::Ana_SS3L, true));
-    if(not jetSelector) {
-        cerr<<"OverlapTools_SS3L: cannot perform j_e_overlap without JetSelector"<<endl
-            <<"Please call OverlapTools_SS3L::jetSelector(JetSelector*)"<<endl;
-        // assert(false);
-    }
     for(int iEl=electrons.size()-1; iEl>=0; iEl--) {
         const Electron* e = electrons.at(iEl);
         for(int iJ=jets.size()-1; iJ>=0; iJ--){
             const Jet* j = jets.at(iJ);
             if(e->DeltaRy(*j) < dR){
-                bool isBjet = jetSelector->isB_for_OR(j);
+                bool isBjet = JetPolicy_SS3L::isB_for_OR(*j);
                 if(isBjet) {
                     if(verbose()) print_rm_msg("j_e_overlap: ", e, j);
                     electrons.erase(electrons.begin()+iEl);
@@ -0,0 +1,109 @@
+#include "SusyNtuple/PerfCounters.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using Susy::PerfCounters;
+using Susy::PerfSample;
+
+using std::cout;
+using std::endl;
+
+#ifdef __linux__
+namespace {
+int openCounter(uint64_t config, int groupFd)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = (groupFd<0 ? 1 : 0);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0);
+}
+}
+#endif
+//----------------------------------------------------------
+std::string PerfSample::str() const
+{
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "IPC %.2f, cache miss/kinstr %.2f, branch miss/instr %.2f%%",
+             ipc(), cacheMissesPerKiloInstruction(), branchMissPercent());
+    return buffer;
+}
+//----------------------------------------------------------
+PerfCounters::PerfCounters() :
+    m_leader(-1),
+    m_nOpen(0)
+{
+    for(int i=0; i<s_nCounters; ++i) m_fds[i] = m_slot[i] = -1;
+}
+//----------------------------------------------------------
+PerfCounters::~PerfCounters()
+{
+    close();
+}
+//----------------------------------------------------------
+bool PerfCounters::open()
+{
+    close();
+#ifdef __linux__
+    const uint64_t configs[s_nCounters] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                           PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    m_leader = openCounter(configs[0], -1);
+    if(m_leader<0) {
+        cout<<"PerfCounters::open: hardware counters not available"
+            <<" (check /proc/sys/kernel/perf_event_paranoid)"<<endl;
+        return false;
+    }
+    m_fds[0] = m_leader;
+    m_slot[0] = m_nOpen++;
+    for(int i=1; i<s_nCounters; ++i) {
+        m_fds[i] = openCounter(configs[i], m_leader);
+        if(m_fds[i]>=0) m_slot[i] = m_nOpen++;
+    }
+    ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+#else
+    cout<<"PerfCounters::open: hardware counters are only supported on Linux"<<endl;
+    return false;
+#endif
+}
+//----------------------------------------------------------
+void PerfCounters::close()
+{
+#ifdef __linux__
+    for(int i=s_nCounters-1; i>=0; --i)
+        if(m_fds[i]>=0) ::close(m_fds[i]);
+#endif
+    for(int i=0; i<s_nCounters; ++i) m_fds[i] = m_slot[i] = -1;
+    m_leader = -1;
+    m_nOpen = 0;
+}
+//----------------------------------------------------------
+PerfSample PerfCounters::read() const
+{
+    PerfSample sample;
+#ifdef __linux__
+    if(m_leader<0) return sample;
+    uint64_t buffer[1+s_nCounters] = {0}; // nr, values
+    if(::read(m_leader, buffer, sizeof(buffer))<static_cast<ssize_t>((1+m_nOpen)*sizeof(uint64_t))) return sample;
+    uint64_t* values[s_nCounters] = {&sample.cycles, &sample.instructions, &sample.cacheMisses, &sample.branchMisses};
+    for(int i=0; i<s_nCounters; ++i)
+        if(m_slot[i]>=0) *values[i] = buffer[1+m_slot[i]];
+#endif
+    return sample;
+}
+//----------------------------------------------------------
@@ -63,15 +63,7 @@ PhotonSelector::PhotonSelector():
 // -------------------------------------------------------------------------------------------- //
 bool PhotonSelector::isBaseline(const Photon* ph)
 {
-    bool pass = false;
-    if(ph) {
-        bool pass_author = (ph->authorPhoton || ph->authorAmbiguous); // reco. as photon OR (photon AND ele)
-        pass = (ph->tight &&
-                ph->Pt()        > 25 &&
-                std::abs(ph->clusEtaBE) < 2.37 &&
-                pass_author);
-    }
-    return pass;
+    return (ph && PhotonPolicy::isBaseline(*ph));
 }
 // -------------------------------------------------------------------------------------------- //
 bool PhotonSelector::isSignal(const Photon* ph)
@@ -84,23 +76,29 @@ bool PhotonSelector::isSignal(const Photon* ph)
     return pass;
 }
 // -------------------------------------------------------------------------------------------- //
-// begin PhotonSelector_2Lep Ana_2Lep
-// -------------------------------------------------------------------------------------------- //
-
-// -------------------------------------------------------------------------------------------- //
-// begin PhotonSelector_3Lep Ana_3Lep
-// -------------------------------------------------------------------------------------------- //
-
-// -------------------------------------------------------------------------------------------- //
-// begin PhotonSelector_2LepWH Ana_2LepWH
-// -------------------------------------------------------------------------------------------- //
-
+void PhotonSelector::selectBaseline(const PhotonVector &in, PhotonVector &out)
+{
+    for(size_t i=0; i<in.size(); ++i)
+        if(isBaseline(in[i])) out.push_back(in[i]);
+}
 // -------------------------------------------------------------------------------------------- //
-// begin PhotonSelector_SS3L Ana_SS3L
+void PhotonSelector::selectSignal(const PhotonVector &in, PhotonVector &out)
+{
+    for(size_t i=0; i<in.size(); ++i)
+        if(isSignal(in[i])) out.push_back(in[i]);
+}
 // -------------------------------------------------------------------------------------------- //
-
+void PhotonSelector::classify(ObjectStatus::Collection<Photon> &status)
+{
+    const PhotonVector &in = status.objects();
+    std::vector<uint8_t> &bits = status.bits();
+    for(size_t i=0; i<in.size(); ++i) {
+        if(isBaseline(in[i])) bits[i] |= ObjectStatus::Baseline;
+        if(isSignal(in[i])) bits[i] |= ObjectStatus::PassSignal;
+    }
+}
 // -------------------------------------------------------------------------------------------- //
-// begin PhotonSelector_Stop2L Ana_Stop2L
+// the analysis-specific selectors are the policies in PhotonSelector.h
 // -------------------------------------------------------------------------------------------- //
 
 } // namespace Susy
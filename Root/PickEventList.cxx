@@ -0,0 +1,106 @@
+#include "SusyNtuple/PickEventList.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using Susy::PickEventList;
+
+using std::cout;
+using std::endl;
+using std::string;
+
+namespace {
+/// parse an unsigned 32-bit number at p; return false if there is none or it overflows
+inline bool parseNumber(const char* &p, const char* end, uint32_t &value)
+{
+    uint64_t v = 0;
+    const char* start = p;
+    while(p<end && *p>='0' && *p<='9') {
+        v = 10*v + (*p - '0');
+        if(v>0xffffffffULL) return false;
+        ++p;
+    }
+    value = static_cast<uint32_t>(v);
+    return p!=start;
+}
+inline bool isBlank(char c) { return c==' ' || c=='\t' || c=='\r'; }
+inline bool isSeparator(char c) { return isBlank(c) || c==':' || c==','; }
+}
+//----------------------------------------------------------
+PickEventList::PickEventList() :
+    m_nMalformed(0),
+    m_verbose(false)
+{
+}
+//----------------------------------------------------------
+bool PickEventList::read(const std::string &filename)
+{
+    FILE* file = fopen(filename.c_str(), "rb");
+    if(!file) {
+        cout<<"PickEventList::read: cannot open '"<<filename<<"'"<<endl;
+        return false;
+    }
+    const size_t blockSize = 4*1024*1024;
+    std::vector<char> buffer(blockSize);
+    size_t nCarried = 0; // bytes of an incomplete line left from the previous block
+    size_t nPairs = 0;
+    while(true) {
+        if(nCarried==buffer.size()) buffer.resize(2*buffer.size()); // absurdly long line
+        size_t nRead = fread(&buffer[nCarried], 1, buffer.size()-nCarried, file);
+        const char* begin = &buffer[0];
+        const char* end = begin + nCarried + nRead;
+        if(nRead==0) { // last line without a newline
+            if(nCarried>0) nPairs += parse(begin, end);
+            break;
+        }
+        const char* lastNewline = end;
+        while(lastNewline>begin && *(lastNewline-1)!='\n') --lastNewline;
+        nPairs += parse(begin, lastNewline);
+        nCarried = end - lastNewline;
+        if(nCarried>0) memmove(&buffer[0], lastNewline, nCarried);
+    }
+    bool success = !ferror(file);
+    fclose(file);
+    if(!success)
+        cout<<"PickEventList::read: error while reading '"<<filename<<"'"<<endl;
+    if(m_verbose || m_nMalformed>0)
+        cout<<"PickEventList::read: "<<nPairs<<" pairs from '"<<filename<<"'"
+            <<" ("<<size()<<" distinct events in "<<nRuns()<<" runs"
+            <<(m_nMalformed>0 ? ", some lines could not be parsed" : "")<<")"<<endl;
+    return success;
+}
+//----------------------------------------------------------
+size_t PickEventList::parse(const char* begin, const char* end)
+{
+    size_t nPairs = 0;
+    const char* p = begin;
+    while(p<end) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end-p));
+        if(!eol) eol = end;
+        const char* line = p;
+        while(p<eol && isBlank(*p)) ++p;
+        if(p<eol && *p!='#') {
+            uint32_t run = 0, event = 0;
+            bool valid = parseNumber(p, eol, run);
+            if(valid) {
+                const char* sep = p;
+                while(p<eol && isSeparator(*p)) ++p;
+                valid = p!=sep && parseNumber(p, eol, event);
+            }
+            while(valid && p<eol && isBlank(*p)) ++p;
+            if(valid && p==eol) {
+                m_events.insert(run, event);
+                nPairs++;
+            } else {
+                if(m_verbose)
+                    cout<<"PickEventList::parse: skipping line '"<<string(line, eol)<<"'"<<endl;
+                m_nMalformed++;
+            }
+        }
+        p = eol + 1;
+    }
+    return nPairs;
+}
+//----------------------------------------------------------
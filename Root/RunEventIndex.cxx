@@ -0,0 +1,277 @@
+#include "SusyNtuple/RunEventIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using Susy::EventlistCache;
+using Susy::PickEventList;
+using Susy::RunEventIndex;
+using Susy::RunEventRecord;
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+const char RunEventIndex::s_magic[8] = {'S','N','T','R','E','I','X','\0'};
+
+namespace {
+bool eventBefore(const RunEventRecord &a, const RunEventRecord &b)
+{
+    return a.run<b.run || (a.run==b.run && a.event<b.event);
+}
+bool sameEvent(const RunEventRecord &a, const RunEventRecord &b)
+{
+    return a.run==b.run && a.event==b.event;
+}
+bool entryBefore(const RunEventRecord &a, const RunEventRecord &b)
+{
+    return a.file<b.file || (a.file==b.file && a.entry<b.entry);
+}
+}
+//----------------------------------------------------------
+RunEventIndex::RunEventIndex() :
+    m_sorted(true),
+    m_mapAddress(0),
+    m_mapSize(0),
+    m_mappedBegin(0),
+    m_mappedEnd(0)
+{
+}
+//----------------------------------------------------------
+RunEventIndex::~RunEventIndex()
+{
+    unmap();
+}
+//----------------------------------------------------------
+bool RunEventIndex::isIndexFile(const std::string &filename)
+{
+    char magic[sizeof(s_magic)];
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    return (file.read(magic, sizeof(magic)) &&
+            0==memcmp(magic, s_magic, sizeof(s_magic)));
+}
+//----------------------------------------------------------
+uint32_t RunEventIndex::addFile(const std::string &name, uint64_t nEntries)
+{
+    FileInfo info = {name, EventlistCache::fileKey(name, nEntries), nEntries};
+    m_files.push_back(info);
+    return m_files.size()-1;
+}
+//----------------------------------------------------------
+RunEventIndex& RunEventIndex::add(uint32_t run, uint32_t event, uint32_t file, uint64_t entry)
+{
+    if(isMapped()) materialize();
+    RunEventRecord rec = {run, event, file, 0, entry};
+    if(!m_records.empty() && rec<m_records.back()) m_sorted = false;
+    m_records.push_back(rec);
+    return *this;
+}
+//----------------------------------------------------------
+RunEventIndex& RunEventIndex::add(const std::vector<RunEventRecord> &records)
+{
+    if(isMapped()) materialize();
+    m_records.insert(m_records.end(), records.begin(), records.end());
+    m_sorted = false;
+    return *this;
+}
+//----------------------------------------------------------
+RunEventIndex& RunEventIndex::merge(const RunEventIndex &other)
+{
+    if(isMapped()) materialize();
+    sortRecords();
+    const uint32_t fileOffset = m_files.size();
+    m_files.insert(m_files.end(), other.m_files.begin(), other.m_files.end());
+    const size_t nBefore = m_records.size();
+    for(const RunEventRecord* r=other.begin(); r!=other.end(); ++r) {
+        m_records.push_back(*r);
+        m_records.back().file += fileOffset;
+    }
+    // both parts are sorted
+    std::inplace_merge(m_records.begin(), m_records.begin()+nBefore, m_records.end());
+    return *this;
+}
+//----------------------------------------------------------
+bool RunEventIndex::write(const std::string &filename) const
+{
+    vector<FileRecord> files;
+    string names;
+    for(size_t i=0; i<m_files.size(); ++i) {
+        FileRecord rec = {m_files[i].key, m_files[i].nEntries, names.size(), m_files[i].name.size()};
+        files.push_back(rec);
+        names += m_files[i].name;
+    }
+    Header header;
+    memcpy(header.magic, s_magic, sizeof(s_magic));
+    header.version = s_version;
+    header.nFiles = files.size();
+    header.nRecords = size();
+    header.namesSize = names.size();
+
+    std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if(!files.empty())
+        file.write(reinterpret_cast<const char*>(&files[0]), files.size()*sizeof(FileRecord));
+    if(size())
+        file.write(reinterpret_cast<const char*>(begin()), size()*sizeof(RunEventRecord));
+    file.write(names.data(), names.size());
+    bool success = file.good();
+    file.close();
+    if(!success)
+        cout<<"RunEventIndex::write: failed to write '"<<filename<<"'"<<endl;
+    return success;
+}
+//----------------------------------------------------------
+bool RunEventIndex::read(const std::string &filename)
+{
+    clear();
+    int fd = open(filename.c_str(), O_RDONLY);
+    if(fd<0) {
+        cout<<"RunEventIndex::read: cannot open '"<<filename<<"'"<<endl;
+        return false;
+    }
+    struct stat st;
+    bool valid = (0==fstat(fd, &st) && static_cast<size_t>(st.st_size)>=sizeof(Header));
+    void* address = (valid ? mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED);
+    close(fd);
+    if(address==MAP_FAILED) {
+        cout<<"RunEventIndex::read: cannot map '"<<filename<<"'"<<endl;
+        return false;
+    }
+    const Header* header = static_cast<const Header*>(address);
+    size_t expectedSize = (sizeof(Header) +
+                           header->nFiles*sizeof(FileRecord) +
+                           header->nRecords*sizeof(RunEventRecord) +
+                           header->namesSize);
+    valid = (0==memcmp(header->magic, s_magic, sizeof(s_magic)) &&
+             header->version==s_version &&
+             static_cast<size_t>(st.st_size)==expectedSize);
+    if(!valid) {
+        cout<<"RunEventIndex::read: '"<<filename<<"' is not a valid index file"<<endl;
+        munmap(address, st.st_size);
+        return false;
+    }
+    const FileRecord* files = reinterpret_cast<const FileRecord*>(header+1);
+    const RunEventRecord* records = reinterpret_cast<const RunEventRecord*>(files + header->nFiles);
+    const char* names = reinterpret_cast<const char*>(records + header->nRecords);
+    for(size_t i=0; i<header->nFiles; ++i) {
+        FileInfo info = {string(names + files[i].nameOffset, files[i].nameLength),
+                         files[i].key, files[i].nEntries};
+        m_files.push_back(info);
+    }
+    m_mapAddress = address;
+    m_mapSize = st.st_size;
+    m_mappedBegin = records;
+    m_mappedEnd = records + header->nRecords;
+    return true;
+}
+//----------------------------------------------------------
+void RunEventIndex::clear()
+{
+    unmap();
+    m_files.clear();
+    m_records.clear();
+    m_sorted = true;
+}
+//----------------------------------------------------------
+size_t RunEventIndex::size() const
+{
+    return isMapped() ? m_mappedEnd - m_mappedBegin : m_records.size();
+}
+//----------------------------------------------------------
+const RunEventRecord* RunEventIndex::begin() const
+{
+    if(isMapped()) return m_mappedBegin;
+    sortRecords();
+    return m_records.empty() ? 0 : &m_records[0];
+}
+//----------------------------------------------------------
+const RunEventRecord* RunEventIndex::end() const
+{
+    return begin() + size();
+}
+//----------------------------------------------------------
+std::pair<const RunEventRecord*, const RunEventRecord*> RunEventIndex::find(uint32_t run, uint32_t event) const
+{
+    RunEventRecord key = {run, event, 0, 0, 0};
+    return std::equal_range(begin(), end(), key, eventBefore);
+}
+//----------------------------------------------------------
+bool RunEventIndex::contains(uint32_t run, uint32_t event) const
+{
+    std::pair<const RunEventRecord*, const RunEventRecord*> range = find(run, event);
+    return range.first!=range.second;
+}
+//----------------------------------------------------------
+uint64_t RunEventIndex::select(const PickEventList &pick, EventlistCache &cache) const
+{
+    // scan the records (in memory, no tree is read), then add the hits in entry order
+    vector<RunEventRecord> hits;
+    for(const RunEventRecord* r=begin(); r!=end(); ++r)
+        if(pick.contains(r->run, r->event)) hits.push_back(*r);
+    std::sort(hits.begin(), hits.end(), entryBefore);
+    for(size_t i=0; i<hits.size(); ++i) {
+        const FileInfo &info = m_files.at(hits[i].file);
+        cache.add(info.key, info.nEntries, hits[i].entry);
+    }
+    return hits.size();
+}
+//----------------------------------------------------------
+std::vector<RunEventIndex::RecordPair> RunEventIndex::duplicates() const
+{
+    vector<RecordPair> result;
+    const RunEventRecord* first = begin();
+    for(const RunEventRecord* r=begin(); r!=end(); ++r) {
+        if(!sameEvent(*first, *r)) first = r;
+        else if(r!=first) result.push_back(RecordPair(*first, *r));
+    }
+    return result;
+}
+//----------------------------------------------------------
+std::vector<RunEventIndex::RecordPair> RunEventIndex::commonEvents(const RunEventIndex &a, const RunEventIndex &b)
+{
+    vector<RecordPair> result;
+    const RunEventRecord* ra = a.begin();
+    const RunEventRecord* rb = b.begin();
+    while(ra!=a.end() && rb!=b.end()) {
+        if(eventBefore(*ra, *rb))      ++ra;
+        else if(eventBefore(*rb, *ra)) ++rb;
+        else {
+            result.push_back(RecordPair(*ra, *rb));
+            ++ra;
+            ++rb;
+        }
+    }
+    return result;
+}
+//----------------------------------------------------------
+void RunEventIndex::unmap()
+{
+    if(m_mapAddress) munmap(m_mapAddress, m_mapSize);
+    m_mapAddress = 0;
+    m_mapSize = 0;
+    m_mappedBegin = m_mappedEnd = 0;
+}
+//----------------------------------------------------------
+void RunEventIndex::materialize()
+{
+    vector<RunEventRecord> records(m_mappedBegin, m_mappedEnd);
+    unmap();
+    m_records.swap(records);
+    m_sorted = true;
+}
+//----------------------------------------------------------
+void RunEventIndex::sortRecords() const
+{
+    if(m_sorted) return;
+    std::sort(m_records.begin(), m_records.end());
+    m_sorted = true;
+}
+//----------------------------------------------------------
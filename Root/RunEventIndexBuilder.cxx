@@ -0,0 +1,104 @@
+#include "SusyNtuple/RunEventIndexBuilder.h"
+#include "SusyNtuple/Event.h"
+
+#include "TBranch.h"
+#include "TChain.h"
+#include "TFile.h"
+#include "TObjArray.h"
+#include "TROOT.h"
+#include "TTree.h"
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using Susy::RunEventIndex;
+using Susy::RunEventIndexBuilder;
+using Susy::RunEventRecord;
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+//----------------------------------------------------------
+RunEventIndexBuilder::RunEventIndexBuilder(TChain* chain) :
+    m_chain(chain),
+    m_nThreads(0),
+    m_verbose(false)
+{
+}
+//----------------------------------------------------------
+bool RunEventIndexBuilder::build(RunEventIndex &index)
+{
+    const TObjArray* files = m_chain->GetListOfFiles();
+    const size_t nFiles = files->GetEntries();
+    vector<string> filenames;
+    for(size_t i=0; i<nFiles; ++i) filenames.push_back(files->At(i)->GetTitle());
+    vector<uint64_t> nEntries(nFiles, 0);
+    vector<vector<RunEventRecord> > records(nFiles);
+    vector<char> success(nFiles, false);
+
+    unsigned int nThreads = (m_nThreads>0 ? m_nThreads : std::thread::hardware_concurrency());
+    if(nThreads==0) nThreads = 1;
+    if(nThreads>nFiles) nThreads = nFiles;
+    if(nThreads>1) ROOT::EnableThreadSafety();
+    const uint32_t firstFile = index.nFiles();
+    std::atomic<size_t> nextFile(0);
+    vector<std::thread> threads;
+    for(unsigned int t=0; t<nThreads; ++t) {
+        threads.push_back(std::thread([&]() {
+                    for(size_t i=nextFile++; i<nFiles; i=nextFile++)
+                        success[i] = indexFile(filenames[i], firstFile+i, nEntries[i], records[i]);
+                }));
+    }
+    for(size_t t=0; t<threads.size(); ++t) threads[t].join();
+
+    bool allGood = true;
+    size_t nRecords = 0;
+    for(size_t i=0; i<nFiles; ++i) {
+        index.addFile(filenames[i], nEntries[i]);
+        index.add(records[i]);
+        nRecords += records[i].size();
+        allGood = allGood && success[i];
+    }
+    if(m_verbose)
+        cout<<"RunEventIndexBuilder::build: indexed "<<nRecords<<" events from "<<nFiles<<" files"
+            <<" with "<<nThreads<<" threads"<<endl;
+    return allGood;
+}
+//----------------------------------------------------------
+bool RunEventIndexBuilder::indexFile(const std::string &filename, uint32_t file,
+                                     uint64_t &nEntries, std::vector<RunEventRecord> &records) const
+{
+    std::unique_ptr<TFile> input(TFile::Open(filename.c_str()));
+    TTree* tree = (input && !input->IsZombie() ?
+                   dynamic_cast<TTree*>(input->Get(m_chain->GetName())) : 0);
+    TBranch* branch = (tree ? tree->GetBranch("event") : 0);
+    if(!branch) {
+        cout<<"RunEventIndexBuilder::indexFile: cannot read the 'event' branch from "<<filename<<endl;
+        return false;
+    }
+    Susy::Event* evt = 0;
+    tree->SetBranchStatus("*", 0);
+    tree->SetBranchStatus("event", 1);
+    tree->SetBranchAddress("event", &evt);
+    tree->SetCacheSize(10*1024*1024);
+    tree->AddBranchToCache(branch, kTRUE);
+    tree->StopCacheLearningPhase();
+    nEntries = tree->GetEntries();
+    records.reserve(nEntries);
+    bool success = true;
+    for(uint64_t entry=0; entry<nEntries; ++entry) {
+        if(branch->GetEntry(entry)<=0 || !evt) { success = false; continue; }
+        RunEventRecord rec = {evt->run, evt->eventNumber, file, 0, entry};
+        records.push_back(rec);
+    }
+    tree->ResetBranchAddresses();
+    delete evt;
+    if(!success)
+        cout<<"RunEventIndexBuilder::indexFile: some entries of "<<filename<<" could not be read"<<endl;
+    return success;
+}
+//----------------------------------------------------------
@@ -0,0 +1,293 @@
+#include "SusyNtuple/RunEventSet.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using Susy::RunEventSet;
+using Susy::ConcurrentRunEventSet;
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+namespace {
+/// finalization step of MurmurHash3; the event numbers within a run are often nearly sequential
+inline uint32_t mix(uint32_t h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return h;
+}
+const size_t minTableSize = 16;
+/// write the events in chunks; false after the first failed write
+class BufferedWriter {
+public:
+    explicit BufferedWriter(int fd) : m_fd(fd), m_ok(true) { m_buffer.reserve(chunkSize); }
+    void push_back(uint32_t event) { m_buffer.push_back(event); if(m_buffer.size()==chunkSize) flush(); }
+    bool flush()
+    {
+        const size_t nBytes = m_buffer.size()*sizeof(uint32_t);
+        if(m_ok && nBytes>0 && write(m_fd, &m_buffer[0], nBytes)!=static_cast<ssize_t>(nBytes)) m_ok = false;
+        m_buffer.clear();
+        return m_ok;
+    }
+    typedef uint32_t value_type;
+    typedef const uint32_t& const_reference;
+private:
+    static const size_t chunkSize = 1<<16;
+    int m_fd;
+    bool m_ok;
+    vector<uint32_t> m_buffer;
+};
+}
+//----------------------------------------------------------
+bool RunEventSet::EventTable::insert(uint32_t event)
+{
+    if(event==0) {
+        bool isNew = !hasZero;
+        hasZero = true;
+        return isNew;
+    }
+    if(10*(nUsed+1) > 7*slots.size()) grow();
+    const size_t mask = slots.size()-1;
+    for(size_t i=mix(event)&mask; ; i=(i+1)&mask) {
+        if(slots[i]==event) return false;
+        if(slots[i]==0) {
+            slots[i] = event;
+            nUsed++;
+            return true;
+        }
+    }
+}
+//----------------------------------------------------------
+bool RunEventSet::EventTable::contains(uint32_t event) const
+{
+    if(event==0) return hasZero;
+    if(slots.empty()) return false;
+    const size_t mask = slots.size()-1;
+    for(size_t i=mix(event)&mask; ; i=(i+1)&mask) {
+        if(slots[i]==event) return true;
+        if(slots[i]==0) return false;
+    }
+}
+//----------------------------------------------------------
+void RunEventSet::EventTable::grow()
+{
+    vector<uint32_t> old;
+    old.swap(slots);
+    slots.assign(old.empty() ? minTableSize : 2*old.size(), 0);
+    const size_t mask = slots.size()-1;
+    for(size_t j=0; j<old.size(); ++j) {
+        if(old[j]==0) continue;
+        size_t i = mix(old[j])&mask;
+        while(slots[i]!=0) i = (i+1)&mask;
+        slots[i] = old[j];
+    }
+}
+//----------------------------------------------------------
+bool RunEventSet::RunEntry::contains(uint32_t event) const
+{
+    return table.contains(event) || std::binary_search(spilled.begin, spilled.end, event);
+}
+//----------------------------------------------------------
+RunEventSet::RunEventSet() :
+    m_lastRun(0),
+    m_lastEntry(0),
+    m_size(0),
+    m_memory(0),
+    m_nSpilled(0),
+    m_spillThreshold(0)
+{
+    m_mapping.address = 0;
+    m_mapping.length = 0;
+}
+//----------------------------------------------------------
+RunEventSet::~RunEventSet()
+{
+    clear();
+}
+//----------------------------------------------------------
+bool RunEventSet::insert(uint32_t run, uint32_t event)
+{
+    RunEntry* entry = findRun(run);
+    if(!entry) {
+        entry = &m_runs[run];
+        m_lastRun = run;
+        m_lastEntry = entry;
+    }
+    if(entry->spilled.begin!=entry->spilled.end && entry->contains(event)) return false;
+    const size_t capacity = entry->table.slots.size();
+    const bool isNew = entry->table.insert(event);
+    m_memory += sizeof(uint32_t)*(entry->table.slots.size() - capacity);
+    if(!isNew) return false;
+    m_size++;
+    if(m_spillThreshold>0 && m_memory>m_spillThreshold) spill();
+    return true;
+}
+//----------------------------------------------------------
+bool RunEventSet::contains(uint32_t run, uint32_t event) const
+{
+    const RunEntry* entry = findRun(run);
+    return entry && entry->contains(event);
+}
+//----------------------------------------------------------
+void RunEventSet::clear()
+{
+    m_runs.clear();
+    m_lastEntry = 0;
+    m_size = m_memory = m_nSpilled = 0;
+    if(m_mapping.address) munmap(m_mapping.address, m_mapping.length);
+    m_mapping.address = 0;
+    m_mapping.length = 0;
+}
+//----------------------------------------------------------
+RunEventSet& RunEventSet::setSpill(const std::string &directory, size_t maxMemory)
+{
+    m_spillDirectory = directory;
+    m_spillThreshold = maxMemory;
+    if(m_spillThreshold>0 && m_memory>m_spillThreshold) spill();
+    return *this;
+}
+//----------------------------------------------------------
+RunEventSet::RunEntry* RunEventSet::findRun(uint32_t run) const
+{
+    if(m_lastEntry && m_lastRun==run) return m_lastEntry;
+    std::map<uint32_t, RunEntry>::const_iterator it = m_runs.find(run);
+    if(it==m_runs.end()) return 0;
+    m_lastRun = run;
+    m_lastEntry = const_cast<RunEntry*>(&it->second);
+    return m_lastEntry;
+}
+//----------------------------------------------------------
+bool RunEventSet::spill()
+{
+    string path = (m_spillDirectory.empty() ? string(".") : m_spillDirectory) + "/RunEventSet_XXXXXX";
+    vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+    int fd = mkstemp(&name[0]);
+    if(fd<0) {
+        cout<<"RunEventSet::spill: cannot create a temporary file in '"<<m_spillDirectory<<"';"
+            <<" keeping everything in memory"<<endl;
+        m_spillThreshold = 0;
+        return false;
+    }
+    // one sorted block per run, in the order of m_runs: the spilled events merged with the new ones
+    vector<size_t> nEvents;
+    size_t nTotal = 0;
+    BufferedWriter writer(fd);
+    vector<uint32_t> events;
+    for(std::map<uint32_t, RunEntry>::iterator it=m_runs.begin(); it!=m_runs.end(); ++it) {
+        const EventTable &table = it->second.table;
+        const SpillBlock &spilled = it->second.spilled;
+        events.clear();
+        events.reserve(table.size());
+        if(table.hasZero) events.push_back(0);
+        for(size_t i=0; i<table.slots.size(); ++i)
+            if(table.slots[i]!=0) events.push_back(table.slots[i]);
+        std::sort(events.begin(), events.end());
+        std::merge(spilled.begin, spilled.end, events.begin(), events.end(), std::back_inserter(writer));
+        nEvents.push_back((spilled.end - spilled.begin) + events.size());
+        nTotal += nEvents.back();
+    }
+    const bool success = writer.flush();
+    const size_t length = nTotal*sizeof(uint32_t);
+    void* address = (success && length>0 ? mmap(0, length, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED);
+    close(fd);
+    unlink(&name[0]); // the mapping stays valid; the file disappears with it
+    if(length==0) return true;
+    if(address==MAP_FAILED) {
+        // the previous spill file is still mapped, and the tables are untouched
+        cout<<"RunEventSet::spill: cannot write '"<<&name[0]<<"'; keeping everything in memory"<<endl;
+        m_spillThreshold = 0;
+        return false;
+    }
+    const uint32_t* block = static_cast<const uint32_t*>(address);
+    size_t iRun = 0;
+    for(std::map<uint32_t, RunEntry>::iterator it=m_runs.begin(); it!=m_runs.end(); ++it, ++iRun) {
+        it->second.spilled.begin = block;
+        it->second.spilled.end = block + nEvents[iRun];
+        block += nEvents[iRun];
+        it->second.table = EventTable();
+    }
+    if(m_mapping.address) munmap(m_mapping.address, m_mapping.length);
+    m_mapping.address = address;
+    m_mapping.length = length;
+    m_nSpilled = nTotal;
+    m_memory = 0;
+    return true;
+}
+//----------------------------------------------------------
+ConcurrentRunEventSet::ConcurrentRunEventSet(size_t nStripes)
+{
+    if(nStripes==0) nStripes = 1;
+    m_stripes.reserve(nStripes);
+    for(size_t i=0; i<nStripes; ++i) m_stripes.push_back(std::unique_ptr<Stripe>(new Stripe()));
+}
+//----------------------------------------------------------
+bool ConcurrentRunEventSet::insert(uint32_t run, uint32_t event)
+{
+    Stripe &s = stripe(run, event);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.set.insert(run, event);
+}
+//----------------------------------------------------------
+bool ConcurrentRunEventSet::contains(uint32_t run, uint32_t event) const
+{
+    Stripe &s = stripe(run, event);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.set.contains(run, event);
+}
+//----------------------------------------------------------
+size_t ConcurrentRunEventSet::size() const
+{
+    size_t n = 0;
+    for(size_t i=0; i<m_stripes.size(); ++i) {
+        std::lock_guard<std::mutex> lock(m_stripes[i]->mutex);
+        n += m_stripes[i]->set.size();
+    }
+    return n;
+}
+//----------------------------------------------------------
+size_t ConcurrentRunEventSet::memoryUsage() const
+{
+    size_t n = 0;
+    for(size_t i=0; i<m_stripes.size(); ++i) {
+        std::lock_guard<std::mutex> lock(m_stripes[i]->mutex);
+        n += m_stripes[i]->set.memoryUsage();
+    }
+    return n;
+}
+//----------------------------------------------------------
+void ConcurrentRunEventSet::clear()
+{
+    for(size_t i=0; i<m_stripes.size(); ++i) {
+        std::lock_guard<std::mutex> lock(m_stripes[i]->mutex);
+        m_stripes[i]->set.clear();
+    }
+}
+//----------------------------------------------------------
+ConcurrentRunEventSet& ConcurrentRunEventSet::setSpill(const std::string &directory, size_t maxMemory)
+{
+    for(size_t i=0; i<m_stripes.size(); ++i) {
+        std::lock_guard<std::mutex> lock(m_stripes[i]->mutex);
+        m_stripes[i]->set.setSpill(directory, maxMemory/m_stripes.size());
+    }
+    return *this;
+}
+//----------------------------------------------------------
+ConcurrentRunEventSet::Stripe& ConcurrentRunEventSet::stripe(uint32_t run, uint32_t event) const
+{
+    return *m_stripes[mix(event ^ mix(run)) % m_stripes.size()];
+}
+//----------------------------------------------------------
@@ -0,0 +1,222 @@
+#include "SusyNtuple/StageTimer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+
+using Susy::LatencyHistogram;
+using Susy::PerfSample;
+using Susy::StageTimer;
+
+using std::endl;
+using std::setw;
+using std::string;
+using std::vector;
+
+namespace {
+inline int highestBit(uint64_t v) { return 63 - __builtin_clzll(v); }
+std::atomic<uint64_t> timerCount(0);
+double toMs(uint64_t ns) { return 1.0e-6*ns; }
+double toUs(double ns) { return 1.0e-3*ns; }
+}
+//----------------------------------------------------------
+LatencyHistogram::LatencyHistogram() :
+    m_bins(s_nBins, 0),
+    m_count(0),
+    m_total(0),
+    m_min(0),
+    m_max(0)
+{
+}
+//----------------------------------------------------------
+size_t LatencyHistogram::bin(uint64_t ns)
+{
+    if(ns < (1u<<s_subBits)) return ns;
+    const int e = highestBit(ns);
+    const size_t sub = (ns >> (e - s_subBits)) & ((1u<<s_subBits) - 1);
+    return (static_cast<size_t>(e - s_subBits + 1) << s_subBits) + sub;
+}
+//----------------------------------------------------------
+uint64_t LatencyHistogram::binUpperEdge(size_t bin)
+{
+    if(bin < (1u<<s_subBits)) return bin;
+    const int e = (bin >> s_subBits) + s_subBits - 1;
+    const uint64_t sub = bin & ((1u<<s_subBits) - 1);
+    const uint64_t width = 1ULL << (e - s_subBits);
+    return (1ULL << e) + sub*width + (width - 1);
+}
+//----------------------------------------------------------
+void LatencyHistogram::add(uint64_t ns)
+{
+    m_bins[bin(ns)]++;
+    if(m_count==0 || ns<m_min) m_min = ns;
+    if(ns>m_max) m_max = ns;
+    m_count++;
+    m_total += ns;
+}
+//----------------------------------------------------------
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    if(other.m_count==0) return;
+    for(size_t i=0; i<s_nBins; ++i) m_bins[i] += other.m_bins[i];
+    if(m_count==0 || other.m_min<m_min) m_min = other.m_min;
+    m_max = std::max(m_max, other.m_max);
+    m_count += other.m_count;
+    m_total += other.m_total;
+}
+//----------------------------------------------------------
+void LatencyHistogram::clear()
+{
+    std::fill(m_bins.begin(), m_bins.end(), 0);
+    m_count = m_total = m_min = m_max = 0;
+}
+//----------------------------------------------------------
+uint64_t LatencyHistogram::quantile(double q) const
+{
+    if(m_count==0) return 0;
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q*m_count + 0.5));
+    uint64_t n = 0;
+    for(size_t i=0; i<s_nBins; ++i) {
+        n += m_bins[i];
+        if(n>=rank) return std::min(binUpperEdge(i), m_max);
+    }
+    return m_max;
+}
+//----------------------------------------------------------
+StageTimer::StageTimer() :
+    m_id(++timerCount)
+{
+}
+//----------------------------------------------------------
+StageTimer::~StageTimer()
+{
+}
+//----------------------------------------------------------
+int StageTimer::addStage(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    vector<string>::iterator it = std::find(m_stages.begin(), m_stages.end(), name);
+    if(it!=m_stages.end()) return it - m_stages.begin();
+    m_stages.push_back(name);
+    return m_stages.size()-1;
+}
+//----------------------------------------------------------
+size_t StageTimer::nStages() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stages.size();
+}
+//----------------------------------------------------------
+std::string StageTimer::stageName(int stage) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return (stage>=0 && stage<static_cast<int>(m_stages.size())) ? m_stages[stage] : string("unknown");
+}
+//----------------------------------------------------------
+void StageTimer::record(int stage, uint64_t ns)
+{
+    if(stage<0) return;
+    threadData(stage).histograms[stage].add(ns);
+}
+//----------------------------------------------------------
+void StageTimer::recordCounters(int stage, const PerfSample &delta)
+{
+    if(stage<0) return;
+    ThreadData &data = threadData(stage);
+    data.counters[stage] += delta;
+    data.hasCounters = true;
+}
+//----------------------------------------------------------
+LatencyHistogram StageTimer::summary(int stage) const
+{
+    LatencyHistogram result;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(size_t i=0; i<m_threads.size(); ++i)
+        if(stage>=0 && stage<static_cast<int>(m_threads[i]->histograms.size()))
+            result.merge(m_threads[i]->histograms[stage]);
+    return result;
+}
+//----------------------------------------------------------
+PerfSample StageTimer::counterSummary(int stage) const
+{
+    PerfSample result;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(size_t i=0; i<m_threads.size(); ++i)
+        if(stage>=0 && stage<static_cast<int>(m_threads[i]->counters.size()))
+            result += m_threads[i]->counters[stage];
+    return result;
+}
+//----------------------------------------------------------
+void StageTimer::reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(size_t i=0; i<m_threads.size(); ++i) {
+        ThreadData &data = *m_threads[i];
+        for(size_t j=0; j<data.histograms.size(); ++j) data.histograms[j].clear();
+        data.counters.assign(data.counters.size(), PerfSample());
+        data.hasCounters = false;
+    }
+}
+//----------------------------------------------------------
+void StageTimer::print(std::ostream &out) const
+{
+    const size_t n = nStages();
+    size_t width = 5;
+    for(size_t i=0; i<n; ++i) width = std::max(width, stageName(i).size());
+    bool hasCounters = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for(size_t i=0; i<m_threads.size(); ++i) hasCounters = hasCounters || m_threads[i]->hasCounters;
+    }
+    std::ios_base::fmtflags flags = out.flags();
+    out<<std::left<<setw(width)<<"stage"<<std::right
+       <<setw(10)<<"calls"<<setw(12)<<"total [ms]"<<setw(11)<<"mean [us]"
+       <<setw(10)<<"p50 [us]"<<setw(10)<<"p90 [us]"<<setw(10)<<"p99 [us]"<<setw(11)<<"max [us]";
+    if(hasCounters)
+        out<<setw(7)<<"IPC"<<setw(14)<<"LLC miss/kI"<<setw(12)<<"br miss %";
+    out<<endl;
+    out<<std::fixed;
+    for(size_t i=0; i<n; ++i) {
+        LatencyHistogram h = summary(i);
+        if(h.count()==0) continue;
+        out<<std::left<<setw(width)<<stageName(i)<<std::right
+           <<setw(10)<<h.count()
+           <<setw(12)<<std::setprecision(1)<<toMs(h.total())
+           <<setw(11)<<std::setprecision(2)<<toUs(h.mean())
+           <<setw(10)<<toUs(h.quantile(0.5))
+           <<setw(10)<<toUs(h.quantile(0.9))
+           <<setw(10)<<toUs(h.quantile(0.99))
+           <<setw(11)<<toUs(h.max());
+        if(hasCounters) {
+            PerfSample c = counterSummary(i);
+            out<<setw(7)<<c.ipc()<<setw(14)<<c.cacheMissesPerKiloInstruction()<<setw(12)<<c.branchMissPercent();
+        }
+        out<<endl;
+    }
+    out.flags(flags);
+}
+//----------------------------------------------------------
+StageTimer::ThreadData& StageTimer::threadData(int stage)
+{
+    // per-thread cache of (timer id, data); ids are never reused
+    thread_local vector<std::pair<uint64_t, ThreadData*> > cache;
+    ThreadData* data = 0;
+    for(size_t i=0; i<cache.size() && !data; ++i)
+        if(cache[i].first==m_id) data = cache[i].second;
+    if(!data) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_threads.push_back(std::unique_ptr<ThreadData>(new ThreadData(m_stages.size())));
+        data = m_threads.back().get();
+        cache.push_back(std::make_pair(m_id, data));
+    }
+    if(stage>=static_cast<int>(data->histograms.size())) { // stage added after this thread started
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const size_t n = std::max(m_stages.size(), static_cast<size_t>(stage+1));
+        data->histograms.resize(n);
+        data->counters.resize(n);
+    }
+    return *data;
+}
+//----------------------------------------------------------
@@ -9,11 +9,25 @@ using namespace Susy; // everything in SusyNtuple is in this namespace
 
 // std/stl
 #include <iomanip> // setw
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <sstream> // stringstream, ostringstream
 using namespace std;
 
+namespace {
+// cuts of each cutflow, in the order in which they are registered in initialize_counters
+enum CleaningCut { CutGRL, CutLAr, CutTile, CutTTC, CutSCT, CutGoodVtx, CutBadMuon, CutCosmicMuon, CutJetCleaning,
+                   CutBaselineLeptons };
+enum DileptonCut { CutTwoSignalLeptons, CutOS, CutMll, CutZVeto, CutLeptonPt };
+enum SignalRegionCut { CutMt290, CutMt2120, CutMt2150,
+                       CutTwoBJets, CutExactlyTwoBJets, CutNoLightJets,
+                       CutTwoJets, CutForwardJetVeto, CutBVeto, CutDphill, CutMet100, CutHt500, CutMeff500,
+                       CutN };
+// weight stages
+enum { StageNoBTag, StageBTag };
+}
+
 //////////////////////////////////////////////////////////////////////////////
 Susy2LepCutflow::Susy2LepCutflow() :
     m_dbg(0),
@@ -29,6 +43,52 @@ Susy2LepCutflow::Susy2LepCutflow() :
 void Susy2LepCutflow::initialize_counters()
 {
     n_readin = 0;
+
+    m_cleaning = Cutflow("Event Counters");
+    m_cleaning.addCut("pass GRL");
+    m_cleaning.addCut("pass LAr error");
+    m_cleaning.addCut("pass Tile error");
+    m_cleaning.addCut("pass TTC veto");
+    m_cleaning.addCut("pass SCT error");
+    m_cleaning.addCut("pass good vertex");
+    m_cleaning.addCut("pass bad muon");
+    m_cleaning.addCut("pass cosmic muon veto");
+    m_cleaning.addCut("pass jet cleaning");
+    m_cleaning.addCut(">=2 baseline leptons", 1); // weighted with the lepton SF
+
+    m_dilepton = Cutflow("Selection / Flavor");
+    m_dilepton.addCut("==2 signal leptons");
+    m_dilepton.addCut("opposite sign");
+    m_dilepton.addCut("mll > 20 GeV");
+    m_dilepton.addCut("Z-veto");
+    m_dilepton.addCut("lep pT > (25, 20) GeV");
+
+    // the signal regions require the dilepton selection, and the cuts of one of the
+    // three selections below up to a given step: each step is a region of its own
+    m_regions = RegionSet("Signal regions");
+    const char* cuts[CutN] = {"mt2 > 90 GeV", "mt2 > 120 GeV", "mt2 > 150 GeV",
+                              ">=2 b-tagged jets", "==2 b-tagged jets", "==0 non-b-tagged jets",
+                              ">=2 jets", "forward jet veto", "b-jet veto", "dphi_ll < pi/2",
+                              "MET > 100 GeV", "HT > 500 GeV", "MEFF > 500 GeV"};
+    for(int cut = 0; cut < CutN; cut++) m_regions.addCut(cuts[cut]);
+    for(int cut = CutMt290; cut <= CutMt2150; cut++)
+        m_regions.addRegion(string("SR mT2: ") + cuts[cut], RegionSet::bit(cut), StageNoBTag);
+    RegionSet::Mask required = 0;
+    for(int cut = CutTwoBJets; cut <= CutNoLightJets; cut++) {
+        required |= RegionSet::bit(cut);
+        m_regions.addRegion(string("SR b-jets: ") + cuts[cut], required, StageBTag);
+    }
+    required = 0;
+    for(int cut = CutTwoJets; cut <= CutMeff500; cut++) {
+        required |= RegionSet::bit(cut);
+        m_regions.addRegion(string("SR Jets + MET: ") + cuts[cut], required, cut < CutBVeto ? StageNoBTag : StageBTag);
+    }
+
+    // the flavor columns follow DiLepEvtType (ET_me is counted as ET_em)
+    for(const char* flavor : {"EE", "MM", "EM"}) {
+        m_dilepton.addColumn(flavor);
+        m_regions.addColumn(flavor);
+    }
 }
 //////////////////////////////////////////////////////////////////////////////
 void Susy2LepCutflow::Begin(TTree* /*tree*/)
@@ -74,6 +134,7 @@ Bool_t Susy2LepCutflow::Process(Long64_t entry)
     // (c.f. SusyNtuple/MCWeighter.h)
     if(nt.evt()->isMC) {
         float lumi = 100000; // normalize the MC to 100 fb-1 (we store xsec in pb so lumi is in pb-1)
+        StageTimer::Scope timer = timeStage(StageWeight);
         m_mc_weight = SusyNtAna::mcWeighter().getMCWeight(nt.evt(), lumi, NtSys::NOM);
     }
     else {
@@ -81,53 +142,40 @@ Bool_t Susy2LepCutflow::Process(Long64_t entry)
     }
 
     // check that the event passes the standard ATLAS event cleaning cuts
-    if(!passEventCleaning(m_preMuons, m_baseMuons, m_baseJets)) return false;
+    Cutflow::Mask cleaning = eventCleaningCuts(m_preMuons, m_baseMuons, m_baseJets, m_baseLeptons);
+    // compute the lepton efficiency scale factors once the cleaning cuts pass
+    // (only the baseline lepton cut is weighted with them)
+    m_lep_sf = 1.0;
+    if(Cutflow::nPassed(cleaning) >= CutBaselineLeptons)
+        m_lep_sf = compute_lepton_scale_factors(m_baseLeptons);
+    m_cleaning.fill(cleaning, {w(), w() * sf()});
+    if(Cutflow::nPassed(cleaning) < m_cleaning.nCuts()) return false;
 
     // check that the event passes dilepton selection
-    if(!passDileptonEvent(m_baseLeptons, m_signalLeptons)) return false;
-
-    // pass mt2 selections
-    check_mt2_selections(m_signalLeptons, m_met);
-
-    // pass n-jet selections
-    check_njet_selections(m_signalJets);
-
-    // pass some jet and met selections
-    check_jetmet_selections(m_signalJets, m_met, m_signalLeptons);
+    Cutflow::Mask dilepton = dileptonCuts(m_signalLeptons);
+    if(m_lep_type == ET_Unknown) return false;
+    m_dilepton.fill(dilepton, w() * sf(), m_lep_type);
+    if(Cutflow::nPassed(dilepton) < m_dilepton.nCuts()) return false;
 
+    // evaluate the cuts of all the signal regions once, and count the regions passed
+    RegionSet::Mask regions = signalRegionCuts(m_signalLeptons, m_signalJets, m_met);
+    m_regions.fill(regions, {w() * sf(), w() * sf() * btagsf()}, m_lep_type);
 
     return kTRUE;
 }
 //////////////////////////////////////////////////////////////////////////////
-bool Susy2LepCutflow::passEventCleaning(const MuonVector& preMuons, const MuonVector& baseMuons,
-            const JetVector& baseJets)
+Cutflow::Mask Susy2LepCutflow::eventCleaningCuts(const MuonVector& preMuons, const MuonVector& baseMuons,
+            const JetVector& baseJets, const LeptonVector& baseLeptons)
 {
     int flags = nt.evt()->cutFlags[NtSys::NOM];
+    Cutflow::Mask pass = 0;
 
-    if(!nttools().passGRL(flags))           return false;
-    event_cleaning_counters.grl++;
-    event_cleaning_counters.grl_w += w();
-
-    if(!nttools().passLarErr(flags))        return false;
-    event_cleaning_counters.lar++;
-    event_cleaning_counters.lar_w += w();
-
-    if(!nttools().passTileErr(flags))       return false;
-    event_cleaning_counters.tile++;
-    event_cleaning_counters.tile_w += w();
-
-    if(!nttools().passTTC(flags))           return false;
-    event_cleaning_counters.ttc++;
-    event_cleaning_counters.ttc_w += w();
-
-    if(!nttools().passSCTErr(flags))        return false;
-    event_cleaning_counters.sct++;
-    event_cleaning_counters.sct_w += w();
-
-    if(!nttools().passGoodVtx(flags))       return false;
-    event_cleaning_counters.vtx++;
-    event_cleaning_counters.vtx_w += w();
-
+    if(nttools().passGRL(flags))            pass |= Cutflow::bit(CutGRL);
+    if(nttools().passLarErr(flags))         pass |= Cutflow::bit(CutLAr);
+    if(nttools().passTileErr(flags))        pass |= Cutflow::bit(CutTile);
+    if(nttools().passTTC(flags))            pass |= Cutflow::bit(CutTTC);
+    if(nttools().passSCTErr(flags))         pass |= Cutflow::bit(CutSCT);
+    if(nttools().passGoodVtx(flags))        pass |= Cutflow::bit(CutGoodVtx);
 
     ///////////////////////////////////////////////////////
     // for bad muon, cosmic moun, and jet cleaning the
@@ -138,42 +186,29 @@ bool Susy2LepCutflow::passEventCleaning(const MuonVector& preMuons, const MuonVe
     // rather use the objects that have passed the various
     // analysis selections to do the checks
     ///////////////////////////////////////////////////////
-    if(!nttools().passBadMuon(preMuons))    return false;
-    event_cleaning_counters.bad_mu++;
-    event_cleaning_counters.bad_mu_w += w();
-
-    if(!nttools().passCosmicMuon(baseMuons)) return false;
-    event_cleaning_counters.cos_mu++;
-    event_cleaning_counters.cos_mu_w += w();
+    if(nttools().passBadMuon(preMuons))     pass |= Cutflow::bit(CutBadMuon);
+    if(nttools().passCosmicMuon(baseMuons)) pass |= Cutflow::bit(CutCosmicMuon);
+    if(nttools().passJetCleaning(baseJets)) pass |= Cutflow::bit(CutJetCleaning);
 
-    if(!nttools().passJetCleaning(baseJets)) return false;
-    event_cleaning_counters.bad_jet++;
-    event_cleaning_counters.bad_jet_w += w();
-
-    return true;
-}
-//////////////////////////////////////////////////////////////////////////////
-bool Susy2LepCutflow::passDileptonEvent(const LeptonVector& baseLeptons, const LeptonVector& signalLeptons)
-{
     ///////////////////////////////////////////////////////
     // at least two baseline leptons
     ///////////////////////////////////////////////////////
-    size_t n_base_leptons = (baseLeptons.size());
-
-    // compute the lepton efficiency scale factors
-    m_lep_sf = compute_lepton_scale_factors(baseLeptons);
+    if(baseLeptons.size()>=2)               pass |= Cutflow::bit(CutBaselineLeptons);
 
-    if(!n_base_leptons>=2) return false;
-    dilepton_counters.n_baseline++;
-    dilepton_counters.n_baseline_w += w() * sf();
+    return pass;
+}
+//////////////////////////////////////////////////////////////////////////////
+Cutflow::Mask Susy2LepCutflow::dileptonCuts(const LeptonVector& signalLeptons)
+{
+    Cutflow::Mask pass = 0;
+    m_lep_type = ET_Unknown;
 
     ///////////////////////////////////////////////////////
     // exactly two signal leptons
     ///////////////////////////////////////////////////////
-
-
     size_t n_signal_leptons = (signalLeptons.size());
-    if(n_signal_leptons!=2) return false;
+    if(n_signal_leptons!=2) return pass;
+    pass |= Cutflow::bit(CutTwoSignalLeptons);
 
     // re-compute the lepton efficiency scale factor using the signal leptons
     // (really, since we got here, this value should not have changed)
@@ -181,8 +216,6 @@ bool Susy2LepCutflow::passDileptonEvent(const LeptonVector& baseLeptons, const L
 
     m_lep_type = getDiLepEvtType(signalLeptons); // c.f. SusyNtuple/SusyDefs.h
     if(m_lep_type == ET_me) m_lep_type = ET_em; // group together all different-flavor
-    dilepton_counters.n_signal[m_lep_type]++;
-    dilepton_counters.n_signal_w[m_lep_type] += w() * sf();
 
     Susy::Lepton* l0 = signalLeptons.at(0);
     Susy::Lepton* l1 = signalLeptons.at(1);
@@ -190,28 +223,20 @@ bool Susy2LepCutflow::passDileptonEvent(const LeptonVector& baseLeptons, const L
     ///////////////////////////////////////////////////////
     // only look at opposite sign dilepton events
     ///////////////////////////////////////////////////////
-    float is_os = ((l0->q * l1->q) < 0);
-    if(!is_os) return false;
-    dilepton_counters.n_os[m_lep_type]++;
-    dilepton_counters.n_os_w[m_lep_type] += w() * sf();
+    bool is_os = ((l0->q * l1->q) < 0);
+    if(is_os) pass |= Cutflow::bit(CutOS);
 
     ///////////////////////////////////////////////////////
     // dilepton invariant mass > 20 GeV
     ///////////////////////////////////////////////////////
     float mll = (*l0 + *l1).M(); // Susy::Lepton inherits from TLorentzVector
-    if(! (mll>20. /*GeV*/)) return false;
-    dilepton_counters.n_mll[m_lep_type]++;
-    dilepton_counters.n_mll_w[m_lep_type] += w() * sf();
+    if(mll>20. /*GeV*/) pass |= Cutflow::bit(CutMll);
 
     ///////////////////////////////////////////////////////
     // veto Z decays
     ///////////////////////////////////////////////////////
-    if(m_lep_type == ET_ee || m_lep_type == ET_mm) {
-        bool pass_z = (fabs(mll-91.2)>10.);
-        if(!pass_z) return false;
-    }
-    dilepton_counters.n_vetoZ[m_lep_type]++;
-    dilepton_counters.n_vetoZ_w[m_lep_type] += w() * sf();
+    bool is_sf = (m_lep_type == ET_ee || m_lep_type == ET_mm);
+    if(!is_sf || fabs(mll-91.2)>10.) pass |= Cutflow::bit(CutZVeto);
 
     ///////////////////////////////////////////////////////
     // lepton pT > (25, 20) for (lead, sublead)
@@ -221,12 +246,9 @@ bool Susy2LepCutflow::passDileptonEvent(const LeptonVector& baseLeptons, const L
 
     bool lead_pt_ok = (lead_lepton_pt > 25.);
     bool sublead_pt_ok = (sublead_lepton_pt > 20.);
+    if(lead_pt_ok && sublead_pt_ok) pass |= Cutflow::bit(CutLeptonPt);
 
-    if(!(lead_pt_ok && sublead_pt_ok)) return false;
-    dilepton_counters.n_pt[m_lep_type]++;
-    dilepton_counters.n_pt_w[m_lep_type] += w() * sf();
-
-    return true;
+    return pass;
 }
 //////////////////////////////////////////////////////////////////////////////
 float Susy2LepCutflow::compute_lepton_scale_factors(const LeptonVector& leptons)
@@ -257,136 +279,76 @@ float Susy2LepCutflow::compute_btagging_sf(const JetVector& jets)
     return sf;
 }
 //////////////////////////////////////////////////////////////////////////////
-void Susy2LepCutflow::check_mt2_selections(const LeptonVector& leptons, const Met* met)
+RegionSet::Mask Susy2LepCutflow::signalRegionCuts(const LeptonVector& leptons, const JetVector& jets, const Met* met)
 {
+    RegionSet::Mask pass = 0;
 
-    // mt2 > 90 GeV
+    ///////////////////////////////////////////////////////
+    // mt2 > 90, 120, 150 GeV
+    ///////////////////////////////////////////////////////
     float mt2 = kin::getMT2(leptons, met);
-    if(mt2>90) {
-        dilepton_counters.n_mt290[m_lep_type]++;
-        dilepton_counters.n_mt290_w[m_lep_type] += w() * sf();
-    }
-
-    // mt2 > 120 GeV
-    if(mt2>120) {
-        dilepton_counters.n_mt2120[m_lep_type]++;
-        dilepton_counters.n_mt2120_w[m_lep_type] += w() * sf();
-    }
+    if(mt2>90)  pass |= RegionSet::bit(CutMt290);
+    if(mt2>120) pass |= RegionSet::bit(CutMt2120);
+    if(mt2>150) pass |= RegionSet::bit(CutMt2150);
 
-    // mt2 > 150 GeV
-    if(mt2>150) {
-        dilepton_counters.n_mt2150[m_lep_type]++;
-        dilepton_counters.n_mt2150_w[m_lep_type] += w() * sf();
-    }
-
-}
-//////////////////////////////////////////////////////////////////////////////
-void Susy2LepCutflow::check_njet_selections(const JetVector& jets)
-{
-    JetVector bjets;
-    JetVector non_bjets;
+    ///////////////////////////////////////////////////////
+    // b-tagged and forward jets
+    ///////////////////////////////////////////////////////
+    size_t n_jets = jets.size();
+    size_t n_bjets = 0;
+    size_t n_fjets = 0;
 
     // we can use the SusyNtTools object to grab our AnalysisType's
     // JetSelector object to perform the b-tagging selection
     // (c.f. SusyNtuple/JetSelector)
     for(auto & j : jets) {
-        if(nttools().jetSelector().isB(j)) bjets.push_back(j);
-        else { non_bjets.push_back(j); }
+        if(nttools().jetSelector().isB(j)) n_bjets++;
+        if(j->Pt() > 30. && fabs(j->Eta()) > 2.4 && fabs(j->Eta() < 4.5)) n_fjets++;
     }
+    size_t n_nonbjets = n_jets - n_bjets;
 
     // we are now selecting on b-tagged objects, so compute the b-tagging scale-factor
     // using the internal SusyNtTools object
-    m_btag_sf = nttools().bTagSF(jets);
     m_btag_sf = compute_btagging_sf(jets);
 
-    size_t n_bjets = bjets.size();
-    size_t n_nonbjets = non_bjets.size();
-
-    if(n_bjets>=2) {
-        dilepton_counters.n_ge2bjets[m_lep_type]++;
-        dilepton_counters.n_ge2bjets_w[m_lep_type] += w() * sf() * btagsf();
-        if(n_bjets==2) {
-            dilepton_counters.n_e2bjets[m_lep_type]++;
-            dilepton_counters.n_e2bjets_w[m_lep_type] += w() * sf() * btagsf();
-            if(n_nonbjets==0) {
-                dilepton_counters.n_e2bjets0sjets[m_lep_type]++;
-                dilepton_counters.n_e2bjets0sjets_w[m_lep_type] += w() * sf() * btagsf();
-            }
-        }
-    }
-
-}
-//////////////////////////////////////////////////////////////////////////////
-void Susy2LepCutflow::check_jetmet_selections(const JetVector& jets, const Met* met,
-            const LeptonVector& leptons)
-{
-    size_t n_jets = jets.size();
-    JetVector bjets;
-    JetVector fjets;
-
-    for(auto & j : jets) {
-        if(nttools().jetSelector().isB(j)) bjets.push_back(j);
-        if(j->Pt() > 30. && fabs(j->Eta()) > 2.4 && fabs(j->Eta() < 4.5)) fjets.push_back(j);
-    }
+    if(n_bjets>=2)     pass |= RegionSet::bit(CutTwoBJets);
+    if(n_bjets==2)     pass |= RegionSet::bit(CutExactlyTwoBJets);
+    if(n_nonbjets==0)  pass |= RegionSet::bit(CutNoLightJets);
 
+    ///////////////////////////////////////////////////////
+    // jets + met
+    ///////////////////////////////////////////////////////
     // require at least 2 jets
-    if(n_jets>=2) {
-        dilepton_counters.n_ge2jets[m_lep_type]++;
-        dilepton_counters.n_ge2jets_w[m_lep_type] += w() * sf();
-    }
-    else { return; }
+    if(n_jets>=2) pass |= RegionSet::bit(CutTwoJets);
 
     // veto forward jets
-    if(fjets.size()==0) {
-        dilepton_counters.n_forwardJetVeto[m_lep_type]++;
-        dilepton_counters.n_forwardJetVeto_w[m_lep_type] += w() * sf();
-    }
-    else { return; }
+    if(n_fjets==0) pass |= RegionSet::bit(CutForwardJetVeto);
 
     // veto b-tagged jets
-    if(bjets.size()==0) {
-        dilepton_counters.n_bveto[m_lep_type]++;
-        dilepton_counters.n_bveto_w[m_lep_type] += w() * sf() * btagsf();
-    }
-    else { return; }
+    if(n_bjets==0) pass |= RegionSet::bit(CutBVeto);
 
     // require leptons to be close in azimuth 
     Susy::Lepton* l0 = leptons.at(0);
     Susy::Lepton* l1 = leptons.at(1);
     float delta_phi = l0->DeltaPhi(*l1);
-    if(fabs(delta_phi) < (M_PI/2.)) {
-        dilepton_counters.n_dphill[m_lep_type]++;
-        dilepton_counters.n_dphill_w[m_lep_type] += w() * sf() * btagsf();
-    }
-    else { return; }
+    if(fabs(delta_phi) < (M_PI/2.)) pass |= RegionSet::bit(CutDphill);
 
     // require met > 100 GeV
-    float metvalue = m_met->Et;
-    if(metvalue>100.) {
-        dilepton_counters.n_met100[m_lep_type]++;
-        dilepton_counters.n_met100_w[m_lep_type] += w() * sf() * btagsf();
-    }
-    else { return; }
+    float metvalue = met->Et;
+    if(metvalue>100.) pass |= RegionSet::bit(CutMet100);
 
     // require ht > 500
     float ht = 0.0;
-    // we can loop over jets, we are downstream from the b- and f-jet vetos
     for(auto & j : jets) ht += j->Pt();
-    if(ht>500.) {
-        dilepton_counters.n_ht500[m_lep_type]++;
-        dilepton_counters.n_ht500_w[m_lep_type] += w() * sf() * btagsf();
-    }
-    else { return; }
+    if(ht>500.) pass |= RegionSet::bit(CutHt500);
 
     // meff (ht + met + leptons)
     ht += l0->Pt();
     ht += l1->Pt();
-    ht += m_met->Et;
-    if(ht>500.) {
-        dilepton_counters.n_meff500[m_lep_type]++;
-        dilepton_counters.n_meff500_w[m_lep_type] += w() * sf() * btagsf();
-    }
-    else { return; }
+    ht += met->Et;
+    if(ht>500.) pass |= RegionSet::bit(CutMeff500);
+
+    return pass;
 }
 //////////////////////////////////////////////////////////////////////////////
 string Susy2LepCutflow::weight_str(float weighted, int counter)
@@ -400,73 +362,20 @@ string Susy2LepCutflow::event_counters()
 {
     ostringstream oss;
     oss << "------------------------------------------" << endl;
-    oss << " Event Counters " << endl;
-    oss << endl;
-    oss << "  pass GRL              : " << weight_str(event_cleaning_counters.grl_w, event_cleaning_counters.grl) << endl;
-    oss << "  pass LAr error        : " << weight_str(event_cleaning_counters.lar_w, event_cleaning_counters.lar) << endl;
-    oss << "  pass Tile error       : " << weight_str(event_cleaning_counters.tile_w, event_cleaning_counters.tile) << endl;
-    oss << "  pass TTC veto         : " << weight_str(event_cleaning_counters.ttc_w, event_cleaning_counters.ttc) << endl;
-    oss << "  pass SCT error        : " << weight_str(event_cleaning_counters.sct_w, event_cleaning_counters.sct) << endl;
-    oss << "  pass good vertex      : " << weight_str(event_cleaning_counters.vtx_w, event_cleaning_counters.vtx) << endl;
-    oss << "  pass bad muon         : " << weight_str(event_cleaning_counters.bad_mu_w, event_cleaning_counters.bad_mu) << endl;
-    oss << "  pass cosmic muon veto : " << weight_str(event_cleaning_counters.cos_mu_w, event_cleaning_counters.cos_mu) << endl;
-    oss << "  pass jet cleaning     : " << weight_str(event_cleaning_counters.bad_jet_w, event_cleaning_counters.bad_jet) << endl;
+    m_cleaning.print(oss);
     oss << "- - - - - - - - - - - - - - - - - - - - - " << endl;
     return oss.str();
-
-
-}
-//////////////////////////////////////////////////////////////////////////////
-string Susy2LepCutflow::dil_cut(float* counter_w, uint* counter, int weight)
-{
-    stringstream sx;
-    sx << std::right << setw(weight) << (weight_str(counter_w[0], counter[0]))
-       << std::right << setw(weight) << (weight_str(counter_w[1], counter[1]))
-       << std::right << setw(weight) << (weight_str(counter_w[2], counter[2]));
-    return sx.str();
 }
 //////////////////////////////////////////////////////////////////////////////
 string Susy2LepCutflow::dilepton_counts()
 {
-    int weight = 20;
     ostringstream oss;
     oss << " Dilepton Counters " << endl;
     oss << endl;
-    oss << ">=2 baseline leptons  " << setw(weight) << weight_str(dilepton_counters.n_baseline_w, dilepton_counters.n_baseline) << endl; 
-    oss << endl;
-    oss << "Selection / Flavor    " << setw(weight) << "EE" << setw(weight) << "MM" << setw(weight) << "EM" << endl;
-    oss << "==2 signal leptons    " << setw(weight) << dil_cut(dilepton_counters.n_signal_w, dilepton_counters.n_signal) << endl;
-    oss << "opposite sign         " << setw(weight) << dil_cut(dilepton_counters.n_os_w, dilepton_counters.n_os) << endl;
-    oss << "mll > 20 GeV          " << setw(weight) << dil_cut(dilepton_counters.n_mll_w, dilepton_counters.n_mll) << endl;
-    oss << "Z-veto                " << setw(weight) << dil_cut(dilepton_counters.n_vetoZ_w, dilepton_counters.n_vetoZ) << endl;
-    oss << "lep pT > (25, 20) GeV " << setw(weight) << dil_cut(dilepton_counters.n_pt_w, dilepton_counters.n_pt) << endl;
-    oss << "- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -" << endl;
-    oss << " * SR mT2 90 * " << endl;
-    oss << "mt2 > 90 GeV          " << setw(weight) << dil_cut(dilepton_counters.n_mt290_w, dilepton_counters.n_mt290) << endl;
-    oss << "- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -" << endl;
-    oss << " * SR mT2 120 * " << endl;
-    oss << "mt2 > 120 GeV         " << setw(weight) << dil_cut(dilepton_counters.n_mt2120_w, dilepton_counters.n_mt2120) << endl;
+    m_dilepton.print(oss);
     oss << "- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -" << endl;
-    oss << " * SR mT2 150 * " << endl;
-    oss << "mt2 > 150 GeV         " << setw(weight) << dil_cut(dilepton_counters.n_mt2150_w, dilepton_counters.n_mt2150) << endl;
-    oss << "- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -" << endl;
-    oss << " * SR b-jets * " << endl; 
-    oss << ">=2 b-tagged jets     " << setw(weight) << dil_cut(dilepton_counters.n_ge2bjets_w, dilepton_counters.n_ge2bjets) << endl;
-    oss << "==2 b-tagged jets     " << setw(weight) << dil_cut(dilepton_counters.n_e2bjets_w, dilepton_counters.n_e2bjets) << endl;
-    oss << "==0 non-b-tagged jets " << setw(weight) << dil_cut(dilepton_counters.n_e2bjets0sjets_w, dilepton_counters.n_e2bjets0sjets) << endl;
-    oss << "- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -" << endl;
-    oss << " * SR Jets + MET * " << endl;
-    oss << ">=2 jets              " << setw(weight) << dil_cut(dilepton_counters.n_ge2jets_w, dilepton_counters.n_ge2jets) << endl;
-    oss << "forward jet veto      " << setw(weight) << dil_cut(dilepton_counters.n_forwardJetVeto_w, dilepton_counters.n_forwardJetVeto) << endl;
-    oss << "b-jet veto            " << setw(weight) << dil_cut(dilepton_counters.n_bveto_w, dilepton_counters.n_bveto) << endl;
-    oss << "dphi_ll < pi/2        " << setw(weight) << dil_cut(dilepton_counters.n_dphill_w, dilepton_counters.n_dphill) << endl;
-    oss << "MET > 100 GeV         " << setw(weight) << dil_cut(dilepton_counters.n_met100_w, dilepton_counters.n_met100) << endl;
-    oss << "HT > 500 GeV          " << setw(weight) << dil_cut(dilepton_counters.n_ht500_w, dilepton_counters.n_ht500) << endl;
-    oss << "MEFF > 500 GeV        " << setw(weight) << dil_cut(dilepton_counters.n_meff500_w, dilepton_counters.n_meff500) << endl;
+    m_regions.print(oss);
     oss << "-------------------------------------------------------------" << endl;
-    
-    
-
     return oss.str();
 }
 //////////////////////////////////////////////////////////////////////////////
@@ -480,6 +389,13 @@ void Susy2LepCutflow::Terminate()
 {
     // print the cutflows
     print_counters();
+    if(!m_cutflow_output.empty()) {
+        ofstream out(m_cutflow_output.c_str());
+        m_cleaning.write(out);
+        m_dilepton.write(out);
+        m_regions.write(out);
+        if(!out) cout << "Susy2LepCutflow::Terminate    cannot write the cutflows to " << m_cutflow_output << endl;
+    }
 
     // close SusyNtAna and print timers
     SusyNtAna::Terminate();
@@ -9,6 +9,12 @@
 using namespace std;
 using namespace Susy;
 
+namespace {
+// cuts of the cutflow, in the order in which they are registered in the constructor
+enum Cut { CutGRL, CutLAr, CutTile, CutTTC, CutSCT, CutGoodVtx, CutBadMuon, CutCosmic, CutBadJet,
+           CutNLep, CutNTau, CutTrig, CutSFOS, CutZ, CutMet, CutBJet, CutMt };
+}
+
 /*--------------------------------------------------------------------------------*/
 // Susy3LepCutflow Constructor
 /*--------------------------------------------------------------------------------*/
@@ -32,23 +38,24 @@ Susy3LepCutflow::Susy3LepCutflow() :
         m_writeOut(false)
 {
   n_readin        = 0;
-  n_pass_grl      = 0;
-  n_pass_lar      = 0;
-  n_pass_tile     = 0;
-  n_pass_ttc      = 0;
-  n_pass_sct      = 0;
-  n_pass_badMuon  = 0;
-  n_pass_badJet   = 0;
-  n_pass_goodVtx  = 0;
-  n_pass_cosmic   = 0;
-  n_pass_nLep     = 0;
-  n_pass_nTau     = 0;
-  n_pass_trig     = 0;
-  n_pass_sfos     = 0;
-  n_pass_z        = 0;
-  n_pass_met      = 0;
-  n_pass_bJet     = 0;
-  n_pass_mt       = 0;
+  m_cutflow = Cutflow("Susy3LepCutflow");
+  m_cutflow.addCut("pass GRL");
+  m_cutflow.addCut("pass LArErr");
+  m_cutflow.addCut("pass TileErr");
+  m_cutflow.addCut("pass TTCVeto");
+  m_cutflow.addCut("pass SCTerr");
+  m_cutflow.addCut("pass PrimVtx");
+  m_cutflow.addCut("pass BadMuon");
+  m_cutflow.addCut("pass cosmic");
+  m_cutflow.addCut("pass BadJet");
+  m_cutflow.addCut("pass nLep");
+  m_cutflow.addCut("pass nTau");
+  m_cutflow.addCut("pass trig");
+  m_cutflow.addCut("pass sfos");
+  m_cutflow.addCut("pass z");
+  m_cutflow.addCut("pass met");
+  m_cutflow.addCut("pass b-jet");
+  m_cutflow.addCut("pass mt");
 
   n_evt_tot       = 0;
 
@@ -117,23 +124,32 @@ Bool_t Susy3LepCutflow::Process(Long64_t entry)
   SusyNtAna::selectObjects(ntSys);
 
   //
-  // Event selection
-  //
-
-  // Check that the event passes event cleaning cuts
-  int flags = nt.evt()->cutFlags[NtSys::NOM];
-  if(!passEventCleaning(flags, m_preMuons, m_baseMuons, m_baseJets)) return false;
-  // Check that the event passes object selection
-  if(!selectEvent(m_signalLeptons, m_signalTaus, m_signalJets, m_met)) return false;
-
-  //
-  // Event weighting
+  // Event weighting, also used for the cutflow
   //
   // Weight event to luminosity with cross section and pileup
   // New approach, using MCWeighter
   const Event* evt = nt.evt();
   NtSys::SusyNtSys wSys = NtSys::NOM;
-  float w = SusyNtAna::mcWeighter().getMCWeight(evt, 1000, wSys);
+  float w = 1;
+  {
+    StageTimer::Scope timer = timeStage(StageWeight);
+    w = SusyNtAna::mcWeighter().getMCWeight(evt, 1000, wSys);
+  }
+
+  //
+  // Event selection
+  //
+
+  // Check that the event passes the event cleaning cuts and the event selection
+  int flags = nt.evt()->cutFlags[NtSys::NOM];
+  Cutflow::Mask pass = eventCuts(flags, m_preMuons, m_baseMuons, m_baseJets,
+                                 m_signalLeptons, m_signalTaus, m_signalJets, m_met);
+  m_cutflow.fill(pass, w);
+  if(Cutflow::nPassed(pass) < m_cutflow.nCuts()) return false;
+
+  if(m_writeOut){
+    out << nt.evt()->run << " " << nt.evt()->eventNumber << endl;
+  }
 
 
   // Lepton efficiency correction
@@ -200,23 +216,20 @@ void Susy3LepCutflow::bookHistos()
 /*--------------------------------------------------------------------------------*/
 // Full event selection
 /*--------------------------------------------------------------------------------*/
-bool Susy3LepCutflow::passEventCleaning(int flags, const MuonVector& preMuons,
-                        const MuonVector& baseMuons, const JetVector& baseJets)
+Cutflow::Mask Susy3LepCutflow::eventCuts(int flags, const MuonVector& preMuons,
+                        const MuonVector& baseMuons, const JetVector& baseJets,
+                        const LeptonVector& leptons, const TauVector& taus,
+                        const JetVector& jets, const Met* met)
 {
+    Cutflow::Mask pass = 0;
     // grl
-    if( !nttools().passGRL(flags) )                  return false;
-        n_pass_grl++;
+    if( nttools().passGRL(flags) )                  pass |= Cutflow::bit(CutGRL);
     // noisy lar
-    if( !nttools().passLarErr(flags) )               return false;
-        n_pass_lar++;
-    if( !nttools().passTileErr(flags) )              return false;
-        n_pass_tile++;
-    if( !nttools().passTTC(flags) )                  return false;
-        n_pass_ttc++;
-    if( !nttools().passSCTErr(flags) )               return false;
-        n_pass_sct++;
-    if( !nttools().passGoodVtx(flags) )              return false;
-        n_pass_goodVtx++;
+    if( nttools().passLarErr(flags) )               pass |= Cutflow::bit(CutLAr);
+    if( nttools().passTileErr(flags) )              pass |= Cutflow::bit(CutTile);
+    if( nttools().passTTC(flags) )                  pass |= Cutflow::bit(CutTTC);
+    if( nttools().passSCTErr(flags) )               pass |= Cutflow::bit(CutSCT);
+    if( nttools().passGoodVtx(flags) )              pass |= Cutflow::bit(CutGoodVtx);
 
     //////////////////////////////////////////////////////
     // These cuts depend on the analysis' definition of
@@ -226,44 +239,23 @@ bool Susy3LepCutflow::passEventCleaning(int flags, const MuonVector& preMuons,
     // stored as EventFlags when writing SusyNt
 
     // veto events with "bad" muons
-    if( !nttools().passBadMuon(preMuons) )           return false;
-        n_pass_badMuon++;
+    if( nttools().passBadMuon(preMuons) )           pass |= Cutflow::bit(CutBadMuon);
     // veto events with cosmic muons
-    if( !nttools().passCosmicMuon(baseMuons) )       return false;
-        n_pass_cosmic++;
+    if( nttools().passCosmicMuon(baseMuons) )       pass |= Cutflow::bit(CutCosmic);
     // veto events with "bad" jets
-    if( !nttools().passJetCleaning(baseJets) )       return false;
-        n_pass_badJet++;
-
-    return true;
-}
-/*--------------------------------------------------------------------------------*/
-bool Susy3LepCutflow::selectEvent(const LeptonVector& leptons, const TauVector& taus, 
-                                  const JetVector& jets, const Met* met)
-{
-
-  if(!passNLepCut(leptons)) return false;
-  n_pass_nLep++;
-  if(!passNTauCut(taus)) return false;
-  n_pass_nTau++;
-  if(!passTrigger(leptons)) return false;
-  n_pass_trig++;
-  if(!passSFOSCut(leptons)) return false;
-  n_pass_sfos++;
-  if(!passZCut(leptons)) return false;
-  n_pass_z++;
-  if(!passMetCut(met)) return false;
-  n_pass_met++;
-  if(!passBJetCut()) return false;
-  n_pass_bJet++;
-  if(!passMtCut(leptons, met)) return false;
-  n_pass_mt++;
-
-  if(m_writeOut){
-    out << nt.evt()->run << " " << nt.evt()->eventNumber << endl;
-  }
-
-  return true;
+    if( nttools().passJetCleaning(baseJets) )       pass |= Cutflow::bit(CutBadJet);
+
+    // event selection
+    if( passNLepCut(leptons) )                      pass |= Cutflow::bit(CutNLep);
+    if( passNTauCut(taus) )                         pass |= Cutflow::bit(CutNTau);
+    if( passTrigger(leptons) )                      pass |= Cutflow::bit(CutTrig);
+    if( passSFOSCut(leptons) )                      pass |= Cutflow::bit(CutSFOS);
+    if( passZCut(leptons) )                         pass |= Cutflow::bit(CutZ);
+    if( met && passMetCut(met) )                    pass |= Cutflow::bit(CutMet);
+    if( passBJetCut() )                             pass |= Cutflow::bit(CutBJet);
+    if( met && passMtCut(leptons, met) )            pass |= Cutflow::bit(CutMt);
+
+    return pass;
 }
 
 /*--------------------------------------------------------------------------------*/
@@ -384,22 +376,7 @@ void Susy3LepCutflow::dumpEventCounters()
   cout << endl;
   cout << "Susy3LepCutflow event counters"    << endl;
   cout << "read in     :  " << n_readin        << endl;
-  cout << "pass GRL    :  " << n_pass_grl      << endl;
-  cout << "pass LArErr :  " << n_pass_lar      << endl;
-  cout << "pass TileErr:  " << n_pass_tile     << endl;
-  cout << "pass TTCVeto:  " << n_pass_ttc      << endl;
-  cout << "pass SCTerr :  " << n_pass_sct      << endl;
-  cout << "pass PrimVtx:  " << n_pass_goodVtx  << endl;
-  cout << "pass BadMuon:  " << n_pass_badMuon  << endl;
-  cout << "pass cosmic :  " << n_pass_cosmic   << endl;
-  cout << "pass BadJet :  " << n_pass_badJet   << endl;
-  cout << "pass nLep   :  " << n_pass_nLep     << endl;
-  cout << "pass trig   :  " << n_pass_trig     << endl;
-  cout << "pass sfos   :  " << n_pass_sfos     << endl;
-  cout << "pass z      :  " << n_pass_z        << endl;
-  cout << "pass met    :  " << n_pass_met      << endl;
-  cout << "pass b-jet  :  " << n_pass_bJet     << endl;
-  cout << "pass mt     :  " << n_pass_mt       << endl;
+  m_cutflow.print(cout);
   cout << endl;
   cout << "Weighted event yields"              << endl;
   cout << "A-L (20/fb) :  " << n_evt_tot       << endl;
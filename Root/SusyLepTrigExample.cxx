@@ -22,16 +22,16 @@ SusyLepTrigExample::SusyLepTrigExample() :
     m_sublead_pt(20),
     outfile_initialized(false),
     m_out_file(nullptr),
-    h_single_mu_fired(nullptr),
-    h_single_mu_match(nullptr),
-    h_dimu_fired(nullptr),
-    h_dimu_match(nullptr),
-    h_single_ele_fired(nullptr),
-    h_single_ele_match(nullptr),
-    h_diel_fired(nullptr),
-    h_diel_match(nullptr),
-    h_mixed_fired(nullptr),
-    h_mixed_match(nullptr)
+    h_single_mu_fired(0),
+    h_single_mu_match(0),
+    h_dimu_fired(0),
+    h_dimu_match(0),
+    h_single_ele_fired(0),
+    h_single_ele_match(0),
+    h_diel_fired(0),
+    h_diel_match(0),
+    h_mixed_fired(0),
+    h_mixed_match(0)
 {
     cout << "SusyLepTrigExample" << endl;
     gROOT->SetBatch(true);
@@ -56,127 +56,50 @@ void SusyLepTrigExample::initialize_output()
 //////////////////////////////////////////////////////////////////////////////
 void SusyLepTrigExample::initialize_histos()
 {
-
-    // single muon fire/matching histo
-    size_t  n_bins = nttools().triggerTool().single_muo_triggers().size();
+    // single muon fire/matching and scale factor histos
     vector<string> sm_trigs = nttools().triggerTool().single_muo_triggers();
-    h_single_mu_fired = new TH1F("h_single_mu_fired", "Single Mu;;Entries", n_bins, 0, n_bins);
-    h_single_mu_fired->SetLineColor(kBlack);
-    h_single_mu_match = new TH1F("h_single_mu_match", "Single Mu;;Entries", n_bins, 0, n_bins);
-    h_single_mu_match->SetFillStyle(3354);
-    h_single_mu_match->SetFillColor(30);
-    h_single_mu_match->SetLineColor(kBlue);
-
-    for(int itrig = 0; itrig < (int)sm_trigs.size(); itrig++) {
-        h_single_mu_fired->GetXaxis()->SetBinLabel(itrig+1, sm_trigs.at(itrig).c_str());
-        h_single_mu_match->GetXaxis()->SetBinLabel(itrig+1, sm_trigs.at(itrig).c_str());
-    }
-
-    // single muon scale factor histos
-    for(int itrig = 0; itrig < (int)sm_trigs.size(); itrig++) {
-        stringstream sx; 
-        sx << "Single Muon Trigger SF: " << sm_trigs.at(itrig);
-        stringstream id;
-        id << "h_single_muon_sf_" << sm_trigs.at(itrig);
-        TH1F* h = new TH1F(id.str().c_str(), sx.str().c_str(), 120, 0, 1.20);
-        h->SetLineColor(kBlack);
-        h->SetFillColor(30);
-        h_single_mu_sf.push_back(h);
-    }
+    book_fired_matched("h_single_mu", "Single Mu", sm_trigs, h_single_mu_fired, h_single_mu_match);
+    h_single_mu_sf = book_sf_histos("h_single_muon_sf_", "Single Muon Trigger SF: ", sm_trigs);
 
-    // dimuon fire/matching histo
-    n_bins = nttools().triggerTool().di_muo_triggers().size();
+    // dimuon fire/matching and scale factor histos
     vector<string> dm_trigs = nttools().triggerTool().di_muo_triggers();
-    h_dimu_fired = new TH1F("h_di_mu_fired", "Di Mu;;Entries", n_bins, 0, n_bins);
-    h_dimu_fired->SetLineColor(kBlack);
-    h_dimu_match = new TH1F("h_di_mu_match", "Di Mu;;Entries", n_bins, 0, n_bins);
-    h_dimu_match->SetFillStyle(3354);
-    h_dimu_match->SetFillColor(38);
-    h_dimu_match->SetLineColor(kBlue);
-
-    for(int itrig = 0; itrig < (int)dm_trigs.size(); itrig++) {
-        h_dimu_fired->GetXaxis()->SetBinLabel(itrig+1, dm_trigs.at(itrig).c_str());
-        h_dimu_match->GetXaxis()->SetBinLabel(itrig+1, dm_trigs.at(itrig).c_str());
-    }
-
-    // dimuon scale factor histos
-    for(int itrig = 0; itrig < (int)dm_trigs.size(); itrig++) {
-        stringstream sx;
-        sx << "Dimuon Trigger SF: " << dm_trigs.at(itrig);
-        stringstream id;
-        id << "h_dimuon_sf_" << dm_trigs.at(itrig);
-        TH1F* h = new TH1F(id.str().c_str(), sx.str().c_str(), 120, 0, 1.20);
-        h->SetLineColor(kBlack);
-        h->SetFillColor(38);
-        h_di_mu_sf.push_back(h);
-    }
+    book_fired_matched("h_di_mu", "Di Mu", dm_trigs, h_dimu_fired, h_dimu_match);
+    h_di_mu_sf = book_sf_histos("h_dimuon_sf_", "Dimuon Trigger SF: ", dm_trigs);
 
-    // single electron fire/matching histo
-    n_bins = nttools().triggerTool().single_ele_triggers().size();
+    // single electron fire/matching and scale factor histos
     vector<string> se_trigs = nttools().triggerTool().single_ele_triggers();
-    h_single_ele_fired = new TH1F("h_single_ele_fired", "Single Ele;;Entries", n_bins, 0, n_bins);
-    h_single_ele_fired->SetLineColor(kBlack);
-    h_single_ele_match = new TH1F("h_single_ele_match", "Single Ele;;Entries", n_bins, 0, n_bins);
-    h_single_ele_match->SetFillStyle(3354);
-    h_single_ele_match->SetFillColor(30);
-    h_single_ele_match->SetLineColor(kBlue);
-    for(int itrig = 0; itrig < (int)se_trigs.size(); itrig++) {
-        h_single_ele_fired->GetXaxis()->SetBinLabel(itrig+1, se_trigs.at(itrig).c_str());
-        h_single_ele_match->GetXaxis()->SetBinLabel(itrig+1, se_trigs.at(itrig).c_str());
-    }
+    book_fired_matched("h_single_ele", "Single Ele", se_trigs, h_single_ele_fired, h_single_ele_match);
+    h_single_ele_sf = book_sf_histos("h_single_ele_sf_", "Single Electron Trigger SF: ", se_trigs);
 
-    // single electron scale factor histos
-    for(int itrig = 0; itrig < (int)se_trigs.size(); itrig++) {
-        stringstream sx;
-        sx << "Single Electron Trigger SF: " << se_trigs.at(itrig);
-        stringstream id;
-        id << "h_single_ele_sf_" << se_trigs.at(itrig);
-        TH1F* h = new TH1F(id.str().c_str(), sx.str().c_str(), 120, 0, 1.2);
-        h->SetLineColor(kBlack);
-        h->SetFillColor(30);
-        h_single_ele_sf.push_back(h);
-    }
-
-    // dielectron fire/matching histo
-    n_bins = nttools().triggerTool().di_ele_triggers().size();
+    // dielectron fire/matching and scale factor histos
     vector<string> de_trigs = nttools().triggerTool().di_ele_triggers();
-    h_diel_fired = new TH1F("h_dielectron_fired", "Dielectron;;Entries", n_bins, 0, n_bins);
-    h_diel_fired->SetLineColor(kBlack);
-    h_diel_match = new TH1F("h_dielectron_match", "Dielectron;;Entries", n_bins, 0, n_bins);
-    h_diel_match->SetFillStyle(3354);
-    h_diel_match->SetFillColor(38);
-    h_diel_match->SetLineColor(kBlue);
-    for(int itrig = 0; itrig < (int)de_trigs.size(); itrig++) {
-        h_diel_fired->GetXaxis()->SetBinLabel(itrig+1, de_trigs.at(itrig).c_str());
-        h_diel_match->GetXaxis()->SetBinLabel(itrig+1, de_trigs.at(itrig).c_str());
-    }
-
-    // dielectron scale factor histos
-    for(int itrig = 0; itrig < (int)de_trigs.size(); itrig++) {
-        stringstream sx;
-        sx << "Dielectron Trigger SF: " << de_trigs.at(itrig);
-        stringstream id;
-        id << "h_dielectron_sf_" << de_trigs.at(itrig);
-        TH1F* h = new TH1F(id.str().c_str(), sx.str().c_str(), 120, 0, 1.2);
-        h->SetLineColor(kBlack);
-        h->SetFillColor(30);
-        h_di_el_sf.push_back(h);
-    }
+    book_fired_matched("h_dielectron", "Dielectron", de_trigs, h_diel_fired, h_diel_match);
+    h_di_el_sf = book_sf_histos("h_dielectron_sf_", "Dielectron Trigger SF: ", de_trigs);
 
     // mixed fire/matching histos
-    n_bins = nttools().triggerTool().ele_muo_triggers().size();
     vector<string> mix_trigs = nttools().triggerTool().ele_muo_triggers();
-    h_mixed_fired = new TH1F("h_mixed_fired", "Mixed Lepton;;Entries", n_bins, 0, n_bins);
-    h_mixed_fired->SetLineColor(kBlack);
-    h_mixed_match = new TH1F("h_mixed_match", "Mixed Lepton;;Entries", n_bins, 0, n_bins);
-    h_mixed_match->SetFillStyle(3354);
-    h_mixed_match->SetFillColor(38);
-    h_mixed_match->SetLineColor(kBlue);
-    for(int itrig = 0; itrig < (int)mix_trigs.size(); itrig++) {
-        h_mixed_fired->GetXaxis()->SetBinLabel(itrig+1, mix_trigs.at(itrig).c_str());
-        h_mixed_match->GetXaxis()->SetBinLabel(itrig+1, mix_trigs.at(itrig).c_str());
+    book_fired_matched("h_mixed", "Mixed Lepton", mix_trigs, h_mixed_fired, h_mixed_match);
+}
+//////////////////////////////////////////////////////////////////////////////
+void SusyLepTrigExample::book_fired_matched(const string& name, const string& title,
+        const vector<string>& triggers, size_t& fired, size_t& matched)
+{
+    int n_bins = triggers.size();
+    fired = m_histos.book(name + "_fired", title + ";;Entries", n_bins, 0, n_bins);
+    matched = m_histos.book(name + "_match", title + ";;Entries", n_bins, 0, n_bins);
+    for(int itrig = 0; itrig < n_bins; itrig++) {
+        m_histos.setBinLabel(fired, itrig+1, triggers.at(itrig));
+        m_histos.setBinLabel(matched, itrig+1, triggers.at(itrig));
     }
-
+}
+//////////////////////////////////////////////////////////////////////////////
+vector<size_t> SusyLepTrigExample::book_sf_histos(const string& name, const string& title,
+        const vector<string>& triggers)
+{
+    vector<size_t> sf_histos;
+    for(const auto & trigger : triggers)
+        sf_histos.push_back(m_histos.book(name + trigger, title + trigger, 120, 0, 1.20));
+    return sf_histos;
 }
 //////////////////////////////////////////////////////////////////////////////
 Bool_t SusyLepTrigExample::Process(Long64_t entry)
@@ -315,17 +238,15 @@ void SusyLepTrigExample::test_single_mu_trigger(Susy::Muon* muon, string trigger
     // did the trigger even fire?
     bool trig_has_fired = nttools().triggerTool().passTrigger(nt.evt()->trigBits, trigger);
     if(!trig_has_fired) return;
-    int content = h_single_mu_fired->GetBinContent(sm_idx+1);
-    h_single_mu_fired->SetBinContent(sm_idx+1, content+1);
+    m_histos.fill(h_single_mu_fired, sm_idx);
 
     
     bool mu_is_matched = (muon->Pt() >= threshold);
     mu_is_matched = (mu_is_matched && nttools().triggerTool().lepton_trigger_match(muon, trigger));
     if(mu_is_matched) {
-        int content = h_single_mu_match->GetBinContent(sm_idx+1);
-        h_single_mu_match->SetBinContent(sm_idx+1, content+1);
+        m_histos.fill(h_single_mu_match, sm_idx);
         float sf = nttools().get_muon_trigger_scale_factor(*muon, trigger);
-        h_single_mu_sf.at(sm_idx)->Fill(sf);
+        m_histos.fill(h_single_mu_sf.at(sm_idx), sf);
     }
 }
 //////////////////////////////////////////////////////////////////////////////
@@ -334,15 +255,13 @@ void SusyLepTrigExample::test_single_ele_trigger(Susy::Electron* electron, strin
     // did the trigger even fire?
     bool trig_has_fired = nttools().triggerTool().passTrigger(nt.evt()->trigBits, trigger);
     if(!trig_has_fired) return;
-    int content = h_single_ele_fired->GetBinContent(se_idx+1);
-    h_single_ele_fired->SetBinContent(se_idx+1, content+1);
+    m_histos.fill(h_single_ele_fired, se_idx);
 
     bool ele_is_matched = nttools().triggerTool().lepton_trigger_match(electron, trigger);
     if(ele_is_matched) {
-        int content = h_single_ele_match->GetBinContent(se_idx+1);
-        h_single_ele_match->SetBinContent(se_idx+1, content+1);
+        m_histos.fill(h_single_ele_match, se_idx);
         float sf = nttools().get_electron_trigger_scale_factor(*electron, trigger);
-        h_single_ele_sf.at(se_idx)->Fill(sf);
+        m_histos.fill(h_single_ele_sf.at(se_idx), sf);
     }
 }
 //////////////////////////////////////////////////////////////////////////////
@@ -354,8 +273,7 @@ void SusyLepTrigExample::test_dimuon_trigger(Susy::Muon* mu0, Susy::Muon* mu1, s
     // did the trigger even fire?
     bool trig_has_fired = nttools().triggerTool().passTrigger(nt.evt()->trigBits, trigger);
     if(!trig_has_fired) return;
-    int content = h_dimu_fired->GetBinContent(dimu_idx+1);
-    h_dimu_fired->SetBinContent(dimu_idx+1, content+1);
+    m_histos.fill(h_dimu_fired, dimu_idx);
 
     bool muons_are_matched = (mu0->Pt() >= 24); //std::get<0>(thresholds));
     muons_are_matched = (muons_are_matched && (mu1->Pt() >= 20));//std::get<1>(thresholds)));
@@ -363,10 +281,9 @@ void SusyLepTrigExample::test_dimuon_trigger(Susy::Muon* mu0, Susy::Muon* mu1, s
                 nttools().triggerTool().dilepton_trigger_match(nt.evt(), mu0, mu1, trigger)); 
 
     if(muons_are_matched) {
-        int content = h_dimu_match->GetBinContent(dimu_idx+1);
-        h_dimu_match->SetBinContent(dimu_idx+1, content+1);
+        m_histos.fill(h_dimu_match, dimu_idx);
         float sf = nttools().get_muon_trigger_scale_factor(*mu0, *mu1, trigger);
-        h_di_mu_sf.at(dimu_idx)->Fill(sf);
+        m_histos.fill(h_di_mu_sf.at(dimu_idx), sf);
     }
 
 }
@@ -377,15 +294,13 @@ void SusyLepTrigExample::test_dielectron_trigger(Susy::Electron* el0, Susy::Elec
     // did the trigger even fire?
     bool trig_has_fired = nttools().triggerTool().passTrigger(nt.evt()->trigBits, trigger);
     if(!trig_has_fired) return;
-    int content = h_diel_fired->GetBinContent(diel_idx+1);
-    h_diel_fired->SetBinContent(diel_idx+1, content+1);
+    m_histos.fill(h_diel_fired, diel_idx);
 
     bool electrons_are_matched = nttools().triggerTool().dilepton_trigger_match(nt.evt(), el0, el1, trigger);
     if(electrons_are_matched) {
-        int content = h_diel_match->GetBinContent(diel_idx+1);
-        h_diel_match->SetBinContent(diel_idx+1, content+1);
+        m_histos.fill(h_diel_match, diel_idx);
         float sf = nttools().get_electron_trigger_scale_factor(*el0, *el1, trigger);
-        h_di_el_sf.at(diel_idx)->Fill(sf);
+        m_histos.fill(h_di_el_sf.at(diel_idx), sf);
     }
 
 }
@@ -395,13 +310,11 @@ void SusyLepTrigExample::test_mixed_trigger(Susy::Electron* el, Susy::Muon* mu,
     // did the trigger even fire?
     bool trig_has_fired = nttools().triggerTool().passTrigger(nt.evt()->trigBits, trigger);
     if(!trig_has_fired) return;
-    int content = h_mixed_fired->GetBinContent(mix_idx+1);
-    h_mixed_fired->SetBinContent(mix_idx+1, content+1);
+    m_histos.fill(h_mixed_fired, mix_idx);
 
     bool leptons_are_matched = nttools().triggerTool().dilepton_trigger_match(nt.evt(), el, mu, trigger);
     if(leptons_are_matched) {
-        int content = h_mixed_match->GetBinContent(mix_idx+1);
-        h_mixed_match->SetBinContent(mix_idx+1, content+1);
+        m_histos.fill(h_mixed_match, mix_idx);
         // don't have SF for mixed triggers yet
     }
 }
@@ -480,118 +393,81 @@ map<string, pair<float, float> > SusyLepTrigExample::dimuon_trigger_thresholds()
     return threshold_map;
 }
 //////////////////////////////////////////////////////////////////////////////
-void SusyLepTrigExample::write_single_mu_histos()
+void SusyLepTrigExample::write_fired_matched(const char* canvas, size_t fired, size_t matched, Color_t match_color)
 {
     m_out_file->cd();
 
-    TCanvas* c0 = new TCanvas("c_single_mu_fired_matched", "", 800, 600);
+    TCanvas* c0 = new TCanvas(canvas, "", 800, 600);
     c0->SetGrid(1,1);
     c0->cd();
 
-    float maxy = h_single_mu_fired->GetMaximum();
-    if(h_single_mu_match->GetMaximum() > maxy) maxy = h_single_mu_match->GetMaximum();
+    TH1F* h_fired = m_histos.toTH1F(fired);
+    h_fired->SetLineColor(kBlack);
+    TH1F* h_match = m_histos.toTH1F(matched);
+    h_match->SetFillStyle(3354);
+    h_match->SetFillColor(match_color);
+    h_match->SetLineColor(kBlue);
+
+    float maxy = h_fired->GetMaximum();
+    if(h_match->GetMaximum() > maxy) maxy = h_match->GetMaximum();
     maxy = 1.4*maxy;
-    h_single_mu_fired->SetMaximum(maxy);
-    h_single_mu_match->SetMaximum(maxy);
-    h_single_mu_fired->SetMinimum(0);
-    h_single_mu_match->SetMinimum(0);
+    h_fired->SetMaximum(maxy);
+    h_match->SetMaximum(maxy);
+    h_fired->SetMinimum(0);
+    h_match->SetMinimum(0);
 
-    h_single_mu_fired->Draw("hist");
-    h_single_mu_match->Draw("hist same");
+    h_fired->Draw("hist");
+    h_match->Draw("hist same");
     c0->Write();
-
-    for(auto & h : h_single_mu_sf) h->Write();
+    delete c0;
+    delete h_match;
+    delete h_fired;
 }
 //////////////////////////////////////////////////////////////////////////////
-void SusyLepTrigExample::write_single_ele_histos()
+void SusyLepTrigExample::write_sf_histos(const vector<size_t>& sf_histos, Color_t fill_color)
 {
     m_out_file->cd();
-
-    TCanvas* c0 = new TCanvas("c_single_ele_fired_matched", "", 800, 600);
-    c0->SetGrid(1,1);
-    c0->cd();
-
-    float maxy = h_single_ele_fired->GetMaximum();
-    if(h_single_ele_match->GetMaximum() > maxy) maxy = h_single_ele_match->GetMaximum();
-    maxy = 1.4*maxy;
-    h_single_ele_fired->SetMaximum(maxy);
-    h_single_ele_match->SetMaximum(maxy);
-    h_single_ele_fired->SetMinimum(0);
-    h_single_ele_match->SetMinimum(0);
-
-    h_single_ele_fired->Draw("hist");
-    h_single_ele_match->Draw("hist same");
-    c0->Write();
-
-    for(auto & h : h_single_ele_sf) h->Write();
+    for(auto & id : sf_histos) {
+        TH1F* h = m_histos.toTH1F(id);
+        h->SetLineColor(kBlack);
+        h->SetFillColor(fill_color);
+        h->Write();
+        delete h;
+    }
+}
+//////////////////////////////////////////////////////////////////////////////
+void SusyLepTrigExample::write_single_mu_histos()
+{
+    write_fired_matched("c_single_mu_fired_matched", h_single_mu_fired, h_single_mu_match, 30);
+    write_sf_histos(h_single_mu_sf, 30);
+}
+//////////////////////////////////////////////////////////////////////////////
+void SusyLepTrigExample::write_single_ele_histos()
+{
+    write_fired_matched("c_single_ele_fired_matched", h_single_ele_fired, h_single_ele_match, 30);
+    write_sf_histos(h_single_ele_sf, 30);
 }
 //////////////////////////////////////////////////////////////////////////////
 void SusyLepTrigExample::write_di_mu_histos()
 {
-    m_out_file->cd();
-
-    TCanvas* c0 = new TCanvas("c_di_mu_fired_matched", "", 800, 600);
-    c0->SetGrid(1,1);
-    c0->cd();
-
-    float maxy = h_dimu_fired->GetMaximum();
-    if(h_dimu_match->GetMaximum() > maxy) maxy = h_dimu_match->GetMaximum();
-    maxy = 1.4*maxy;
-    h_dimu_fired->SetMaximum(maxy);
-    h_dimu_match->SetMaximum(maxy);
-    h_dimu_fired->SetMinimum(0);
-    h_dimu_match->SetMinimum(0);
-
-    h_dimu_fired->Draw("hist");
-    h_dimu_match->Draw("hist same");
-    c0->Write();
-
-    for(auto & h : h_di_mu_sf) h->Write();
+    write_fired_matched("c_di_mu_fired_matched", h_dimu_fired, h_dimu_match, 38);
+    write_sf_histos(h_di_mu_sf, 38);
 }
 //////////////////////////////////////////////////////////////////////////////
 void SusyLepTrigExample::write_di_el_histos()
 {
-    m_out_file->cd();
-    TCanvas* c0 = new TCanvas("c_di_el_fired_matched", "", 800, 600);
-    c0->SetGrid(1,1);
-    c0->cd();
-
-    float maxy = h_diel_fired->GetMaximum();
-    if(h_diel_match->GetMaximum() > maxy) maxy = h_diel_match->GetMaximum();
-    maxy = 1.4*maxy;
-    h_diel_fired->SetMaximum(maxy);
-    h_diel_match->SetMaximum(maxy);
-    h_diel_fired->SetMinimum(0);
-    h_diel_match->SetMinimum(0);
-
-    h_diel_fired->Draw("hist");
-    h_diel_match->Draw("hist same");
-    c0->Write();
-    for(auto & h : h_di_el_sf) h->Write();
+    write_fired_matched("c_di_el_fired_matched", h_diel_fired, h_diel_match, 38);
+    write_sf_histos(h_di_el_sf, 30);
 }
 //////////////////////////////////////////////////////////////////////////////
 void SusyLepTrigExample::write_mix_histos()
 {
-    m_out_file->cd();
-    TCanvas* c0 = new TCanvas("c_mixed_fired_match", "", 800, 600);
-    c0->SetGrid(1,1);
-    c0->cd();
-
-    float maxy = h_mixed_fired->GetMaximum();
-    if(h_mixed_match->GetMaximum() > maxy) maxy = h_mixed_match->GetMaximum();
-    maxy = 1.4*maxy;
-    h_mixed_fired->SetMaximum(maxy);
-    h_mixed_match->SetMaximum(maxy);
-    h_mixed_fired->SetMinimum(0);
-    h_mixed_match->SetMinimum(0);
-
-    h_mixed_fired->Draw("hist");
-    h_mixed_match->Draw("hist same");
-    c0->Write();
+    write_fired_matched("c_mixed_fired_match", h_mixed_fired, h_mixed_match, 38);
 }
 //////////////////////////////////////////////////////////////////////////////
 void SusyLepTrigExample::Terminate()
 {
+    m_histos.merge();
     m_out_file->cd();
 
     write_single_mu_histos();
@@ -10,6 +10,7 @@ using namespace Susy;
 /*--------------------------------------------------------------------------------*/
 SusyNtAna::SusyNtAna() : 
         nt(m_entry),
+        m_tree(NULL),
         m_entry(0),
         m_selectTaus(true),
         m_printFreq(50000),
@@ -17,8 +18,22 @@ SusyNtAna::SusyNtAna() :
         m_dbgEvt(false),
         m_duplicate(false),
         m_sumw_file(""),
-        m_use_sumw_file(false)
+        m_use_sumw_file(false),
+        m_stageTiming(false),
+        m_eventStart(0),
+        m_perfCountersOn(false),
+        m_perfReportEvery(0),
+        m_perfEvents(0)
 {
+  // same order as the Stage enum
+  m_stageTimer.addStage("event");
+  m_stageTimer.addStage("read entry");
+  m_stageTimer.addStage("classify objects");
+  m_stageTimer.addStage("baseline vectors");
+  m_stageTimer.addStage("overlap");
+  m_stageTimer.addStage("signal vectors");
+  m_stageTimer.addStage("met");
+  m_stageTimer.addStage("weight");
 }
 
 /*--------------------------------------------------------------------------------*/
@@ -39,6 +54,16 @@ void SusyNtAna::Init(TTree* tree)
   }
   m_mcWeighter.buildSumwMap(tree);
 }
+/*--------------------------------------------------------------------------------*/
+// New file: the systematics stripped by SusyNtSlimmer, if any
+/*--------------------------------------------------------------------------------*/
+Bool_t SusyNtAna::Notify()
+{
+  TFile* file = (m_tree ? m_tree->GetCurrentFile() : NULL);
+  if(m_nttools.readKeptSystematics(file) && m_dbg)
+    cout << "SusyNtAna::Notify    " << file->GetName() << " has only some of the systematics" << endl;
+  return kTRUE;
+}
 
 /*--------------------------------------------------------------------------------*/
 // The Begin() function is called at the start of the query.
@@ -53,11 +78,38 @@ void SusyNtAna::Begin(TTree* /*tree*/)
 
   // Start the timer
   m_timer.Start();
+  if(m_perfCountersOn){
+    if(m_perfCounters.open()) m_perfLast = m_perfCounters.read();
+    m_perfEvents = 0;
+  }
 
   //Debug event - load event list
-  if(m_dbgEvt) loadEventList();
+  if(m_dbgEvt && m_pickEvents.empty()) loadEventList();
 }
 
+/*--------------------------------------------------------------------------------*/
+// Communicate the entry number to the VarHandles
+/*--------------------------------------------------------------------------------*/
+Int_t SusyNtAna::GetEntry(Long64_t e, Int_t /*getall*/)
+{
+  m_entry=e;
+  if(m_stageTiming){
+    uint64_t now = StageTimer::now();
+    if(m_eventStart>0) m_stageTimer.record(StageEvent, now - m_eventStart);
+    m_eventStart = now;
+    if(m_perfReportEvery>0 && m_perfCounters.isOpen() && ++m_perfEvents%m_perfReportEvery==0){
+      PerfSample sample = m_perfCounters.read();
+      cout << "SusyNtAna::GetEntry    events " << m_perfEvents-m_perfReportEvery << "-" << m_perfEvents
+           << " : " << (sample - m_perfLast).str() << endl;
+      m_perfLast = sample;
+    }
+    // only the event branch, which every event reads; the object branches are read
+    // lazily, and timed with the stage that first uses them
+    StageTimer::Scope read = timeStage(StageRead);
+    nt.evt();
+  }
+  return kTRUE;
+}
 /*--------------------------------------------------------------------------------*/
 // Main process loop function - This is just an example for testing
 /*--------------------------------------------------------------------------------*/
@@ -116,31 +168,47 @@ void SusyNtAna::Terminate()
 
   // Stop the timer
   m_timer.Stop();
+  if(m_stageTiming && m_eventStart>0){
+    m_stageTimer.record(StageEvent, StageTimer::now() - m_eventStart);
+    m_eventStart = 0;
+  }
   dumpTimer();
 }
 
+/*--------------------------------------------------------------------------------*/
+// Event weight for each weight systematic
+/*--------------------------------------------------------------------------------*/
+const std::vector<double>& SusyNtAna::systematicWeights(const float lumi)
+{
+  m_systematicWeights.resize(m_weightSystematics.size());
+  StageTimer::Scope weight = timeStage(StageWeight);
+  const Event* evt = nt.evt();
+  // most systematics leave the MC weight unchanged: compute the nominal once
+  double nominal = m_mcWeighter.getMCWeight(evt, lumi, NtSys::NOM);
+  for(size_t i=0; i<m_weightSystematics.size(); ++i) {
+    NtSys::SusyNtSys sys = m_weightSystematics[i];
+    m_systematicWeights[i] = MCWeighter::affectsMCWeight(sys) ? m_mcWeighter.getMCWeight(evt, lumi, sys) : nominal;
+  }
+  return m_systematicWeights;
+}
 /*--------------------------------------------------------------------------------*/
 // Load Event list of run/event to process. Use to debug events
 /*--------------------------------------------------------------------------------*/
 void SusyNtAna::loadEventList(const std::string filename)
 {
-  int run, event;
-  FILE* eventsFile=fopen(filename.c_str(),"r");
-  int nEvtDbg=0;
-  while(fscanf(eventsFile,"%i %i \n",&run, &event) != EOF){
-    cout << "Adding run-event " << run << " " << event << endl; 
-    addRunEvent(m_eventList, run, event);
-    nEvtDbg++;
-  }
-  std::cout << " >>> Debugging " << nEvtDbg << " events " << std::endl;
+  m_pickEvents.clear();
+  m_pickEvents.setVerbose(m_dbg>0);
+  if(!m_pickEvents.read(filename))
+    cout << "SusyNtAna::loadEventList: cannot read " << filename << endl;
+  std::cout << " >>> Debugging " << m_pickEvents.size() << " events " << std::endl;
 }
 /*--------------------------------------------------------------------------------*/
 // Process selected events only
 /*--------------------------------------------------------------------------------*/
 bool SusyNtAna::processThisEvent(unsigned int run, unsigned int event)
 {
-  if(m_eventList.size()==0) return true;
-  return checkRunEvent(m_eventList, run, event);
+  if(m_pickEvents.empty()) return true;
+  return m_pickEvents.contains(run, event);
 }
 bool SusyNtAna::checkRunEvent(const RunEventMap &runEventMap, unsigned int run, unsigned int event)
 {
@@ -163,13 +231,9 @@ bool SusyNtAna::checkAndAddRunEvent(RunEventMap &runEventMap, unsigned int run,
 /*--------------------------------------------------------------------------------*/
 bool SusyNtAna::isDuplicate(unsigned int run, unsigned int event){
 
-  if(m_eventListDuplicate.size()==0) addRunEvent(m_eventListDuplicate, run, event);
-  else{
-    if(checkRunEvent(m_eventListDuplicate, run, event)){
-      cout << "WARNING Duplicate event - SKIPING IT !!!" << run << " " << event << endl;
-      return true;
-    }
-    else addRunEvent(m_eventListDuplicate, run, event);
+  if(!m_duplicateEvents.insert(run, event)){
+    cout << "WARNING Duplicate event - SKIPING IT !!!" << run << " " << event << endl;
+    return true;
   }
   return false;
 }
@@ -223,6 +287,7 @@ void SusyNtAna::clearObjects()
   m_met = NULL;
   m_trackMet = NULL;
 
+  m_nttools.clearObjectStatus();
 }
 /*--------------------------------------------------------------------------------*/
 // Select baseline and signal leptons
@@ -237,18 +302,38 @@ void SusyNtAna::selectObjects(SusyNtSys sys)
   ///////////////////////////////////////
   // Get the Pre-Selection.
   // Systematic variation applied here.
+  // Each object is classified once (baseline, signal, jet category),
+  // and the vectors below are built from its bits.
   ///////////////////////////////////////
-  m_nttools.getPreObjects(&nt, sys, m_preElectrons, m_preMuons, m_preJets, m_preTaus, m_prePhotons);
+  const ObjectStatus *status = 0;
+  {
+    StageTimer::Scope s = timeStage(StagePreObjects);
+    status = &m_nttools.classifyObjects(&nt, sys);
+    m_preElectrons = status->electrons.objects();
+    m_preMuons = status->muons.objects();
+    m_preJets = status->jets.objects();
+    m_preTaus = status->taus.objects();
+    m_prePhotons = status->photons.objects();
+  }
 
   ///////////////////////////////////////
   // Get the Baseline Objects
   ///////////////////////////////////////
-  m_nttools.getBaselineObjects(m_preElectrons, m_preMuons, m_preJets, m_preTaus, m_prePhotons,
-                               m_baseElectrons, m_baseMuons, m_baseJets, m_baseTaus, m_basePhotons);
+  {
+    StageTimer::Scope s = timeStage(StageBaseline);
+    status->electrons.select(ObjectStatus::Baseline, m_baseElectrons);
+    status->muons.select(ObjectStatus::Baseline, m_baseMuons);
+    status->jets.select(ObjectStatus::Baseline, m_baseJets);
+    status->taus.select(ObjectStatus::Baseline, m_baseTaus);
+    status->photons.select(ObjectStatus::Baseline, m_basePhotons);
+  }
   ///////////////////////////////////////
   // do OR 
   ///////////////////////////////////////
-  m_nttools.overlapTool().performOverlap(m_baseElectrons, m_baseMuons, m_baseJets, m_baseTaus, m_basePhotons);
+  {
+    StageTimer::Scope s = timeStage(StageOverlap);
+    m_nttools.overlapTool().performOverlap(m_baseElectrons, m_baseMuons, m_baseJets, m_baseTaus, m_basePhotons);
+  }
 
   ///////////////////////////////////////
   // SFOS removal
@@ -260,19 +345,27 @@ void SusyNtAna::selectObjects(SusyNtSys sys)
   ///////////////////////////////////////
   // Get the Signal Objects
   ///////////////////////////////////////
-  m_nttools.getSignalObjects(m_baseElectrons, m_baseMuons, m_baseJets, m_baseTaus, m_basePhotons,
-                              m_signalElectrons, m_signalMuons, m_signalJets, m_signalTaus, m_signalPhotons);
-
-  ///////////////////////////////////////
-  // Build Lepton vectors
-  ///////////////////////////////////////
-  m_nttools.buildLeptons(m_preLeptons, m_preElectrons, m_preMuons);
-  m_nttools.buildLeptons(m_baseLeptons, m_baseElectrons, m_baseMuons);
-  m_nttools.buildLeptons(m_signalLeptons, m_signalElectrons, m_signalMuons);
+  {
+    StageTimer::Scope s = timeStage(StageSignal);
+    m_nttools.markOverlapSurvivors(m_baseElectrons, m_baseMuons, m_baseJets, m_baseTaus, m_basePhotons);
+    status->electrons.select(ObjectStatus::Signal, m_signalElectrons);
+    status->muons.select(ObjectStatus::Signal, m_signalMuons);
+    status->jets.select(ObjectStatus::Signal, m_signalJets);
+    status->taus.select(ObjectStatus::Signal, m_signalTaus);
+    status->photons.select(ObjectStatus::Signal, m_signalPhotons);
+
+    ///////////////////////////////////////
+    // Build Lepton vectors
+    ///////////////////////////////////////
+    m_nttools.buildLeptons(m_preLeptons, m_preElectrons, m_preMuons);
+    m_nttools.buildLeptons(m_baseLeptons, m_baseElectrons, m_baseMuons);
+    m_nttools.buildLeptons(m_signalLeptons, m_signalElectrons, m_signalMuons);
+  }
 
   ///////////////////////////////////////
   // Grab met
   ///////////////////////////////////////
+  StageTimer::Scope met = timeStage(StageMet);
   SusyNtSys metSys = sys;
   //AT 05-09-15 JVF obsolete run-2
   //if(sys==NtSys::JVF_UP || sys==NtSys::JVF_DN) metSys = NtSys::NOM;
@@ -333,6 +426,13 @@ void SusyNtAna::dumpTimer()
   printf("\t Analysis time: Real %d:%02d:%02d, CPU %.3f      \n", hours, min, sec, cpuTime);
   printf("\t Analysis speed [kHz]: %2.3f                     \n",speed);
   printf("---------------------------------------------------\n\n");
+  if(m_perfCounters.isOpen())
+    cout << " Hardware counters: " << m_perfCounters.read().str() << endl << endl;
+  if(m_stageTiming){
+    cout << " Time per stage:" << endl;
+    m_stageTimer.print(cout);
+    cout << endl;
+  }
 }
 
 /*--------------------------------------------------------------------------------*/
@@ -0,0 +1,636 @@
+#include "SusyNtuple/SusyNtGenerator.h"
+#include "SusyNtuple/TriggerTools.h"
+
+#include "TFile.h"
+#include "TH1F.h"
+#include "TMath.h"
+#include "TNamed.h"
+#include "TTree.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using Susy::SusyNtGenerator;
+using Susy::Electron;
+using Susy::Event;
+using Susy::Jet;
+using Susy::Met;
+using Susy::Muon;
+using Susy::Particle;
+using Susy::Photon;
+using Susy::Tau;
+using Susy::TrackMet;
+namespace NtSys = Susy::NtSys;
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+namespace {
+const float electronMass = 0.000511;
+const float muonMass = 0.105658;
+const float tauMass = 1.77686;
+const float bTagCut = 0.8244; // MV2c10 at 70% efficiency
+const Long64_t defaultNEvents = 10000;
+/// pt threshold of the leading object of a trigger chain, e.g. 24 for "HLT_e24_lhmedium_L1EM20VH" or "HLT_2e12_lhloose_L12EM10VH"
+float leadingThreshold(const string &chain)
+{
+    size_t i = chain.find('_');
+    i = (i==string::npos ? 0 : i+1);
+    if(i+1<chain.size() && isdigit(chain[i]) && isalpha(chain[i+1])) ++i; // multiplicity
+    while(i<chain.size() && isalpha(chain[i])) ++i;
+    return atof(chain.c_str()+i);
+}
+bool contains(const vector<string> &list, const string &name)
+{
+    return std::find(list.begin(), list.end(), name)!=list.end();
+}
+void sortByPt(vector<Jet> &jets)
+{
+    std::sort(jets.begin(), jets.end(), [](const Jet &a, const Jet &b) { return a.pt > b.pt; });
+}
+}
+//----------------------------------------------------------
+SusyNtGenerator::SusyNtGenerator() :
+    m_outputFilename("susyNt_synthetic.root"),
+    m_nEvents(defaultNEvents),
+    m_seed(4357),
+    m_isMC(true),
+    m_mcChannel(410009),
+    m_run(0),
+    m_sumw(-1.0),
+    m_meanElectrons(1.2),
+    m_meanMuons(1.2),
+    m_meanJets(4.0),
+    m_meanTaus(0.5),
+    m_meanPhotons(0.3),
+    m_systematics(true),
+    m_triggerEfficiency(0.9),
+    m_verbose(false),
+    m_started(false),
+    m_iEvent(0),
+    m_sumWeights(0),
+    m_sumWeightsSquared(0)
+{
+}
+//----------------------------------------------------------
+const std::vector<NtSys::SusyNtSys>& SusyNtGenerator::metSystematics()
+{
+    static const vector<NtSys::SusyNtSys> systematics = {
+        NtSys::EG_RESOLUTION_ALL_DN, NtSys::EG_RESOLUTION_ALL_UP, NtSys::EG_SCALE_ALL_DN, NtSys::EG_SCALE_ALL_UP,
+        NtSys::JER,
+        NtSys::JET_GroupedNP_1_UP, NtSys::JET_GroupedNP_1_DN, NtSys::JET_GroupedNP_2_UP,
+        NtSys::JET_GroupedNP_2_DN, NtSys::JET_GroupedNP_3_UP, NtSys::JET_GroupedNP_3_DN,
+        NtSys::JET_EtaIntercalibration_UP, NtSys::JET_EtaIntercalibration_DN,
+        NtSys::MET_SoftTrk_ResoPara, NtSys::MET_SoftTrk_ResoPerp, NtSys::MET_SoftTrk_ScaleDown, NtSys::MET_SoftTrk_ScaleUp,
+        NtSys::MUON_ID_DN, NtSys::MUON_ID_UP, NtSys::MUON_MS_DN, NtSys::MUON_MS_UP, NtSys::MUON_SCALE_DN, NtSys::MUON_SCALE_UP,
+        NtSys::MUON_SAGITTA_RESBIAS_DN, NtSys::MUON_SAGITTA_RESBIAS_UP, NtSys::MUON_SAGITTA_RHO_DN, NtSys::MUON_SAGITTA_RHO_UP,
+        NtSys::TAUS_SME_TOTAL_DN, NtSys::TAUS_SME_TOTAL_UP
+    };
+    return systematics;
+}
+//----------------------------------------------------------
+Long64_t SusyNtGenerator::generate()
+{
+    m_started = false;
+    start();
+    TDirectory *pwd = gDirectory;
+    TFile *output = TFile::Open(m_outputFilename.c_str(), "recreate");
+    if(!output || output->IsZombie()) {
+        cout<<"SusyNtGenerator::generate: cannot open output file '"<<m_outputFilename<<"'"<<endl;
+        return -1;
+    }
+    output->cd();
+    TTree *tree = new TTree("susyNt", "susyNt");
+    tree->SetDirectory(output);
+    m_nt.SetActive();
+    m_nt.WriteTo(tree);
+    for(Long64_t i=0; i<m_nEvents; ++i) {
+        generateEvent();
+        tree->Fill();
+        if(m_verbose && (i+1)%100000==0)
+            cout<<"SusyNtGenerator::generate: "<<(i+1)<<" events"<<endl;
+    }
+    output->cd();
+    tree->Write(0, TObject::kOverwrite);
+
+    TH1F *trig = triggerHistogram();
+    trig->Write(0, TObject::kOverwrite);
+    delete trig;
+    std::ostringstream sample;
+    sample<<(m_isMC ? "mc15_13TeV." : "data16_13TeV.")<<(m_isMC ? m_mcChannel : m_run)<<".synthetic";
+    TNamed inputContainer("inputContainerName", (sample.str()+".DAOD_SUSY2").c_str());
+    TNamed outputContainer("outputContainerName", (sample.str()+".SusyNt").c_str());
+    inputContainer.Write(0, TObject::kOverwrite);
+    outputContainer.Write(0, TObject::kOverwrite);
+    output->Close();
+    delete output;
+    pwd->cd();
+    if(m_verbose)
+        cout<<"SusyNtGenerator::generate: wrote "<<m_nEvents<<" events to '"<<m_outputFilename<<"'"
+            <<(m_isMC ? " (sumw " : "")<<(m_isMC ? std::to_string(m_sumw<0 ? m_sumWeights : m_sumw) + ")" : "")<<endl;
+    return m_nEvents;
+}
+//----------------------------------------------------------
+TH1F* SusyNtGenerator::triggerHistogram() const
+{
+    // TriggerTools::buildTriggerMap skips the last bin
+    const int nTriggers = m_triggers.size();
+    TH1F *trig = new TH1F("trig", "Event Level Triggers Fired", nTriggers+1, 0.0, nTriggers+1);
+    trig->SetDirectory(0);
+    for(int i=0; i<nTriggers; ++i) {
+        trig->GetXaxis()->SetBinLabel(i+1, m_triggers[i].c_str());
+        trig->SetBinContent(i+1, m_triggerCounts[i]);
+    }
+    return trig;
+}
+//----------------------------------------------------------
+void SusyNtGenerator::start()
+{
+    // the weights have their own sequence: sum them now, then restart it for the events
+    m_weightRandom.SetSeed(m_seed+1);
+    m_sumWeights = m_sumWeightsSquared = 0;
+    for(Long64_t i=0; i<m_nEvents; ++i) {
+        double w = drawWeight();
+        m_sumWeights += w;
+        m_sumWeightsSquared += w*w;
+    }
+    m_weightRandom.SetSeed(m_seed+1);
+    m_random.SetSeed(m_seed);
+
+    m_triggers = TriggerTools::getTrigNames();
+    m_triggerTypes.clear();
+    for(size_t i=0; i<m_triggers.size(); ++i) {
+        const string &t = m_triggers[i];
+        TriggerType type = TrigMet;
+        if     (contains(TriggerTools::single_ele_triggers(), t)) type = TrigSingleEle;
+        else if(contains(TriggerTools::single_muo_triggers(), t)) type = TrigSingleMuo;
+        else if(contains(TriggerTools::di_ele_triggers(), t))     type = TrigDiEle;
+        else if(contains(TriggerTools::di_muo_triggers(), t))     type = TrigDiMuo;
+        else if(contains(TriggerTools::ele_muo_triggers(), t))    type = TrigEleMuo;
+        m_triggerTypes.push_back(type);
+    }
+    m_triggerCounts.assign(m_triggers.size(), 0);
+    m_iEvent = 0;
+    m_started = true;
+}
+//----------------------------------------------------------
+float SusyNtGenerator::drawWeight()
+{
+    // NLO-like: mostly around 1, with a fraction of negative weights
+    float w = m_weightRandom.Gaus(1.0, 0.1);
+    return (m_weightRandom.Rndm() < 0.05 ? -w : w);
+}
+//----------------------------------------------------------
+void SusyNtGenerator::generateEvent()
+{
+    if(!m_started) start();
+    Event *evt = m_nt.evt();
+    vector<Electron> *electrons = m_nt.ele();
+    vector<Muon> *muons = m_nt.muo();
+    vector<Jet> *jets = m_nt.jet();
+    vector<Tau> *taus = m_nt.tau();
+    vector<Photon> *photons = m_nt.pho();
+    electrons->clear(); muons->clear(); jets->clear(); taus->clear(); photons->clear();
+    m_nt.tpr()->clear(); m_nt.tjt()->clear(); m_nt.tmt()->clear();
+
+    fillEvent(*evt);
+
+    vector<float> pts = drawPts(m_meanElectrons, 10.0, 25.0);
+    electrons->resize(pts.size());
+    for(size_t i=0; i<pts.size(); ++i) fillElectron(electrons->at(i), i, pts[i]);
+
+    pts = drawPts(m_meanMuons, 10.0, 25.0);
+    muons->resize(pts.size());
+    for(size_t i=0; i<pts.size(); ++i) fillMuon(muons->at(i), i, pts[i]);
+
+    pts = drawPts(m_meanJets, 20.0, 40.0);
+    jets->resize(pts.size());
+    for(size_t i=0; i<pts.size(); ++i) fillJet(jets->at(i), pts[i]);
+    // the electrons are also in the jet collection, about half of the time above the jet threshold
+    for(size_t i=0; i<electrons->size(); ++i) {
+        const Electron &ele = electrons->at(i);
+        const float pt = ele.pt*aroundOne(0.05);
+        if(pt<20.0 || !pass(0.5)) continue;
+        Jet jet;
+        fillJet(jet, pt);
+        jet.eta = jet.detEta = ele.eta;
+        jet.phi = ele.phi;
+        jet.emfrac = 0.95;
+        jet.truthLabel = 0;
+        jet.mv2c10 = m_random.Gaus(-0.6, 0.2);
+        jet.bjet = false;
+        jet.resetTLV();
+        jets->push_back(jet);
+    }
+    sortByPt(*jets);
+    for(size_t i=0; i<jets->size(); ++i) jets->at(i).idx = i;
+
+    pts = drawPts(m_meanTaus, 20.0, 30.0);
+    taus->resize(pts.size());
+    for(size_t i=0; i<pts.size(); ++i) fillTau(taus->at(i), pts[i]);
+
+    pts = drawPts(m_meanPhotons, 25.0, 30.0);
+    photons->resize(pts.size());
+    for(size_t i=0; i<pts.size(); ++i) fillPhoton(photons->at(i), pts[i]);
+
+    fillMet();
+    fillTriggers(*evt);
+    m_iEvent++;
+}
+//----------------------------------------------------------
+std::vector<float> SusyNtGenerator::drawPts(double mean, float ptMin, float ptSlope)
+{
+    vector<float> pts(mean>0 ? m_random.Poisson(mean) : 0);
+    for(size_t i=0; i<pts.size(); ++i) pts[i] = ptMin + m_random.Exp(ptSlope);
+    std::sort(pts.begin(), pts.end(), std::greater<float>());
+    return pts;
+}
+//----------------------------------------------------------
+void SusyNtGenerator::setKinematics(Particle &p, float pt, float etaMax, float m)
+{
+    p.pt = pt;
+    p.eta = m_random.Uniform(-etaMax, etaMax);
+    p.phi = m_random.Uniform(-TMath::Pi(), TMath::Pi());
+    p.m = m;
+    p.resetTLV();
+}
+//----------------------------------------------------------
+void SusyNtGenerator::fillEvent(Event &evt)
+{
+    evt.clear();
+    evt.trigBits.reset();
+    evt.isMC = m_isMC;
+    evt.run = m_run ? m_run : (m_isMC ? 284500 : 303638);
+    evt.eventNumber = m_iEvent+1;
+    evt.lb = 1 + m_iEvent/1000;
+    evt.treatAsYear = (evt.run<290000 ? 2015 : 2016);
+    evt.stream = (m_isMC ? Stream_MC : Stream_PhysicsMain);
+    evt.nVtx = 1 + m_random.Poisson(14.0);
+    evt.avgMu = std::max(1.0, m_random.Gaus(24.0, 8.0));
+    evt.avgMuDataSF = evt.avgMu/1.09;
+    if(m_isMC) {
+        evt.mcChannel = m_mcChannel;
+        evt.w = drawWeight();
+        evt.initialNumberOfEvents = m_nEvents;
+        evt.sumOfEventWeights = (m_sumw<0 ? m_sumWeights : m_sumw);
+        evt.sumOfEventWeightsSquared = m_sumWeightsSquared;
+        evt.wPileup = aroundOne(0.2);
+        evt.wPileup_up = evt.wPileup*aroundOne(0.05);
+        evt.wPileup_dn = evt.wPileup*aroundOne(0.05);
+        evt.xsec = 1.0;
+        evt.sumw = evt.sumOfEventWeights;
+    } else {
+        evt.w = 1;
+    }
+    // one bit per cleaning cut, set when the event passes it
+    unsigned int flags = 0;
+    for(int bit=0; bit<12; ++bit)
+        if(pass(0.998)) flags |= (1u << bit);
+    std::fill(evt.cutFlags, evt.cutFlags + NtSys::SYS_UNKNOWN, flags);
+}
+//----------------------------------------------------------
+void SusyNtGenerator::fillElectron(Electron &ele, int idx, float pt)
+{
+    ele.clear();
+    setKinematics(ele, pt, 2.47, electronMass);
+    ele.idx = idx;
+    ele.q = pass(0.5) ? 1 : -1;
+    ele.author = 1;
+    ele.authorElectron = true;
+    ele.clusE = ele.E();
+    ele.clusEta = ele.clusEtaBE = ele.eta;
+    ele.clusPhi = ele.clusPhiBE = ele.phi;
+    ele.trackPt = pt*aroundOne(0.05);
+    ele.trackEta = ele.eta;
+    const double u = m_random.Rndm(); // nested working points
+    ele.veryLooseLLH = u<0.98;
+    ele.looseLLH = u<0.95;
+    ele.looseLLHBLayer = u<0.93;
+    ele.mediumLLH = u<0.80;
+    ele.tightLLH = u<0.65;
+    ele.passOQBadClusElectron = pass(0.995);
+    const double v = m_random.Rndm();
+    ele.isoLoose = ele.isoGradientLoose = ele.isoLooseTrackOnly = v<0.90;
+    ele.isoGradient = v<0.85;
+    ele.isoFixedCutTightTrackOnly = v<0.75;
+    ele.isoGradientLooseCloseBy = ele.isoGradientLoose;
+    ele.isoFixedCutTightTrackOnlyCloseBy = ele.isoFixedCutTightTrackOnly;
+    ele.ptcone20 = ele.ptvarcone20 = pt*m_random.Exp(0.03);
+    ele.ptcone30 = ele.ptvarcone30 = ele.ptcone20*aroundOne(0.2);
+    ele.etconetopo20 = pt*m_random.Exp(0.05);
+    ele.etconetopo30 = ele.etconetopo20*aroundOne(0.2);
+    ele.errD0 = 0.02;
+    ele.d0 = m_random.Gaus(0.0, 0.03);
+    ele.d0sigBSCorr = m_random.Gaus(0.0, 1.5);
+    ele.errZ0 = 0.05;
+    ele.z0 = m_random.Gaus(0.0, 0.3);
+    ele.passChargeFlipTagger = pass(0.98);
+    ele.truthCharge = ele.q;
+    ele.effSF = aroundOne(0.02);
+    ele.res_all_dn = aroundOne(0.01);
+    ele.res_all_up = aroundOne(0.01);
+    ele.scale_all_dn = 1.0 - std::abs(m_random.Gaus(0.0, 0.005));
+    ele.scale_all_up = 1.0 + std::abs(m_random.Gaus(0.0, 0.005));
+    const size_t n = Susy::ElectronId::ElectronIdInvalid;
+    for(size_t i=0; i<n; ++i) {
+        ele.eleEffSF.push_back(aroundOne(0.02));
+        ele.eleTrigSF_single.push_back(aroundOne(0.02));
+        ele.eleTrigSF_double.push_back(aroundOne(0.02));
+        ele.eleTrigSF_mixed.push_back(aroundOne(0.02));
+        ele.eleCHFSF.push_back(aroundOne(0.02));
+    }
+    if(m_systematics) {
+        vector<float>* errors[] = {&ele.errEffSF_id_up, &ele.errEffSF_id_dn, &ele.errEffSF_reco_up, &ele.errEffSF_reco_dn,
+                                   &ele.errEffSF_iso_up, &ele.errEffSF_iso_dn,
+                                   &ele.errEffSF_trig_up_single, &ele.errEffSF_trig_dn_single,
+                                   &ele.errEffSF_trig_up_double, &ele.errEffSF_trig_dn_double,
+                                   &ele.errEffSF_trig_up_mixed, &ele.errEffSF_trig_dn_mixed};
+        const size_t nErrors = sizeof(errors)/sizeof(errors[0]);
+        for(size_t iError=0; iError<nErrors; ++iError) { // alternating up, down
+            errors[iError]->resize(n);
+            for(size_t i=0; i<n; ++i) (*errors[iError])[i] = (iError%2==0 ? 1 : -1)*std::abs(m_random.Gaus(0.0, 0.01));
+        }
+    }
+}
+//----------------------------------------------------------
+void SusyNtGenerator::fillMuon(Muon &muo, int idx, float pt)
+{
+    muo.clear();
+    setKinematics(muo, pt, 2.7, muonMass);
+    muo.idx = idx;
+    muo.q = pass(0.5) ? 1 : -1;
+    muo.isCombined = pass(0.95);
+    muo.isCaloTagged = !muo.isCombined && std::abs(muo.eta)<0.1;
+    muo.isSiForward = !muo.isCombined && std::abs(muo.eta)>2.5;
+    muo.idTrackPt = pt*aroundOne(0.02);
+    muo.idTrackEta = muo.eta;
+    muo.idTrackPhi = muo.phi;
+    muo.idTrackQ = muo.q;
+    muo.idTrackTheta = 2.0*atan(exp(-muo.eta));
+    muo.idTrackQoverP = muo.q/muo.P();
+    muo.msTrackPt = pt*aroundOne(0.05);
+    muo.msTrackEta = muo.eta;
+    muo.msTrackPhi = muo.phi;
+    muo.msTrackQ = muo.q;
+    muo.msTrackTheta = muo.idTrackTheta;
+    muo.msTrackQoverP = muo.idTrackQoverP;
+    const double u = m_random.Rndm(); // nested working points
+    muo.veryLoose = u<0.99;
+    muo.loose = u<0.97;
+    muo.medium = u<0.92;
+    muo.tight = u<0.80;
+    const double v = m_random.Rndm();
+    muo.isoLoose = muo.isoGradientLoose = muo.isoLooseTrackOnly = v<0.92;
+    muo.isoGradient = v<0.87;
+    muo.isoFixedCutTightTrackOnly = v<0.78;
+    muo.isoGradientLooseCloseBy = muo.isoGradientLoose;
+    muo.isoFixedCutTightTrackOnlyCloseBy = muo.isoFixedCutTightTrackOnly;
+    muo.ptcone20 = muo.ptvarcone20 = pt*m_random.Exp(0.03);
+    muo.ptcone30 = muo.ptvarcone30 = muo.ptcone20*aroundOne(0.2);
+    muo.etconetopo20 = pt*m_random.Exp(0.05);
+    muo.etconetopo30 = muo.etconetopo20*aroundOne(0.2);
+    muo.errD0 = 0.015;
+    muo.d0 = m_random.Gaus(0.0, 0.02);
+    muo.d0sigBSCorr = m_random.Gaus(0.0, 1.2);
+    muo.errZ0 = 0.04;
+    muo.z0 = m_random.Gaus(0.0, 0.2);
+    muo.isBadMuon = pass(0.001);
+    muo.isCosmic = pass(0.001);
+    muo.effSF = aroundOne(0.01);
+    muo.ms_up = aroundOne(0.005); muo.ms_dn = aroundOne(0.005);
+    muo.id_up = aroundOne(0.005); muo.id_dn = aroundOne(0.005);
+    muo.scale_up = 1.0 + std::abs(m_random.Gaus(0.0, 0.002));
+    muo.scale_dn = 1.0 - std::abs(m_random.Gaus(0.0, 0.002));
+    muo.sagitta_bias_up = aroundOne(0.002); muo.sagitta_bias_dn = aroundOne(0.002);
+    muo.sagitta_rho_up = aroundOne(0.002); muo.sagitta_rho_dn = aroundOne(0.002);
+    const size_t n = Susy::MuonId::MuonIdInvalid;
+    for(size_t i=0; i<n; ++i) {
+        muo.muoEffSF.push_back(aroundOne(0.01));
+        muo.muoTrigSF.push_back(aroundOne(0.02));
+    }
+    if(m_systematics) {
+        vector<float>* errors[] = {&muo.errEffSF_stat_up, &muo.errEffSF_stat_dn, &muo.errEffSF_syst_up, &muo.errEffSF_syst_dn,
+                                   &muo.errEffSF_stat_lowpt_up, &muo.errEffSF_stat_lowpt_dn,
+                                   &muo.errEffSF_syst_lowpt_up, &muo.errEffSF_syst_lowpt_dn,
+                                   &muo.errIso_stat_up, &muo.errIso_stat_dn, &muo.errIso_syst_up, &muo.errIso_syst_dn,
+                                   &muo.errTTVA_stat_up, &muo.errTTVA_stat_dn, &muo.errTTVA_syst_up, &muo.errTTVA_syst_dn,
+                                   &muo.errBadMu_stat_up, &muo.errBadMu_stat_dn, &muo.errBadMu_syst_up, &muo.errBadMu_syst_dn};
+        for(vector<float>* error : errors) {
+            error->resize(n);
+            for(size_t i=0; i<n; ++i) (*error)[i] = m_random.Gaus(0.0, 0.005);
+        }
+    }
+}
+//----------------------------------------------------------
+void SusyNtGenerator::fillJet(Jet &jet, float pt)
+{
+    jet.clear();
+    setKinematics(jet, pt, pass(0.8) ? 2.8 : 4.5, pt*m_random.Uniform(0.05, 0.15));
+    jet.detEta = jet.eta;
+    jet.emfrac = m_random.Uniform(0.1, 0.9);
+    const double flavor = m_random.Rndm();
+    jet.truthLabel = (flavor<0.10 ? 5 : (flavor<0.20 ? 4 : 0));
+    jet.matchTruth = pass(0.9);
+    jet.nTracks = m_random.Poisson(8.0);
+    jet.sumTrkPt = pt*m_random.Uniform(0.2, 0.8);
+    jet.mv2c10 = (jet.truthLabel==5 ? m_random.Gaus(0.9, 0.15) :
+                  jet.truthLabel==4 ? m_random.Gaus(0.2, 0.5) : m_random.Gaus(-0.6, 0.3));
+    jet.mv2c10 = std::max(-1.0f, std::min(1.0f, jet.mv2c10));
+    jet.bjet = (std::abs(jet.eta)<2.5 && jet.mv2c10>bTagCut);
+    jet.effscalefact = aroundOne(0.03);
+    // pileup jets at low pt
+    jet.jvt = (pt<60.0 && pass(0.15)) ? m_random.Uniform(0.0, 0.59) : m_random.Uniform(0.59, 1.0);
+    jet.jvf = jet.jvt;
+    jet.jvtEff = aroundOne(0.01);
+    jet.jvtEff_up = jet.jvtEff*aroundOne(0.01);
+    jet.jvtEff_dn = jet.jvtEff*aroundOne(0.01);
+    jet.isBadVeryLoose = pass(0.001);
+    jet.isHotTile = pass(0.0001);
+    jet.jer = aroundOne(0.03);
+    jet.eta_intercal_up = aroundOne(0.01);
+    jet.eta_intercal_dn = aroundOne(0.01);
+    if(m_systematics) {
+        jet.groupedNP.resize(6);
+        for(size_t i=0; i<jet.groupedNP.size(); ++i)
+            jet.groupedNP[i] = 1.0 + (i%2==0 ? 1 : -1)*std::abs(m_random.Gaus(0.0, 0.02));
+        jet.FTSys.resize(10);
+        for(size_t i=0; i<jet.FTSys.size(); ++i) jet.FTSys[i] = m_random.Gaus(0.0, 0.02);
+    }
+}
+//----------------------------------------------------------
+void SusyNtGenerator::fillTau(Tau &tau, float pt)
+{
+    tau.clear();
+    setKinematics(tau, pt, 2.47, tauMass);
+    tau.q = pass(0.5) ? 1 : -1;
+    tau.nTrack = pass(0.75) ? 1 : 3;
+    const double u = m_random.Rndm(); // nested working points
+    tau.loose = u<0.7;
+    tau.medium = u<0.55;
+    tau.tight = u<0.4;
+    tau.isTruthMatched = pass(0.5);
+    tau.isHadronicTau = tau.isTruthMatched;
+    tau.truthPdgId = tau.isTruthMatched ? -15*tau.q : 0;
+    tau.truthNProngs = tau.isTruthMatched ? tau.nTrack : 0;
+    tau.truthCharge = tau.isTruthMatched ? tau.q : 0;
+    tau.looseEffSF = aroundOne(0.03);
+    tau.mediumEffSF = aroundOne(0.03);
+    tau.tightEffSF = aroundOne(0.03);
+    tau.errLooseEffSF = tau.errMediumEffSF = tau.errTightEffSF = 0.03;
+    tau.sme_total_up = 1.0 + std::abs(m_random.Gaus(0.0, 0.02));
+    tau.sme_total_dn = 1.0 - std::abs(m_random.Gaus(0.0, 0.02));
+}
+//----------------------------------------------------------
+void SusyNtGenerator::fillPhoton(Photon &pho, float pt)
+{
+    pho.clear();
+    setKinematics(pho, pt, 2.37, 0.0);
+    pho.author = 4;
+    pho.authorPhoton = true;
+    pho.isConv = pass(0.3);
+    pho.loose = pass(0.9);
+    pho.tight = pho.loose && pass(0.8);
+    pho.clusE = pho.E();
+    pho.clusEta = pho.clusEtaBE = pho.eta;
+    pho.clusPhi = pho.clusPhiBE = pho.phi;
+    pho.OQ = pass(0.995);
+    const double v = m_random.Rndm();
+    pho.isoFixedCutLoose = v<0.9;
+    pho.isoFixedCutTight = v<0.8;
+    pho.isoFixedCutTightCaloOnly = v<0.8;
+    pho.topoEtcone40 = pt*m_random.Exp(0.05);
+}
+//----------------------------------------------------------
+void SusyNtGenerator::fillMet()
+{
+    struct Term {
+        double px, py, sumet;
+        Term() : px(0), py(0), sumet(0) {}
+        void add(const TLorentzVector &v) { px -= v.Px(); py -= v.Py(); sumet += v.Pt(); }
+        double et() const { return sqrt(px*px + py*py); }
+        double phi() const { return (px==0 && py==0) ? 0.0 : atan2(py, px); }
+    };
+    Term ele, muo, jet, gamma, tau, soft, trackJet;
+    for(const Electron &e : *m_nt.ele()) ele.add(e);
+    for(const Muon &m : *m_nt.muo()) muo.add(m);
+    for(const Jet &j : *m_nt.jet()) {
+        jet.add(j);
+        if(std::abs(j.eta)<2.5) trackJet.add(j);
+    }
+    for(const Photon &p : *m_nt.pho()) gamma.add(p);
+    for(const Tau &t : *m_nt.tau()) tau.add(t);
+    soft.px = m_random.Gaus(0.0, 10.0);
+    soft.py = m_random.Gaus(0.0, 10.0);
+    soft.sumet = 20.0 + m_random.Exp(30.0);
+    // invisible particles
+    const double nu = m_random.Exp(20.0), nuPhi = m_random.Uniform(-TMath::Pi(), TMath::Pi());
+    const double px = ele.px + muo.px + jet.px + gamma.px + tau.px + soft.px + nu*cos(nuPhi);
+    const double py = ele.py + muo.py + jet.py + gamma.py + tau.py + soft.py + nu*sin(nuPhi);
+
+    Met met;
+    met.Et = sqrt(px*px + py*py);
+    met.phi = atan2(py, px);
+    met.sumet = ele.sumet + muo.sumet + jet.sumet + gamma.sumet + tau.sumet + soft.sumet;
+    met.refEle_et = ele.et(); met.refEle_phi = ele.phi(); met.refEle_sumet = ele.sumet;
+    met.refMuo_et = muo.et(); met.refMuo_phi = muo.phi(); met.refMuo_sumet = muo.sumet;
+    met.refJet_et = jet.et(); met.refJet_phi = jet.phi(); met.refJet_sumet = jet.sumet;
+    met.refGamma_et = gamma.et(); met.refGamma_phi = gamma.phi(); met.refGamma_sumet = gamma.sumet;
+    met.refTau_et = tau.et(); met.refTau_phi = tau.phi(); met.refTau_sumet = tau.sumet;
+    met.softTerm_et = soft.et(); met.softTerm_phi = soft.phi(); met.softTerm_sumet = soft.sumet;
+    met.sys = NtSys::NOM;
+
+    const double tpx = ele.px + muo.px + trackJet.px + 0.6*soft.px + nu*cos(nuPhi);
+    const double tpy = ele.py + muo.py + trackJet.py + 0.6*soft.py + nu*sin(nuPhi);
+    TrackMet tkm;
+    tkm.Et = sqrt(tpx*tpx + tpy*tpy);
+    tkm.phi = atan2(tpy, tpx);
+    tkm.sumet = ele.sumet + muo.sumet + trackJet.sumet + 0.6*soft.sumet;
+    tkm.refEle_et = met.refEle_et; tkm.refEle_phi = met.refEle_phi; tkm.refEle_sumet = met.refEle_sumet;
+    tkm.refMuo_et = met.refMuo_et; tkm.refMuo_phi = met.refMuo_phi; tkm.refMuo_sumet = met.refMuo_sumet;
+    tkm.refJet_et = trackJet.et(); tkm.refJet_phi = trackJet.phi(); tkm.refJet_sumet = trackJet.sumet;
+    tkm.softTerm_et = 0.6*soft.et(); tkm.softTerm_phi = soft.phi(); tkm.softTerm_sumet = 0.6*soft.sumet;
+    tkm.sys = NtSys::NOM;
+
+    vector<Met> *mets = m_nt.met();
+    vector<TrackMet> *tkms = m_nt.tkm();
+    mets->assign(1, met);
+    tkms->assign(1, tkm);
+    if(!m_systematics) return;
+    const vector<NtSys::SusyNtSys> &systematics = metSystematics();
+    for(size_t i=0; i<systematics.size(); ++i) {
+        Met shifted = met;
+        const float sf = aroundOne(0.03);
+        shifted.Et *= sf;
+        shifted.sumet *= sf;
+        shifted.phi += m_random.Gaus(0.0, 0.02);
+        shifted.sys = systematics[i];
+        mets->push_back(shifted);
+        TrackMet tkmShifted = tkm;
+        tkmShifted.Et *= sf;
+        tkmShifted.sumet *= sf;
+        tkmShifted.sys = systematics[i];
+        tkms->push_back(tkmShifted);
+    }
+}
+//----------------------------------------------------------
+void SusyNtGenerator::fillTriggers(Event &evt)
+{
+    vector<Electron> &electrons = *m_nt.ele();
+    vector<Muon> &muons = *m_nt.muo();
+    for(Electron &e : electrons) e.trigBits.reset();
+    for(Muon &m : muons) m.trigBits.reset();
+    const float leadEle = electrons.size() ? electrons[0].pt : 0.0;
+    const float leadMuo = muons.size() ? muons[0].pt : 0.0;
+    const float subleadEle = electrons.size()>1 ? electrons[1].pt : 0.0;
+    const float subleadMuo = muons.size()>1 ? muons[1].pt : 0.0;
+    const float met = m_nt.met()->at(0).Et;
+    const float eleMatchPt = TriggerTools::ele_match_pt();
+    const float muoMatchPt = TriggerTools::muo_match_pt();
+    evt.trigFlags = 0;
+    for(size_t iTrig=0; iTrig<m_triggers.size(); ++iTrig) {
+        const float threshold = leadingThreshold(m_triggers[iTrig]) + 1.0;
+        const TriggerType type = m_triggerTypes[iTrig];
+        bool active = false;
+        switch(type) {
+        case TrigSingleEle: active = leadEle>threshold; break;
+        case TrigSingleMuo: active = leadMuo>threshold; break;
+        case TrigDiEle:     active = leadEle>threshold && subleadEle>eleMatchPt; break;
+        case TrigDiMuo:     active = leadMuo>threshold && subleadMuo>muoMatchPt; break;
+        case TrigEleMuo:    active = leadEle>threshold && leadMuo>muoMatchPt; break;
+        case TrigMet:       active = met>threshold; break;
+        }
+        if(!(active ? pass(m_triggerEfficiency) : pass(0.002))) continue;
+        evt.trigBits.set(iTrig);
+        if(iTrig<63) evt.trigFlags |= (1LL << iTrig);
+        m_triggerCounts[iTrig]++;
+        // lepton matching, see TriggerTools::lepton_trigger_match and dilepton_trigger_match
+        if(type==TrigSingleEle)
+            for(Electron &e : electrons) if(e.pt>threshold && pass(0.95)) e.trigBits.set(iTrig);
+        if(type==TrigSingleMuo)
+            for(Muon &m : muons) if(m.pt>threshold && pass(0.95)) m.trigBits.set(iTrig);
+        const bool ee = type==TrigDiEle, mm = type==TrigDiMuo, em = type==TrigEleMuo;
+        if(!(ee || mm || em)) continue;
+        const size_t n0 = std::min<size_t>(mm ? muons.size() : electrons.size(), 16);
+        const size_t n1 = std::min<size_t>(ee ? electrons.size() : muons.size(), 16);
+        for(size_t i0=0; i0<n0; ++i0) {
+            const float pt0 = mm ? muons[i0].pt : electrons[i0].pt;
+            if(pt0<(mm ? muoMatchPt : eleMatchPt)) break;
+            for(size_t i1=(em ? 0 : i0+1); i1<n1; ++i1) {
+                const float pt1 = ee ? electrons[i1].pt : muons[i1].pt;
+                if(pt1<(ee ? eleMatchPt : muoMatchPt)) break;
+                if(!pass(0.95)) continue;
+                DileptonTrigTuple tuple = (iTrig << 8) | (i0 << 4) | i1;
+                evt.m_dilepton_trigger_matches[tuple] = 1;
+            }
+        }
+    }
+}
+//----------------------------------------------------------
@@ -1,8 +1,12 @@
 #include "SusyNtuple/SusyNtObject.h"
+#include "SusyNtuple/ReuseStorageStreamer.h"
+
+#include "TClass.h"
 
 using namespace std;
 using namespace Susy;
 
+#include <algorithm>
 #include <iostream>
 
 
@@ -60,6 +64,18 @@ void SusyNtObject::SetActive()
   tmt.SetActive(true);
 }
 
+/*--------------------------------------------------------------------------------*/
+// Set active only the named branches
+/*--------------------------------------------------------------------------------*/
+void SusyNtObject::SetActive(const std::vector<std::string> &branchNames)
+{
+  vector<D3PDReader::VarHandleBase*> vars = handles();
+  for(size_t i=0; i<vars.size(); ++i){
+    bool active = find(branchNames.begin(), branchNames.end(), string(vars[i]->GetName())) != branchNames.end();
+    vars[i]->SetActive(active);
+  }
+}
+
 /*--------------------------------------------------------------------------------*/
 // Connect the objects to an output tree
 /*--------------------------------------------------------------------------------*/
@@ -113,3 +129,71 @@ void SusyNtObject::clear()
   tjt()->clear();
   tmt()->clear();
 }
+
+/*--------------------------------------------------------------------------------*/
+// Read the current entry for the active branches
+/*--------------------------------------------------------------------------------*/
+void SusyNtObject::ReadActive()
+{
+  vector<D3PDReader::VarHandleBase*> vars = handles();
+  for(size_t i=0; i<vars.size(); ++i){
+    if(vars[i]->IsActive()) vars[i]->ReadCurrentEntry();
+  }
+}
+
+/*--------------------------------------------------------------------------------*/
+// List of the variable handles
+/*--------------------------------------------------------------------------------*/
+std::vector<D3PDReader::VarHandleBase*> SusyNtObject::handles()
+{
+  D3PDReader::VarHandleBase* vars[] = { &evt, &ele, &muo, &jet, &pho, &tau,
+                                        &met, &tkm, &tpr, &tjt, &tmt };
+  return vector<D3PDReader::VarHandleBase*>(vars, vars + sizeof(vars)/sizeof(vars[0]));
+}
+
+/*--------------------------------------------------------------------------------*/
+// In-place reading of the object vectors
+/*--------------------------------------------------------------------------------*/
+namespace {
+bool reuseStorageEnabled = false;
+
+template <class T>
+bool setReuseStorage(bool reuse)
+{
+  TClass *cl = TClass::GetClass(typeid(std::vector<T>));
+  if(!cl) return false;
+  TClassStreamer *current = cl->GetStreamer();
+  ReuseStorageStreamer<T> *installed = dynamic_cast<ReuseStorageStreamer<T>*>(current);
+  if(reuse && !installed) {
+    cl->AdoptStreamer(new ReuseStorageStreamer<T>(current ? current->Generate() : 0));
+  } else if(!reuse && installed) {
+    const TClassStreamer *original = installed->original();
+    cl->AdoptStreamer(original ? original->Generate() : 0);
+  } else {
+    return false;
+  }
+  return true;
+}
+}
+
+bool SusyNtObject::SetReuseStorage(bool reuse)
+{
+  bool changed = false;
+  changed |= setReuseStorage<Electron>(reuse);
+  changed |= setReuseStorage<Muon>(reuse);
+  changed |= setReuseStorage<Jet>(reuse);
+  changed |= setReuseStorage<Photon>(reuse);
+  changed |= setReuseStorage<Tau>(reuse);
+  changed |= setReuseStorage<Met>(reuse);
+  changed |= setReuseStorage<TrackMet>(reuse);
+  changed |= setReuseStorage<TruthParticle>(reuse);
+  changed |= setReuseStorage<TruthJet>(reuse);
+  changed |= setReuseStorage<TruthMet>(reuse);
+  reuseStorageEnabled = reuse;
+  return changed;
+}
+
+bool SusyNtObject::ReuseStorage()
+{
+  return reuseStorageEnabled;
+}
@@ -0,0 +1,299 @@
+#include "SusyNtuple/SusyNtSlimmer.h"
+#include "SusyNtuple/AsyncWriter.h"
+
+#include "TChain.h"
+#include "TFile.h"
+#include "TH1.h"
+#include "TKey.h"
+#include "TNamed.h"
+#include "TObjArray.h"
+#include "TTree.h"
+
+#include <algorithm>
+#include <iostream>
+#include <set>
+
+using Susy::SusyNtSlimmer;
+using Susy::SusyNtObject;
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+//----------------------------------------------------------
+SusyNtSlimmer::SusyNtSlimmer() :
+    m_outputFilename("susyNt_slim.root"),
+    m_stripSys(false),
+    m_verbose(false),
+    m_asyncQueue(0),
+    m_imtThreads(0),
+    m_entry(0),
+    m_nt(m_entry),
+    m_nRead(0),
+    m_nWritten(0)
+{
+}
+//----------------------------------------------------------
+SusyNtSlimmer& SusyNtSlimmer::setSystematicsToKeep(const std::vector<NtSys::SusyNtSys> &value)
+{
+    m_stripSys = true;
+    m_sysToKeep.clear();
+    m_sysToKeep.insert(NtSys::NOM);
+    m_sysToKeep.insert(value.begin(), value.end());
+    return *this;
+}
+//----------------------------------------------------------
+Long64_t SusyNtSlimmer::process(TChain* chain, Long64_t nEntries)
+{
+    m_nRead = m_nWritten = 0;
+    Long64_t nChainEntries = chain->GetEntries();
+    if(nEntries<0 || nEntries>nChainEntries) nEntries = nChainEntries;
+    if(!collectSumw(chain)) return -1;
+
+    TDirectory *pwd = gDirectory;
+    TFile *output = TFile::Open(m_outputFilename.c_str(), "recreate");
+    if(!output || output->IsZombie()) {
+        cout<<"SusyNtSlimmer::process: cannot open output file '"<<m_outputFilename<<"'"<<endl;
+        return -1;
+    }
+    m_writerOptions.apply(output);
+    output->cd();
+    TTree *outputTree = new TTree(chain->GetName(), chain->GetTitle());
+    outputTree->SetDirectory(output);
+    m_writerOptions.apply(outputTree);
+
+    m_nt.ReadFrom(chain);
+    chain->LoadTree(0);
+    configureBranches();
+    if(m_asyncQueue>0) {
+        processAsync(chain, nEntries, outputTree);
+    } else {
+        m_writerOptions.apply(m_nt);
+        m_nt.WriteTo(outputTree);
+        for(Long64_t iEntry=0; iEntry<nEntries; ++iEntry) {
+            m_entry = chain->LoadTree(iEntry);
+            if(m_entry<0) break;
+            m_nRead++;
+            if(m_filter && !m_filter(m_nt)) continue;
+            m_nt.ReadActive();
+            fixSumw();
+            if(m_stripSys) stripSystematics();
+            prepareEvent();
+            outputTree->Fill();
+            m_nWritten++;
+        }
+    }
+    output->cd();
+    outputTree->Write(0, TObject::kOverwrite);
+    bool success = copyMetadata(chain, output);
+    if(m_stripSys) {
+        string names;
+        for(std::set<NtSys::SusyNtSys>::const_iterator it=m_sysToKeep.begin(); it!=m_sysToKeep.end(); ++it)
+            names += (names.empty() ? "" : ",") + NtSys::SusyNtSysNames.at(*it);
+        TNamed kept("keptSystematics", names.c_str());
+        output->cd();
+        kept.Write(0, TObject::kOverwrite);
+    }
+    output->Close();
+    delete output;
+    pwd->cd();
+    if(m_verbose)
+        cout<<"SusyNtSlimmer::process: wrote "<<m_nWritten<<" out of "<<m_nRead<<" events"
+            <<" to '"<<m_outputFilename<<"'"<<endl;
+    return success ? m_nWritten : -1;
+}
+//----------------------------------------------------------
+Long64_t SusyNtSlimmer::processAsync(TChain* chain, Long64_t nEntries, TTree* outputTree)
+{
+    // the writer fills the tree from its own objects, with the active branches of m_nt
+    SusyNtObject out;
+    vector<D3PDReader::VarHandleBase*> inVars = m_nt.handles();
+    vector<D3PDReader::VarHandleBase*> outVars = out.handles();
+    for(size_t i=0; i<inVars.size(); ++i) outVars[i]->SetActive(inVars[i]->IsActive());
+    m_writerOptions.apply(out);
+    out.WriteTo(outputTree);
+
+    AsyncWriter writer(m_asyncQueue);
+    writer.setImplicitMT(m_imtThreads);
+    vector<EventContents> slots(writer.capacity());
+    writer.start();
+    for(Long64_t iEntry=0; iEntry<nEntries; ++iEntry) {
+        m_entry = chain->LoadTree(iEntry);
+        if(m_entry<0) break;
+        m_nRead++;
+        if(m_filter && !m_filter(m_nt)) continue;
+        m_nt.ReadActive();
+        fixSumw();
+        if(m_stripSys) stripSystematics();
+        prepareEvent();
+        const size_t slot = writer.acquire();
+        swapContents(m_nt, slots[slot]);
+        writer.submit(slot, [&out, &slots, outputTree, slot]() {
+                swapContents(out, slots[slot]);
+                outputTree->Fill();
+            });
+        m_nWritten++;
+    }
+    writer.finish();
+    if(m_verbose) writer.print(cout);
+    return m_nWritten;
+}
+//----------------------------------------------------------
+void SusyNtSlimmer::swapContents(SusyNtObject &nt, EventContents &c)
+{
+    if(nt.evt.IsActive()) std::swap(*nt.evt(), c.evt);
+    if(nt.ele.IsActive()) nt.ele()->swap(c.ele);
+    if(nt.muo.IsActive()) nt.muo()->swap(c.muo);
+    if(nt.jet.IsActive()) nt.jet()->swap(c.jet);
+    if(nt.pho.IsActive()) nt.pho()->swap(c.pho);
+    if(nt.tau.IsActive()) nt.tau()->swap(c.tau);
+    if(nt.met.IsActive()) nt.met()->swap(c.met);
+    if(nt.tkm.IsActive()) nt.tkm()->swap(c.tkm);
+    if(nt.tpr.IsActive()) nt.tpr()->swap(c.tpr);
+    if(nt.tjt.IsActive()) nt.tjt()->swap(c.tjt);
+    if(nt.tmt.IsActive()) nt.tmt()->swap(c.tmt);
+}
+//----------------------------------------------------------
+void SusyNtSlimmer::configureBranches()
+{
+    vector<D3PDReader::VarHandleBase*> vars = m_nt.handles();
+    for(size_t i=0; i<vars.size(); ++i) {
+        string name = vars[i]->GetName();
+        bool requested = (m_branchesToKeep.empty() ||
+                          std::find(m_branchesToKeep.begin(), m_branchesToKeep.end(), name)!=m_branchesToKeep.end());
+        bool dropped = std::find(m_branchesToDrop.begin(), m_branchesToDrop.end(), name)!=m_branchesToDrop.end();
+        bool available = vars[i]->IsAvailable();
+        vars[i]->SetActive(requested && !dropped && available);
+        if(m_verbose)
+            cout<<"SusyNtSlimmer: "<<(vars[i]->IsActive() ? "keeping " : "dropping ")<<name
+                <<(available ? "" : " (not in input)")<<endl;
+    }
+    if(!m_nt.evt.IsActive())
+        cout<<"SusyNtSlimmer: WARNING the 'event' branch is not being written;"
+            <<" the output cannot be read by SusyNtAna"<<endl;
+}
+//----------------------------------------------------------
+void SusyNtSlimmer::fixSumw()
+{
+    if(!m_nt.evt.IsActive()) return;
+    Susy::Event *evt = m_nt.evt();
+    std::map<SumwKey, SumwInfo>::const_iterator it = m_sumw.find(sumwKey(*evt));
+    if(!evt->isMC || it==m_sumw.end()) return;
+    evt->initialNumberOfEvents = it->second.initialNumberOfEvents;
+    evt->sumOfEventWeights = it->second.sumOfEventWeights;
+    evt->sumOfEventWeightsSquared = it->second.sumOfEventWeightsSquared;
+}
+//----------------------------------------------------------
+void SusyNtSlimmer::stripSystematics()
+{
+    if(m_nt.ele.IsActive())
+        for(size_t i=0; i<m_nt.ele()->size(); ++i) m_nt.ele()->at(i).stripSys(m_sysToKeep);
+    if(m_nt.muo.IsActive())
+        for(size_t i=0; i<m_nt.muo()->size(); ++i) m_nt.muo()->at(i).stripSys(m_sysToKeep);
+    if(m_nt.jet.IsActive())
+        for(size_t i=0; i<m_nt.jet()->size(); ++i) m_nt.jet()->at(i).stripSys(m_sysToKeep);
+    const std::set<NtSys::SusyNtSys> &keep = m_sysToKeep;
+    if(m_nt.met.IsActive()) {
+        vector<Susy::Met> *met = m_nt.met();
+        met->erase(std::remove_if(met->begin(), met->end(),
+                                  [&keep](const Susy::Met &m) { return !keep.count(static_cast<NtSys::SusyNtSys>(m.sys)); }),
+                   met->end());
+    }
+    if(m_nt.tkm.IsActive()) {
+        vector<Susy::TrackMet> *tkm = m_nt.tkm();
+        tkm->erase(std::remove_if(tkm->begin(), tkm->end(),
+                                  [&keep](const Susy::TrackMet &m) { return !keep.count(static_cast<NtSys::SusyNtSys>(m.sys)); }),
+                   tkm->end());
+    }
+}
+//----------------------------------------------------------
+bool SusyNtSlimmer::collectSumw(TChain* chain)
+{
+    // the sumw stored in the event is per input file and process: read it from the first event of each
+    m_sumw.clear();
+    TIter next(chain->GetListOfFiles());
+    while(TObject *element = next()) {
+        TFile *file = TFile::Open(element->GetTitle());
+        TTree *tree = (file ? static_cast<TTree*>(file->Get(chain->GetName())) : NULL);
+        if(!tree) {
+            cout<<"SusyNtSlimmer::collectSumw: cannot read tree '"<<chain->GetName()<<"'"
+                <<" from '"<<element->GetTitle()<<"'"<<endl;
+            delete file;
+            return false;
+        }
+        if(tree->GetEntries()>0) {
+            Susy::Event *evt = NULL;
+            tree->SetBranchStatus("*", 0);
+            tree->SetBranchStatus("event", 1);
+            tree->SetBranchAddress("event", &evt);
+            // one entry per process of the file: for the samples with several susyFinalState
+            // (signal) the events of the other processes have their own sumw
+            std::set<SumwKey> seen;
+            const Long64_t nEntries = tree->GetEntries();
+            for(Long64_t iEntry=0; iEntry<nEntries; ++iEntry) {
+                tree->GetEntry(iEntry);
+                if(!evt || !evt->isMC) break;
+                if(seen.insert(sumwKey(*evt)).second) {
+                    SumwInfo &info = m_sumw[sumwKey(*evt)];
+                    info.initialNumberOfEvents += evt->initialNumberOfEvents;
+                    info.sumOfEventWeights += evt->sumOfEventWeights;
+                    info.sumOfEventWeightsSquared += evt->sumOfEventWeightsSquared;
+                }
+                if(iEntry==0 && evt->susyFinalState<=0) break; // single process: the first event is enough
+            }
+            tree->ResetBranchAddresses();
+            delete evt;
+        }
+        file->Close();
+        delete file;
+    }
+    return true;
+}
+//----------------------------------------------------------
+bool SusyNtSlimmer::copyMetadata(TChain* chain, TFile* output)
+{
+    TObjArray histograms;
+    histograms.SetOwner(kTRUE);
+    bool isFirstFile = true;
+    TIter next(chain->GetListOfFiles());
+    while(TObject *element = next()) {
+        TFile *file = TFile::Open(element->GetTitle());
+        if(!file) {
+            cout<<"SusyNtSlimmer::copyMetadata: cannot open '"<<element->GetTitle()<<"'"<<endl;
+            return false;
+        }
+        std::set<string> names; // the list of keys includes all the cycles; use only the latest one
+        TIter nextKey(file->GetListOfKeys());
+        while(TKey *key = static_cast<TKey*>(nextKey())) {
+            string name = key->GetName();
+            if(names.count(name) || name==chain->GetName()) continue;
+            names.insert(name);
+            TClass *cls = TClass::GetClass(key->GetClassName());
+            if(!cls || cls->InheritsFrom(TTree::Class())) continue;
+            if(cls->InheritsFrom(TH1::Class())) {
+                TH1 *h = static_cast<TH1*>(key->ReadObj());
+                h->SetDirectory(0);
+                if(TH1 *sum = static_cast<TH1*>(histograms.FindObject(name.c_str()))) {
+                    sum->Add(h);
+                    delete h;
+                } else {
+                    histograms.Add(h);
+                }
+            } else if(isFirstFile) {
+                TObject *obj = key->ReadObj();
+                output->cd();
+                obj->Write(name.c_str());
+                delete obj;
+            }
+        }
+        file->Close();
+        delete file;
+        isFirstFile = false;
+    }
+    output->cd();
+    for(Int_t i=0; i<histograms.GetEntriesFast(); ++i)
+        histograms.At(i)->Write();
+    return true;
+}
+//----------------------------------------------------------
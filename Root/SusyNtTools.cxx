@@ -1,7 +1,9 @@
 #include <set>
+#include <sstream>
 
 #include "TFile.h"
 #include "TKey.h"
+#include "TNamed.h"
 #include "TChainElement.h"
 #include "TH1F.h"
 #include "TSystem.h"
@@ -33,7 +35,8 @@ SusyNtTools::SusyNtTools() :
     m_overlapTool(nullptr),
     m_anaType(AnalysisType::kUnknown),
     m_doSFOS(false),
-    n_warning(0)
+    n_warning(0),
+    m_sysStripped(false)
 {
 }
 //----------------------------------------------------------
@@ -70,6 +73,7 @@ void SusyNtTools::setAnaType(AnalysisType a, bool verbose)
     m_overlapTool->setElectronIsolation(electronSelector().signalIsolation());
     m_overlapTool->setMuonIsolation(muonSelector().signalIsolation());
     m_overlapTool->jetSelector(m_jetSelector);
+    m_objectStatus.clear();
 
     // set whether to perform SFOS removal on baseline objects
     setSFOSRemoval(a);
@@ -189,6 +193,7 @@ void SusyNtTools::setSFOSRemoval(AnalysisType a)
 void SusyNtTools::getPreObjects(SusyNtObject* susyNt, SusyNtSys sys,
         ElectronVector& preElectrons, MuonVector& preMuons, JetVector& preJets, TauVector& preTaus, PhotonVector& prePhotons)
 {
+    m_objectStatus.clear();
     preElectrons = getPreElectrons(susyNt, sys);
     preMuons     = getPreMuons(susyNt, sys);
     preJets      = getPreJets(susyNt, sys);
@@ -220,6 +225,48 @@ void SusyNtTools::getSignalObjects(const ElectronVector& baseElectrons, const Mu
     signalPhotons   = getSignalPhotons(basePhotons);
 }
 /*--------------------------------------------------------------------------------*/
+namespace {
+/// pointer to the first object of v, or 0
+template<class T>
+const T* first(const std::vector<T>* v) { return (v && !v->empty()) ? &v->front() : 0; }
+/// set OverlapSurvivor on the objects of survivors, and Signal on those that also pass the signal selection
+template<class T>
+void markSurvivors(ObjectStatus::Collection<T>& status, const std::vector<T*>& survivors)
+{
+    for(size_t i=0; i<survivors.size(); ++i) status.set(survivors[i], ObjectStatus::OverlapSurvivor);
+    const uint8_t signal = ObjectStatus::OverlapSurvivor | ObjectStatus::PassSignal;
+    std::vector<uint8_t>& bits = status.bits();
+    for(size_t i=0; i<bits.size(); ++i)
+        if((bits[i] & signal)==signal) bits[i] |= ObjectStatus::Signal;
+}
+}
+/*--------------------------------------------------------------------------------*/
+const ObjectStatus& SusyNtTools::classifyObjects(SusyNtObject* susyNt, SusyNtSys sys)
+{
+    if(!isSysAvailable(sys)) sys = NtSys::NOM;
+    m_objectStatus.electrons.reset(getPreElectrons(susyNt, sys), first(susyNt->ele()));
+    m_objectStatus.muons.reset(getPreMuons(susyNt, sys), first(susyNt->muo()));
+    m_objectStatus.jets.reset(getPreJets(susyNt, sys), first(susyNt->jet()));
+    m_objectStatus.taus.reset(getPreTaus(susyNt, sys), first(susyNt->tau()));
+    m_objectStatus.photons.reset(getPrePhotons(susyNt, sys), first(susyNt->pho()));
+    electronSelector().classify(m_objectStatus.electrons);
+    muonSelector().classify(m_objectStatus.muons);
+    jetSelector().classify(m_objectStatus.jets);
+    tauSelector().classify(m_objectStatus.taus);
+    photonSelector().classify(m_objectStatus.photons);
+    return m_objectStatus;
+}
+/*--------------------------------------------------------------------------------*/
+void SusyNtTools::markOverlapSurvivors(const ElectronVector& baseElectrons, const MuonVector& baseMuons, const JetVector& baseJets,
+                                       const TauVector& baseTaus, const PhotonVector& basePhotons)
+{
+    markSurvivors(m_objectStatus.electrons, baseElectrons);
+    markSurvivors(m_objectStatus.muons, baseMuons);
+    markSurvivors(m_objectStatus.jets, baseJets);
+    markSurvivors(m_objectStatus.taus, baseTaus);
+    markSurvivors(m_objectStatus.photons, basePhotons);
+}
+/*--------------------------------------------------------------------------------*/
 void SusyNtTools::buildLeptons(LeptonVector& leptons, const ElectronVector& electrons, const MuonVector& muons)
 {
     for(uint ie = 0; ie < electrons.size(); ie++) {
@@ -245,6 +292,44 @@ bool SusyNtTools::initTriggerTool(const std::string &anyInputFilename)
     return m_triggerTool.init(anyInputFilename);
 }
 //----------------------------------------------------------
+bool SusyNtTools::readKeptSystematics(TFile* file)
+{
+    m_sysStripped = false;
+    m_keptSys.clear();
+    TNamed* kept = (file ? dynamic_cast<TNamed*>(file->Get("keptSystematics")) : NULL);
+    if(!kept) return false;
+    m_sysStripped = true;
+    m_keptSys.insert(NtSys::NOM);
+    std::istringstream names(kept->GetTitle());
+    string name;
+    while(std::getline(names, name, ',')) {
+        bool found = false;
+        for(const auto &sn : NtSys::SusyNtSysNames) {
+            if(sn.second==name) { m_keptSys.insert(sn.first); found = true; break; }
+        }
+        if(!found)
+            cout<<"SusyNtTools::readKeptSystematics: WARNING unknown systematic '"<<name<<"' in "
+                <<file->GetName()<<endl;
+    }
+    delete kept;
+    return true;
+}
+//----------------------------------------------------------
+bool SusyNtTools::isSysAvailable(SusyNtSys sys)
+{
+    if(sys == NtSys::NOM || !m_sysStripped || m_keptSys.count(sys)) return true;
+    warnMissingSys(sys);
+    return false;
+}
+//----------------------------------------------------------
+void SusyNtTools::warnMissingSys(SusyNtSys sys)
+{
+    if(!m_warnedSys.insert(sys).second) return;
+    auto it = NtSys::SusyNtSysNames.find(sys);
+    cout<<"SusyNtTools: WARNING systematic "<<(it!=NtSys::SusyNtSysNames.end() ? it->second : std::to_string(sys))
+        <<" is not in the input (see SusyNtSlimmer::setSystematicsToKeep), using the nominal"<<endl;
+}
+//----------------------------------------------------------
 /*--------------------------------------------------------------------------------*/
 // Methods to grab the Baseline objects
 /*--------------------------------------------------------------------------------*/
@@ -252,6 +337,8 @@ ElectronVector SusyNtTools::getPreElectrons(SusyNtObject* susyNt, SusyNtSys sys)
 {
     // Not sure if I want to pass SusyNt object around or not... but just do it this way
     // for now for lack of a more creative idea.
+    // setState changes the objects: forget their classification (see classifyObjects)
+    m_objectStatus.electrons.clear();
     ElectronVector elecs;
     for (uint ie = 0; ie < susyNt->ele()->size(); ++ie) {
         Electron* e = &susyNt->ele()->at(ie);
@@ -267,12 +354,7 @@ ElectronVector SusyNtTools::getPreElectrons(SusyNtObject* susyNt, SusyNtSys sys)
 ElectronVector SusyNtTools::getBaselineElectrons(const ElectronVector& preElecs)
 {
     ElectronVector elecs;
-    for (uint ie = 0; ie < preElecs.size(); ++ie) {
-        Electron* e = preElecs.at(ie);
-        if(electronSelector().isBaseline(e)){
-            elecs.push_back(e);
-        }
-    } // ie
+    electronSelector().selectBaseline(preElecs, elecs);
     // sort by pT
     std::sort(elecs.begin(), elecs.end(), comparePt);
 
@@ -281,6 +363,7 @@ ElectronVector SusyNtTools::getBaselineElectrons(const ElectronVector& preElecs)
 /*--------------------------------------------------------------------------------*/
 MuonVector SusyNtTools::getPreMuons(SusyNtObject* susyNt, SusyNtSys sys)
 {
+    m_objectStatus.muons.clear();
     MuonVector muons;
     for (uint im = 0; im < susyNt->muo()->size(); ++im) {
         Muon* mu = &susyNt->muo()->at(im);
@@ -296,12 +379,7 @@ MuonVector SusyNtTools::getPreMuons(SusyNtObject* susyNt, SusyNtSys sys)
 MuonVector SusyNtTools::getBaselineMuons(const MuonVector& preMuons)
 {
     MuonVector baseMuons;
-    for (uint im = 0; im < preMuons.size(); ++im) {
-        Muon* mu = preMuons.at(im);
-        if(muonSelector().isBaseline(mu)){
-            baseMuons.push_back(mu);
-        }
-    } // im
+    muonSelector().selectBaseline(preMuons, baseMuons);
     // sort by pT
     std::sort(baseMuons.begin(), baseMuons.end(), comparePt);
 
@@ -311,12 +389,7 @@ MuonVector SusyNtTools::getBaselineMuons(const MuonVector& preMuons)
 TauVector SusyNtTools::getBaselineTaus(const TauVector& preTaus)
 {
     TauVector baseTaus;
-    for (uint iTau = 0; iTau < preTaus.size(); iTau++) {
-        Tau* tau = preTaus.at(iTau);
-        if(tauSelector().isBaseline(tau)){
-            baseTaus.push_back(tau);
-        }
-    } // iTau
+    tauSelector().selectBaseline(preTaus, baseTaus);
     // sort by pT
     std::sort(baseTaus.begin(), baseTaus.end(), comparePt);
 
@@ -326,12 +399,7 @@ TauVector SusyNtTools::getBaselineTaus(const TauVector& preTaus)
 PhotonVector SusyNtTools::getBaselinePhotons(const PhotonVector& prePhotons)
 {
     PhotonVector basePhotons;
-    for(uint iPho = 0; iPho < prePhotons.size(); iPho++){
-        Photon* pho = prePhotons.at(iPho);
-        if(photonSelector().isBaseline(pho)){
-            basePhotons.push_back(pho);
-        }
-    } // iPho
+    photonSelector().selectBaseline(prePhotons, basePhotons);
     // sort by pT
     std::sort(basePhotons.begin(), basePhotons.end(), comparePt);
 
@@ -340,6 +408,7 @@ PhotonVector SusyNtTools::getBaselinePhotons(const PhotonVector& prePhotons)
 /*--------------------------------------------------------------------------------*/
 TauVector SusyNtTools::getPreTaus(SusyNtObject* susyNt, SusyNtSys sys)
 {
+    m_objectStatus.taus.clear();
     TauVector taus;
     for (uint iTau = 0; iTau < susyNt->tau()->size(); iTau++) {
         Tau* tau = &susyNt->tau()->at(iTau);
@@ -354,6 +423,7 @@ TauVector SusyNtTools::getPreTaus(SusyNtObject* susyNt, SusyNtSys sys)
 /*--------------------------------------------------------------------------------*/
 PhotonVector SusyNtTools::getPrePhotons(SusyNtObject* susyNt, SusyNtSys sys)
 {
+    m_objectStatus.photons.clear();
     PhotonVector photons;
     for(uint iPho = 0; iPho < susyNt->pho()->size(); iPho++) {
         Photon* photon = &susyNt->pho()->at(iPho);
@@ -368,6 +438,7 @@ PhotonVector SusyNtTools::getPrePhotons(SusyNtObject* susyNt, SusyNtSys sys)
 /*--------------------------------------------------------------------------------*/
 JetVector SusyNtTools::getPreJets(SusyNtObject* susyNt, SusyNtSys sys)
 {
+    m_objectStatus.jets.clear();
     JetVector jets;
     for (uint ij = 0; ij < susyNt->jet()->size(); ++ij) {
         Jet* j = &susyNt->jet()->at(ij);
@@ -383,12 +454,7 @@ JetVector SusyNtTools::getPreJets(SusyNtObject* susyNt, SusyNtSys sys)
 JetVector SusyNtTools::getBaselineJets(const JetVector& preJets)
 {
     JetVector baseJets;
-    for (uint ij = 0; ij < preJets.size(); ++ij) {
-        Jet* j = preJets.at(ij);
-        if(jetSelector().isBaseline(j)) {
-            baseJets.push_back(j);
-        }
-    } // ij
+    jetSelector().selectBaseline(preJets, baseJets);
     // sort by pT 
     std::sort(baseJets.begin(), baseJets.end(), comparePt);
 
@@ -400,12 +466,7 @@ JetVector SusyNtTools::getBaselineJets(const JetVector& preJets)
 ElectronVector SusyNtTools::getSignalElectrons(const ElectronVector& baseElecs)
 {
     ElectronVector sigElecs;
-    for (uint ie = 0; ie < baseElecs.size(); ++ie) {
-        Electron* e = baseElecs.at(ie);
-        if (electronSelector().isSignal(e)){
-            sigElecs.push_back(e);
-        }
-    }
+    electronSelector().selectSignal(baseElecs, sigElecs);
     // sort by pT
     std::sort(sigElecs.begin(), sigElecs.end(), comparePt);
 
@@ -415,12 +476,7 @@ ElectronVector SusyNtTools::getSignalElectrons(const ElectronVector& baseElecs)
 MuonVector SusyNtTools::getSignalMuons(const MuonVector& baseMuons)
 {
     MuonVector sigMuons;
-    for (uint im = 0; im < baseMuons.size(); ++im) {
-        Muon* mu = baseMuons.at(im);
-        if (muonSelector().isSignal(mu)){
-            sigMuons.push_back(mu);
-        }
-    }
+    muonSelector().selectSignal(baseMuons, sigMuons);
     // sort by pT
     std::sort(sigMuons.begin(), sigMuons.end(), comparePt);
     
@@ -430,14 +486,7 @@ MuonVector SusyNtTools::getSignalMuons(const MuonVector& baseMuons)
 TauVector SusyNtTools::getSignalTaus(const TauVector& baseTaus)
 {
     TauVector sigTaus;
-    for (uint iTau = 0; iTau < baseTaus.size(); iTau++) {
-        Tau* tau = baseTaus[iTau];
-
-        if(tauSelector().isSignal(tau)) {
-            sigTaus.push_back(tau);
-        }
-    } // iTau
-
+    tauSelector().selectSignal(baseTaus, sigTaus);
     // sort by pT 
     std::sort(sigTaus.begin(), sigTaus.end(), comparePt);
 
@@ -447,12 +496,7 @@ TauVector SusyNtTools::getSignalTaus(const TauVector& baseTaus)
 PhotonVector SusyNtTools::getSignalPhotons(const PhotonVector& basePhotons)
 {
     PhotonVector sigPhotons;
-    for(uint iPho = 0; iPho < basePhotons.size(); iPho++) {
-        Photon* pho = basePhotons[iPho];
-        if(photonSelector().isSignal(pho)) {
-            sigPhotons.push_back(pho);
-        }
-    } // iPho
+    photonSelector().selectSignal(basePhotons, sigPhotons);
     // sort by pT
     std::sort(sigPhotons.begin(), sigPhotons.end(), comparePt);
     return sigPhotons;
@@ -461,12 +505,7 @@ PhotonVector SusyNtTools::getSignalPhotons(const PhotonVector& basePhotons)
 JetVector SusyNtTools::getSignalJets(const JetVector& baseJets)
 {
     JetVector sigJets;
-    for(uint ij=0; ij<baseJets.size(); ++ij){
-        Jet* j = baseJets.at(ij);
-        if(jetSelector().isSignal(j)) {
-            sigJets.push_back(j);
-        }
-    }
+    jetSelector().selectSignal(baseJets, sigJets);
     // sort by pT
     std::sort(sigJets.begin(), sigJets.end(), comparePt);
 
@@ -500,6 +539,10 @@ Met* SusyNtTools::getMet(SusyNtObject* susyNt, SusyNtSys sys)//, bool useNomPhiF
             return met;
         }
     }
+    // stripped from the input (see SusyNtSlimmer::setSystematicsToKeep): use the nominal
+    if (m_sysStripped && !isSysAvailable(sys)) {
+        return getMet(susyNt, NtSys::NOM);
+    }
     if (!met) {
         cout << "Error: Unable to find met for given systematic!  Returning NULL!! " << sys << endl;
     }
@@ -525,6 +568,11 @@ TrackMet* SusyNtTools::getTrackMet(SusyNtObject* susyNt, SusyNtSys sys)//, bool
             return metTrack;
         }
     }
+    // stripped from the input (see SusyNtSlimmer::setSystematicsToKeep): use the nominal
+    if (m_sysStripped && !isSysAvailable(sys))
+    {
+        return getTrackMet(susyNt, NtSys::NOM);
+    }
     if (!metTrack)
     {
         cout << "Error: Unable to find metTrack for given systematic!  Returning NULL!! " << sys << endl;
@@ -542,44 +590,53 @@ TrackMet* SusyNtTools::getTrackMet(SusyNtObject* susyNt, SusyNtSys sys)//, bool
 /*--------------------------------------------------------------------------------*/
 bool SusyNtTools::isSignal(const Lepton* l)
 {
-    if(l->isEle()) return electronSelector().isSignal((Electron*)l);
-    else           return muonSelector().isSignal((Muon*)l);
+    if(l->isEle()) return isSignal((const Electron*)l);
+    else           return isSignal((const Muon*)l);
 };
 /*--------------------------------------------------------------------------------*/
 bool SusyNtTools::isSignal(const Electron* e)
 {
+    uint8_t bits = m_objectStatus.electrons.status(e);
+    if(bits) return bits & ObjectStatus::PassSignal;
     return electronSelector().isSignal(e);
 }
 /*--------------------------------------------------------------------------------*/
 bool SusyNtTools::isSignal(const Muon* m)
 {
+    uint8_t bits = m_objectStatus.muons.status(m);
+    if(bits) return bits & ObjectStatus::PassSignal;
     return muonSelector().isSignal(m);
 }
 
 /*--------------------------------------------------------------------------------*/
 bool SusyNtTools::isSignal(const Tau* tau)
 {
+    uint8_t bits = m_objectStatus.taus.status(tau);
+    if(bits) return bits & ObjectStatus::PassSignal;
     return tauSelector().isSignal(tau);
 }
 /*--------------------------------------------------------------------------------*/
 int SusyNtTools::numberOfCLJets(const JetVector& jets)
 {
-    return jetSelector().count_CL_jets(jets);
+    int n = m_objectStatus.jets.count(jets, ObjectStatus::CentralLight);
+    return n>=0 ? n : jetSelector().count_CL_jets(jets);
 }
 /*--------------------------------------------------------------------------------*/
 int SusyNtTools::numberOfCBJets(const JetVector& jets)
 {
-    return jetSelector().count_CB_jets(jets);
+    int n = m_objectStatus.jets.count(jets, ObjectStatus::CentralB);
+    return n>=0 ? n : jetSelector().count_CB_jets(jets);
 }
 /*--------------------------------------------------------------------------------*/
 int SusyNtTools::numberOfFJets(const JetVector& jets)
 {
-    return jetSelector().count_F_jets(jets);
+    int n = m_objectStatus.jets.count(jets, ObjectStatus::Forward);
+    return n>=0 ? n : jetSelector().count_F_jets(jets);
 }
 /*--------------------------------------------------------------------------------*/
 int SusyNtTools::numBJets(const JetVector& jets)
 {
-    return jetSelector().count_CB_jets(jets);
+    return numberOfCBJets(jets);
 }
 /*--------------------------------------------------------------------------------*/
 bool SusyNtTools::hasBJet(const JetVector& jets)
@@ -591,7 +648,8 @@ JetVector SusyNtTools::getBJets(const JetVector& jets)
 {
     JetVector bJets;
     for(auto jet : jets) {
-        if (jetSelector().isCentralB(jet))
+        uint8_t bits = m_objectStatus.jets.status(jet);
+        if (bits ? (bits & ObjectStatus::CentralB) : jetSelector().isCentralB(jet))
             bJets.push_back(jet);
     }
     return bJets;
@@ -615,6 +673,7 @@ float SusyNtTools::bTagSF(const JetVector& jets)
 
 float SusyNtTools::bTagSFError(const JetVector& jets, const NtSys::SusyNtSys sys)
 {
+    if(!isSysAvailable(sys)) return bTagSF(jets);
     float outSF = 1.0;
     float delta = 0.0;
     float sf = 1.0;
@@ -645,6 +704,7 @@ float SusyNtTools::leptonEffSF(const Lepton* lep, const NtSys::SusyNtSys sys)
 
 float SusyNtTools::leptonEffSF(const Lepton& lep, const NtSys::SusyNtSys sys)
 {
+    if(!isSysAvailable(sys)) return leptonEffSF(lep, NtSys::NOM);
     float sf = 1.0;
     if(lep.isEle()) {
         sf = electronSelector().effSF((Electron&)lep, sys);
@@ -657,6 +717,7 @@ float SusyNtTools::leptonEffSF(const Lepton& lep, const NtSys::SusyNtSys sys)
 
 float SusyNtTools::leptonEffSFError(const Lepton& lep, const NtSys::SusyNtSys sys)
 {
+    if(!isSysAvailable(sys)) return 0.0;
     float delta = 0.0;
     if(lep.isEle()){
         delta = electronSelector().errEffSF((Electron&)lep, sys);
@@ -668,6 +729,7 @@ float SusyNtTools::leptonEffSFError(const Lepton& lep, const NtSys::SusyNtSys sy
 float SusyNtTools::leptonTriggerSF(const LeptonVector& leptons, std::string trigger,
         const NtSys::SusyNtSys sys)
 {
+    if(!isSysAvailable(sys)) return leptonTriggerSF(leptons, trigger, NtSys::NOM);
     string hlt = "HLT_";
     bool has_hlt_start = (trigger.find(hlt) != std::string::npos);
     if(!has_hlt_start) {
@@ -778,7 +840,7 @@ float SusyNtTools::get_single_muon_trigger_scale_factor(const MuonVector& muons,
         double eff_data = 1.0;
         double eff_mc = 1.0;
         if(id == MuonId::Medium) {
-            if(sys == NtSys::NOM) {
+            if(sys == NtSys::NOM || !m->hasSys(sys)) { // stripped variations fall back to nominal
                 eff_data = m->muoTrigEffData_medium[idx];
                 eff_mc = m->muoTrigEffMC_medium[idx];
             }
@@ -868,7 +930,7 @@ float SusyNtTools::get_dimuon_trigger_scale_factor(const MuonVector& muons, Muon
             double eff_data = 1.0;
             double eff_mc = 1.0;
             if(id == MuonId::Medium) {
-                if(sys == NtSys::NOM) {
+                if(sys == NtSys::NOM || !m->hasSys(sys)) { // stripped variations fall back to nominal
                     eff_data = m->muoTrigEffData_medium[idx_t];
                     eff_mc = m->muoTrigEffMC_medium[idx_t];
                 }
@@ -967,39 +1029,40 @@ float SusyNtTools::get_electron_trigger_scale_factor(const ElectronVector& elect
 
     // get the god-given, so-called "single", "double", or "mixed" electron trigger SF's
     for(auto & el : electrons) {
+        int sys_el = (el->hasSys(sys) ? sys_ele : 0); // stripped variations fall back to nominal
         // single
         if(is_single) {
-            if(sys_ele==0) {
+            if(sys_el==0) {
                 scale_factor *= el->eleTrigSF_single[id];
             }
-            else if(sys_ele<0) {
+            else if(sys_el<0) {
                 scale_factor *= el->errEffSF_trig_dn_single[id];
             }
-            else if(sys_ele>0) {
+            else if(sys_el>0) {
                 scale_factor *= el->errEffSF_trig_up_single[id];
             }
         }
         // double
         else if(is_double) {
-            if(sys_ele==0) {
+            if(sys_el==0) {
                 scale_factor *= el->eleTrigSF_double[id];
             }
-            else if(sys_ele<0) {
+            else if(sys_el<0) {
                 scale_factor *= el->errEffSF_trig_dn_double[id];
             }
-            else if(sys_ele>0) {
+            else if(sys_el>0) {
                 scale_factor *= el->errEffSF_trig_up_double[id];
             }
         }
         // mixed
         else if(is_mixed) {
-            if(sys_ele==0) {
+            if(sys_el==0) {
                 scale_factor *= el->eleTrigSF_mixed[id];
             }
-            else if(sys_ele<0) {
+            else if(sys_el<0) {
                 scale_factor *= el->errEffSF_trig_dn_mixed[id];
             }
-            else if(sys_ele>0) {
+            else if(sys_el>0) {
                 scale_factor *= el->errEffSF_trig_up_mixed[id];
             }
         }
@@ -0,0 +1,143 @@
+#include "SusyNtuple/SystematicHistograms.h"
+
+#include "TH1F.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using Susy::SystematicHistograms;
+
+using std::cout;
+using std::endl;
+
+//----------------------------------------------------------
+SystematicHistograms::FillBuffer::FillBuffer(SystematicHistograms &histos, size_t capacity) :
+    m_histos(histos),
+    m_capacity(std::max<size_t>(capacity, 1)),
+    m_weights(histos.nVariations(), 1.0),
+    m_current(0)
+{
+    m_fills.reserve(m_capacity);
+}
+//----------------------------------------------------------
+void SystematicHistograms::FillBuffer::setWeights(const std::vector<double> &weights)
+{
+    if(weights.size()!=m_histos.nVariations()) {
+        cout<<"SystematicHistograms::FillBuffer::setWeights: "<<weights.size()<<" weights for "
+            <<m_histos.nVariations()<<" variations, ignored"<<endl;
+        return;
+    }
+    setWeights(&weights[0]);
+}
+//----------------------------------------------------------
+void SystematicHistograms::FillBuffer::setWeights(const double *weights)
+{
+    const size_t n = m_histos.nVariations();
+    // the current weights can be overwritten if no fill uses them
+    const bool used = !m_fills.empty() && m_fills.back().weights==m_current;
+    if(used) m_current = m_weights.size();
+    m_weights.resize(m_current + n);
+    std::copy(weights, weights + n, m_weights.begin() + m_current);
+}
+//----------------------------------------------------------
+void SystematicHistograms::FillBuffer::flush()
+{
+    for(size_t i=0; i<m_fills.size(); ++i)
+        m_histos.fill(m_fills[i].id, m_fills[i].x, &m_weights[m_fills[i].weights]);
+    m_fills.clear();
+    // keep the current weights for the next fills
+    const size_t n = m_histos.nVariations();
+    std::copy(m_weights.begin() + m_current, m_weights.begin() + m_current + n, m_weights.begin());
+    m_weights.resize(n);
+    m_current = 0;
+}
+//----------------------------------------------------------
+SystematicHistograms::SystematicHistograms(const std::vector<std::string> &variations) :
+    m_variations(variations)
+{
+    if(m_variations.empty()) m_variations.push_back("NOM");
+}
+//----------------------------------------------------------
+SystematicHistograms::SystematicHistograms(const std::vector<NtSys::SusyNtSys> &systematics)
+{
+    for(size_t i=0; i<systematics.size(); ++i) m_variations.push_back(NtSys::SusyNtSysNames.at(systematics[i]));
+    if(m_variations.empty()) m_variations.push_back("NOM");
+}
+//----------------------------------------------------------
+size_t SystematicHistograms::findVariation(const std::string &name) const
+{
+    return std::find(m_variations.begin(), m_variations.end(), name) - m_variations.begin();
+}
+//----------------------------------------------------------
+size_t SystematicHistograms::book(const std::string &name, const std::string &title, int nBins, double low, double high,
+                                  const std::string &titleX, const std::string &titleY)
+{
+    return add(Definition(name, title, nBins, low, high, titleX, titleY));
+}
+//----------------------------------------------------------
+size_t SystematicHistograms::book(const std::string &name, const std::string &title, const std::vector<double> &edges,
+                                  const std::string &titleX, const std::string &titleY)
+{
+    return add(Definition(name, title, edges, titleX, titleY));
+}
+//----------------------------------------------------------
+size_t SystematicHistograms::add(const Definition &d)
+{
+    const size_t offset = m_histograms.empty() ? 0 : m_offsets.back() + m_histograms.back().nBins + 2;
+    m_histograms.push_back(d);
+    m_offsets.push_back(offset);
+    m_sumw.resize((offset + d.nBins + 2)*nVariations(), 0.0);
+    m_sumw2.resize(m_sumw.size(), 0.0);
+    m_entries.push_back(0);
+    return m_histograms.size()-1;
+}
+//----------------------------------------------------------
+void SystematicHistograms::fill(size_t id, double x, const double *weights)
+{
+    if(id>=m_histograms.size()) return;
+    const size_t n = nVariations();
+    double *sumw = &m_sumw[cell(id, m_histograms[id].findBin(x))];
+    double *sumw2 = &m_sumw2[sumw - &m_sumw[0]];
+    for(size_t v=0; v<n; ++v) {
+        sumw[v] += weights[v];
+        sumw2[v] += weights[v]*weights[v];
+    }
+    m_entries[id]++;
+}
+//----------------------------------------------------------
+TH1F* SystematicHistograms::toTH1F(size_t id, size_t v) const
+{
+    TH1F* result = m_histograms[id].makeTH1F("_" + m_variations[v]);
+    for(int bin=0; bin<=nBins(id)+1; ++bin) {
+        result->SetBinContent(bin, content(id, bin, v));
+        result->SetBinError(bin, std::sqrt(sumw2(id, bin, v)));
+    }
+    result->SetEntries(entries(id));
+    return result;
+}
+//----------------------------------------------------------
+bool SystematicHistograms::merge(const SystematicHistograms &other)
+{
+    bool same = other.m_variations==m_variations && other.m_histograms.size()==m_histograms.size();
+    for(size_t i=0; same && i<m_histograms.size(); ++i)
+        same = other.m_histograms[i].name==m_histograms[i].name && other.m_histograms[i].nBins==m_histograms[i].nBins;
+    if(!same) {
+        cout<<"SystematicHistograms::merge: cannot merge, the histograms or variations differ"<<endl;
+        return false;
+    }
+    for(size_t i=0; i<m_sumw.size(); ++i) {
+        m_sumw[i] += other.m_sumw[i];
+        m_sumw2[i] += other.m_sumw2[i];
+    }
+    for(size_t i=0; i<m_entries.size(); ++i) m_entries[i] += other.m_entries[i];
+    return true;
+}
+//----------------------------------------------------------
+void SystematicHistograms::clear()
+{
+    std::fill(m_sumw.begin(), m_sumw.end(), 0.0);
+    std::fill(m_sumw2.begin(), m_sumw2.end(), 0.0);
+    std::fill(m_entries.begin(), m_entries.end(), 0);
+}
+//----------------------------------------------------------
@@ -37,9 +37,7 @@ TauSelector::TauSelector():
 //----------------------------------------------------------
 bool TauSelector::isBaseline(const Tau& tau)
 {
-    return ( (std::abs(tau.Eta()) < 2.5) &&
-             (tau.nTrack > 0) &&
-             (tau.medium) );
+    return TauPolicy::isBaseline(tau);
 }
 //----------------------------------------------------------
 bool TauSelector::isSignal(const Tau& tau)
@@ -49,43 +47,28 @@ bool TauSelector::isSignal(const Tau& tau)
             tau.Pt() > 20);
 }
 //----------------------------------------------------------
-//----------------------------------------------------------
-// begin TauSelector_2Lep Ana_2Lep
-//----------------------------------------------------------
-
-//----------------------------------------------------------
-// begin TauSelector_3Lep Ana_3Lep
-//----------------------------------------------------------
-
-//----------------------------------------------------------
-// begin TauSelector_2LepWH Ana_2LepWH
-//----------------------------------------------------------
-
-//----------------------------------------------------------
-// begin TauSelector_4Lep Ana_4Lep
-//----------------------------------------------------------
-bool TauSelector_4Lep::isBaseline(const Tau& tau)
+void TauSelector::selectBaseline(const TauVector &in, TauVector &out)
 {
-    return (tau.Pt() > 20.0 					&&
-			std::abs(tau.Eta()) < 2.47			&& 
-			(tau.nTrack == 1 || tau.nTrack ==3 )&&
-			std::abs(tau.q) == 1 );
+    for(size_t i=0; i<in.size(); ++i)
+        if(in[i] && isBaseline(in[i])) out.push_back(in[i]);
 }
 //----------------------------------------------------------
-bool TauSelector_4Lep::isSignal(const Tau& tau)
+void TauSelector::selectSignal(const TauVector &in, TauVector &out)
 {
-    return (isBaseline(tau) &&
-            tau.medium);
+    for(size_t i=0; i<in.size(); ++i)
+        if(in[i] && isSignal(in[i])) out.push_back(in[i]);
 }
-
-//----------------------------------------------------------
-// begin TauSelector_SS3L Ana_SS3L
-//----------------------------------------------------------
-
 //----------------------------------------------------------
-// begin TauSelector_Stop2L Ana_Stop2L
+void TauSelector::classify(ObjectStatus::Collection<Tau> &status)
+{
+    const TauVector &in = status.objects();
+    std::vector<uint8_t> &bits = status.bits();
+    for(size_t i=0; i<in.size(); ++i) {
+        if(isBaseline(in[i])) bits[i] |= ObjectStatus::Baseline;
+        if(isSignal(in[i])) bits[i] |= ObjectStatus::PassSignal;
+    }
+}
 //----------------------------------------------------------
-
+// the analysis-specific selectors are the policies in TauSelector.h
 //----------------------------------------------------------
 } // namespace Susy
-
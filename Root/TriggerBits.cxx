@@ -0,0 +1,19 @@
+#include "SusyNtuple/TriggerBits.h"
+
+#include "TBits.h"
+
+using Susy::TriggerBits;
+
+//----------------------------------------------------------
+bool TriggerBits::fromTBits(const TBits &bits)
+{
+    reset();
+    bool complete = true;
+    for(UInt_t i=0; i<bits.GetNbits(); ++i) {
+        if(!bits.TestBitNumber(i)) continue;
+        if(i<nBits) set(i);
+        else complete = false;
+    }
+    return complete;
+}
+//----------------------------------------------------------
@@ -143,12 +143,12 @@ std::string TriggerTools::trigger_at_idx(int idx)
     return m_triggerMap_bit[idx];
 }
 //////////////////////////////////////////////////////////////////////////////
-bool TriggerTools::passTrigger(const TBits& triggerbits, const std::string &triggerName) const
+bool TriggerTools::passTrigger(const Susy::TriggerBits& triggerbits, const std::string &triggerName) const
 {
     bool pass = false;
     auto nameBit = m_triggerMap.find(triggerName);
     if(nameBit!=m_triggerMap.end()){
-        pass = triggerbits.TestBitNumber(nameBit->second);
+        pass = triggerbits.test(nameBit->second);
     }
     else {
         std::cout << "Trigger " << triggerName << " not available!!" << std::endl;
@@ -159,6 +159,59 @@ bool TriggerTools::passTrigger(const TBits& triggerbits, const std::string &trig
     return pass;
 }
 //////////////////////////////////////////////////////////////////////////////
+TriggerMask TriggerTools::compile(const std::vector<std::string> &anyOf, const std::vector<std::string> &allOf) const
+{
+    TriggerMask mask;
+    for(int iList=0; iList<2; ++iList) {
+        const vector<string> &names = (iList==0 ? anyOf : allOf);
+        ULong64_t &bits = (iList==0 ? mask.any : mask.all);
+        for(const string &name : names) {
+            auto nameBit = m_triggerMap.find(name);
+            if(nameBit==m_triggerMap.end() || nameBit->second<0 ||
+               nameBit->second>=static_cast<int>(Susy::TriggerBits::nBits)) {
+                cout << "TriggerTools::compile    Trigger " << name << " not available!!" << endl;
+                cout << "Dumping available triggers and exitting." << endl;
+                dumpTriggerInfo();
+                exit(1);
+            }
+            bits |= Susy::TriggerBits::mask(nameBit->second);
+        }
+    }
+    if(m_dbg)
+        cout << "TriggerTools::compile    any " << hex << mask.any << " all " << mask.all << dec << endl;
+    return mask;
+}
+//////////////////////////////////////////////////////////////////////////////
+YearTriggerMask& YearTriggerMask::set(int year, const TriggerMask &mask)
+{
+    for(auto &yearMask : m_masks) {
+        if(yearMask.first==year) {
+            yearMask.second = mask;
+            return *this;
+        }
+    }
+    m_masks.push_back(make_pair(year, mask));
+    return *this;
+}
+//////////////////////////////////////////////////////////////////////////////
+const TriggerMask& YearTriggerMask::forYear(int year) const
+{
+    static const TriggerMask none;
+    for(const auto &yearMask : m_masks)
+        if(yearMask.first==year) return yearMask.second;
+    return none;
+}
+//////////////////////////////////////////////////////////////////////////////
+bool YearTriggerMask::pass(const Susy::Event &event) const
+{
+    return forYear(event.treatAsYear).pass(event.trigBits);
+}
+//////////////////////////////////////////////////////////////////////////////
+bool YearTriggerMask::match(const Susy::Event &event, const Susy::Lepton &lepton) const
+{
+    return forYear(event.treatAsYear).match(event.trigBits, lepton.trigBits);
+}
+//////////////////////////////////////////////////////////////////////////////
 bool TriggerTools::lepton_trigger_match(Susy::Lepton* lep, string trigger)
 {
     // lepton_trigger_match is just an ~alias so that it is made clear that it is
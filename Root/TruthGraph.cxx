@@ -0,0 +1,244 @@
+#include "SusyNtuple/TruthGraph.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+using Susy::mc::TruthGraph;
+using Susy::mc::vint_t;
+using Susy::mc::vvint_t;
+
+using std::vector;
+
+//----------------------------------------------------------
+TruthGraph::TruthGraph() :
+    m_parentOffsets(1, 0),
+    m_childOffsets(1, 0),
+    m_words(0),
+    m_nInvalid(0),
+    m_hasCycle(false),
+    m_hasAncestry(false)
+{
+}
+//----------------------------------------------------------
+TruthGraph::TruthGraph(const vint_t &pdgs, const vvint_t &parentIndices) :
+    m_words(0),
+    m_nInvalid(0),
+    m_hasCycle(false),
+    m_hasAncestry(false)
+{
+    build(pdgs, parentIndices);
+}
+//----------------------------------------------------------
+TruthGraph::TruthGraph(const vint_t &pdgs, const vvint_t &parentIndices, const vvint_t &childrenIndices) :
+    m_words(0),
+    m_nInvalid(0),
+    m_hasCycle(false),
+    m_hasAncestry(false)
+{
+    build(pdgs, parentIndices, childrenIndices);
+}
+//----------------------------------------------------------
+void TruthGraph::build(const vint_t &pdgs, const vvint_t &parentIndices)
+{
+    m_pdgs = pdgs;
+    m_nInvalid = 0;
+    fillLinks(parentIndices, m_parentOffsets, m_parents);
+    invertParents();
+    buildCopies();
+}
+//----------------------------------------------------------
+void TruthGraph::build(const vint_t &pdgs, const vvint_t &parentIndices, const vvint_t &childrenIndices)
+{
+    m_pdgs = pdgs;
+    m_nInvalid = 0;
+    fillLinks(parentIndices, m_parentOffsets, m_parents);
+    fillLinks(childrenIndices, m_childOffsets, m_children);
+    buildCopies();
+}
+//----------------------------------------------------------
+void TruthGraph::fillLinks(const vvint_t &links, std::vector<int> &offsets, std::vector<int> &flat)
+{
+    const int n = size();
+    offsets.resize(n+1);
+    offsets[0] = 0;
+    flat.clear();
+    for(int i=0; i<n; ++i) {
+        if(i<static_cast<int>(links.size())) {
+            const vint_t &l = links[i];
+            for(size_t j=0; j<l.size(); ++j) {
+                if(l[j]>=0 && l[j]<n) flat.push_back(l[j]);
+                else m_nInvalid++;
+            }
+        }
+        offsets[i+1] = flat.size();
+    }
+}
+//----------------------------------------------------------
+void TruthGraph::invertParents()
+{
+    const int n = size();
+    m_childOffsets.assign(n+1, 0);
+    for(size_t j=0; j<m_parents.size(); ++j) m_childOffsets[m_parents[j]+1]++;
+    for(int i=0; i<n; ++i) m_childOffsets[i+1] += m_childOffsets[i];
+    m_children.resize(m_parents.size());
+    // fill in increasing child index, as stored in the record
+    vector<int> next(m_childOffsets.begin(), m_childOffsets.end()-1);
+    for(int i=0; i<n; ++i)
+        for(int j=m_parentOffsets[i]; j<m_parentOffsets[i+1]; ++j)
+            m_children[next[m_parents[j]]++] = i;
+}
+//----------------------------------------------------------
+void TruthGraph::buildCopies()
+{
+    const int n = size();
+    m_hasAncestry = false;
+    m_ancestors.clear();
+    m_words = 0;
+    m_hasCycle = false;
+
+    m_selfParent.assign(n, -1);
+    for(int i=0; i<n; ++i) {
+        for(int j=m_parentOffsets[i]; j<m_parentOffsets[i+1]; ++j) {
+            if(m_pdgs[m_parents[j]]==m_pdgs[i]) { m_selfParent[i] = m_parents[j]; break; }
+        }
+    }
+
+    // depth-first on the parent links: a particle is appended after its parents
+    m_order.clear();
+    vector<char> state(n, 0); // 0: not visited, 1: its parents are being visited, 2: done
+    vector<std::pair<int, int> > stack; // particle, next parent link
+    for(int root=0; root<n; ++root) {
+        if(state[root]) continue;
+        state[root] = 1;
+        stack.push_back(std::make_pair(root, m_parentOffsets[root]));
+        while(!stack.empty()) {
+            const int i = stack.back().first;
+            if(stack.back().second<m_parentOffsets[i+1]) {
+                const int p = m_parents[stack.back().second++];
+                if(state[p]==0) {
+                    state[p] = 1;
+                    stack.push_back(std::make_pair(p, m_parentOffsets[p]));
+                } else if(state[p]==1) {
+                    m_hasCycle = true;
+                }
+            } else {
+                state[i] = 2;
+                m_order.push_back(i);
+                stack.pop_back();
+            }
+        }
+    }
+
+    m_firstCopy.assign(n, -1);
+    for(size_t k=0; k<m_order.size(); ++k) {
+        const int i = m_order[k];
+        const int p = m_selfParent[i];
+        if(p<0) { m_firstCopy[i] = i; continue; }
+        if(m_firstCopy[p]>=0) { m_firstCopy[i] = m_firstCopy[p]; continue; }
+        // p is on a cycle of copies: walk up, at most once around
+        int first = i;
+        for(int steps=0; steps<n && m_selfParent[first]>=0; ++steps) first = m_selfParent[first];
+        m_firstCopy[i] = first;
+    }
+}
+//----------------------------------------------------------
+void TruthGraph::buildAncestry()
+{
+    const int n = size();
+    m_words = (n + 63)/64;
+    m_ancestors.assign(static_cast<size_t>(n)*m_words, 0);
+    // in order the parents are complete before their children; cycles need more passes
+    bool changed = true;
+    while(changed) {
+        changed = false;
+        for(size_t k=0; k<m_order.size(); ++k) {
+            const int i = m_order[k];
+            uint64_t *row = &m_ancestors[static_cast<size_t>(i)*m_words];
+            for(int j=m_parentOffsets[i]; j<m_parentOffsets[i+1]; ++j) {
+                const int p = m_parents[j];
+                const uint64_t *parentRow = &m_ancestors[static_cast<size_t>(p)*m_words];
+                for(size_t w=0; w<m_words; ++w) {
+                    const uint64_t merged = row[w] | parentRow[w] | (w==static_cast<size_t>(p/64) ? uint64_t(1)<<(p%64) : 0);
+                    if(merged!=row[w]) { row[w] = merged; changed = true; }
+                }
+            }
+        }
+        if(!m_hasCycle) break;
+    }
+    m_hasAncestry = true;
+}
+//----------------------------------------------------------
+bool TruthGraph::isAncestor(int a, int i) const
+{
+    const int n = size();
+    if(a<0 || a>=n || i<0 || i>=n) return false;
+    if(m_hasAncestry) return testAncestor(a, i);
+    vector<char> visited(n, 0);
+    vector<int> stack(1, i);
+    while(!stack.empty()) {
+        const int c = stack.back();
+        stack.pop_back();
+        for(int j=m_parentOffsets[c]; j<m_parentOffsets[c+1]; ++j) {
+            const int p = m_parents[j];
+            if(p==a) return true;
+            if(!visited[p]) { visited[p] = 1; stack.push_back(p); }
+        }
+    }
+    return false;
+}
+//----------------------------------------------------------
+vint_t TruthGraph::ancestors(int i) const
+{
+    vint_t result;
+    const int n = size();
+    if(i<0 || i>=n) return result;
+    if(m_hasAncestry) {
+        for(int a=0; a<n; ++a) if(testAncestor(a, i)) result.push_back(a);
+        return result;
+    }
+    vector<char> visited(n, 0);
+    vector<int> stack(1, i);
+    while(!stack.empty()) {
+        const int c = stack.back();
+        stack.pop_back();
+        for(int j=m_parentOffsets[c]; j<m_parentOffsets[c+1]; ++j) {
+            const int p = m_parents[j];
+            if(!visited[p]) { visited[p] = 1; stack.push_back(p); result.push_back(p); }
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+//----------------------------------------------------------
+int TruthGraph::parentPdg(int i) const
+{
+    const Range pars = parents(m_firstCopy[i]);
+    return pars.empty() ? -999 : m_pdgs[pars[0]];
+}
+//----------------------------------------------------------
+bool TruthGraph::isSmTop(int i) const
+{
+    if(m_pdgs[i]!=kPt && m_pdgs[i]!=kAt) return false;
+    const Range chs = children(i);
+    for(size_t j=0; j<chs.size(); ++j) {
+        const int p = abs(m_pdgs[chs[j]]);
+        if(!(p==kPd || p==kPs || p==kPb || p==kPw || p==kPglu)) return false; // can radiate gluon
+    }
+    return true;
+}
+//----------------------------------------------------------
+bool TruthGraph::isDecayingW(int i) const
+{
+    if(m_pdgs[i]!=kPw && m_pdgs[i]!=kAw) return false;
+    const Range chs = children(i);
+    for(size_t j=0; j<chs.size(); ++j) {
+        const int p = abs(m_pdgs[chs[j]]);
+        if(p==kPw) return false; // intermediate W
+        if(!(p==kPd || p==kPu || p==kPs || p==kPc || p==kPb
+             || p==kPel || p==kPve || p==kPmu || p==kPvm || p==kPtau || p==kPvt
+             || p==kPgam)) return false; // can radiate gamma
+    }
+    return true;
+}
+//----------------------------------------------------------
@@ -10,7 +10,7 @@ namespace D3PDReader {
                                  const ::Long64_t* master )
       : fMaster( master ), fParent( parent ), fFromInput( kFALSE ),
         fInTree( 0 ), fInBranch( 0 ), fAvailable( UNKNOWN ), fName( name ),
-        fActive( kFALSE ), fType( "" ),
+        fActive( kFALSE ), fBasketSize( 32000 ), fSplitLevel( 0 ), fType( "" ),
         fEntriesRead(), fBranchSize(), fZippedSize() {
 
 #ifdef COLLECT_D3PD_READING_STATISTICS
@@ -73,6 +73,28 @@ namespace D3PDReader {
       return;
    }
 
+   ::Int_t VarHandleBase::GetBasketSize() const {
+
+      return fBasketSize;
+   }
+
+   void VarHandleBase::SetBasketSize( ::Int_t size ) {
+
+      fBasketSize = size;
+      return;
+   }
+
+   ::Int_t VarHandleBase::GetSplitLevel() const {
+
+      return fSplitLevel;
+   }
+
+   void VarHandleBase::SetSplitLevel( ::Int_t level ) {
+
+      fSplitLevel = level;
+      return;
+   }
+
    ::Bool_t VarHandleBase::IsAvailable() const {
 
       if( ! fFromInput ) return kTRUE;
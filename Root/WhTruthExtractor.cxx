@@ -35,9 +35,14 @@ WhTruthExtractor::WhTruthExtractor() :
 //----------------------------------
 smc::Hdecays WhTruthExtractor::update(const vint_t* pdg, const vvint_t *childIndex, const vvint_t *parentIndex)
 {
-  hIndices_ = findHiggsIndices(*pdg);
-  buildHiggsChildrenPgds(*pdg, *childIndex);
-  buildHiggsParentsPgds(*pdg, *parentIndex);
+  return update(smc::TruthGraph(*pdg, *parentIndex, *childIndex));
+}
+//----------------------------------
+smc::Hdecays WhTruthExtractor::update(const smc::TruthGraph &graph)
+{
+  hIndices_ = findHiggsIndices(graph.pdgs());
+  buildHiggsChildrenPgds(graph);
+  buildHiggsParentsPgds(graph);
   interestingHiggs_ = firstInterestingHiggs();
   decay_ = (interestingHiggs_ < 0 ?
             smc::kUnknown : decayType(static_cast<size_t>(interestingHiggs_)));
@@ -66,25 +71,25 @@ WhTruthExtractor::vint_t WhTruthExtractor::findHiggsIndices(const vint_t &pdg)
   return ihi.higgsIndices_;
 }
 //----------------------------------
-void WhTruthExtractor::buildHiggsChildrenPgds(const vint_t &pdgs, const vvint_t &childIndices)
+void WhTruthExtractor::buildHiggsChildrenPgds(const smc::TruthGraph &graph)
 {
   hChiPdgs_.resize(hIndices_.size());
   for(size_t iH=0; iH<hIndices_.size(); ++iH) {
     vint_t &chPdgs = hChiPdgs_[iH];
-    const vint_t &chIdxs = childIndices[ hIndices_[iH] ];
+    const smc::TruthGraph::Range chIdxs = graph.children(hIndices_[iH]);
     chPdgs.resize(chIdxs.size());
-    std::transform(chIdxs.begin(), chIdxs.end(), chPdgs.begin(), smc::IndexToPdg(pdgs));
+    std::transform(chIdxs.begin(), chIdxs.end(), chPdgs.begin(), smc::IndexToPdg(graph.pdgs()));
   } // end for(iH)
 }
 //----------------------------------
-void WhTruthExtractor::buildHiggsParentsPgds(const vint_t &pdgs, const vvint_t &parentIndices)
+void WhTruthExtractor::buildHiggsParentsPgds(const smc::TruthGraph &graph)
 {
   hParPdgs_.resize(hIndices_.size());
   for(size_t iH=0; iH<hIndices_.size(); ++iH) {
     vint_t &parPdgs = hParPdgs_[iH];
-    const vint_t &parIdxs = parentIndices[ hIndices_[iH] ];
+    const smc::TruthGraph::Range parIdxs = graph.parents(hIndices_[iH]);
     parPdgs.resize(parIdxs.size());
-    std::transform(parIdxs.begin(), parIdxs.end(), parPdgs.begin(), smc::IndexToPdg(pdgs));
+    std::transform(parIdxs.begin(), parIdxs.end(), parPdgs.begin(), smc::IndexToPdg(graph.pdgs()));
   } // end for(iH)
 }
 //----------------------------------
@@ -149,20 +154,24 @@ void WhTruthExtractor::printEvent(const vint_t &pdg, const vint_t &status,
 WhTruthExtractor::vint_t WhTruthExtractor::ttbarMcAtNloParticles(const vint_t *pdgs,
                                                                  const vvint_t *childrenIndices)
 
+{
+  return ttbarMcAtNloParticles(smc::TruthGraph(*pdgs, vvint_t(), *childrenIndices));
+}
+//----------------------------------
+WhTruthExtractor::vint_t WhTruthExtractor::ttbarMcAtNloParticles(const smc::TruthGraph &graph)
 {
   // actually identify the particles we want to store
   vint_t particles;
-  smc::IsSmTopIndex   topFilter(pdgs, childrenIndices);
-  smc::IsDecayingWIndex wFilter(pdgs, childrenIndices);
-  int nParts(pdgs->size());
+  int nParts(graph.size());
   for(int i=0; i<nParts; ++i){
-    if(topFilter(i)){
+    if(graph.isSmTop(i)){
       particles.push_back(i);
-      vint_t bs(sut::filter(childrenIndices->at(i), std::not1(smc::IsBIndex(pdgs))));
-      particles.insert(particles.end(), bs.begin(), bs.end());
-    } else if(wFilter(i)){
+      const smc::TruthGraph::Range chIdxs = graph.children(i);
+      for(const int *c=chIdxs.begin(); c!=chIdxs.end(); ++c)
+        if(graph.pdg(*c)==smc::kPb || graph.pdg(*c)==smc::kAb) particles.push_back(*c);
+    } else if(graph.isDecayingW(i)){
       particles.push_back(i);
-      const vint_t &chIdxs = childrenIndices->at(i);
+      const smc::TruthGraph::Range chIdxs = graph.children(i);
       particles.insert(particles.end(), chIdxs.begin(), chIdxs.end());
     }
   }
@@ -173,13 +182,18 @@ WhTruthExtractor::vint_t WhTruthExtractor::ttbarMcAtNloParticles(const vint_t *p
 WhTruthExtractor::vint_t WhTruthExtractor::higgsEventParticleIndices(const vint_t* pdg,
                                                                      const vvint_t *childIndex,
                                                                      const vvint_t *parentIndex)
+{
+    return higgsEventParticleIndices(smc::TruthGraph(*pdg, *parentIndex, *childIndex));
+}
+//----------------------------------
+WhTruthExtractor::vint_t WhTruthExtractor::higgsEventParticleIndices(const smc::TruthGraph &graph)
 {
     vint_t indices;
-    update(pdg, childIndex, parentIndex);
+    update(graph);
     bool interesting_H_was_found = (interestingHiggs_ >=0);
     if(interesting_H_was_found){
         const int hIdx = hIndices_[interestingHiggs_];
-        const vint_t &chIdxs  = childIndex ->at(hIdx);
+        const smc::TruthGraph::Range chIdxs = graph.children(hIdx);
         indices.push_back(hIdx);
         indices.insert(indices.end(), chIdxs.begin(), chIdxs.end());
         // note to self: the h parent is usually another h; no need to store parents
@@ -0,0 +1,198 @@
+#include "SusyNtuple/WriterOptions.h"
+#include "SusyNtuple/SusyNtObject.h"
+#include "SusyNtuple/string_utils.h"
+
+#include "TFile.h"
+#include "TTree.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using Susy::WriterOptions;
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+namespace {
+/// value of an integer option; false if it is not an integer
+bool toInteger(const string &value, Long64_t &result)
+{
+    if(!Susy::utils::isInt(value)) return false;
+    result = strtoll(value.c_str(), NULL, 10);
+    return true;
+}
+}
+//----------------------------------------------------------
+WriterOptions::WriterOptions() :
+    m_compression(-1),
+    m_basketSize(-1),
+    m_hasAutoFlush(false),
+    m_autoFlush(0),
+    m_splitLevel(-1)
+{
+}
+//----------------------------------------------------------
+WriterOptions& WriterOptions::setCompression(Algorithm algorithm, int level)
+{
+    if(level<0 || level>9) {
+        cout<<"WriterOptions::setCompression: invalid level "<<level<<" (0-9), ignored"<<endl;
+        return *this;
+    }
+    m_compression = (level==0 ? 0 : 100*algorithm + level);
+    return *this;
+}
+//----------------------------------------------------------
+WriterOptions& WriterOptions::setBasketSize(int bytes)
+{
+    if(bytes>0) m_basketSize = bytes;
+    else cout<<"WriterOptions::setBasketSize: invalid basket size "<<bytes<<", ignored"<<endl;
+    return *this;
+}
+//----------------------------------------------------------
+WriterOptions& WriterOptions::setBasketSize(const std::string &branch, int bytes)
+{
+    if(bytes>0) m_branchBasketSize[branch] = bytes;
+    else cout<<"WriterOptions::setBasketSize: invalid basket size "<<bytes<<" for '"<<branch<<"', ignored"<<endl;
+    return *this;
+}
+//----------------------------------------------------------
+WriterOptions& WriterOptions::setAutoFlush(Long64_t value)
+{
+    m_hasAutoFlush = true;
+    m_autoFlush = value;
+    return *this;
+}
+//----------------------------------------------------------
+WriterOptions& WriterOptions::setSplitLevel(int level)
+{
+    if(level>=0 && level<=99) m_splitLevel = level;
+    else cout<<"WriterOptions::setSplitLevel: invalid split level "<<level<<" (0-99), ignored"<<endl;
+    return *this;
+}
+//----------------------------------------------------------
+int WriterOptions::basketSize(const std::string &branch) const
+{
+    std::map<string, int>::const_iterator it = m_branchBasketSize.find(branch);
+    return it!=m_branchBasketSize.end() ? it->second : m_basketSize;
+}
+//----------------------------------------------------------
+bool WriterOptions::parse(const std::string &options)
+{
+    WriterOptions result(*this);
+    vector<string> items = Susy::utils::tokenizeString(options, ',');
+    for(size_t i=0; i<items.size(); ++i) {
+        const string item = Susy::utils::rmLeadingTrailingWhitespaces(items[i]);
+        if(item.empty() || item=="default") continue;
+        const size_t eq = item.find('=');
+        if(eq==string::npos) {
+            // compression: <algorithm>[:<level>]
+            const size_t colon = item.find(':');
+            const string name = item.substr(0, colon);
+            Long64_t level = -1;
+            if(colon!=string::npos && !toInteger(item.substr(colon+1), level)) level = -2;
+            Algorithm algorithm = Global;
+            Long64_t defaultLevel = 1;
+            if     (name=="global") { algorithm = Global; defaultLevel = 1; }
+            else if(name=="zlib") { algorithm = Zlib; defaultLevel = 1; }
+            else if(name=="lzma") { algorithm = Lzma; defaultLevel = 5; }
+            else if(name=="lz4")  { algorithm = Lz4;  defaultLevel = 4; }
+            else if(name=="zstd") { algorithm = Zstd; defaultLevel = 5; }
+            else if(name=="none" && colon==string::npos) { level = 0; }
+            else {
+                cout<<"WriterOptions::parse: unknown compression '"<<item<<"'"<<endl;
+                return false;
+            }
+            if(level==-1) level = defaultLevel;
+            if(level<0 || level>9) {
+                cout<<"WriterOptions::parse: invalid compression level in '"<<item<<"' (0-9)"<<endl;
+                return false;
+            }
+            result.setCompression(algorithm, level);
+            continue;
+        }
+        const string key = item.substr(0, eq);
+        Long64_t value = 0;
+        if(!toInteger(item.substr(eq+1), value)) {
+            cout<<"WriterOptions::parse: invalid value in '"<<item<<"'"<<endl;
+            return false;
+        }
+        const string basketSuffix = ".basket";
+        if(key=="flush") {
+            result.setAutoFlush(value);
+        } else if(key=="basket" && value>0) {
+            result.setBasketSize(value);
+        } else if(key=="split" && value>=0 && value<=99) {
+            result.setSplitLevel(value);
+        } else if(key.size()>basketSuffix.size() && Susy::utils::endswith(key, basketSuffix) && value>0) {
+            result.setBasketSize(key.substr(0, key.size()-basketSuffix.size()), value);
+        } else {
+            cout<<"WriterOptions::parse: invalid option '"<<item<<"'"<<endl;
+            return false;
+        }
+    }
+    *this = result;
+    return true;
+}
+//----------------------------------------------------------
+std::string WriterOptions::str() const
+{
+    std::ostringstream out;
+    const char* separator = "";
+    if(m_compression==0) {
+        out<<"none";
+        separator = ",";
+    } else if(m_compression>0) {
+        out<<algorithmName(static_cast<Algorithm>(m_compression/100))<<":"<<m_compression%100;
+        separator = ",";
+    }
+    if(m_basketSize>0) { out<<separator<<"basket="<<m_basketSize; separator = ","; }
+    for(std::map<string, int>::const_iterator it=m_branchBasketSize.begin(); it!=m_branchBasketSize.end(); ++it) {
+        out<<separator<<it->first<<".basket="<<it->second;
+        separator = ",";
+    }
+    if(m_hasAutoFlush) { out<<separator<<"flush="<<m_autoFlush; separator = ","; }
+    if(m_splitLevel>=0) { out<<separator<<"split="<<m_splitLevel; separator = ","; }
+    const string result = out.str();
+    return result.empty() ? "default" : result;
+}
+//----------------------------------------------------------
+void WriterOptions::apply(TFile* file) const
+{
+    if(file && m_compression>=0) file->SetCompressionSettings(m_compression);
+}
+//----------------------------------------------------------
+void WriterOptions::apply(TTree* tree) const
+{
+    if(tree && m_hasAutoFlush) tree->SetAutoFlush(m_autoFlush);
+}
+//----------------------------------------------------------
+void WriterOptions::apply(SusyNtObject &nt) const
+{
+    vector<D3PDReader::VarHandleBase*> vars = nt.handles();
+    for(size_t i=0; i<vars.size(); ++i) {
+        const int size = basketSize(vars[i]->GetName());
+        if(size>0) vars[i]->SetBasketSize(size);
+        if(m_splitLevel>=0) vars[i]->SetSplitLevel(m_splitLevel);
+    }
+    for(std::map<string, int>::const_iterator it=m_branchBasketSize.begin(); it!=m_branchBasketSize.end(); ++it) {
+        bool found = false;
+        for(size_t i=0; i<vars.size() && !found; ++i) found = it->first==vars[i]->GetName();
+        if(!found) cout<<"WriterOptions::apply: no branch '"<<it->first<<"', its basket size is ignored"<<endl;
+    }
+}
+//----------------------------------------------------------
+std::string WriterOptions::algorithmName(Algorithm algorithm)
+{
+    switch(algorithm) {
+    case Zlib: return "zlib";
+    case Lzma: return "lzma";
+    case Lz4:  return "lz4";
+    case Zstd: return "zstd";
+    default:   return "global";
+    }
+}
+//----------------------------------------------------------
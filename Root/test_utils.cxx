@@ -0,0 +1,32 @@
+#include "SusyNtuple/test_utils.h"
+
+#include <iostream>
+
+using Susy::utils::TestReport;
+
+//----------------------------------
+TestReport::TestReport(const std::string &name) :
+    m_name(name),
+    m_nChecks(0),
+    m_nFailed(0),
+    m_verbose(false)
+{
+}
+//----------------------------------
+bool TestReport::check(bool pass, const std::string &expression, const char *file, int line)
+{
+    m_nChecks++;
+    if(!pass) m_nFailed++;
+    if(!pass || m_verbose)
+        std::cout<<m_name<<": "<<(pass ? "pass" : "FAIL")<<" "<<expression
+                 <<" ["<<file<<":"<<line<<"]"<<std::endl;
+    return pass;
+}
+//----------------------------------
+int TestReport::finish() const
+{
+    if(success()) std::cout<<m_name<<": success"<<std::endl;
+    else std::cout<<m_name<<": FAILED ("<<m_nFailed<<" of "<<m_nChecks<<" checks)"<<std::endl;
+    return success() ? 0 : 1;
+}
+//----------------------------------
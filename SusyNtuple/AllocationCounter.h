@@ -0,0 +1,70 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_AllocationCounter_h
+#define SusyNtuple_AllocationCounter_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace Susy {
+
+///  Count the heap allocations made by the process
+/**
+   The counters are incremented by the replacement operator new/delete
+   defined by SUSYNT_DEFINE_COUNTING_OPERATOR_NEW. The macro must be
+   used in exactly one translation unit of an executable (not in the
+   library), e.g. in a benchmark:
+   \code
+   #include "SusyNtuple/AllocationCounter.h"
+   SUSYNT_DEFINE_COUNTING_OPERATOR_NEW
+
+   Susy::AllocationCounter counter;
+   loop();
+   cout<<counter.allocations()<<" allocations, "<<counter.bytes()<<" bytes"<<endl;
+   \endcode
+   Without the macro the counters stay at zero.
+ */
+class AllocationCounter {
+
+public:
+    /// start counting from now
+    AllocationCounter() { reset(); }
+    void reset() { m_allocations = totalAllocations(); m_bytes = totalBytes(); }
+    /// number of allocations since construction or the last reset
+    uint64_t allocations() const { return totalAllocations() - m_allocations; }
+    /// number of bytes allocated since construction or the last reset
+    uint64_t bytes() const { return totalBytes() - m_bytes; }
+
+    static std::atomic<uint64_t>& allocationCount() { static std::atomic<uint64_t> n(0); return n; }
+    static std::atomic<uint64_t>& byteCount() { static std::atomic<uint64_t> n(0); return n; }
+    static uint64_t totalAllocations() { return allocationCount().load(std::memory_order_relaxed); }
+    static uint64_t totalBytes() { return byteCount().load(std::memory_order_relaxed); }
+    static void record(std::size_t size)
+    {
+        allocationCount().fetch_add(1, std::memory_order_relaxed);
+        byteCount().fetch_add(size, std::memory_order_relaxed);
+    }
+
+private:
+    uint64_t m_allocations;
+    uint64_t m_bytes;
+};
+
+} // Susy
+
+#define SUSYNT_DEFINE_COUNTING_OPERATOR_NEW                               \
+    void* operator new(std::size_t size)                                  \
+    {                                                                     \
+        Susy::AllocationCounter::record(size);                            \
+        if(void *p = std::malloc(size ? size : 1)) return p;              \
+        throw std::bad_alloc();                                           \
+    }                                                                     \
+    void* operator new[](std::size_t size) { return operator new(size); } \
+    void operator delete(void *p) noexcept { std::free(p); }              \
+    void operator delete[](void *p) noexcept { std::free(p); }            \
+    void operator delete(void *p, std::size_t) noexcept { std::free(p); } \
+    void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+#endif
@@ -0,0 +1,104 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_AsyncWriter_h
+#define SusyNtuple_AsyncWriter_h
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <iosfwd>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Susy {
+
+///  Run the output work (TTree::Fill, basket compression) on a background thread
+/**
+   The event loop hands each output entry over as a task; a single
+   writer thread runs the tasks in order, so that TTree::Fill and the
+   compression of the baskets do not stall the event processing.
+
+   The entries are passed through a fixed number of slots, e.g. an
+   array of output buffers indexed by slot: the event loop acquires a
+   free slot, fills its buffers and submits a task that writes them.
+   When all the slots are in use the event loop waits (back-pressure),
+   so the memory is bounded by the number of slots:
+   \code
+   AsyncWriter writer(16);
+   vector<EventBuffers> buffers(writer.capacity());
+   writer.start();
+   ...
+   size_t slot = writer.acquire();
+   buffers[slot].copyFrom(event);
+   writer.submit(slot, [&, slot]() { outputBuffers.swap(buffers[slot]); tree->Fill(); });
+   ...
+   writer.finish(); // wait for the pending entries
+   tree->Write();
+   \endcode
+   The tree and its output file must only be used by the tasks until
+   finish(). Without start() (or when start() fails) the tasks run
+   immediately on the calling thread.
+
+   start() calls ROOT::EnableThreadSafety(); with setImplicitMT() it
+   also enables ROOT's implicit multithreading, with which TTree::Fill
+   compresses the baskets of the different branches in parallel.
+ */
+class AsyncWriter {
+
+public:
+    typedef std::function<void ()> Task;
+
+    /// capacity: number of slots, i.e. of entries queued or being written
+    explicit AsyncWriter(size_t capacity=16);
+    /// finish()
+    ~AsyncWriter();
+
+    /// number of threads used by ROOT to compress the baskets (0, the default: no implicit MT); call before start()
+    AsyncWriter& setImplicitMT(unsigned int nThreads) { m_imtThreads = nThreads; return *this; }
+    /// start the writer thread; false if it cannot be started (the tasks then run synchronously)
+    bool start();
+    bool running() const { return m_thread.joinable(); }
+    size_t capacity() const { return m_capacity; }
+
+    /// a free slot; waits while all the slots are queued or being written
+    size_t acquire();
+    /// queue task, which uses the buffers of slot; the slot is free again once the task has run
+    void submit(size_t slot, Task task);
+    /// acquire() a slot for a task that does not need one
+    void push(Task task) { submit(acquire(), task); }
+    /// run all the queued tasks, then stop the writer thread
+    void finish();
+
+    uint64_t nTasks() const;
+    /// number of acquire() calls that had to wait for a free slot, and their total wait
+    uint64_t nStalls() const;
+    uint64_t stallNs() const;
+    /// one line with the number of tasks and stalls
+    void print(std::ostream &out) const;
+
+private:
+    AsyncWriter(const AsyncWriter&);
+    AsyncWriter& operator=(const AsyncWriter&);
+    /// loop of the writer thread
+    void run();
+
+    const size_t m_capacity;
+    unsigned int m_imtThreads;
+    mutable std::mutex m_mutex;          ///< protects all the members below
+    std::condition_variable m_queued;    ///< signals the writer: a task, or stop
+    std::condition_variable m_freed;     ///< signals the event loop: a free slot
+    std::deque<std::pair<size_t, Task> > m_queue;
+    std::vector<size_t> m_free;          ///< free slots
+    bool m_stop;
+    uint64_t m_nTasks;
+    uint64_t m_nStalls;
+    uint64_t m_stallNs;
+    std::thread m_thread;
+};
+
+} // Susy
+
+#endif
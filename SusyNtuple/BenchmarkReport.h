@@ -0,0 +1,99 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_BenchmarkReport_h
+#define SusyNtuple_BenchmarkReport_h
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Susy {
+
+///  Results of a benchmark suite, as named metrics per measurement
+/**
+   Each measurement (e.g. "overlap/Ana_2Lep/m=4") has a list of
+   metrics (e.g. "ns_per_call"), kept in the order in which they were
+   added. The report can be printed as a table, or written as JSON so
+   that the throughput can be tracked from one release to the next:
+   \code
+   {
+     "suite": "SusyNtMicroBench",
+     "label": "SusyNtuple-00-07-00",
+     "results": [
+       {"name": "baseline/m=1", "multiplicity": 1, "ns_per_call": 812.5},
+       ...
+     ]
+   }
+   \endcode
+   with one result per line.
+
+   A report read back with readJson() can be used as the baseline of a
+   later run: compare() lists the metrics that got worse by more than
+   their relative tolerance.
+ */
+class BenchmarkReport {
+
+public:
+    typedef std::pair<std::string, double> Metric;
+    struct Result {
+        std::string name;
+        std::vector<Metric> metrics;
+        explicit Result(const std::string &n="") : name(n) {}
+        /// the value of metric, or 0 if it was not measured
+        const double* value(const std::string &metric) const;
+    };
+    /// how much a metric may change before it is a regression
+    struct Tolerance {
+        double fraction;      ///< relative change allowed, e.g. 0.1
+        bool higherIsBetter;  ///< true for rates, false for time, memory, allocations
+        Tolerance(double f=0.1, bool h=false) : fraction(f), higherIsBetter(h) {}
+    };
+    typedef std::map<std::string, Tolerance> Tolerances;
+    /// a metric that got worse than in the baseline
+    struct Regression {
+        std::string name;
+        std::string metric;
+        double baseline;
+        double value;
+        double change;        ///< (value-baseline)/baseline
+    };
+
+    explicit BenchmarkReport(const std::string &suite="") : m_suite(suite) {}
+
+    /// free-form label identifying the build, e.g. a release tag
+    BenchmarkReport& setLabel(const std::string &value) { m_label = value; return *this; }
+    const std::string& suite() const { return m_suite; }
+    const std::string& label() const { return m_label; }
+
+    /// set one metric of a measurement (created if needed)
+    void add(const std::string &name, const std::string &metric, double value);
+    /// the measurement called name, or 0
+    const Result* find(const std::string &name) const;
+    const std::vector<Result>& results() const { return m_results; }
+    size_t size() const { return m_results.size(); }
+
+    /// table with one row per measurement and one column per metric
+    void print(std::ostream &out) const;
+    void writeJson(std::ostream &out) const;
+    /// return false if the file cannot be written
+    bool writeJson(const std::string &filename) const;
+    /// read a report written by writeJson(); return false if it cannot be parsed
+    bool readJson(std::istream &in);
+    bool readJson(const std::string &filename);
+
+    /// metrics listed in tolerances that are worse than in baseline by more than their tolerance
+    /**
+       Measurements or metrics missing from either report are skipped.
+     */
+    std::vector<Regression> compare(const BenchmarkReport &baseline, const Tolerances &tolerances) const;
+
+private:
+    std::string m_suite;
+    std::string m_label;
+    std::vector<Result> m_results;
+};
+
+} // Susy
+
+#endif
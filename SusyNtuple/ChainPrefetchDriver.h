@@ -0,0 +1,129 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_ChainPrefetchDriver_h
+#define SusyNtuple_ChainPrefetchDriver_h
+
+#include "Rtypes.h"
+
+#include <atomic>
+#include <iosfwd>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TChain;
+class TFile;
+class TSelector;
+
+namespace Susy {
+
+///  Drive a TSelector over a TChain, warming up the next file in the background
+/**
+   With TChain::Process the next file is opened when the loop crosses
+   the file boundary: on high-latency storage the event loop stalls
+   while the file is opened, its keys and the trigger histogram are
+   read, and the first baskets are fetched.
+
+   This driver runs the same loop (Begin, SlaveBegin, Init, Notify,
+   Process(local entry), SlaveTerminate, Terminate), and while a file
+   is being processed a background thread warms up the next one:
+   - opens it and reads its header and keys
+   - looks up the "trig" histogram, whose labels are compared with
+     those of the first file (TriggerTools uses the bits of the first
+     file for the whole chain)
+   - reads the baskets of its first cluster, for the branches in the
+     TTreeCache of the current file (all branches if the cache is
+     still learning).
+   The warm-up starts once the TTreeCache has learned which branches
+   are read. When the chain then opens the file, the storage (the
+   page cache, a caching proxy, the connection to the file server)
+   already holds what it needs; the warm-up copy of the file is closed
+   once the chain has switched to it.
+
+   Usage:
+   \code
+   ChainPrefetchDriver driver(chain);
+   driver.process(&analysis, "", nEntries);
+   driver.print(cout);
+   \endcode
+   The selector is not called from the background thread.
+ */
+class ChainPrefetchDriver {
+
+public:
+    explicit ChainPrefetchDriver(TChain* chain);
+    /// wait for the background warm-up, if any
+    ~ChainPrefetchDriver();
+
+    /// size of the TTreeCache (bytes)
+    ChainPrefetchDriver& setCacheSize(Long64_t value) { m_cacheSize = value; return *this; }
+    /// toggle the warm-up of the next file (default: on)
+    ChainPrefetchDriver& setPrefetch(bool value=true) { m_prefetch = value; return *this; }
+    ChainPrefetchDriver& setVerbose(bool value=true) { m_verbose = value; return *this; }
+
+    /// loop on the first nEntries of the chain (all if <0); return the number processed
+    Long64_t process(TSelector* selector, const char* option="", Long64_t nEntries=-1);
+
+    /// number of files that were warmed up before the chain opened them
+    int nWarmed() const { return m_nWarmed; }
+    /// number of files whose warm-up had not finished at the file boundary, and the time waited for them
+    int nWaits() const { return m_nWaits; }
+    uint64_t waitNs() const { return m_waitNs; }
+    /// time spent by the background thread opening and warming up the files
+    uint64_t warmNs() const { return m_warmNs; }
+    /// bytes of the first clusters read in the background
+    Long64_t bytesPrefetched() const { return m_bytesPrefetched; }
+    /// number of files whose trigger histogram differs from the one of the first file
+    int nTriggerMismatches() const { return m_nTriggerMismatches; }
+    /// one line with the statistics above
+    void print(std::ostream &out) const;
+
+    /// bin labels of the "trig" histogram of file; empty if there is none
+    static std::vector<std::string> triggerLabels(TFile* file);
+
+private:
+    ChainPrefetchDriver(const ChainPrefetchDriver&);
+    ChainPrefetchDriver& operator=(const ChainPrefetchDriver&);
+
+    /// a file opened and warmed up by the background thread
+    struct WarmFile {
+        Int_t treeNumber;
+        std::string name;
+        std::vector<std::string> branches; ///< branches to prefetch (all if empty)
+        TFile* file;
+        bool ok;
+        Long64_t bytes;
+        uint64_t ns;
+        std::vector<std::string> triggerLabels;
+        WarmFile() : treeNumber(-1), file(0), ok(false), bytes(0), ns(0) {}
+    };
+    /// start warming up tree treeNumber of the chain in the background
+    void startWarmup(Int_t treeNumber);
+    /// wait for the background warm-up; return its tree number, -1 if there was none or it failed
+    Int_t finishWarmup();
+    /// close the warm-up copy of the file
+    void releaseWarmup();
+    /// branches in the TTreeCache of the current file; empty while it is learning
+    std::vector<std::string> cachedBranches() const;
+    /// body of the background thread; sets done at the end
+    static void warmup(WarmFile &warm, const std::string &treeName, std::atomic<bool> &done);
+
+    TChain* m_chain;
+    Long64_t m_cacheSize;
+    bool m_prefetch;
+    bool m_verbose;
+    std::thread m_thread;
+    WarmFile m_warm;                      ///< only used by the background thread while it runs
+    std::atomic<bool> m_warmDone;
+    std::vector<std::string> m_firstTriggerLabels;
+    int m_nWarmed;
+    int m_nWaits;
+    uint64_t m_waitNs;
+    uint64_t m_warmNs;
+    Long64_t m_bytesPrefetched;
+    int m_nTriggerMismatches;
+};
+
+} // Susy
+
+#endif
@@ -0,0 +1,216 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_Cutflow_h
+#define SusyNtuple_Cutflow_h
+
+#include <cstddef>
+#include <initializer_list>
+#include <iosfwd>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class TH1;
+
+namespace Susy {
+
+///  Sequential cutflow with raw, weighted and sumw2 counts for several columns
+/**
+   The cuts are registered once; each event is then evaluated into a
+   mask with one bit per cut, and counted at each cut up to the first
+   one that fails:
+   \code
+   Cutflow cutflow("dilepton");
+   const size_t os = cutflow.addCut("opposite sign");
+   const size_t mll = cutflow.addCut("mll > 20 GeV");
+   cutflow.addColumn("EE"); cutflow.addColumn("MM"); cutflow.addColumn("EM");
+   ...
+   Cutflow::Mask pass = 0;
+   if(isOS) pass |= Cutflow::bit(os);
+   if(mll>20.) pass |= Cutflow::bit(mll);
+   cutflow.fill(pass, weight, flavor);
+   \endcode
+   A column is a systematic variation or a channel; the counts of all
+   cuts and columns are kept in contiguous arrays, so adding a column
+   costs neither code nor time per cut.
+
+   A cut can use a later weight 'stage' (e.g. after a b-tagging scale
+   factor is applied): fill() then takes one weight per stage,
+   fill(pass, {w, w*btagSF}).
+
+   Cutflows with the same cuts and columns, filled by different
+   threads or jobs, can be combined with merge(), also after a write()
+   and read() roundtrip.
+ */
+class Cutflow {
+
+public:
+    typedef uint64_t Mask;
+    static const size_t maxCuts = 64;
+
+    explicit Cutflow(const std::string &name="");
+
+    const std::string& name() const { return m_name; }
+    /// append a cut counted with the weight of stage; returns its index
+    size_t addCut(const std::string &name, size_t stage=0);
+    /// append a column; returns its index. Without columns there is one, called "nominal".
+    size_t addColumn(const std::string &name);
+    size_t nCuts() const { return m_cuts.size(); }
+    size_t nColumns() const { return m_columns.empty() ? 1 : m_columns.size(); }
+    const std::string& cut(size_t i) const { return m_cuts[i]; }
+    const std::string& column(size_t i) const;
+    /// index of the cut called name, or nCuts()
+    size_t findCut(const std::string &name) const;
+
+    /// mask with the bit of cut i
+    static Mask bit(size_t cut) { return cut<maxCuts ? (Mask(1) << cut) : 0; }
+    /// number of leading cuts passed
+    static size_t nPassed(Mask pass);
+
+    /// count an event passing the cuts of pass, up to the first one that fails
+    void fill(Mask pass, double weight=1.0, size_t column=0);
+    /// same, with one weight per stage (a cut with a stage beyond the list uses the last one)
+    void fill(Mask pass, std::initializer_list<double> weights, size_t column=0);
+    /// count an event passing all the cuts
+    void fillAll(double weight=1.0, size_t column=0) { fill(~Mask(0), weight, column); }
+
+    uint64_t raw(size_t cut, size_t column=0) const { return m_raw[index(cut, column)]; }
+    double weighted(size_t cut, size_t column=0) const { return m_sumw[index(cut, column)]; }
+    double sumw2(size_t cut, size_t column=0) const { return m_sumw2[index(cut, column)]; }
+
+    /// reset all the counts
+    void clear();
+    /// add the counts of other; false (and nothing added) if the cuts, stages or columns differ
+    bool merge(const Cutflow &other);
+
+    /// table with one row per cut, "weighted [raw]" for each column
+    void print(std::ostream &out, int width=20) const;
+    /// text format, one line per cut and per count, lossless
+    void write(std::ostream &out) const;
+    bool write(const std::string &filename) const;
+    /// read what write() wrote; false (and *this unchanged) on a malformed input
+    bool read(std::istream &in);
+    bool read(const std::string &filename);
+
+private:
+    size_t index(size_t cut, size_t column) const { return column*m_cuts.size() + cut; }
+    /// resize the counters to the cuts and columns, keeping the counts of the existing cuts
+    void resize(size_t nCuts, size_t nColumns);
+    void add(size_t n, const double *weights, size_t nWeights, size_t column);
+
+    std::string m_name;
+    std::vector<std::string> m_cuts;
+    std::vector<size_t> m_stages;       ///< weight stage of each cut
+    std::vector<std::string> m_columns;
+    std::vector<uint64_t> m_raw;        ///< [column*nCuts + cut]
+    std::vector<double> m_sumw;
+    std::vector<double> m_sumw2;
+};
+
+///  Yields of many regions, each requiring a set of cuts of the same event mask
+/**
+   The cuts are evaluated once per event into a mask (as for
+   Cutflow); a region passes if the mask has all its cuts, so that
+   hundreds of signal and control regions cost one comparison each:
+   \code
+   RegionSet regions("SR");
+   const size_t os = regions.addCut("opposite sign");
+   const size_t met = regions.addCut("MET > 100 GeV");
+   const size_t bveto = regions.addCut("b-jet veto");
+   regions.addRegion("SR-met", {"opposite sign", "MET > 100 GeV", "b-jet veto"});
+   regions.addRegion("CR-top", RegionSet::bit(os) | RegionSet::bit(met));
+   regions.addNMinusOne(0, met, metHisto); // MET of the events passing all the other cuts of SR-met
+   ...
+   double values[3] = {0, metValue, 0};
+   regions.fill(pass, weight, flavor, values);
+   \endcode
+   A region requiring a cut to fail needs the inverted cut as a cut
+   of its own. As for Cutflow, regions can use a later weight stage,
+   and the yields have one column per systematic or channel, merge
+   across jobs and round-trip through a text format (the N-1
+   histograms are not part of it).
+ */
+class RegionSet {
+
+public:
+    typedef Cutflow::Mask Mask;
+    static const size_t maxCuts = Cutflow::maxCuts;
+
+    explicit RegionSet(const std::string &name="");
+
+    const std::string& name() const { return m_name; }
+    /// append a cut; returns its bit
+    size_t addCut(const std::string &name);
+    size_t nCuts() const { return m_cuts.size(); }
+    const std::string& cut(size_t i) const { return m_cuts[i]; }
+    /// index of the cut called name, or nCuts()
+    size_t findCut(const std::string &name) const;
+    static Mask bit(size_t cut) { return Cutflow::bit(cut); }
+
+    /// append a region requiring all the cuts of required, counted with the weight of stage; returns its index
+    size_t addRegion(const std::string &name, Mask required, size_t stage=0);
+    /// same, with the names of the cuts; returns nRegions() (and adds nothing) if a cut is unknown
+    size_t addRegion(const std::string &name, const std::vector<std::string> &cuts, size_t stage=0);
+    size_t nRegions() const { return m_regions.size(); }
+    const std::string& region(size_t i) const { return m_regions[i]; }
+    Mask required(size_t region) const { return m_required[region]; }
+    /// append a column; returns its index. Without columns there is one, called "nominal".
+    size_t addColumn(const std::string &name);
+    size_t nColumns() const { return m_columns.empty() ? 1 : m_columns.size(); }
+    const std::string& column(size_t i) const;
+
+    /// fill histogram with values[cut] for the events passing all the cuts of region except cut (not owned)
+    void addNMinusOne(size_t region, size_t cut, TH1 *histogram);
+
+    bool pass(size_t region, Mask pass) const { return (pass & m_required[region])==m_required[region]; }
+    /// the cuts of region that the event fails
+    Mask failed(size_t region, Mask pass) const { return m_required[region] & ~pass; }
+
+    /// count the event in all the regions it passes; values (one per cut) are needed for the N-1 histograms
+    void fill(Mask pass, double weight=1.0, size_t column=0, const double *values=0);
+    /// same, with one weight per stage (a region with a stage beyond the list uses the last one)
+    void fill(Mask pass, std::initializer_list<double> weights, size_t column=0, const double *values=0);
+
+    uint64_t raw(size_t region, size_t column=0) const { return m_raw[index(region, column)]; }
+    double weighted(size_t region, size_t column=0) const { return m_sumw[index(region, column)]; }
+    double sumw2(size_t region, size_t column=0) const { return m_sumw2[index(region, column)]; }
+
+    /// reset all the yields (not the N-1 histograms)
+    void clear();
+    /// add the yields of other; false (and nothing added) if the cuts, regions, stages or columns differ
+    bool merge(const RegionSet &other);
+
+    /// table with one row per region, "weighted [raw]" for each column
+    void print(std::ostream &out, int width=20) const;
+    void write(std::ostream &out) const;
+    bool write(const std::string &filename) const;
+    /// read what write() wrote (without N-1 histograms); false (and *this unchanged) on a malformed input
+    bool read(std::istream &in);
+    bool read(const std::string &filename);
+
+private:
+    size_t index(size_t region, size_t column) const { return column*m_regions.size() + region; }
+    void resize(size_t nRegions, size_t nColumns);
+    void add(Mask pass, const double *weights, size_t nWeights, size_t column, const double *values);
+
+    struct NMinusOne {
+        Mask required;   ///< the other cuts of the region
+        size_t cut;
+        size_t stage;
+        TH1 *histogram;
+    };
+
+    std::string m_name;
+    std::vector<std::string> m_cuts;
+    std::vector<std::string> m_regions;
+    std::vector<Mask> m_required;       ///< cuts of each region
+    std::vector<size_t> m_stages;       ///< weight stage of each region
+    std::vector<std::string> m_columns;
+    std::vector<uint64_t> m_raw;        ///< [column*nRegions + region]
+    std::vector<double> m_sumw;
+    std::vector<double> m_sumw2;
+    std::vector<NMinusOne> m_nMinusOne;
+};
+
+} // Susy
+
+#endif
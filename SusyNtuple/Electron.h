@@ -3,6 +3,7 @@
 #define SUSYNTUPLE_ELECTRON_H
 
 // std
+#include <set>
 #include <vector>
 
 // SusyNtuple
@@ -97,6 +98,11 @@ public:
     /// Shift energy up/down for systematic
     void setState(int sys);
 
+    /// false if the SF uncertainty for sys has been stripped (see SusyNtSlimmer::setSystematicsToKeep)
+    bool hasSys(NtSys::SusyNtSys sys) const;
+    /// drop the SF uncertainties of the systematics that are not in keep
+    void stripSys(const std::set<NtSys::SusyNtSys> &keep);
+
     /// Print method
     void print() const;
 
@@ -6,10 +6,15 @@
 #include "SusyNtuple/AnalysisType.h"
 #include "SusyNtuple/ElectronId.h"
 #include "SusyNtuple/Isolation.h"
+#include "SusyNtuple/Electron.h"
+#include "SusyNtuple/SusyDefs.h" // ElectronVector
+#include "SusyNtuple/vec_utils.h"
+#include "SusyNtuple/ObjectStatus.h"
 
+#include <cmath>
+#include <typeinfo>
 
 namespace Susy {
-class Electron;
 
 /// A class to select electrons
 /**
@@ -21,6 +26,10 @@ class Electron;
 
    The analysis-specific selector should be instantiated with ElectronsSelector::build().
 
+   As for MuonSelector, the analysis-specific criteria are inline
+   policies (e.g. ElectronPolicy_2Lep) and build() returns
+   ElectronSelectorT adapters.
+
    For details on the design and implementation of this class, see the
    documentation for JetSelector.
 
@@ -48,6 +57,12 @@ public:
 
     virtual bool passIpCut(const Electron &el);
     virtual bool outsideCrackRegion(const Electron &el);
+    /// append to out the electrons of in passing isBaseline()
+    virtual void selectBaseline(const ElectronVector &in, ElectronVector &out);
+    /// append to out the electrons of in passing isSignal()
+    virtual void selectSignal(const ElectronVector &in, ElectronVector &out);
+    /// set the Baseline and PassSignal bits of the electrons in status (see ObjectStatus)
+    virtual void classify(ObjectStatus::Collection<Electron> &status);
 
     /// id of signal electron, used to determine err SF
     ElectronId signalId() const { return m_signalId; }
@@ -91,58 +106,194 @@ protected :
 
 //----------------------------------------------------------
 //
-// End generic selector, begin analysis-specific ones
+// End generic selector, begin compile-time policies
 //
 //----------------------------------------------------------
 
-/// implements electron selection for ATL-COM-PHYS-2013-911
-class ElectronSelector_2Lep : public ElectronSelector
+/// generic electron criteria, as inline static functions
+/**
+   Self is the analysis policy deriving from ElectronCriteria (CRTP);
+   see MuonCriteria.
+*/
+template<class Self>
+struct ElectronCriteria
 {
-    virtual bool isBaseline(const Electron* el);
-    virtual bool passIpCut(const Electron  &el);
-    virtual bool isSignal(const Electron* el);
+    static bool isBaseline(const Electron &el)
+    {
+        return (el.looseLLHBLayer && // good for all
+                el.passOQBadClusElectron &&
+                el.Pt()  > 10.0 &&
+                std::abs(el.clusEta) < 2.47 ); // SUSYTools uses CaloCluster::eta() for this but CaloCluster::etaBE(2) for crack region...
+    }
+    static bool isSignal(const Electron &el)
+    {
+        return (el.Pt() > 10.0 && // good for all
+                std::abs(el.Eta()) < 2.47 &&
+                el.tightLLH &&
+                Self::passIpCut(el) &&
+                el.isoGradientLoose);
+    }
+    static bool passIpCut(const Electron &el)
+    {
+        return (std::abs(el.d0sigBSCorr)  < 5.0 &&
+                std::abs(el.z0SinTheta()) < 0.5 );
+    }
+    static bool outsideCrackRegion(const Electron &el)
+    {
+        return (std::abs(el.clusEtaBE) < 1.37 ||
+                std::abs(el.clusEtaBE) > 1.52 );
+    }
 };
 
-/// implements electron selection for ATL-COM-PHYS-2013-888
-class ElectronSelector_3Lep : public ElectronSelector
+/// ElectronSelector implemented by the compile-time Policy (see MuonSelectorT)
+template<class Policy, class Self=void>
+class ElectronSelectorT : public ElectronSelector
 {
+public:
+    typedef Policy policy_type;
+    bool isBaseline(const Electron* el) override { return el && Policy::isBaseline(*el); }
+    bool isSignal(const Electron* el) override { return el && Policy::isSignal(*el); }
+    bool passIpCut(const Electron &el) override { return Policy::passIpCut(el); }
+    bool outsideCrackRegion(const Electron &el) override { return Policy::outsideCrackRegion(el); }
+    void selectBaseline(const ElectronVector &in, ElectronVector &out) override
+    {
+        if(!usesPolicy()) return ElectronSelector::selectBaseline(in, out);
+        utils::appendIf(in, out, [](const Electron &el) { return Policy::isBaseline(el); });
+    }
+    void selectSignal(const ElectronVector &in, ElectronVector &out) override
+    {
+        if(!usesPolicy()) return ElectronSelector::selectSignal(in, out);
+        utils::appendIf(in, out, [](const Electron &el) { return Policy::isSignal(el); });
+    }
+    void classify(ObjectStatus::Collection<Electron> &status) override
+    {
+        if(!usesPolicy()) return ElectronSelector::classify(status);
+        const ElectronVector &in = status.objects();
+        std::vector<uint8_t> &bits = status.bits();
+        for(size_t i=0; i<in.size(); ++i) {
+            const Electron &o = *in[i];
+            bits[i] |= ((Policy::isBaseline(o) ? ObjectStatus::Baseline : 0) |
+                        (Policy::isSignal(o) ? ObjectStatus::PassSignal : 0));
+        }
+    }
+protected:
+    /// whether the per-object checks are the Policy ones (no subclass overrides them)
+    bool usesPolicy() const
+    { return typeid(*this)==typeid(ElectronSelectorT) || typeid(*this)==typeid(Self); }
 };
 
+//----------------------------------------------------------
+//
+// Analysis-specific policies and selectors
+//
+//----------------------------------------------------------
+
+/// generic electron selection
+struct ElectronPolicy : ElectronCriteria<ElectronPolicy> {};
+
+/// implements electron selection for ATL-COM-PHYS-2013-911
+struct ElectronPolicy_2Lep : ElectronCriteria<ElectronPolicy_2Lep>
+{
+    static bool isSignal(const Electron &el)
+    {
+        return (isBaseline(el)      &&
+                el.mediumLLH        &&
+                el.isoGradientLoose &&
+                passIpCut(el));
+    }
+};
+class ElectronSelector_2Lep : public ElectronSelectorT<ElectronPolicy_2Lep, ElectronSelector_2Lep> {};
+
+/// implements electron selection for ATL-COM-PHYS-2013-888
+struct ElectronPolicy_3Lep : ElectronCriteria<ElectronPolicy_3Lep> {};
+class ElectronSelector_3Lep : public ElectronSelectorT<ElectronPolicy_3Lep, ElectronSelector_3Lep> {};
+
 /// implements electron selection for 4L
-class ElectronSelector_4Lep : public ElectronSelector
+struct ElectronPolicy_4Lep : ElectronCriteria<ElectronPolicy_4Lep>
 {
-    virtual bool isSignal(const Electron* el);
+    static bool isSignal(const Electron &el)
+    {
+        return (isBaseline(el) &&
+                el.mediumLLH &&
+                el.isoGradientLoose &&
+                passIpCut(el));
+    }
 };
+class ElectronSelector_4Lep : public ElectronSelectorT<ElectronPolicy_4Lep, ElectronSelector_4Lep> {};
 
 /// implements electron selection for ATL-COM-PHYS-2014-221
-class ElectronSelector_2LepWH : public ElectronSelector
+struct ElectronPolicy_2LepWH : ElectronCriteria<ElectronPolicy_2LepWH>
 {
-    virtual bool passIpCut(const Electron &el);
+    static bool passIpCut(const Electron &el)
+    {
+        return (std::abs(el.d0sigBSCorr)  < 3.0 && // tighter than default
+                std::abs(el.z0SinTheta()) < 0.4 );
+    }
 };
+class ElectronSelector_2LepWH : public ElectronSelectorT<ElectronPolicy_2LepWH, ElectronSelector_2LepWH> {};
 
 /// implements electron selection from https://twiki.cern.ch/twiki/bin/viewauth/AtlasProtected/SUSYSameSignLeptonsJetsRun2
-class ElectronSelector_SS3L : public ElectronSelector
+struct ElectronPolicy_SS3L : ElectronCriteria<ElectronPolicy_SS3L>
 {
-    virtual bool isBaseline(const Electron* el);
-    virtual bool isSignal(const Electron* el);
+    static bool isBaseline(const Electron &el)
+    {
+        return (el.looseLLH &&
+                el.passOQBadClusElectron &&
+                el.Pt()                   > 10.0  &&
+                std::abs(el.clusEta)      <  2.47 &&
+                std::abs(el.d0sigBSCorr)  <  5.0  &&
+                outsideCrackRegion(el));
+    }
+    static bool isSignal(const Electron &el)
+    {
+        bool isIsolated = ((el.ptvarcone20/el.Pt()  < 0.06) &&
+                           (el.etconetopo20/el.Pt() < 0.06) );
+        bool passLH = (el.Pt() < 300 ? el.tightLLH : el.mediumLLH);
+        return (isBaseline(el) &&
+                isIsolated &&
+                passLH &&
+                std::abs(el.trackEta)     <  2.0 &&
+                std::abs(el.z0SinTheta()) <  0.5 );
+    }
 };
+class ElectronSelector_SS3L : public ElectronSelectorT<ElectronPolicy_SS3L, ElectronSelector_SS3L> {};
 
 /// implements electron selection from https://twiki.cern.ch/twiki/bin/view/AtlasProtected/DirectStop2Lepton
-class ElectronSelector_Stop2L : public ElectronSelector
+struct ElectronPolicy_Stop2L : ElectronCriteria<ElectronPolicy_Stop2L>
 {
-    virtual bool passIpCut(const Electron  &el);
-    virtual bool isSignal(const Electron* el);
+    static bool passIpCut(const Electron &el)
+    {
+        return (std::abs(el.d0sigBSCorr)  < 3.0 &&
+                std::abs(el.z0SinTheta()) < 0.5 );
+    }
+    static bool isSignal(const Electron &el)
+    {
+        return (isBaseline(el) &&
+                el.mediumLLH &&
+                el.isoGradientLoose &&
+                passIpCut(el));
+    }
 };
+class ElectronSelector_Stop2L : public ElectronSelectorT<ElectronPolicy_Stop2L, ElectronSelector_Stop2L> {};
 
 /// WWBB analysis
-class ElectronSelector_WWBB : public ElectronSelector
+struct ElectronPolicy_WWBB : ElectronCriteria<ElectronPolicy_WWBB>
 {
-    virtual bool passIpCut(const Electron &el);
-    virtual bool isBaseline(const Electron* el);
-    virtual bool isSignal(const Electron* el);
+    static bool passIpCut(const Electron &el)
+    {
+        return (std::abs(el.d0sigBSCorr) < 3.0 && std::abs(el.z0SinTheta()) < 0.5);
+    }
+    static bool isSignal(const Electron &el)
+    {
+        return (isBaseline(el) &&
+                el.mediumLLH &&
+                el.isoFixedCutTightTrackOnly &&
+                passIpCut(el) &&
+                outsideCrackRegion(el));
+    }
 };
+class ElectronSelector_WWBB : public ElectronSelectorT<ElectronPolicy_WWBB, ElectronSelector_WWBB> {};
+
 } // Susy
 
 #endif
-
-
@@ -0,0 +1,101 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_EntryRangeDriver_h
+#define SusyNtuple_EntryRangeDriver_h
+
+#include "SusyNtuple/EventlistCache.h"
+#include "SusyNtuple/PickEventList.h"
+
+#include "Rtypes.h"
+
+#include <vector>
+
+class TChain;
+class TSelector;
+class TTree;
+
+namespace Susy {
+
+///  Drive a TSelector over the entries stored in an EventlistCache
+/**
+   TChain::Process (with or without a TEventList) reads every cluster
+   of every file. This driver instead, for each file in the chain:
+   - looks up the cached selection (see EventlistCache::fileKey())
+   - groups the selected entries by the clusters they belong to
+   - restricts the TTreeCache to one group of clusters at the time,
+     so that only the baskets of clusters with selected entries are
+     read and decompressed
+   - while a group is being processed, asks the file to prefetch the
+     baskets of the next group (TFile::ReadBufferAsync).
+
+   Files that are not in the cache are skipped. The selector sees the
+   same sequence of calls as with TChain::Process (Begin, SlaveBegin,
+   Init, Notify, Process(local entry), SlaveTerminate, Terminate).
+
+   Usage:
+   \code
+   EventlistHandler list;
+   list.setCacheFilename("cache/sample.evl").fetchCache();
+   EntryRangeDriver driver(chain, list.cache());
+   driver.process(&analysis);
+   \endcode
+   To pick a list of run:event pairs, the cache can instead be built
+   with selectEvents(), which reads only the 'event' branch.
+ */
+class EntryRangeDriver {
+
+public:
+    /// a group of selected entries sharing the clusters [first, end)
+    struct ClusterBlock {
+        Long64_t first; ///< first entry of the first cluster
+        Long64_t end;   ///< first entry after the last cluster
+        std::vector<EntryRange> ranges; ///< selected entries in this block
+        ClusterBlock(Long64_t f, Long64_t e) : first(f), end(e) {}
+    };
+
+    EntryRangeDriver(TChain* chain, const EventlistCache &cache);
+
+    /// size of the TTreeCache (bytes)
+    EntryRangeDriver& setCacheSize(Long64_t value) { m_cacheSize = value; return *this; }
+    /// toggle prefetching of the next block of clusters
+    EntryRangeDriver& setPrefetch(bool value=true) { m_prefetch = value; return *this; }
+    EntryRangeDriver& setVerbose(bool value=true) { m_verbose = value; return *this; }
+
+    /// loop on the selected entries; process at most nEntries of them (all if <0). Return the number processed.
+    /**
+       As with TChain::Process, the selected entries before the chain
+       entry firstEntry are skipped.
+     */
+    Long64_t process(TSelector* selector, const char* option="", Long64_t nEntries=-1, Long64_t firstEntry=0);
+
+    /**
+       Fill cache with the entries of chain whose run:event is in pick.
+       Only the 'event' branch is read, so this costs a small fraction
+       of a full pass on the chain. The files are read through a chain
+       of their own: the branch status, addresses and cache of chain
+       are not changed. Return the number of entries found.
+     */
+    static Long64_t selectEvents(TChain* chain, const PickEventList &pick, EventlistCache &cache,
+                                 bool verbose=false);
+    /// group the selection for tree into blocks of clusters
+    static std::vector<ClusterBlock> clusterBlocks(TTree* tree, const EventlistCache::FileSelection &sel);
+
+    Long64_t nClustersRead() const { return m_nClustersRead; }
+    Long64_t nClustersTotal() const { return m_nClustersTotal; }
+
+private:
+    /// hint the file to read the baskets of the cached branches for block
+    void prefetch(TTree* tree, const ClusterBlock &block);
+    static Long64_t countClusters(TTree* tree, Long64_t first, Long64_t end);
+
+    TChain* m_chain;
+    const EventlistCache &m_cache;
+    Long64_t m_cacheSize;
+    bool m_prefetch;
+    bool m_verbose;
+    Long64_t m_nClustersRead;  ///< clusters containing at least one selected entry
+    Long64_t m_nClustersTotal; ///< clusters in the files that were processed
+};
+
+} // Susy
+
+#endif
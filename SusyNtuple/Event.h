@@ -7,7 +7,8 @@
 #include "SusyNtuple/SusyDefs.h" // DataStream
 #include "SusyNtuple/TriggerTools.h" // DileptonTrigTuple
 
-#include "TBits.h"
+#include "SusyNtuple/TriggerBits.h"
+
 #include "TObject.h"
 
 namespace Susy
@@ -17,8 +18,7 @@ namespace Susy
 class Event: public TObject
 {
 public:
-    Event() :
-        trigBits(m_nTriggerBits)
+    Event()
         {
             clear();
         }
@@ -63,8 +63,8 @@ public:
     //unsigned int trigFlags; ///< Event level trigger bits
     long long trigFlags;      ///< Event level trigger bits
 
-    TBits               trigBits;
-    static const size_t m_nTriggerBits=64;
+    TriggerBits         trigBits; ///< fired triggers, bit i is TriggerTools::getTrigNames()[i] (TBits up to v39)
+    static const size_t m_nTriggerBits=TriggerBits::nBits;
 
     // Dilepton trigger matching information
     std::map<DileptonTrigTuple, int> m_dilepton_trigger_matches; 
@@ -126,7 +126,7 @@ public:
       m_dilepton_trigger_matches.clear();
     }
 
-    ClassDef(Event, 39);
+    ClassDef(Event, 40);
   };
 } // Susy
 #endif
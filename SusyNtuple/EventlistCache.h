@@ -0,0 +1,138 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_EventlistCache_h
+#define SusyNtuple_EventlistCache_h
+
+#include <cstddef>
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace Susy {
+
+/// A contiguous range of selected entries [first, end) within one tree
+struct EntryRange {
+    uint64_t first; ///< first selected entry
+    uint64_t end;   ///< one past the last selected entry
+    EntryRange() : first(0), end(0) {}
+    EntryRange(uint64_t f, uint64_t e) : first(f), end(e) {}
+    uint64_t size() const { return end - first; }
+};
+
+///  Compact binary cache of selected entries, keyed by input file
+/**
+   The selection is stored as run-length encoded bitmaps: for each
+   input file there is a sorted list of non-overlapping EntryRange
+   objects, in local (per-tree) entry numbers. Files are identified
+   by a hash of their basename and number of entries (see fileKey()),
+   so the cache does not depend on the order in which files are added
+   to a TChain, nor on the directory they are read from.
+
+   On-disk layout (native byte order, all fields 8-byte aligned):
+   \code
+   Header     : magic[8] version(u32) nFiles(u32) nRanges(u64) reserved(u64)
+   FileRecord : key nEntries firstRange nRanges nSelected  (u64 each, sorted by key)
+   EntryRange : first end                                   (u64 each)
+   \endcode
+   read() memory-maps the file, so loading a cache costs one mmap
+   regardless of its size.
+
+   Filling with add() is O(1) when entries come in increasing order
+   (the usual case in an event loop).
+
+   See EventlistHandler for the interface to be used from a looper.
+ */
+class EventlistCache {
+
+public:
+    /// read-only view of the selection for one file
+    class FileSelection {
+    public:
+        FileSelection() : m_begin(0), m_end(0), m_nEntries(0), m_nSelected(0) {}
+        FileSelection(const EntryRange* b, const EntryRange* e, uint64_t nEntries, uint64_t nSelected) :
+            m_begin(b), m_end(e), m_nEntries(nEntries), m_nSelected(nSelected) {}
+        const EntryRange* begin() const { return m_begin; }
+        const EntryRange* end() const { return m_end; }
+        size_t nRanges() const { return m_end - m_begin; }
+        /// number of entries in the tree when the selection was made
+        uint64_t nEntries() const { return m_nEntries; }
+        /// number of selected entries
+        uint64_t nSelected() const { return m_nSelected; }
+        /// whether entry is selected (binary search on the ranges)
+        bool contains(uint64_t entry) const;
+    private:
+        const EntryRange* m_begin;
+        const EntryRange* m_end;
+        uint64_t m_nEntries;
+        uint64_t m_nSelected;
+    };
+
+    EventlistCache();
+    ~EventlistCache();
+
+    /// key used to identify an input file; depends only on its basename and number of entries
+    static uint64_t fileKey(const std::string &filename, uint64_t nEntries);
+    /// whether filename starts with the EventlistCache magic string
+    static bool isCacheFile(const std::string &filename);
+
+    /// add one selected entry of the file identified by key
+    EventlistCache& add(uint64_t key, uint64_t nEntries, uint64_t entry);
+    /// write the selection to filename; return false on failure
+    bool write(const std::string &filename) const;
+    /// memory-map the selection stored in filename; return false on failure
+    bool read(const std::string &filename);
+    /// drop the current selection (and unmap the file, if any)
+    void clear();
+
+    /// fill sel with the selection for key; return false if the file is unknown
+    bool find(uint64_t key, FileSelection &sel) const;
+    /// whether entry of the file identified by key is selected
+    bool contains(uint64_t key, uint64_t entry) const;
+    /// keys of all the files in the cache, sorted
+    std::vector<uint64_t> keys() const;
+    size_t nFiles() const;
+    uint64_t nSelected() const;
+    bool isMapped() const { return m_mapAddress!=0; }
+
+private:
+    EventlistCache(const EventlistCache&);
+    EventlistCache& operator=(const EventlistCache&);
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t nFiles;
+        uint64_t nRanges;
+        uint64_t reserved;
+    };
+    struct FileRecord {
+        uint64_t key;
+        uint64_t nEntries;
+        uint64_t firstRange;
+        uint64_t nRanges;
+        uint64_t nSelected;
+    };
+    struct FileBuilder {
+        uint64_t nEntries;
+        uint64_t nSelected;
+        std::vector<EntryRange> ranges;
+        FileBuilder() : nEntries(0), nSelected(0) {}
+    };
+    static const char s_magic[8];
+    static const uint32_t s_version = 1;
+
+    void unmap();
+    /// copy the mapped selection into m_files, so that it can be extended
+    void materialize();
+
+    std::map<uint64_t, FileBuilder> m_files; ///< selection being built (or copied from an unmapped file)
+    void* m_mapAddress;                      ///< base address of the mapped file, if any
+    size_t m_mapSize;
+    const Header* m_header;
+    const FileRecord* m_records;
+    const EntryRange* m_ranges;
+};
+
+} // Susy
+
+#endif
@@ -2,22 +2,30 @@
 #ifndef SUSY_EVENTLISTHANDLER_H
 #define SUSY_EVENTLISTHANDLER_H
 
+#include "SusyNtuple/EventlistCache.h"
+
 #include "TEventList.h"
 
 #include <string>
 
-class TFile;
+class TTree;
 
 namespace Susy {
-///  A class to cache a TEventList for SusyNt
+///  A class to cache the list of selected entries for SusyNt
 /**
-  Usage: set the cache filename. On the first run, the TEventList is
-  created and filled. Then just check cacheDoesExists(), and call
-  TChain::SetEventList(EventlistHandler::fecthEventList())
+  Usage: set the cache filename and the input tree (normally the
+  TChain being processed). On the first run, call addEvent() for the
+  selected entries; the cache is written when the handler is
+  destroyed. On the following runs, check cacheDoesExists() and call
+  fetchCache(); then either test isSelected() at the top of Process(),
+  or loop only on the selected entries with EntryRangeDriver.
+
+  The cache is an EventlistCache: selected entries are stored as
+  ranges of local entry numbers for each input file, so the order in
+  which the files are added to the TChain does not matter.
 
-  Caveat:
-  - if you are using a TChain, the trees must be added in the same
-    order from one run to the next. Use a filelist to ensure this
+  Caches written by older versions of this class (a TEventList stored
+  in a root file) can still be read with fetchEventList().
 
   See test_EventlistHandler.cxx for an example of how this class can be used
 
@@ -29,28 +37,43 @@ public:
     EventlistHandler();
     ~EventlistHandler();
     bool cacheDoesExists() const;
-    EventlistHandler& setCacheFilename(const std::string value="./cache/Sample_eventList.root");
+    EventlistHandler& setCacheFilename(const std::string value="./cache/Sample_eventList.evl");
     EventlistHandler& setListName(const std::string value="EventList") { m_listName = value; return *this; }
+    /// tree (or TChain) being processed; used to determine which file an entry belongs to
+    EventlistHandler& setInputTree(TTree* tree);
+    /// add a selected entry (local entry in the current tree, as provided to TSelector::Process)
     EventlistHandler& addEvent(Long64_t entry);
     EventlistHandler& setVerbose(bool value=true) { m_verbose = value; return *this; }
-    TEventList* eventList() { return &m_eventlist; }
+    /// load (mmap) the cache; return false if it cannot be read
+    bool fetchCache();
+    /// whether the entry of the current tree is in the cache
+    bool isSelected(Long64_t entry);
+    /// write the cache now rather than in the destructor
+    bool saveCache();
+    const EventlistCache& cache() const { return m_cache; }
+    /// the cached selection as a TEventList in TChain entry numbers (slow, for backward compatibility)
     TEventList* fetchEventList();
+    TEventList* eventList() { return &m_eventlist; }
     std::string cacheFilename() const { return m_cacheFilename; }
-    
+
 private: // rule of three
 //    EventlistHandler& (const EventlistHandler&);
 //    EventlistHandler& operator=(const EventlistHandler&);
 private:
-    bool initOutputFile();
-    bool outputFileExists();
-    bool closeOutputFile();
+    /// update the key of the current file when the tree changes
+    void updateCurrentFile();
+    bool fetchLegacyEventList();
     void setDefaultValues();
 private:
     std::string m_cacheFilename;
     std::string m_listName;
     bool m_firstEventHasBeenProcessed;
+    EventlistCache m_cache;
     TEventList m_eventlist;
-    TFile *m_cacheFile;
+    TTree *m_tree;              ///< input tree (or TChain)
+    Int_t m_treeNumber;         ///< TChain tree number for which m_fileKey was computed
+    uint64_t m_fileKey;         ///< EventlistCache::fileKey of the current file
+    uint64_t m_fileEntries;     ///< number of entries in the current file
     bool m_verbose;
 };
 } // Susy
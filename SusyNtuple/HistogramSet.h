@@ -0,0 +1,165 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_HistogramSet_h
+#define SusyNtuple_HistogramSet_h
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class TH1F;
+
+namespace Susy {
+
+///  1D histograms filled from several threads, merged deterministically
+/**
+   The histograms are booked once (e.g. in Begin()); each worker then
+   fills its own Filler, i.e. private arrays of bin contents, without
+   locks and without touching ROOT (no TH1 lookup, no gDirectory):
+   \code
+   HistogramSet histos;
+   const size_t hMll = histos.book("h_mll", "m_{ll};m_{ll} [GeV];Entries", 50, 0.0, 250.0);
+   histos.setBatchSize(256);                      // optional: buffer the fills
+   ...
+   HistogramSet::Filler &filler = histos.filler(workerIndex);  // once per worker
+   filler.fill(hMll, mll, weight);
+   ...
+   histos.merge();                                // in Terminate(), after the workers
+   TH1F *h = histos.toTH1F(hMll);
+   \endcode
+   merge() adds the fillers in the order of their slot index, so that
+   the result does not depend on thread scheduling (for a given
+   assignment of the events to the slots). A single-threaded loop can
+   use fill(), which fills slot 0.
+
+   Bins follow the ROOT convention: 0 is the underflow, nBins+1 the
+   overflow. Book all histograms before the first fill.
+ */
+class HistogramSet {
+
+public:
+    ///  Name, titles, binning and labels of one histogram
+    struct Definition {
+        std::string name;
+        std::string title;
+        std::string titleX;
+        std::string titleY;
+        int nBins;
+        double low;
+        double high;
+        std::vector<double> edges;  ///< empty for uniform bins
+        std::vector<std::pair<int, std::string> > labels;
+        Definition() : nBins(1), low(0.0), high(1.0) {}
+        /// nBins uniform bins in [low, high) (one bin, and a message, if invalid)
+        Definition(const std::string &name, const std::string &title, int nBins, double low, double high,
+                   const std::string &titleX="", const std::string &titleY="");
+        /// nBins+1 increasing bin edges (one bin in [0, 1], and a message, if invalid)
+        Definition(const std::string &name, const std::string &title, const std::vector<double> &edges,
+                   const std::string &titleX="", const std::string &titleY="");
+        /// bin of x: 0 is the underflow, nBins+1 the overflow (and NaN)
+        int findBin(double x) const;
+        /// empty TH1F with this binning, titles and labels (with Sumw2, not attached to any directory)
+        TH1F* makeTH1F(const std::string &suffix="") const;
+    };
+
+    ///  Private bin contents of one worker
+    class Filler {
+    public:
+        /// add weight to the bin of x in histogram id
+        void fill(size_t id, double x, double weight=1.0)
+        {
+            if(m_set.m_batchSize==0) { add(id, x, weight); return; }
+            m_buffer.push_back(Entry(id, x, weight));
+            if(m_buffer.size()>=m_set.m_batchSize) flush();
+        }
+        /// apply the buffered fills
+        void flush();
+        /// drop all the contents
+        void clear();
+    private:
+        friend class HistogramSet;
+        struct Entry {
+            size_t id;
+            double x;
+            double weight;
+            Entry(size_t i, double v, double w) : id(i), x(v), weight(w) {}
+        };
+        explicit Filler(const HistogramSet &set);
+        Filler(const Filler&);
+        Filler& operator=(const Filler&);
+        void add(size_t id, double x, double weight);
+        /// make room for histograms booked after this filler
+        void resize();
+
+        const HistogramSet &m_set;
+        std::vector<Entry> m_buffer;
+        std::vector<double> m_sumw;     ///< [offset(id) + bin]
+        std::vector<double> m_sumw2;
+        std::vector<uint64_t> m_entries; ///< [id]
+    };
+
+    HistogramSet();
+    ~HistogramSet();
+
+    /// book a histogram with nBins uniform bins in [low, high); return its id
+    size_t book(const std::string &name, const std::string &title, int nBins, double low, double high,
+                const std::string &titleX="", const std::string &titleY="");
+    /// same, with the nBins+1 bin edges
+    size_t book(const std::string &name, const std::string &title, const std::vector<double> &edges,
+                const std::string &titleX="", const std::string &titleY="");
+    /// label of bin (1 to nBins) of histogram id, used by toTH1F()
+    HistogramSet& setBinLabel(size_t id, int bin, const std::string &label);
+    size_t nHistograms() const { return m_histograms.size(); }
+    const Definition& definition(size_t id) const { return m_histograms[id]; }
+    const std::string& name(size_t id) const { return m_histograms[id].name; }
+    /// id of the histogram called name, or nHistograms()
+    size_t find(const std::string &name) const;
+    int nBins(size_t id) const { return m_histograms[id].nBins; }
+    /// bin of x in histogram id
+    int findBin(size_t id, double x) const { return m_histograms[id].findBin(x); }
+
+    /// buffer this many fills per Filler before adding them (0, the default: add immediately); set before filling
+    HistogramSet& setBatchSize(size_t value) { m_batchSize = value; return *this; }
+    /// buffers of worker slot (created on the first call; keep the reference in the worker)
+    Filler& filler(size_t slot);
+    size_t nFillers() const;
+    /// fill slot 0
+    void fill(size_t id, double x, double weight=1.0) { m_first->fill(id, x, weight); }
+
+    /// flush the fillers and add them to the result, in slot order; call when no worker is filling
+    void merge();
+    /// merged contents (after merge())
+    double content(size_t id, int bin) const { return m_sumw[m_histograms[id].offset + bin]; }
+    double sumw2(size_t id, int bin) const { return m_sumw2[m_histograms[id].offset + bin]; }
+    uint64_t entries(size_t id) const { return m_entries[id]; }
+    /// new TH1F with the merged contents (with Sumw2, not attached to any directory; owned by the caller)
+    TH1F* toTH1F(size_t id) const;
+    /// drop the contents of the fillers and of the result
+    void clear();
+
+private:
+    HistogramSet(const HistogramSet&);
+    HistogramSet& operator=(const HistogramSet&);
+
+    struct Histogram : public Definition {
+        size_t offset;              ///< of bin 0 in the content arrays
+        Histogram(const Definition &d, size_t o) : Definition(d), offset(o) {}
+    };
+    size_t add(const Definition &d);
+    size_t nCells() const { return m_sumw.size(); }
+
+    std::vector<Histogram> m_histograms;
+    size_t m_batchSize;
+    mutable std::mutex m_mutex;         ///< protects m_fillers
+    std::vector<std::unique_ptr<Filler> > m_fillers; ///< [slot]
+    Filler* m_first;                    ///< slot 0
+    std::vector<double> m_sumw;         ///< merged, [offset(id) + bin]
+    std::vector<double> m_sumw2;
+    std::vector<uint64_t> m_entries;
+};
+
+} // Susy
+
+#endif
@@ -5,6 +5,9 @@
 #include "SusyNtuple/Particle.h"
 #include "SusyNtuple/SusyNtSys.h"
 
+#include <set>
+#include <vector>
+
 namespace Susy
 {
 /// Jet class
@@ -78,6 +81,11 @@ public:
     float getFTSys(Susy::NtSys::SusyNtSys sys);
     void  setFTSys(Susy::NtSys::SusyNtSys sys, double scale);
 
+    /// false if the groupedNP or FTSys payload for sys has been stripped (see SusyNtSlimmer::setSystematicsToKeep)
+    bool hasSys(Susy::NtSys::SusyNtSys sys) const;
+    /// drop groupedNP (FTSys) if none of the JES (flavor tagging) systematics are in keep
+    void stripSys(const std::set<Susy::NtSys::SusyNtSys> &keep);
+
     // Print method
     void print() const;
 
@@ -5,10 +5,15 @@
 #include "SusyNtuple/SusyNtSys.h"
 #include "SusyNtuple/AnalysisType.h"
 #include "SusyNtuple/SusyDefs.h" // JetVector
+#include "SusyNtuple/Jet.h"
+#include "SusyNtuple/vec_utils.h"
+#include "SusyNtuple/ObjectStatus.h"
 
-namespace Susy {
+#include <algorithm>
+#include <cmath>
+#include <typeinfo>
 
-class Jet;
+namespace Susy {
 
 ///  A class to select jets
 /**
@@ -43,6 +48,13 @@ class Jet;
 
    See test_JetSelector.cxx for an example of how this class can be used
 
+   The analysis-specific criteria are written as inline policies
+   (e.g. JetPolicy_SS3L) deriving from JetCriteria, and the
+   analysis-specific selectors are JetSelectorT adapters implementing
+   the virtual interface with them. The selection loops
+   (selectBaseline(), count_CL_jets(), ...) then cost one virtual call
+   per collection, and the per-jet checks are inlined in the loop.
+
    Note to self:
    design choices tested in https://gist.github.com/gerbaudo/7854402
 
@@ -79,6 +91,12 @@ public:
 
     virtual bool isBaseline(const Jet* jet); ///< often analsysi-dependent
     virtual bool isSignal(const Jet* jet); ///< often analsysi-dependent
+    /// append to out the jets of in passing isBaseline()
+    virtual void selectBaseline(const JetVector &in, JetVector &out);
+    /// append to out the jets of in passing isSignal()
+    virtual void selectSignal(const JetVector &in, JetVector &out);
+    /// set the Baseline and PassSignal bits and the jet categories of the jets in status (see ObjectStatus)
+    virtual void classify(ObjectStatus::Collection<Jet> &status);
 
     bool verbose() const { return m_verbose; }
     JetSelector& setVerbose(bool v) { m_verbose = v; return *this; }
@@ -123,53 +141,212 @@ private:
 
 //----------------------------------------------------------
 //
-// End generic selector, begin analysis-specific ones
+// End generic selector, begin compile-time policies
 //
 //----------------------------------------------------------
 
-/// implements jet selection from ATL-COM-PHYS-2013-911
-class JetSelector_2Lep : public JetSelector
+/// generic jet criteria, as inline static functions
+/**
+   Self is the analysis policy deriving from JetCriteria (CRTP): e.g.
+   a policy redefining isB() also changes isCentralLight() and
+   isSignal(), as an override would in the virtual interface.
+*/
+template<class Self>
+struct JetCriteria
 {
+    static bool isBaseline(const Jet &jet)
+    {
+        return (jet.Pt() > 20.0);
+    }
+    static bool isSignal(const Jet &jet)
+    {
+        return (Self::isCentralLight(jet) ||
+                Self::isCentralB(jet) ||
+                Self::isForward(jet));
+    }
+    static bool isB(const Jet &jet)
+    {
+        return ((jet.Pt()             > 20.0   ) &&
+                (std::fabs(jet.Eta()) <  2.5   ) &&
+                (jet.mv2c10           > JetSelector::mv2c10_77efficiency()) &&
+                (passJvt(jet)));
+    }
+    static bool isCentralLight(const Jet &jet)
+    {
+        return (jet.Pt()              > 20.0 &&
+                std::fabs(jet.detEta) <  2.4 &&
+                passJvt(jet) &&
+                !Self::isB(jet));
+    }
+    static bool isCentralB(const Jet &jet)
+    {
+        return (jet.Pt()              > 20.0 &&
+                std::fabs(jet.detEta) <  2.4 &&
+                passJvt(jet) &&
+                Self::isB(jet));
+    }
+    static bool isForward(const Jet &jet)
+    {
+        return (jet.Pt()              > 30.0 &&
+                std::fabs(jet.detEta) >  2.4 &&
+                std::fabs(jet.detEta) <  4.5 );
+    }
+    /// see JetSelector::passJvt
+    static bool passJvt(const Jet &jet)
+    {
+        return ((jet.jvt              >  0.59) ||
+                (std::fabs(jet.Eta()) >  2.4)  ||
+                (jet.Pt()             > 60.0) );
+    }
 };
-/// implements jet selection from ATL-COM-PHYS-2013-888
-class JetSelector_3Lep : public JetSelector
+
+/// JetSelector implemented by the compile-time Policy (see MuonSelectorT)
+template<class Policy, class Self=void>
+class JetSelectorT : public JetSelector
 {
+public:
+    typedef Policy policy_type;
+    bool isB(const Jet* jet) override { return jet && Policy::isB(*jet); }
+    bool isCentralLight(const Jet* jet) override { return jet && Policy::isCentralLight(*jet); }
+    bool isCentralB(const Jet* jet) override { return jet && Policy::isCentralB(*jet); }
+    bool isForward(const Jet* jet) override { return jet && Policy::isForward(*jet); }
+    bool isBaseline(const Jet* jet) override { return jet && Policy::isBaseline(*jet); }
+    bool isSignal(const Jet* jet) override { return jet && Policy::isSignal(*jet); }
+    void selectBaseline(const JetVector &in, JetVector &out) override
+    {
+        if(!usesPolicy()) return JetSelector::selectBaseline(in, out);
+        utils::appendIf(in, out, [](const Jet &jet) { return Policy::isBaseline(jet); });
+    }
+    void selectSignal(const JetVector &in, JetVector &out) override
+    {
+        if(!usesPolicy()) return JetSelector::selectSignal(in, out);
+        utils::appendIf(in, out, [](const Jet &jet) { return Policy::isSignal(jet); });
+    }
+    void classify(ObjectStatus::Collection<Jet> &status) override
+    {
+        if(!usesPolicy()) return JetSelector::classify(status);
+        const JetVector &in = status.objects();
+        std::vector<uint8_t> &bits = status.bits();
+        for(size_t i=0; i<in.size(); ++i) {
+            const Jet &o = *in[i];
+            bits[i] |= ((Policy::isBaseline(o) ? ObjectStatus::Baseline : 0) |
+                        (Policy::isSignal(o) ? ObjectStatus::PassSignal : 0) |
+                        (Policy::isCentralLight(o) ? ObjectStatus::CentralLight : 0) |
+                        (Policy::isCentralB(o) ? ObjectStatus::CentralB : 0) |
+                        (Policy::isForward(o) ? ObjectStatus::Forward : 0));
+        }
+    }
+    size_t count_CL_jets(const JetVector &jets) override
+    {
+        if(!usesPolicy()) return JetSelector::count_CL_jets(jets);
+        return std::count_if(jets.begin(), jets.end(), [](const Jet* j) { return j && Policy::isCentralLight(*j); });
+    }
+    size_t count_CB_jets(const JetVector &jets) override
+    {
+        if(!usesPolicy()) return JetSelector::count_CB_jets(jets);
+        return std::count_if(jets.begin(), jets.end(), [](const Jet* j) { return j && Policy::isCentralB(*j); });
+    }
+    size_t count_F_jets(const JetVector &jets) override
+    {
+        if(!usesPolicy()) return JetSelector::count_F_jets(jets);
+        return std::count_if(jets.begin(), jets.end(), [](const Jet* j) { return j && Policy::isForward(*j); });
+    }
+protected:
+    /// whether the per-object checks are the Policy ones (no subclass overrides them)
+    bool usesPolicy() const
+    { return typeid(*this)==typeid(JetSelectorT) || typeid(*this)==typeid(Self); }
 };
 
+//----------------------------------------------------------
+//
+// Analysis-specific policies and selectors
+//
+//----------------------------------------------------------
+
+/// generic jet selection
+struct JetPolicy : JetCriteria<JetPolicy> {};
+
+/// implements jet selection from ATL-COM-PHYS-2013-911
+struct JetPolicy_2Lep : JetCriteria<JetPolicy_2Lep> {};
+class JetSelector_2Lep : public JetSelectorT<JetPolicy_2Lep, JetSelector_2Lep> {};
+
+/// implements jet selection from ATL-COM-PHYS-2013-888
+struct JetPolicy_3Lep : JetCriteria<JetPolicy_3Lep> {};
+class JetSelector_3Lep : public JetSelectorT<JetPolicy_3Lep, JetSelector_3Lep> {};
+
 /// implements jet selection for 4L
-class JetSelector_4Lep : public JetSelector
-{
-  bool isBaseline(const Jet* jet);
-};
+struct JetPolicy_4Lep : JetCriteria<JetPolicy_4Lep> {};
+class JetSelector_4Lep : public JetSelectorT<JetPolicy_4Lep, JetSelector_4Lep> {};
 
 /// implements jet selection from ATL-COM-PHYS-2014-221
-class JetSelector_2LepWH : public JetSelector
-{
-};
+struct JetPolicy_2LepWH : JetCriteria<JetPolicy_2LepWH> {};
+class JetSelector_2LepWH : public JetSelectorT<JetPolicy_2LepWH, JetSelector_2LepWH> {};
 
 /// implements jet selection from https://twiki.cern.ch/twiki/bin/viewauth/AtlasProtected/SUSYSameSignLeptonsJetsRun2
-class JetSelector_SS3L : public JetSelector
+struct JetPolicy_SS3L : JetCriteria<JetPolicy_SS3L>
+{
+    // Note: abs(eta) < 2.8 criterion in `isSignal` so that
+    //       overlap removal can be performed using baseline jets
+    static bool isSignal(const Jet &jet)
+    {
+        return (isBaseline(jet) &&
+                jet.Pt()             > 20.0 &&
+                std::fabs(jet.Eta()) <  2.8 &&
+                passJvt(jet)                );
+    }
+    static bool isB(const Jet &jet)
+    {
+        return (jet.Pt()             > 20.0    &&
+                std::fabs(jet.Eta()) <  2.5    &&
+                passJvt(jet)                   &&
+                jet.mv2c10           > JetSelector::mv2c10_70efficiency());
+    }
+    static bool isB_for_OR(const Jet &jet)
+    {
+        return (jet.Pt()             > 20.0    &&
+                std::fabs(jet.Eta()) <  2.5    &&
+                passJvt(jet)                   &&
+                jet.mv2c10           > JetSelector::mv2c10_85efficiency());
+    }
+};
+class JetSelector_SS3L : public JetSelectorT<JetPolicy_SS3L, JetSelector_SS3L>
 {
-    virtual bool isBaseline(const Jet* jet);
-    virtual bool isSignal(const Jet* jet);
-    virtual bool isB(const Jet* jet);
 public:
-    virtual bool isB_for_OR(const Jet* jet);
+    bool isB_for_OR(const Jet* jet) { return jet && JetPolicy_SS3L::isB_for_OR(*jet); }
 };
 
 /// implements jet selection from https://twiki.cern.ch/twiki/bin/view/AtlasProtected/DirectStop2Lepton
-class JetSelector_Stop2L : public JetSelector
+struct JetPolicy_Stop2L : JetCriteria<JetPolicy_Stop2L>
 {
-    virtual bool isBaseline(const Jet* jet);
-    virtual bool isSignal(const Jet* jet);
+    static bool isSignal(const Jet &jet)
+    {
+        return (jet.Pt()             > 20.0 &&
+                std::fabs(jet.Eta()) <  2.8 &&
+                passJvt(jet));
+    }
 };
+class JetSelector_Stop2L : public JetSelectorT<JetPolicy_Stop2L, JetSelector_Stop2L> {};
 
-class JetSelector_WWBB : public JetSelector
+struct JetPolicy_WWBB : JetCriteria<JetPolicy_WWBB>
 {
-    virtual bool isBaseline(const Jet* jet);
-    virtual bool isSignal(const Jet* jet);
-    virtual bool isB(const Jet* jet);
-    virtual bool isBMod(const Jet* jet, int wp=77, float ptcut=20.);
+    static bool isSignal(const Jet &jet)
+    {
+        return (jet.Pt() > 20.0 &&
+                std::fabs(jet.Eta()) < 2.8 &&
+                passJvt(jet));
+    }
+    static bool isB(const Jet &jet)
+    {
+        return (jet.Pt() > 20.0 &&
+                std::fabs(jet.Eta()) < 2.5 &&
+                passJvt(jet) &&
+                jet.mv2c10 > JetSelector::mv2c10_85efficiency());
+    }
+};
+class JetSelector_WWBB : public JetSelectorT<JetPolicy_WWBB, JetSelector_WWBB>
+{
+public:
+    bool isBMod(const Jet* jet, int wp=77, float ptcut=20.) override;
 };
 } // Susy
 
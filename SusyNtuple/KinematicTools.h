@@ -9,6 +9,7 @@
 #include "SusyNtuple/SusyDefs.h"
 #include "SusyNtuple/SusyNt.h"
 #include "SusyNtuple/SusyNtObject.h"
+#include "SusyNtuple/TruthGraph.h"
 
 using namespace Susy;
 
@@ -22,6 +23,8 @@ namespace kin {
 // SUSY-ness
 /////////////////////////////////////////////
 bool eventHasSusyPropagators(const std::vector<int> &pdgs, const std::vector<std::vector<int>> &parentIndices);
+// same, on the truth graph of the event built for the other truth queries
+bool eventHasSusyPropagators(const Susy::mc::TruthGraph &graph);
 
 /* ----------------------------------------------------------------- */
 /*  Kinematic calculations [begin]                                   */
@@ -4,7 +4,7 @@
 
 #include "SusyNtuple/Particle.h"
 
-#include "TBits.h"
+#include "SusyNtuple/TriggerBits.h"
 
 namespace Susy
 {
@@ -12,8 +12,7 @@ namespace Susy
 class Lepton : public Particle
 {
 public:
-    Lepton() :
-        trigBits(m_nTriggerBits)
+    Lepton()
         {
             clear();
         }
@@ -83,8 +82,8 @@ public:
     float effSF;              ///< Efficiency scale factor  (for electron from LH)
     //float errEffSF;           ///< Uncertainty on the efficiency scale factor (for electron from LH)
 
-    TBits   trigBits;         ///< TBits to store matched trigger chains
-    static const size_t m_nTriggerBits=64;
+    TriggerBits trigBits;     ///< matched trigger chains (TBits up to v25)
+    static const size_t m_nTriggerBits=TriggerBits::nBits;
 
     /// Methods to return impact parameter variables
     /** Note that these are not absolute valued! */
@@ -122,7 +121,7 @@ public:
         Particle::clear();
     }
 
-    ClassDef(Lepton, 25);
+    ClassDef(Lepton, 26);
 };
 } // Susy
 #endif
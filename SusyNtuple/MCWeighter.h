@@ -94,6 +94,8 @@ class MCWeighter
 
         double getMCWeight(const Susy::Event* evt, const float lumi = 1000,
                 Susy::NtSys::SusyNtSys sys = Susy::NtSys::NOM, bool includePileup = true);
+        /// whether getMCWeight depends on sys (pileup and cross-section), i.e. differs from the nominal
+        static bool affectsMCWeight(Susy::NtSys::SusyNtSys sys);
 
         double getSumw(const Susy::Event* evt);
 
@@ -8,6 +8,7 @@
 
 #include <vector>
 #include <map>
+#include <set>
 
 namespace Susy
 {
@@ -111,6 +112,11 @@ public:
     bool isMu()  const { return true; }
     void setState(int sys);
 
+    /// false if the SF uncertainty for sys has been stripped (see SusyNtSlimmer::setSystematicsToKeep)
+    bool hasSys(NtSys::SusyNtSys sys) const;
+    /// drop the SF uncertainties of the systematics that are not in keep
+    void stripSys(const std::set<NtSys::SusyNtSys> &keep);
+
     /// Print method
     void print() const;
 
@@ -6,12 +6,16 @@
 #include "SusyNtuple/AnalysisType.h"
 #include "SusyNtuple/Isolation.h"
 #include "SusyNtuple/MuonId.h"
+#include "SusyNtuple/Muon.h"
+#include "SusyNtuple/SusyDefs.h" // MuonVector
+#include "SusyNtuple/vec_utils.h"
+#include "SusyNtuple/ObjectStatus.h"
 
+#include <cmath>
+#include <typeinfo>
 
 namespace Susy {
 
-class Muon;
-
 /// A class to select muons
 /**
    The generic MuonSelector implements the generic definitions from
@@ -22,6 +26,11 @@ class Muon;
 
    The analysis-specific selector should be instantiated with MuonsSelector::build().
 
+   The analysis-specific criteria are inline policies (e.g.
+   MuonPolicy_2Lep) known at compile time; the classes returned by
+   build() are MuonSelectorT adapters implementing this virtual
+   interface with them.
+
    For details on the design and implementation of this class, see the
    documentation for JetSelector.
 
@@ -47,6 +56,12 @@ public :
     virtual bool isSignal(const Muon* mu);
     /// whether mu is close enough to the primary vertex
     virtual bool passIpCut(const Muon* mu);
+    /// append to out the muons of in passing isBaseline()
+    virtual void selectBaseline(const MuonVector &in, MuonVector &out);
+    /// append to out the muons of in passing isSignal()
+    virtual void selectSignal(const MuonVector &in, MuonVector &out);
+    /// set the Baseline and PassSignal bits of the muons in status (see ObjectStatus)
+    virtual void classify(ObjectStatus::Collection<Muon> &status);
     /// nominal efficiency scale factor of mu
     virtual float effSF(const Muon& mu, const NtSys::SusyNtSys sys);
     /// wraps effSF() above
@@ -83,57 +98,188 @@ protected :
 
 //----------------------------------------------------------
 //
-// End generic selector, begin analysis-specific ones
+// End generic selector, begin compile-time policies
+//
+//----------------------------------------------------------
+
+/// generic muon criteria, as inline static functions
+/**
+   Self is the analysis policy deriving from MuonCriteria (CRTP): the
+   checks that depend on other checks call them through Self, so that
+   an analysis policy redefining e.g. passIpCut() also changes its
+   isSignal(), as an override would in the virtual interface.
+*/
+template<class Self>
+struct MuonCriteria
+{
+    static bool isBaseline(const Muon &mu)
+    {
+        return (mu.medium &&
+                mu.Pt()             > 10.0 &&
+                std::fabs(mu.Eta()) <  2.4 );
+    }
+    static bool isSignal(const Muon &mu)
+    {
+        return (mu.Pt() > 10.0 &&
+                mu.medium &&
+                mu.isoGradientLoose &&
+                Self::passIpCut(mu));
+    }
+    static bool passIpCut(const Muon &mu)
+    {
+        return (std::fabs(mu.d0sigBSCorr)  < 3.0 &&
+                std::fabs(mu.z0SinTheta()) < 0.5 );
+    }
+};
+
+/// MuonSelector implemented by the compile-time Policy
+/**
+   The virtual functions forward to the inline Policy functions, and
+   selectBaseline()/selectSignal() call them in the loop, so that a
+   collection costs one virtual call rather than one per muon.
+
+   Self is the analysis selector built with this policy (e.g.
+   MuonSelector_2Lep). An analysis selector can still be subclassed to
+   tweak a cut: when the object is not exactly a Self, the loops fall
+   back to the MuonSelector ones, which call the overridden per-muon
+   functions.
+*/
+template<class Policy, class Self=void>
+class MuonSelectorT : public MuonSelector
+{
+public:
+    typedef Policy policy_type;
+    bool isBaseline(const Muon* mu) override { return mu && Policy::isBaseline(*mu); }
+    bool isSignal(const Muon* mu) override { return mu && Policy::isSignal(*mu); }
+    bool passIpCut(const Muon* mu) override { return mu && Policy::passIpCut(*mu); }
+    void selectBaseline(const MuonVector &in, MuonVector &out) override
+    {
+        if(!usesPolicy()) return MuonSelector::selectBaseline(in, out);
+        utils::appendIf(in, out, [](const Muon &mu) { return Policy::isBaseline(mu); });
+    }
+    void selectSignal(const MuonVector &in, MuonVector &out) override
+    {
+        if(!usesPolicy()) return MuonSelector::selectSignal(in, out);
+        utils::appendIf(in, out, [](const Muon &mu) { return Policy::isSignal(mu); });
+    }
+    void classify(ObjectStatus::Collection<Muon> &status) override
+    {
+        if(!usesPolicy()) return MuonSelector::classify(status);
+        const MuonVector &in = status.objects();
+        std::vector<uint8_t> &bits = status.bits();
+        for(size_t i=0; i<in.size(); ++i) {
+            const Muon &o = *in[i];
+            bits[i] |= ((Policy::isBaseline(o) ? ObjectStatus::Baseline : 0) |
+                        (Policy::isSignal(o) ? ObjectStatus::PassSignal : 0));
+        }
+    }
+protected:
+    /// whether the per-object checks are the Policy ones (no subclass overrides them)
+    bool usesPolicy() const
+    { return typeid(*this)==typeid(MuonSelectorT) || typeid(*this)==typeid(Self); }
+};
+
+//----------------------------------------------------------
+//
+// Analysis-specific policies and selectors
 //
 //----------------------------------------------------------
 
+/// generic muon selection
+struct MuonPolicy : MuonCriteria<MuonPolicy> {};
+
 /// implements muon selection for ATL-COM-PHYS-2013-911
-class MuonSelector_2Lep : public MuonSelector
+struct MuonPolicy_2Lep : MuonCriteria<MuonPolicy_2Lep>
 {
-    bool isBaseline(const Muon* mu);
-    virtual bool isSignal(const Muon* mu);
+    static bool isSignal(const Muon &mu)
+    {
+        return (isBaseline(mu)      &&
+                mu.isoGradientLoose &&
+                passIpCut(mu)       );
+    }
 };
+class MuonSelector_2Lep : public MuonSelectorT<MuonPolicy_2Lep, MuonSelector_2Lep> {};
 
 /// implements muon selection for ATL-COM-PHYS-2013-888
-class MuonSelector_3Lep : public MuonSelector
+struct MuonPolicy_3Lep : MuonCriteria<MuonPolicy_3Lep>
 {
-    virtual bool isSignal(const Muon* mu);
+    static bool isSignal(const Muon &mu)
+    {
+        return (isBaseline(mu) &&
+                mu.isoFixedCutTightTrackOnly &&
+                passIpCut(mu));
+    }
 };
+class MuonSelector_3Lep : public MuonSelectorT<MuonPolicy_3Lep, MuonSelector_3Lep> {};
 
 /// implements muon selection for 4L
-class MuonSelector_4Lep : public MuonSelector
+struct MuonPolicy_4Lep : MuonCriteria<MuonPolicy_4Lep>
 {
-    bool isBaseline(const Muon* mu);
+    static bool isBaseline(const Muon &mu)
+    {
+        return (mu.medium &&
+                mu.Pt()             > 10.0 &&
+                std::fabs(mu.Eta()) <  2.5 );
+    }
 };
+class MuonSelector_4Lep : public MuonSelectorT<MuonPolicy_4Lep, MuonSelector_4Lep> {};
 
 /// implements muon selection for ATL-COM-PHYS-2014-221
-class MuonSelector_2LepWH : public MuonSelector
+struct MuonPolicy_2LepWH : MuonCriteria<MuonPolicy_2LepWH>
 {
-    virtual bool isSignal(const Muon* mu);
+    static bool isSignal(const Muon &mu)
+    {
+        return (isBaseline(mu) &&
+                mu.ptvarcone30/mu.Pt()  < 0.06 &&
+                mu.etconetopo30/mu.Pt() < 0.14 &&
+                passIpCut(mu));
+    }
 };
+class MuonSelector_2LepWH : public MuonSelectorT<MuonPolicy_2LepWH, MuonSelector_2LepWH> {};
 
 /// implements https://twiki.cern.ch/twiki/bin/viewauth/AtlasProtected/SUSYSameSignLeptonsJetsRun2
-class MuonSelector_SS3L : public MuonSelector
+struct MuonPolicy_SS3L : MuonCriteria<MuonPolicy_SS3L>
 {
-    virtual bool isBaseline(const Muon* mu);
-    virtual bool isSignal(const Muon* mu);
+    static bool isBaseline(const Muon &mu)
+    {
+        return (mu.medium &&
+                mu.Pt()             > 10.0 &&
+                std::fabs(mu.Eta()) <  2.5 );
+    }
+    static bool isSignal(const Muon &mu)
+    {
+        return (isBaseline(mu) &&
+                mu.ptvarcone30/mu.Pt() < 0.06 &&
+                passIpCut(mu));
+    }
 };
+class MuonSelector_SS3L : public MuonSelectorT<MuonPolicy_SS3L, MuonSelector_SS3L> {};
 
 /// implements Muon selection from https://twiki.cern.ch/twiki/bin/view/AtlasProtected/DirectStop2Lepton
-class MuonSelector_Stop2L : public MuonSelector
+struct MuonPolicy_Stop2L : MuonCriteria<MuonPolicy_Stop2L>
 {
-    virtual bool isBaseline(const Muon* mu);
-    virtual bool isSignal(const Muon* mu);
+    static bool isSignal(const Muon &mu)
+    {
+        return (mu.Pt() > 10.0 &&
+                isBaseline(mu) &&
+                mu.isoGradientLoose &&
+                passIpCut(mu));
+    }
 };
+class MuonSelector_Stop2L : public MuonSelectorT<MuonPolicy_Stop2L, MuonSelector_Stop2L> {};
+
 /// implements muon selection for Analysis WWBB
-class MuonSelector_WWBB : public MuonSelector
+struct MuonPolicy_WWBB : MuonCriteria<MuonPolicy_WWBB>
 {
-    virtual bool isBaseline(const Muon* mu);
-    virtual bool isSignal(const Muon* mu);
+    static bool isSignal(const Muon &mu)
+    {
+        return (isBaseline(mu) &&
+                mu.isoFixedCutTightTrackOnly &&
+                passIpCut(mu));
+    }
 };
-
+class MuonSelector_WWBB : public MuonSelectorT<MuonPolicy_WWBB, MuonSelector_WWBB> {};
 
 } // end namespace
 
 #endif
-
@@ -0,0 +1,134 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_ObjectStatus_h
+#define SusyNtuple_ObjectStatus_h
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+namespace Susy {
+
+class Electron;
+class Muon;
+class Jet;
+class Tau;
+class Photon;
+
+///  Selection status of the objects of one event, as one byte per object
+/**
+   Filled by SusyNtTools::classifyObjects(), which calls the selectors
+   once per collection (see e.g. MuonSelector::classify()) for the
+   current systematic. The object vectors (baseline, signal, b-jets,
+   ...) and the counts are then derived from the bits without calling
+   the selectors again:
+   \code
+   const ObjectStatus &status = nttools.classifyObjects(&nt, sys);
+   status.jets.select(ObjectStatus::Baseline, baseJets);
+   nttools.overlapTool().performOverlap(baseElectrons, baseMuons, baseJets, baseTaus, basePhotons);
+   nttools.markOverlapSurvivors(baseElectrons, baseMuons, baseJets, baseTaus, basePhotons);
+   status.jets.select(ObjectStatus::Signal, signalJets);
+   size_t nBJets = status.jets.count(signalJets, ObjectStatus::CentralB);
+   \endcode
+   The bits are valid until the next classifyObjects() or
+   SusyNtTools::clearObjectStatus().
+ */
+class ObjectStatus {
+
+public:
+    enum Bit {
+        Pre             = 1<<0, ///< in the SusyNt collection (always set)
+        Baseline        = 1<<1, ///< passes the selector's isBaseline()
+        OverlapSurvivor = 1<<2, ///< baseline, and kept by the overlap removal
+        PassSignal      = 1<<3, ///< passes the selector's isSignal()
+        Signal          = 1<<4, ///< OverlapSurvivor and PassSignal
+        CentralLight    = 1<<5, ///< jets: JetSelector::isCentralLight()
+        CentralB        = 1<<6, ///< jets: JetSelector::isCentralB() (i.e. b-tagged)
+        Forward         = 1<<7  ///< jets: JetSelector::isForward()
+    };
+
+    ///  Bits of the objects of one collection
+    /**
+       The objects are kept in the order of the pre-selected vector
+       (i.e. sorted by pt), so that the selected vectors are sorted
+       too. Objects are found from their pointer into the SusyNt
+       vector.
+     */
+    template<class T>
+    class Collection {
+    public:
+        Collection() : m_begin(0) {}
+        /// start a new event; objects point into the SusyNt vector starting at begin
+        void reset(const std::vector<T*> &objects, const T *begin)
+        {
+            m_objects = objects;
+            m_bits.assign(objects.size(), Pre);
+            m_begin = begin;
+            size_t n = 0;
+            for(size_t i=0; i<objects.size(); ++i)
+                if(objects[i]-begin>=static_cast<ptrdiff_t>(n)) n = objects[i]-begin+1;
+            m_position.assign(n, -1);
+            for(size_t i=0; i<objects.size(); ++i) m_position[objects[i]-begin] = i;
+        }
+        void clear() { m_objects.clear(); m_bits.clear(); m_position.clear(); m_begin = 0; }
+        const std::vector<T*>& objects() const { return m_objects; }
+        /// bits of objects()[i]
+        std::vector<uint8_t>& bits() { return m_bits; }
+        const std::vector<uint8_t>& bits() const { return m_bits; }
+        /// bits of o, 0 if o is not in the collection
+        uint8_t status(const T *o) const
+        {
+            ptrdiff_t i = o - m_begin;
+            if(!o || !m_begin || i<0 || i>=static_cast<ptrdiff_t>(m_position.size()) || m_position[i]<0) return 0;
+            return m_bits[m_position[i]];
+        }
+        bool contains(const T *o) const { return status(o)!=0; }
+        /// set (OR) bit on o, if it is in the collection
+        void set(const T *o, uint8_t bit)
+        {
+            ptrdiff_t i = o - m_begin;
+            if(o && m_begin && i>=0 && i<static_cast<ptrdiff_t>(m_position.size()) && m_position[i]>=0)
+                m_bits[m_position[i]] |= bit;
+        }
+        /// append to out the objects having all the bits of mask
+        void select(uint8_t mask, std::vector<T*> &out) const
+        {
+            for(size_t i=0; i<m_objects.size(); ++i)
+                if((m_bits[i] & mask)==mask) out.push_back(m_objects[i]);
+        }
+        /// number of objects having all the bits of mask
+        size_t count(uint8_t mask) const
+        {
+            size_t n = 0;
+            for(size_t i=0; i<m_bits.size(); ++i) n += ((m_bits[i] & mask)==mask);
+            return n;
+        }
+        /// number of objects of v having all the bits of mask; -1 if some are not in the collection
+        int count(const std::vector<T*> &v, uint8_t mask) const
+        {
+            int n = 0;
+            for(size_t i=0; i<v.size(); ++i) {
+                uint8_t b = status(v[i]);
+                if(!b) return -1;
+                n += ((b & mask)==mask);
+            }
+            return n;
+        }
+    private:
+        std::vector<T*> m_objects;
+        std::vector<uint8_t> m_bits;
+        std::vector<int> m_position; ///< position in m_objects of each SusyNt index, or -1
+        const T *m_begin;
+    };
+
+    Collection<Electron> electrons;
+    Collection<Muon> muons;
+    Collection<Jet> jets;
+    Collection<Tau> taus;
+    Collection<Photon> photons;
+
+    void clear() { electrons.clear(); muons.clear(); jets.clear(); taus.clear(); photons.clear(); }
+};
+
+} // Susy
+
+#endif
@@ -0,0 +1,79 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_PerfCounters_h
+#define SusyNtuple_PerfCounters_h
+
+#include <stdint.h>
+#include <string>
+
+namespace Susy {
+
+/// Values of the hardware counters, or a difference between two readings
+struct PerfSample {
+    uint64_t cycles;
+    uint64_t instructions;
+    uint64_t cacheMisses;   ///< last-level cache misses
+    uint64_t branchMisses;
+    PerfSample() : cycles(0), instructions(0), cacheMisses(0), branchMisses(0) {}
+    PerfSample& operator+=(const PerfSample &o)
+    {
+        cycles += o.cycles; instructions += o.instructions;
+        cacheMisses += o.cacheMisses; branchMisses += o.branchMisses;
+        return *this;
+    }
+    PerfSample operator-(const PerfSample &o) const
+    {
+        PerfSample d;
+        d.cycles = cycles - o.cycles; d.instructions = instructions - o.instructions;
+        d.cacheMisses = cacheMisses - o.cacheMisses; d.branchMisses = branchMisses - o.branchMisses;
+        return d;
+    }
+    /// instructions per cycle
+    double ipc() const { return cycles ? double(instructions)/cycles : 0.0; }
+    /// cache misses per 1000 instructions
+    double cacheMissesPerKiloInstruction() const { return instructions ? 1.0e3*cacheMisses/instructions : 0.0; }
+    /// branch misses per 100 instructions
+    double branchMissPercent() const { return instructions ? 1.0e2*branchMisses/instructions : 0.0; }
+    /// e.g. "IPC 1.52, cache miss/kinstr 2.10, branch miss/instr 0.31%"
+    std::string str() const;
+};
+
+///  Hardware performance counters of the calling thread (Linux perf_event)
+/**
+   Counts cycles, instructions, last-level cache misses and branch
+   misses in user space for the thread that called open(); the four
+   counters are read together with one read() call (about 1 us), so
+   this is meant for stages of at least tens of us, or for blocks of
+   events.
+
+   open() fails, with a message, when perf_event is not available
+   (not Linux, no PMU in a virtual machine, or
+   /proc/sys/kernel/perf_event_paranoid > 2); read() then returns
+   zeros. Counters that the CPU does not provide are left at zero.
+ */
+class PerfCounters {
+
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    /// start counting for the calling thread; return false if the counters are not available
+    bool open();
+    void close();
+    bool isOpen() const { return m_leader>=0; }
+    /// current values (since open)
+    PerfSample read() const;
+
+private:
+    PerfCounters(const PerfCounters&);
+    PerfCounters& operator=(const PerfCounters&);
+
+    static const int s_nCounters = 4;
+    int m_leader;                  ///< group leader (cycles); -1 if not open
+    int m_fds[s_nCounters];
+    int m_slot[s_nCounters];       ///< position of each counter in the group read, -1 if missing
+    int m_nOpen;
+};
+
+} // Susy
+
+#endif
@@ -4,10 +4,15 @@
 
 #include "SusyNtuple/AnalysisType.h"
 #include "SusyNtuple/Isolation.h"
+#include "SusyNtuple/Photon.h"
+#include "SusyNtuple/SusyDefs.h" // PhotonVector
+#include "SusyNtuple/vec_utils.h"
+#include "SusyNtuple/ObjectStatus.h"
 
-namespace Susy {
+#include <cmath>
+#include <typeinfo>
 
-    class Photon;
+namespace Susy {
 
     /// A class to select photons
     /**
@@ -18,6 +23,9 @@ namespace Susy {
         analysis-specific class inheriting from PhotonSelector.
 
         The analysis-specific selector should be instantiated with PhotonSelector::build().
+
+        As for MuonSelector, the analysis-specific criteria are inline
+        policies and build() returns PhotonSelectorT adapters.
     */ 
 
     class PhotonSelector
@@ -34,6 +42,12 @@ namespace Susy {
         virtual bool isBaseline(const Photon* ph); ///< whether photon passes the baseline criteria
         /// whether photon passes the signal criteria
         virtual bool isSignal(const Photon* ph);
+        /// append to out the photons of in passing isBaseline()
+        virtual void selectBaseline(const PhotonVector &in, PhotonVector &out);
+        /// append to out the photons of in passing isSignal()
+        virtual void selectSignal(const PhotonVector &in, PhotonVector &out);
+        /// set the Baseline and PassSignal bits of the photons in status (see ObjectStatus)
+        virtual void classify(ObjectStatus::Collection<Photon> &status);
 
         Isolation signalIsolation() const { return m_signalIsolation; }
 
@@ -56,44 +70,97 @@ namespace Susy {
 
 // ------------------------------------------------------------------
 //
-// End generic selector, begin analysis-specific ones
+// End generic selector, begin compile-time policies
 //
 // ------------------------------------------------------------------
 
-    /// Implement photon selector for Ana_2Lep
-    class PhotonSelector_2Lep : public PhotonSelector
+    /// generic photon criteria, as inline static functions
+    /**
+        Self is the analysis policy deriving from PhotonCriteria (CRTP);
+        see MuonCriteria.
+    */
+    template<class Self>
+    struct PhotonCriteria
     {
+        static bool isBaseline(const Photon &ph)
+        {
+            bool pass_author = (ph.authorPhoton || ph.authorAmbiguous); // reco. as photon OR (photon AND ele)
+            return (ph.tight &&
+                    ph.Pt()        > 25 &&
+                    std::abs(ph.clusEtaBE) < 2.37 &&
+                    pass_author);
+        }
+        static bool isSignal(const Photon &ph)
+        {
+            return (Self::isBaseline(ph) &&
+                    ph.isoFixedCutTight);
+        }
     };
 
-    /// Implement photon selector for Ana_3Lep
-    class PhotonSelector_3Lep : public PhotonSelector
+    /// PhotonSelector implemented by the compile-time Policy (see MuonSelectorT)
+    template<class Policy, class Self=void>
+    class PhotonSelectorT : public PhotonSelector
     {
+        public :
+        typedef Policy policy_type;
+        bool isBaseline(const Photon* ph) override { return ph && Policy::isBaseline(*ph); }
+        bool isSignal(const Photon* ph) override { return ph && Policy::isSignal(*ph); }
+        void selectBaseline(const PhotonVector &in, PhotonVector &out) override
+        {
+            if(!usesPolicy()) return PhotonSelector::selectBaseline(in, out);
+            utils::appendIf(in, out, [](const Photon &ph) { return Policy::isBaseline(ph); });
+        }
+        void selectSignal(const PhotonVector &in, PhotonVector &out) override
+        {
+            if(!usesPolicy()) return PhotonSelector::selectSignal(in, out);
+            utils::appendIf(in, out, [](const Photon &ph) { return Policy::isSignal(ph); });
+        }
+        void classify(ObjectStatus::Collection<Photon> &status) override
+        {
+            if(!usesPolicy()) return PhotonSelector::classify(status);
+            const PhotonVector &in = status.objects();
+            std::vector<uint8_t> &bits = status.bits();
+            for(size_t i=0; i<in.size(); ++i) {
+                const Photon &o = *in[i];
+                bits[i] |= ((Policy::isBaseline(o) ? ObjectStatus::Baseline : 0) |
+                            (Policy::isSignal(o) ? ObjectStatus::PassSignal : 0));
+            }
+        }
+    protected:
+        /// whether the per-object checks are the Policy ones (no subclass overrides them)
+        bool usesPolicy() const
+        { return typeid(*this)==typeid(PhotonSelectorT) || typeid(*this)==typeid(Self); }
     };
 
+// ------------------------------------------------------------------
+//
+// Analysis-specific policies and selectors
+//
+// ------------------------------------------------------------------
+
+    /// generic photon selection
+    struct PhotonPolicy : PhotonCriteria<PhotonPolicy> {};
+
+    /// Implement photon selector for Ana_2Lep
+    class PhotonSelector_2Lep : public PhotonSelectorT<PhotonPolicy, PhotonSelector_2Lep> {};
+
+    /// Implement photon selector for Ana_3Lep
+    class PhotonSelector_3Lep : public PhotonSelectorT<PhotonPolicy, PhotonSelector_3Lep> {};
+
     /// Implement photon selector for Ana_4Lep
-    class PhotonSelector_4Lep : public PhotonSelector
-    {
-    };
+    class PhotonSelector_4Lep : public PhotonSelectorT<PhotonPolicy, PhotonSelector_4Lep> {};
 
     /// Implement photon selector for Ana_2LepWH
-    class PhotonSelector_2LepWH : public PhotonSelector
-    {
-    };
+    class PhotonSelector_2LepWH : public PhotonSelectorT<PhotonPolicy, PhotonSelector_2LepWH> {};
 
     /// Implement photon selector for Ana_SS3L
-    class PhotonSelector_SS3L : public PhotonSelector
-    {
-    };
+    class PhotonSelector_SS3L : public PhotonSelectorT<PhotonPolicy, PhotonSelector_SS3L> {};
 
     /// Implement photon selector for Ana_Stop2L
-    class PhotonSelector_Stop2L : public PhotonSelector
-    {
-    };
+    class PhotonSelector_Stop2L : public PhotonSelectorT<PhotonPolicy, PhotonSelector_Stop2L> {};
 
     /// Implement photon selector for Ana_WWBB
-    class PhotonSelector_WWBB : public PhotonSelector
-    {
-    };
+    class PhotonSelector_WWBB : public PhotonSelectorT<PhotonPolicy, PhotonSelector_WWBB> {};
 } // namespace Susy
 
 #endif
@@ -0,0 +1,61 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_PickEventList_h
+#define SusyNtuple_PickEventList_h
+
+#include "SusyNtuple/RunEventSet.h"
+
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+
+namespace Susy {
+
+///  A list of run:event pairs to be picked from a dataset
+/**
+   The text file has one pair per line; run and event number are
+   separated by blanks, ':' or ','. Empty lines and lines starting
+   with '#' are skipped. The file is read in large blocks and parsed
+   by hand (no fscanf/iostream), so that lists with millions of
+   events can be loaded in a fraction of a second; the pairs are
+   stored in a RunEventSet.
+
+   Usage, to process only the picked events:
+   \code
+   PickEventList pick;
+   pick.read("pick.txt");
+   EventlistCache entries;
+   EntryRangeDriver::selectEvents(chain, pick, entries); // reads only the 'event' branch
+   EntryRangeDriver(chain, entries).process(&analysis);
+   \endcode
+   or, from within a looper, see SusyNtAna::loadEventList().
+ */
+class PickEventList {
+
+public:
+    PickEventList();
+
+    /// read the pairs from filename; return false if it cannot be read
+    bool read(const std::string &filename);
+    /// parse the complete lines in [begin, end); return the number of pairs found
+    size_t parse(const char* begin, const char* end);
+    PickEventList& add(uint32_t run, uint32_t event) { m_events.insert(run, event); return *this; }
+    bool contains(uint32_t run, uint32_t event) const { return m_events.contains(run, event); }
+    /// number of distinct pairs
+    size_t size() const { return m_events.size(); }
+    bool empty() const { return m_events.empty(); }
+    size_t nRuns() const { return m_events.nRuns(); }
+    /// number of lines that could not be parsed
+    size_t nMalformed() const { return m_nMalformed; }
+    void clear() { m_events.clear(); m_nMalformed = 0; }
+    const RunEventSet& events() const { return m_events; }
+    PickEventList& setVerbose(bool value=true) { m_verbose = value; return *this; }
+
+private:
+    RunEventSet m_events;
+    size_t m_nMalformed;
+    bool m_verbose;
+};
+
+} // Susy
+
+#endif
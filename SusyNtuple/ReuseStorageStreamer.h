@@ -0,0 +1,111 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_ReuseStorageStreamer_h
+#define SusyNtuple_ReuseStorageStreamer_h
+
+#include "TBuffer.h"
+#include "TClass.h"
+#include "TClassStreamer.h"
+
+#include <vector>
+
+namespace Susy {
+
+///  Read a std::vector<T> branch in place, reusing the objects of the previous entry
+/**
+   The default ROOT streamer for a (non-split) std::vector<T> clears
+   the vector and then resizes it, so that at each entry every T is
+   destroyed and default-constructed again; for the SusyNt objects
+   this means re-allocating all the std::vector members (SF per WP,
+   systematic payloads, ...).
+
+   This streamer instead resizes the vector only when the multiplicity
+   changes, and streams each element into the existing object; the
+   members are then read into their previous capacity, and in the
+   steady state no allocation is needed. The objects being reused are
+   clear()-ed first, so that members that are not on file (older
+   class versions) are not left over from the previous entry. The
+   buffer layout is the one of the collection streamer (version and
+   byte count, number of elements, elements); a collection streamed
+   member-wise is read by the default streamer.
+
+   Writing, and reading with a different on-file class, are delegated
+   to the original streamer; std::vector<T> usually has none (it is
+   streamed through its collection proxy), and then to the streamer
+   info of the vector class (TBuffer::WriteClassBuffer/ReadClassBuffer),
+   so that writing while the streamer is installed (e.g. SusyNtSlimmer)
+   is unchanged.
+
+   Installed on the vector classes by SusyNtObject::SetReuseStorage().
+ */
+template <class T>
+class ReuseStorageStreamer : public TClassStreamer {
+
+public:
+    /// take ownership of the original streamer of std::vector<T> (see TClass::GetStreamer)
+    explicit ReuseStorageStreamer(TClassStreamer *original) :
+        TClassStreamer(),
+        m_original(original),
+        m_valueClass(TClass::GetClass(typeid(T)))
+    {}
+    ReuseStorageStreamer(const ReuseStorageStreamer &rhs) :
+        TClassStreamer(rhs),
+        m_original(rhs.m_original ? rhs.m_original->Generate() : 0),
+        m_valueClass(rhs.m_valueClass)
+    {}
+    virtual ~ReuseStorageStreamer() { delete m_original; }
+
+    virtual TClassStreamer* Generate() const { return new ReuseStorageStreamer(*this); }
+    /// the original streamer (still owned by this object)
+    const TClassStreamer* original() const { return m_original; }
+
+    virtual void operator()(TBuffer &b, void *objp) { Stream(b, objp, 0); }
+    virtual void Stream(TBuffer &b, void *objp, const TClass *onfileClass)
+    {
+        bool sameClass = (!onfileClass || onfileClass==TClass::GetClass(typeid(std::vector<T>)));
+        if(b.IsWriting() || !sameClass || !m_valueClass) {
+            streamDefault(b, objp, onfileClass);
+            return;
+        }
+        // same layout as the collection streamer: version and byte count, size, elements
+        TClass *vectorClass = TClass::GetClass(typeid(std::vector<T>));
+        const Int_t offset = b.Length();
+        UInt_t start = 0, count = 0;
+        const Version_t version = b.ReadVersion(&start, &count, vectorClass);
+        if(version & TBuffer::kStreamedMemberWise) {
+            // one member at the time for all the elements: leave it to the default streamer
+            b.SetBufferOffset(offset);
+            streamDefault(b, objp, onfileClass);
+            return;
+        }
+        std::vector<T> &v = *static_cast<std::vector<T>*>(objp);
+        Int_t nElements = 0;
+        b >> nElements;
+        const size_t nReused = (v.size() < size_t(nElements) ? v.size() : size_t(nElements));
+        v.resize(nElements);
+        for(Int_t i=0; i<nElements; ++i) {
+            if(size_t(i) < nReused) v[i].clear();
+            m_valueClass->Streamer(&v[i], b);
+        }
+        b.CheckByteCount(start, count, vectorClass);
+    }
+
+private:
+    /// the original streamer if any, otherwise the streamer info of std::vector<T>
+    void streamDefault(TBuffer &b, void *objp, const TClass *onfileClass)
+    {
+        if(m_original) {
+            m_original->Stream(b, objp, onfileClass);
+            return;
+        }
+        TClass *vectorClass = TClass::GetClass(typeid(std::vector<T>));
+        if(b.IsWriting()) b.WriteClassBuffer(vectorClass, objp);
+        else b.ReadClassBuffer(vectorClass, objp, onfileClass);
+    }
+
+    TClassStreamer *m_original;
+    TClass *m_valueClass;
+};
+
+} // Susy
+
+#endif
@@ -0,0 +1,140 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_RunEventIndex_h
+#define SusyNtuple_RunEventIndex_h
+
+#include "SusyNtuple/EventlistCache.h"
+#include "SusyNtuple/PickEventList.h"
+
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Susy {
+
+/// Location of one (run, event) in a dataset
+struct RunEventRecord {
+    uint32_t run;
+    uint32_t event;
+    uint32_t file;     ///< index of the file in the RunEventIndex
+    uint32_t reserved;
+    uint64_t entry;    ///< local entry in the tree of that file
+    bool operator<(const RunEventRecord &o) const {
+        if(run!=o.run) return run<o.run;
+        if(event!=o.event) return event<o.event;
+        if(file!=o.file) return file<o.file;
+        return entry<o.entry;
+    }
+};
+
+///  Persistent index from (run, event) to (file, entry)
+/**
+   The records are kept sorted by run and event number, so that
+   finding an event is a binary search, and comparing two datasets
+   (e.g. to find the events that are in both) is a linear merge of
+   two sorted arrays.
+
+   Files are identified by EventlistCache::fileKey(), so a selection
+   obtained from the index (see select()) can be processed with
+   EntryRangeDriver regardless of the order of the files in the chain.
+
+   On-disk layout (native byte order):
+   \code
+   Header         : magic[8] version(u32) nFiles(u32) nRecords(u64) namesSize(u64)
+   FileRecord     : key nEntries nameOffset nameLength   (u64 each, in file order)
+   RunEventRecord : run event file reserved(u32 each) entry(u64), sorted
+   names          : char[namesSize]
+   \endcode
+   read() memory-maps the file; the records are not copied.
+
+   The index is usually built from a TChain with RunEventIndexBuilder.
+ */
+class RunEventIndex {
+
+public:
+    /// an input file of the indexed dataset
+    struct FileInfo {
+        std::string name;
+        uint64_t key;      ///< EventlistCache::fileKey(name, nEntries)
+        uint64_t nEntries;
+    };
+    /// two records with the same (run, event)
+    typedef std::pair<RunEventRecord, RunEventRecord> RecordPair;
+
+    RunEventIndex();
+    ~RunEventIndex();
+
+    /// whether filename starts with the RunEventIndex magic string
+    static bool isIndexFile(const std::string &filename);
+
+    /// add an input file; return its index, to be used in the records
+    uint32_t addFile(const std::string &name, uint64_t nEntries);
+    /// add the location of (run, event)
+    RunEventIndex& add(uint32_t run, uint32_t event, uint32_t file, uint64_t entry);
+    /// add records (e.g. built by another thread)
+    RunEventIndex& add(const std::vector<RunEventRecord> &records);
+    /// add the files and records of other
+    RunEventIndex& merge(const RunEventIndex &other);
+
+    /// write the index to filename; return false on failure
+    bool write(const std::string &filename) const;
+    /// memory-map the index stored in filename; return false on failure
+    bool read(const std::string &filename);
+    void clear();
+
+    /// number of records
+    size_t size() const;
+    size_t nFiles() const { return m_files.size(); }
+    const FileInfo& file(uint32_t i) const { return m_files.at(i); }
+    /// sorted records
+    const RunEventRecord* begin() const;
+    const RunEventRecord* end() const;
+    /// records of (run, event), as a range [first, second); empty if not found
+    std::pair<const RunEventRecord*, const RunEventRecord*> find(uint32_t run, uint32_t event) const;
+    bool contains(uint32_t run, uint32_t event) const;
+    /// fill cache with the entries of the picked events; return the number of entries
+    uint64_t select(const PickEventList &pick, EventlistCache &cache) const;
+    /// records whose (run, event) occurs more than once, each one with its first occurrence
+    std::vector<RecordPair> duplicates() const;
+    /// (run, event) found in both a and b
+    static std::vector<RecordPair> commonEvents(const RunEventIndex &a, const RunEventIndex &b);
+    bool isMapped() const { return m_mapAddress!=0; }
+
+private:
+    RunEventIndex(const RunEventIndex&);
+    RunEventIndex& operator=(const RunEventIndex&);
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t nFiles;
+        uint64_t nRecords;
+        uint64_t namesSize;
+    };
+    struct FileRecord {
+        uint64_t key;
+        uint64_t nEntries;
+        uint64_t nameOffset;
+        uint64_t nameLength;
+    };
+    static const char s_magic[8];
+    static const uint32_t s_version = 1;
+
+    void unmap();
+    /// copy the mapped records into m_records, so that they can be extended
+    void materialize();
+    void sortRecords() const;
+
+    std::vector<FileInfo> m_files;
+    mutable std::vector<RunEventRecord> m_records; ///< records being built (sorted lazily)
+    mutable bool m_sorted;
+    void* m_mapAddress;                            ///< base address of the mapped file, if any
+    size_t m_mapSize;
+    const RunEventRecord* m_mappedBegin;
+    const RunEventRecord* m_mappedEnd;
+};
+
+} // Susy
+
+#endif
@@ -0,0 +1,50 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_RunEventIndexBuilder_h
+#define SusyNtuple_RunEventIndexBuilder_h
+
+#include "SusyNtuple/RunEventIndex.h"
+
+#include <string>
+#include <vector>
+
+class TChain;
+
+namespace Susy {
+
+///  Build a RunEventIndex for the files of a TChain
+/**
+   Each file is opened independently and only its 'event' branch is
+   read; the files are distributed over several threads. Usage:
+   \code
+   TChain chain("susyNt");
+   ChainHelper::addInput(&chain, input);
+   RunEventIndex index;
+   RunEventIndexBuilder(&chain).setThreads(8).build(index);
+   index.write("sample.idx");
+   \endcode
+ */
+class RunEventIndexBuilder {
+
+public:
+    explicit RunEventIndexBuilder(TChain* chain);
+
+    /// number of threads (files read in parallel); 0 means one per core
+    RunEventIndexBuilder& setThreads(unsigned int value) { m_nThreads = value; return *this; }
+    RunEventIndexBuilder& setVerbose(bool value=true) { m_verbose = value; return *this; }
+
+    /// add the files of the chain and the location of all their events to index; return false if a file cannot be read
+    bool build(RunEventIndex &index);
+
+private:
+    /// read the events of one file; return false if it cannot be read
+    bool indexFile(const std::string &filename, uint32_t file,
+                   uint64_t &nEntries, std::vector<RunEventRecord> &records) const;
+
+    TChain* m_chain;
+    unsigned int m_nThreads;
+    bool m_verbose;
+};
+
+} // Susy
+
+#endif
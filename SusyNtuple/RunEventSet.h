@@ -0,0 +1,136 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_RunEventSet_h
+#define SusyNtuple_RunEventSet_h
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace Susy {
+
+///  Compact set of (run, event) pairs
+/**
+   Replaces RunEventMap (a std::set node per event) for duplicate
+   detection and event lists. The events of each run are stored in an
+   open-addressing hash table of uint32_t (linear probing, load factor
+   between 0.35 and 0.7), i.e. about 8 bytes per event and one probe
+   per lookup in the typical case. Consecutive calls for the same run
+   (the usual case in an event loop) skip the lookup of the run.
+
+   Optionally (setSpill()), when the tables exceed a given size they
+   are written to disk as one sorted block per run; the block is
+   memory-mapped and searched with a binary search, so that the heap
+   usage stays bounded on very large datasets. Each spill merges the
+   new events of a run into its block (the previous spill file is
+   rewritten and dropped), so that a lookup is one binary search
+   however many times the tables were spilled.
+
+   Not thread-safe, not even for concurrent contains(); see
+   ConcurrentRunEventSet.
+ */
+class RunEventSet {
+
+public:
+    RunEventSet();
+    ~RunEventSet();
+
+    /// add (run, event); return true if it was not already in the set
+    bool insert(uint32_t run, uint32_t event);
+    /// whether (run, event) is in the set
+    bool contains(uint32_t run, uint32_t event) const;
+    /// number of (run, event) pairs
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size==0; }
+    size_t nRuns() const { return m_runs.size(); }
+    /// heap bytes used by the in-memory hash tables
+    size_t memoryUsage() const { return m_memory; }
+    /// number of pairs that have been moved to disk
+    size_t nSpilled() const { return m_nSpilled; }
+    void clear();
+
+    /// move the tables to a temporary file in directory whenever they use more than maxMemory bytes
+    RunEventSet& setSpill(const std::string &directory, size_t maxMemory);
+
+private:
+    RunEventSet(const RunEventSet&);
+    RunEventSet& operator=(const RunEventSet&);
+
+    /// open-addressing hash set of the event numbers of one run; 0 marks an empty slot
+    struct EventTable {
+        std::vector<uint32_t> slots;
+        size_t nUsed;
+        bool hasZero;
+        EventTable() : nUsed(0), hasZero(false) {}
+        bool insert(uint32_t event);
+        bool contains(uint32_t event) const;
+        size_t size() const { return nUsed + (hasZero ? 1 : 0); }
+        void grow();
+    };
+    /// sorted event numbers of one run in a mapped spill file
+    struct SpillBlock {
+        const uint32_t* begin;
+        const uint32_t* end;
+    };
+    struct RunEntry {
+        EventTable table;
+        SpillBlock spilled;
+        RunEntry() { spilled.begin = spilled.end = 0; }
+        bool contains(uint32_t event) const;
+    };
+    struct Mapping {
+        void* address;
+        size_t length;
+    };
+
+    RunEntry* findRun(uint32_t run) const;
+    /// merge the in-memory tables with the spilled blocks into a new spill file; return false on failure
+    bool spill();
+
+    std::map<uint32_t, RunEntry> m_runs;
+    mutable uint32_t m_lastRun;      ///< run of the last lookup
+    mutable RunEntry* m_lastEntry;   ///< entry of the last lookup (map nodes are stable)
+    size_t m_size;
+    size_t m_memory;
+    size_t m_nSpilled;
+    std::string m_spillDirectory;
+    size_t m_spillThreshold;         ///< 0 means never spill
+    Mapping m_mapping;               ///< the current spill file, if any
+};
+
+///  Thread-safe RunEventSet
+/**
+   The pairs are distributed over nStripes independent RunEventSet,
+   each one protected by its own mutex, so that threads processing
+   different events rarely wait for each other.
+ */
+class ConcurrentRunEventSet {
+
+public:
+    explicit ConcurrentRunEventSet(size_t nStripes=64);
+
+    /// add (run, event); return true if it was not already in the set
+    bool insert(uint32_t run, uint32_t event);
+    bool contains(uint32_t run, uint32_t event) const;
+    size_t size() const;
+    size_t memoryUsage() const;
+    void clear();
+    /// spill each stripe when it uses more than maxMemory/nStripes bytes
+    ConcurrentRunEventSet& setSpill(const std::string &directory, size_t maxMemory);
+
+private:
+    struct Stripe {
+        mutable std::mutex mutex;
+        RunEventSet set;
+    };
+    Stripe& stripe(uint32_t run, uint32_t event) const;
+
+    std::vector<std::unique_ptr<Stripe> > m_stripes;
+};
+
+} // Susy
+
+#endif
@@ -0,0 +1,156 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_StageTimer_h
+#define SusyNtuple_StageTimer_h
+
+#include "SusyNtuple/PerfCounters.h"
+
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace Susy {
+
+///  Histogram of durations, in ns
+/**
+   Log-linear binning: 8 bins per power of two, i.e. a resolution of
+   about 10% at any scale, from 1 ns to several hours, in a fixed
+   amount of memory. The count, sum, min and max are exact.
+ */
+class LatencyHistogram {
+
+public:
+    LatencyHistogram();
+    void add(uint64_t ns);
+    void merge(const LatencyHistogram &other);
+    void clear();
+    uint64_t count() const { return m_count; }
+    uint64_t total() const { return m_total; }
+    uint64_t min() const { return m_count ? m_min : 0; }
+    uint64_t max() const { return m_max; }
+    double mean() const { return m_count ? double(m_total)/m_count : 0.0; }
+    /// upper edge of the bin containing the fraction q (0-1) of the values
+    uint64_t quantile(double q) const;
+
+    static const int s_subBits = 3;
+    static const size_t s_nBins = (64 - s_subBits + 1) << s_subBits;
+    static size_t bin(uint64_t ns);
+    static uint64_t binUpperEdge(size_t bin);
+
+private:
+    std::vector<uint64_t> m_bins;
+    uint64_t m_count;
+    uint64_t m_total;
+    uint64_t m_min;
+    uint64_t m_max;
+};
+
+///  Low-overhead latency measurement for the stages of an event loop
+/**
+   Each stage is identified by the index returned by addStage(). The
+   durations are recorded in per-thread histograms (no lock and no
+   shared cache line in the event loop); they are merged when a
+   summary is requested. Usage:
+   \code
+   StageTimer timer;
+   int selection = timer.addStage("selection");
+   ...
+   { StageTimer::Scope s(&timer, selection); select(); }
+   ...
+   timer.print(cout);
+   \endcode
+   A Scope built with a null timer does nothing, so that timing can
+   be switched off at the cost of one test.
+
+   The clock is std::chrono::steady_clock, which on Linux reads the
+   TSC through the vDSO (about 20 ns per Scope).
+
+   A Scope can also read PerfCounters at the beginning and at the end
+   of the stage; the sums of the differences are then printed as IPC
+   and miss rates next to the latencies.
+ */
+class StageTimer {
+
+public:
+    /// time one stage until the end of the scope
+    class Scope {
+    public:
+        Scope(StageTimer* timer, int stage, const PerfCounters* counters=0) :
+            m_timer(timer), m_stage(stage), m_counters(timer ? counters : 0), m_start(0)
+        {
+            if(m_counters) m_startCounters = m_counters->read();
+            if(m_timer) m_start = now();
+        }
+        Scope(Scope &&o) :
+            m_timer(o.m_timer), m_stage(o.m_stage), m_counters(o.m_counters),
+            m_start(o.m_start), m_startCounters(o.m_startCounters) { o.m_timer = 0; }
+        ~Scope()
+        {
+            if(!m_timer) return;
+            m_timer->record(m_stage, now() - m_start);
+            if(m_counters) m_timer->recordCounters(m_stage, m_counters->read() - m_startCounters);
+        }
+    private:
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+        StageTimer* m_timer;
+        int m_stage;
+        const PerfCounters* m_counters;
+        uint64_t m_start;
+        PerfSample m_startCounters;
+    };
+
+    StageTimer();
+    ~StageTimer();
+
+    /// add a stage; return its index (an existing stage with the same name is reused)
+    int addStage(const std::string &name);
+    size_t nStages() const;
+    std::string stageName(int stage) const;
+    /// add one measurement for stage
+    void record(int stage, uint64_t ns);
+    /// add the counter differences measured for stage
+    void recordCounters(int stage, const PerfSample &delta);
+    /// all the measurements of stage, from all threads
+    LatencyHistogram summary(int stage) const;
+    /// sum of the counter differences of stage, from all threads
+    PerfSample counterSummary(int stage) const;
+    /// drop all the measurements (the stages are kept)
+    void reset();
+    /// table with calls, total, mean, median, 90% and 99% percentiles and max (and counters, if any) for each stage
+    void print(std::ostream &out) const;
+
+    /// monotonic time in ns
+    static uint64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    StageTimer(const StageTimer&);
+    StageTimer& operator=(const StageTimer&);
+
+    /// measurements of one thread
+    struct ThreadData {
+        std::vector<LatencyHistogram> histograms;
+        std::vector<PerfSample> counters;
+        bool hasCounters;
+        explicit ThreadData(size_t nStages) : histograms(nStages), counters(nStages), hasCounters(false) {}
+    };
+    /// measurements of the calling thread, with room for stage
+    ThreadData& threadData(int stage);
+
+    const uint64_t m_id;                ///< unique id of this timer, to key the thread-local cache
+    mutable std::mutex m_mutex;         ///< protects m_stages and m_threads
+    std::vector<std::string> m_stages;
+    std::vector<std::unique_ptr<ThreadData> > m_threads;
+};
+
+} // Susy
+
+#endif
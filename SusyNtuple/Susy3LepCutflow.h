@@ -9,6 +9,7 @@
 // Susy Common
 #include "SusyNtuple/SusyNtAna.h"
 #include "SusyNtuple/SusyNtTools.h"
+#include "SusyNtuple/Cutflow.h"
 
 #include <fstream>
 
@@ -42,12 +43,12 @@ class Susy3LepCutflow : public SusyNtAna
     // Book histograms
     void bookHistos();
 
-    // Event cleaning cuts
-    bool passEventCleaning(int cutflags, const MuonVector& preMuons,
-                const MuonVector& baseMuons, const JetVector& baseJets);
-    // Full event selection. Specify which leptons to use.
-    bool selectEvent(const LeptonVector& leptons, const TauVector& taus, 
-                     const JetVector& jets, const Susy::Met* met);
+    // Event cleaning and event selection cuts, one bit per cut of cutflow().
+    // Specify which leptons to use.
+    Susy::Cutflow::Mask eventCuts(int cutflags, const MuonVector& preMuons,
+                const MuonVector& baseMuons, const JetVector& baseJets,
+                const LeptonVector& leptons, const TauVector& taus,
+                const JetVector& jets, const Susy::Met* met);
 
     // Fill histograms
     void fillHistos(const LeptonVector& leptons, const TauVector& taus,
@@ -78,6 +79,8 @@ class Susy3LepCutflow : public SusyNtAna
     // Selection region
     void setSelection(std::string s) { m_sel = s; }
 
+    const Susy::Cutflow& cutflow() const { return m_cutflow; }
+
     // debug check
     bool debugEvent();
 
@@ -110,23 +113,7 @@ class Susy3LepCutflow : public SusyNtAna
 
     // Event counters
     uint                n_readin;
-    uint                n_pass_grl;
-    uint                n_pass_lar;
-    uint                n_pass_tile;
-    uint                n_pass_ttc;
-    uint                n_pass_sct;
-    uint                n_pass_badMuon;
-    uint                n_pass_badJet;
-    uint                n_pass_goodVtx;
-    uint                n_pass_cosmic;
-    uint                n_pass_nLep;
-    uint                n_pass_nTau;
-    uint                n_pass_trig;
-    uint                n_pass_sfos;
-    uint                n_pass_z;
-    uint                n_pass_met;
-    uint                n_pass_bJet;
-    uint                n_pass_mt;
+    Susy::Cutflow       m_cutflow;      // weighted with the MC weight
 
     // Final estimate weighted to full lumi
     float               n_evt_tot;
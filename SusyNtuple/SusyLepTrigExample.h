@@ -10,6 +10,7 @@
 //SusyNtuple
 #include "SusyNtuple/SusyNtAna.h"
 #include "SusyNtuple/SusyNtTools.h"
+#include "SusyNtuple/HistogramSet.h"
 
 //std/stl
 #include <fstream>
@@ -44,6 +45,16 @@ class SusyLepTrigExample : public SusyNtAna
         void test_single_ele_trigger(Susy::Electron* electron, std::string trigger, int single_idx);
         void write_single_mu_histos();
         void write_single_ele_histos();
+
+        // book the fired/matched histograms of triggers, one bin per trigger
+        void book_fired_matched(const std::string& name, const std::string& title,
+                const std::vector<std::string>& triggers, size_t& fired, size_t& matched);
+        // book one scale factor histogram per trigger
+        std::vector<size_t> book_sf_histos(const std::string& name, const std::string& title,
+                const std::vector<std::string>& triggers);
+        // draw fired and matched on one canvas, and write it
+        void write_fired_matched(const char* canvas, size_t fired, size_t matched, Color_t match_color);
+        void write_sf_histos(const std::vector<size_t>& sf_histos, Color_t fill_color);
         
 
 
@@ -78,24 +89,26 @@ class SusyLepTrigExample : public SusyNtAna
 
         bool outfile_initialized;
         TFile* m_out_file;
-        TH1F* h_single_mu_fired;
-        TH1F* h_single_mu_match;
-        std::vector<TH1F*> h_single_mu_sf;
-
-        TH1F* h_dimu_fired;
-        TH1F* h_dimu_match;
-        std::vector<TH1F*> h_di_mu_sf;
-
-        TH1F* h_single_ele_fired;
-        TH1F* h_single_ele_match; 
-        std::vector<TH1F*> h_single_ele_sf;
-
-        TH1F* h_diel_fired;
-        TH1F* h_diel_match;
-        std::vector<TH1F*> h_di_el_sf;
-
-        TH1F* h_mixed_fired;
-        TH1F* h_mixed_match;
+        // filled in Process without touching ROOT, converted to TH1F in Terminate
+        Susy::HistogramSet m_histos;
+        size_t h_single_mu_fired;
+        size_t h_single_mu_match;
+        std::vector<size_t> h_single_mu_sf;
+
+        size_t h_dimu_fired;
+        size_t h_dimu_match;
+        std::vector<size_t> h_di_mu_sf;
+
+        size_t h_single_ele_fired;
+        size_t h_single_ele_match; 
+        std::vector<size_t> h_single_ele_sf;
+
+        size_t h_diel_fired;
+        size_t h_diel_match;
+        std::vector<size_t> h_di_el_sf;
+
+        size_t h_mixed_fired;
+        size_t h_mixed_match;
 
 
 }; // class
@@ -11,6 +11,9 @@
 #include "SusyNtuple/MCWeighter.h"
 #include "SusyNtuple/SusyNtSys.h"
 #include "SusyNtuple/TauId.h"
+#include "SusyNtuple/RunEventSet.h"
+#include "SusyNtuple/PickEventList.h"
+#include "SusyNtuple/StageTimer.h"
 
 #include <fstream>
 #include <map>
@@ -46,8 +49,8 @@ class SusyNtAna : public TSelector
     virtual void    Init(TTree *tree);
     /// Begin is called before looping on entries
     virtual void    Begin(TTree *tree);
-    /// Called at the first entry of a new file in a chain
-    virtual Bool_t  Notify() { return kTRUE; }
+    /// Called at the first entry of a new file in a chain; reads the systematics kept in the file
+    virtual Bool_t  Notify();
     /// Terminate is called after looping is finished
     virtual void    Terminate();
     /** Due to ROOT's stupid design, need to specify version >= 2 or the tree will not connect automatically */
@@ -60,10 +63,7 @@ class SusyNtAna : public TSelector
 
     /** Get entry simply communicates the entry number from TSelector 
         to this class and hence to all of the VarHandles */
-    virtual Int_t   GetEntry(Long64_t e, Int_t getall = 0) {
-      m_entry=e;
-      return kTRUE;
-    }
+    virtual Int_t   GetEntry(Long64_t e, Int_t getall = 0);
 
     // Object selection
     void clearObjects();
@@ -92,19 +92,32 @@ class SusyNtAna : public TSelector
     void setDebug(int dbg) { m_dbg = dbg; m_mcWeighter.setVerbose(dbg); }
     int dbg() { return m_dbg; }
 
+    /// Reuse the objects' storage from one entry to the next (see SusyNtObject::SetReuseStorage)
+    void setReuseStorage(bool b=true) { Susy::SusyNtObject::SetReuseStorage(b); }
+
     void toggleCheckDuplicates(bool b=true) { m_duplicate = b; }
     bool checkDuplicate() { return m_duplicate; }
     
     void setEvtDebug() { m_dbgEvt = true; }
     bool dbgEvt() const { return m_dbgEvt; }
+    /// load the run:event pairs to debug (see Susy::PickEventList for the format)
     void loadEventList(const std::string filename="debugEvents.txt");
+    /// whether run:event is in the debug list (true if there is no list)
     bool processThisEvent(unsigned int run, unsigned int event);
+    /**
+       The debug list; to avoid looping on the whole dataset, pass it to
+       EntryRangeDriver::selectEvents() and process the chain with an
+       EntryRangeDriver (see SusyNtTest -p).
+     */
+    const Susy::PickEventList& pickEvents() const { return m_pickEvents; }
     bool checkRunEvent(const RunEventMap &runEventMap, unsigned int run, unsigned int event);
     bool checkAndAddRunEvent(RunEventMap &runEventMap, unsigned int run, unsigned int event);
     void addRunEvent(RunEventMap &runEventMap, unsigned int run, unsigned int event) 
     { checkAndAddRunEvent(runEventMap, run, event); }
 
     bool isDuplicate(unsigned int run, unsigned int event);
+    /// run:event already seen by isDuplicate (e.g. to call setSpill() on very large datasets)
+    Susy::RunEventSet& duplicateEvents() { return m_duplicateEvents; }
     /// the sample name, which used to be used to guess metadata info
     /**
        You should set it to the value provided by
@@ -121,10 +134,51 @@ class SusyNtAna : public TSelector
     /// getter to be used from outside (set xsec dir, access weight, etc.)
     MCWeighter& mcWeighter() { return m_mcWeighter; }
     void setUseSumwFile(std::string file);
+    /**
+       Systematics of the event weight, e.g. the variations of a
+       Susy::SystematicHistograms filled with systematicWeights().
+       The object systematics are in the list too, with the nominal
+       MC weight, for the analysis to multiply in its scale factors.
+     */
+    SusyNtAna& setWeightSystematics(const std::vector<Susy::NtSys::SusyNtSys>& s)
+    { m_weightSystematics = s; return *this; }
+    const std::vector<Susy::NtSys::SusyNtSys>& weightSystematics() const { return m_weightSystematics; }
+    /// MC weight of the current event for each of weightSystematics() (getMCWeight called only for those affecting it)
+    const std::vector<double>& systematicWeights(const float lumi = 1000);
 
     /// Dump timer
     void dumpTimer();
 
+    /// Stages of the event loop that are timed when stage timing is on
+    enum Stage {
+      StageEvent = 0,   ///< from one GetEntry() to the next one, i.e. the whole Process()
+      StageRead,        ///< reading the event branch
+      StagePreObjects,  ///< SusyNtTools::classifyObjects: pre-selection, including the (lazy) reading of the object branches, and baseline/signal/jet classification
+      StageBaseline,    ///< the baseline vectors, from the classification bits
+      StageOverlap,     ///< OverlapTools::performOverlap
+      StageSignal,      ///< the signal vectors, from the bits of the overlap survivors, and buildLeptons
+      StageMet,         ///< SusyNtTools::getMet and getTrackMet, including the reading of the met branches
+      StageWeight,      ///< MCWeighter::getMCWeight (timed by the derived class, see timeStage())
+      nStages
+    };
+    /// time the stages of the event loop; the percentiles are printed by dumpTimer()
+    void setStageTiming(bool b=true) { m_stageTiming = b; }
+    bool stageTiming() const { return m_stageTiming; }
+    /// the stage timer, e.g. to add stages specific to an analysis
+    Susy::StageTimer& stageTimer() { return m_stageTimer; }
+    /**
+       Also read the hardware counters (cycles, instructions, cache and
+       branch misses; see Susy::PerfCounters) for each stage, and print
+       IPC and miss rates every reportEvery events (never if 0).
+       Turns on the stage timing. The counters are opened in Begin().
+     */
+    void setPerfCounters(bool b=true, int reportEvery=0)
+    { m_perfCountersOn = b; m_perfReportEvery = reportEvery; if(b) m_stageTiming = true; }
+    /// time stage until the end of the scope; does nothing unless stage timing is on
+    Susy::StageTimer::Scope timeStage(int stage)
+    { return Susy::StageTimer::Scope(m_stageTiming ? &m_stageTimer : 0, stage,
+                                     m_perfCounters.isOpen() ? &m_perfCounters : 0); }
+
     /// Access tree
     TTree* getTree() { return m_tree; }
 
@@ -152,12 +206,14 @@ class SusyNtAna : public TSelector
     std::string m_parentSample; ///< name of sample from which the ntuple was generated
 
     // To debug events in input file 
-    RunEventMap m_eventList;          ///< run:event to debug 
-    RunEventMap m_eventListDuplicate; ///< Checks for duplicate run/event
+    Susy::PickEventList m_pickEvents;    //! run:event to debug (transient)
+    Susy::RunEventSet m_duplicateEvents; //! Checks for duplicate run/event (transient)
 
     MCWeighter m_mcWeighter;   // provides MC normalization and event weight
     std::string m_sumw_file;
     bool m_use_sumw_file;
+    std::vector<Susy::NtSys::SusyNtSys> m_weightSystematics; ///< see setWeightSystematics
+    std::vector<double> m_systematicWeights;                 //! weights of the current event (transient)
 
 
     //
@@ -194,6 +250,14 @@ class SusyNtAna : public TSelector
 
     /// Timer
     TStopwatch          m_timer;
+    bool                m_stageTiming;          ///< time the stages of the event loop
+    Susy::StageTimer    m_stageTimer;           //! per-stage latencies (transient)
+    uint64_t            m_eventStart;           //! time of the last GetEntry (transient)
+    bool                m_perfCountersOn;       ///< read the hardware counters
+    int                 m_perfReportEvery;      ///< print the counters every N events
+    Susy::PerfCounters  m_perfCounters;         //! hardware counters of the event loop thread (transient)
+    Susy::PerfSample    m_perfLast;             //! counters at the last periodic report (transient)
+    Long64_t            m_perfEvents;           //! events since the counters were opened (transient)
 
 };
 
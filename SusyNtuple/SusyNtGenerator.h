@@ -0,0 +1,147 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_SusyNtGenerator_h
+#define SusyNtuple_SusyNtGenerator_h
+
+#include "SusyNtuple/SusyNtObject.h"
+
+#include "TRandom3.h"
+
+#include <string>
+#include <vector>
+
+class TH1F;
+
+namespace Susy {
+
+///  Write a synthetic susyNt file, for benchmarks and tests that need no external data
+/**
+   The events are not physics, but their content is statistically
+   close to that of a real ntuple, so that the selection, overlap
+   removal, trigger and weighting code runs through its usual
+   branches:
+   - the number of electrons, muons, jets, taus and photons per event
+     is Poisson-distributed with configurable means; pt is a minimum
+     plus an exponential tail, the objects are pt-ordered, and a
+     fraction of the electrons is also reconstructed as a jet (so
+     that the overlap removal has something to do)
+   - the identification, isolation, b-tagging and cleaning flags are
+     set with fixed probabilities, with the usual ordering (e.g. tight
+     implies medium implies loose)
+   - the SF vectors have the sizes checked by Electron::hasSys,
+     Muon::hasSys and Jet::hasSys, and the kinematic systematics have
+     Met and TrackMet entries (optional, see setSystematics)
+   - the event and lepton trigger bits are consistent with the "trig"
+     histogram that is written next to the tree, as read by
+     TriggerTools::init; the dilepton trigger matches are filled for
+     the pairs of leptons above threshold
+   - every event carries the Event::sumOfEventWeights of the whole
+     file, as read by MCWeighter, and the file has the
+     "outputContainerName" read by ChainHelper::sampleName.
+
+   The output depends only on the configuration and on the seed.
+   Usage:
+   \code
+   SusyNtGenerator generator;
+   generator.setOutputFilename("synthetic.root").setNumberOfEvents(100000).setMeanJets(5.0);
+   generator.generate();
+   \endcode
+   The events can also be generated in memory, one at a time, with
+   generateEvent(); see util/SusyNtGen.cxx
+ */
+class SusyNtGenerator {
+
+public:
+    SusyNtGenerator();
+    virtual ~SusyNtGenerator() {}
+
+    SusyNtGenerator& setOutputFilename(const std::string &value) { m_outputFilename = value; return *this; }
+    SusyNtGenerator& setNumberOfEvents(Long64_t value) { m_nEvents = value; return *this; }
+    SusyNtGenerator& setSeed(unsigned int value) { m_seed = value; return *this; }
+    /// simulation (default) or data
+    SusyNtGenerator& setIsMC(bool value) { m_isMC = value; return *this; }
+    /// dataset id; it should be in the SUSYTools cross-section database for MCWeighter (default: 410009, ttbar)
+    SusyNtGenerator& setMcChannel(unsigned int value) { m_mcChannel = value; return *this; }
+    /// run number (default: 284500 for MC, a 2016 run for data)
+    SusyNtGenerator& setRun(unsigned int value) { m_run = value; return *this; }
+    /// sum of the event weights stored in every event (default: sum of the generated weights)
+    SusyNtGenerator& setSumOfEventWeights(double value) { m_sumw = value; return *this; }
+    /// mean numbers of objects per event
+    SusyNtGenerator& setMeanElectrons(double value) { m_meanElectrons = value; return *this; }
+    SusyNtGenerator& setMeanMuons(double value) { m_meanMuons = value; return *this; }
+    SusyNtGenerator& setMeanJets(double value) { m_meanJets = value; return *this; }
+    SusyNtGenerator& setMeanTaus(double value) { m_meanTaus = value; return *this; }
+    SusyNtGenerator& setMeanPhotons(double value) { m_meanPhotons = value; return *this; }
+    /// fill the SF uncertainty vectors and the Met/TrackMet of the kinematic systematics (default: true)
+    SusyNtGenerator& setSystematics(bool value) { m_systematics = value; return *this; }
+    /// probability that a trigger fires when its leptons are in the event (default: 0.9)
+    SusyNtGenerator& setTriggerEfficiency(double value) { m_triggerEfficiency = value; return *this; }
+    SusyNtGenerator& setVerbose(bool value=true) { m_verbose = value; return *this; }
+
+    /// write the file; return the number of events written, -1 on error
+    Long64_t generate();
+    /// fill nt() with the next event (the first call starts the random sequence from the seed)
+    void generateEvent();
+    /// the objects of the last generated event
+    SusyNtObject& nt() { return m_nt; }
+    /// the "trig" histogram of the events generated so far (owned by the caller), e.g. for TriggerTools::buildTriggerMap
+    TH1F* triggerHistogram() const;
+
+    /// the kinematic systematics that have their own Met and TrackMet entries
+    static const std::vector<NtSys::SusyNtSys>& metSystematics();
+
+protected:
+    enum TriggerType { TrigSingleEle, TrigSingleMuo, TrigDiEle, TrigDiMuo, TrigEleMuo, TrigMet };
+
+    /// seed the random numbers, sum the weights, classify the triggers
+    void start();
+    void fillEvent(Event &evt);
+    void fillElectron(Electron &ele, int idx, float pt);
+    void fillMuon(Muon &muo, int idx, float pt);
+    void fillJet(Jet &jet, float pt);
+    void fillTau(Tau &tau, float pt);
+    void fillPhoton(Photon &pho, float pt);
+    /// Met and TrackMet balancing the objects, plus a soft term
+    void fillMet();
+    /// set the event and lepton trigger bits, and the dilepton matches
+    void fillTriggers(Event &evt);
+    /// n pt values, in decreasing order: minimum + exponential tail
+    std::vector<float> drawPts(double mean, float ptMin, float ptSlope);
+    /// eta flat within |eta|<etaMax, phi flat
+    void setKinematics(Particle &p, float pt, float etaMax, float m);
+    /// 1 + a gaussian shift of width sigma (scale factors and their variations)
+    float aroundOne(float sigma) { return 1.0 + m_random.Gaus(0.0, sigma); }
+    bool pass(double probability) { return m_random.Rndm() < probability; }
+    /// MC generator weight, from its own random sequence so that it can be summed in advance
+    float drawWeight();
+
+    std::string m_outputFilename;
+    Long64_t m_nEvents;
+    unsigned int m_seed;
+    bool m_isMC;
+    unsigned int m_mcChannel;
+    unsigned int m_run;
+    double m_sumw;               ///< <0 : use the sum of the generated weights
+    double m_meanElectrons;
+    double m_meanMuons;
+    double m_meanJets;
+    double m_meanTaus;
+    double m_meanPhotons;
+    bool m_systematics;
+    double m_triggerEfficiency;
+    bool m_verbose;
+
+    SusyNtObject m_nt;
+    TRandom3 m_random;
+    TRandom3 m_weightRandom;
+    bool m_started;
+    Long64_t m_iEvent;           ///< index of the next event
+    double m_sumWeights;
+    double m_sumWeightsSquared;
+    std::vector<std::string> m_triggers;
+    std::vector<TriggerType> m_triggerTypes; ///< one per entry of m_triggers
+    std::vector<Long64_t> m_triggerCounts;
+};
+
+} // Susy
+
+#endif
@@ -3,6 +3,7 @@
 #define SusyCommon_SusyNtObject_h
 
 #include "TTree.h"
+#include <string>
 #include <vector>
 
 #include "SusyNtuple/VarHandle.h"
@@ -24,12 +25,29 @@ namespace Susy
       /// Set branches active for writing
       // I will later add flags here for controlling systematics
       void SetActive();
+      /// Set active only the named branches; all the others are set inactive
+      void SetActive(const std::vector<std::string> &branchNames);
       /// Connect the objects to an output tree
       void WriteTo( TTree* tree );
       /// Connect the objects to an input tree
       void ReadFrom( TTree* tree );
       /// Clear variables when in read mode
+      /** Note: with SetReuseStorage this destroys the objects that would otherwise be reused */
       void clear();
+      /// Read the current entry of all the active branches (e.g. before filling an output tree)
+      void ReadActive();
+      /// All the variable handles, in the order in which the branches are written
+      std::vector<D3PDReader::VarHandleBase*> handles();
+      /// Toggle in-place reading of the object vectors (see ReuseStorageStreamer)
+      /**
+         When enabled, the objects read at one entry are reused for the
+         next one instead of being destroyed and re-constructed, so
+         that their std::vector members keep their capacity. This
+         affects the reading of these vector types for the whole
+         process; return true if the streamers were changed.
+       */
+      static bool SetReuseStorage(bool reuse = true);
+      static bool ReuseStorage();
 
       //
       // SusyNt variables
@@ -0,0 +1,166 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_SusyNtSlimmer_h
+#define SusyNtuple_SusyNtSlimmer_h
+
+#include "SusyNtuple/SusyNtObject.h"
+#include "SusyNtuple/SusyNtSys.h"
+#include "SusyNtuple/WriterOptions.h"
+
+#include <functional>
+#include <map>
+#include <set>
+#include <utility>
+#include <string>
+#include <vector>
+
+class TChain;
+class TFile;
+class TTree;
+
+namespace Susy {
+
+///  Write a reduced copy of a SusyNt chain (slim and skim)
+/**
+   The output "susyNt" tree contains only the events accepted by the
+   event filter (skim) and only the active branches (slim), e.g.
+   dropping the truth collections.
+
+   The metadata needed downstream is preserved:
+   - the histograms stored next to the tree (e.g. the "trig" histogram
+     read by TriggerTools::init) are summed over the input files
+   - the other objects (e.g. the container names read by
+     ChainHelper::sampleName) are copied from the first input file
+   - Event::sumOfEventWeights (and its square, and
+     initialNumberOfEvents) are replaced by their sum over all the
+     input files of the same mcChannel and susyFinalState (the key of
+     the MCWeighter sumw map), so that MCWeighter gets the right
+     normalization from the (single) output file.
+
+   Optionally only a subset of the systematic variations can be kept
+   (setSystematicsToKeep): the SF uncertainties of the other ones are
+   removed from the Electron, Muon and Jet objects (see
+   Electron::stripSys), and their Met and TrackMet entries are
+   dropped. The names of the kept variations are written to the output
+   file as the TNamed "keptSystematics". On the read side all the
+   stripped variations fall back to the nominal: hasSys() returns
+   false and the selectors and SusyNtTools use the nominal SF, and
+   SusyNtTools::getMet/getTrackMet return the nominal Met. SusyNtAna
+   reads "keptSystematics" for each file (SusyNtTools::readKeptSystematics)
+   and warns once for each stripped variation that is requested.
+
+   Usage:
+   \code
+   SusyNtSlimmer slimmer;
+   slimmer.setOutputFilename("slim.root")
+          .setBranchesToDrop({"truthParticles", "truthJets", "truthMet"})
+          .setEventFilter([](SusyNtObject &nt) { return nt.ele()->size() + nt.muo()->size() >= 2; });
+   slimmer.process(chain);
+   \endcode
+   With setAsyncWrite() the accepted events are handed over to a
+   background thread (see AsyncWriter) that fills the output tree and
+   compresses its baskets, while the next events are read; the event
+   collections are moved, not copied, to the writer.
+
+   setWriterOptions() sets the compression, basket sizes, auto-flush
+   and split level of the output (see WriterOptions).
+
+   See util/SusyNtSlim.cxx
+ */
+class SusyNtSlimmer {
+
+public:
+    /// return true for the events to be written
+    typedef std::function<bool (SusyNtObject&)> EventFilter;
+
+    SusyNtSlimmer();
+    virtual ~SusyNtSlimmer() {}
+
+    SusyNtSlimmer& setOutputFilename(const std::string &value) { m_outputFilename = value; return *this; }
+    /// write only these branches (default: all)
+    SusyNtSlimmer& setBranchesToKeep(const std::vector<std::string> &value) { m_branchesToKeep = value; return *this; }
+    /// do not write these branches
+    SusyNtSlimmer& setBranchesToDrop(const std::vector<std::string> &value) { m_branchesToDrop = value; return *this; }
+    /// write only the events for which filter returns true (default: all)
+    SusyNtSlimmer& setEventFilter(EventFilter value) { m_filter = value; return *this; }
+    /// keep only the payloads of these systematics (NOM is always kept; default: keep all)
+    SusyNtSlimmer& setSystematicsToKeep(const std::vector<NtSys::SusyNtSys> &value);
+    SusyNtSlimmer& setVerbose(bool value=true) { m_verbose = value; return *this; }
+    /// write on a background thread with this many events in flight (0, the default: write synchronously),
+    /// compressing with imtThreads ROOT threads (0: on the writer thread)
+    SusyNtSlimmer& setAsyncWrite(size_t queueSize, unsigned int imtThreads=0)
+    { m_asyncQueue = queueSize; m_imtThreads = imtThreads; return *this; }
+    /// compression and basket/cluster layout of the output (default: as SusyNtObject::WriteTo)
+    SusyNtSlimmer& setWriterOptions(const WriterOptions &value) { m_writerOptions = value; return *this; }
+
+    /// slim and skim the first nEntries (all if <0) of chain; return the number of events written, -1 on error
+    Long64_t process(TChain* chain, Long64_t nEntries=-1);
+
+    /// the SusyNt object used to read the input and write the output
+    SusyNtObject& nt() { return m_nt; }
+    Long64_t nRead() const { return m_nRead; }
+    Long64_t nWritten() const { return m_nWritten; }
+
+protected:
+    /// set active the branches that are requested and available in the input
+    void configureBranches();
+    /// overwrite sumw-related variables with their sum over the input files
+    void fixSumw();
+    /// drop the payloads of the systematics that are not in m_sysToKeep
+    void stripSystematics();
+    /// hook to modify the objects of each accepted event before it is written
+    virtual void prepareEvent() {}
+    /// sum over the input files of the Event metadata, per mcChannel and susyFinalState
+    bool collectSumw(TChain* chain);
+    /// (mcChannel, susyFinalState) as in MCWeighter::getSumw
+    typedef std::pair<unsigned int, int> SumwKey;
+    static SumwKey sumwKey(const Susy::Event &evt)
+    { return SumwKey(evt.mcChannel, evt.susyFinalState>0 ? evt.susyFinalState : 0); }
+    /// write to output the histograms (summed) and other objects (from the first file) stored in the input files
+    bool copyMetadata(TChain* chain, TFile* output);
+
+    /// the collections of one event, in flight to the writer thread
+    struct EventContents {
+        Event evt;
+        std::vector<Electron> ele;
+        std::vector<Muon> muo;
+        std::vector<Jet> jet;
+        std::vector<Photon> pho;
+        std::vector<Tau> tau;
+        std::vector<Met> met;
+        std::vector<TrackMet> tkm;
+        std::vector<TruthParticle> tpr;
+        std::vector<TruthJet> tjt;
+        std::vector<TruthMet> tmt;
+    };
+    /// exchange the active collections of nt with c
+    static void swapContents(SusyNtObject &nt, EventContents &c);
+    /// fill outputTree from a background thread; return the number of events written
+    Long64_t processAsync(TChain* chain, Long64_t nEntries, TTree* outputTree);
+
+    struct SumwInfo {
+        uint64_t initialNumberOfEvents;
+        double sumOfEventWeights;
+        double sumOfEventWeightsSquared;
+        SumwInfo() : initialNumberOfEvents(0), sumOfEventWeights(0), sumOfEventWeightsSquared(0) {}
+    };
+
+    std::string m_outputFilename;
+    std::vector<std::string> m_branchesToKeep;
+    std::vector<std::string> m_branchesToDrop;
+    EventFilter m_filter;
+    bool m_stripSys;
+    std::set<NtSys::SusyNtSys> m_sysToKeep;
+    bool m_verbose;
+    size_t m_asyncQueue;
+    unsigned int m_imtThreads;
+    WriterOptions m_writerOptions;
+    Long64_t m_entry; ///< current entry in the current tree (must be declared before m_nt)
+    SusyNtObject m_nt;
+    std::map<SumwKey, SumwInfo> m_sumw; ///< per mcChannel and susyFinalState
+    Long64_t m_nRead;
+    Long64_t m_nWritten;
+};
+
+} // Susy
+
+#endif
@@ -4,6 +4,7 @@
 
 // std
 #include <iostream>
+#include <set>
 
 // SusyNtuple
 #include "SusyNtuple/SusyDefs.h"
@@ -19,10 +20,13 @@
 #include "SusyNtuple/TauSelector.h"
 #include "SusyNtuple/TauId.h"
 #include "SusyNtuple/TriggerTools.h"
+#include "SusyNtuple/ObjectStatus.h"
 
 // SUSYTools
 #include "SUSYTools/SUSYCrossSection.h"
 
+class TFile;
+
 using namespace Susy;
 using namespace NtSys;
 
@@ -54,6 +58,22 @@ public:
      */
     bool initTriggerTool(const std::string &anyInputFilename);
 
+    /// read the systematics kept in a file written with SusyNtSlimmer::setSystematicsToKeep; true if it was stripped
+    /**
+       The names are in the TNamed "keptSystematics"; a file without
+       it has all the systematics. SusyNtAna calls this from Notify,
+       for each input file.
+     */
+    bool readKeptSystematics(TFile* file);
+    /// false if sys was stripped from the input (NOM is always there); warns the first time
+    /**
+       The stripped variations fall back to the nominal: the objects
+       and the SFs are the nominal ones, the SF uncertainties give no
+       shift, and getMet/getTrackMet return the nominal Met. In an input
+       that was not stripped, a missing Met variation is still an error.
+     */
+    bool isSysAvailable(SusyNtSys sys);
+
     //
     // Methods to return the tools
     //
@@ -123,6 +143,25 @@ public:
     void getSignalObjects(const ElectronVector& baseElectrons, const MuonVector& baseMuons, const JetVector& baseJets, const TauVector& baseTaus, const PhotonVector& basePhotons,
                             ElectronVector& signalElectrons, MuonVector& signalMuons, JetVector& signalJets, TauVector& signalTaus, PhotonVector& signalPhotons);
 
+    /// Get 'Pre' objects for sys and classify them, with one selector call per collection
+    /**
+       The pre-selected vectors are objectStatus().X.objects(); the
+       baseline and signal vectors, the b-jets and the jet counts are
+       then derived from the bits (see Susy::ObjectStatus), as in
+       SusyNtAna::selectObjects(). isSignal(), numberOfCLJets(),
+       numBJets(), getBJets() etc. use the bits of the objects classified
+       by the last call, and call the selectors only for other objects.
+       setAnaType() clears the bits, and getPreX() those of its
+       collection, since it sets the state (systematic) of the objects.
+     */
+    const Susy::ObjectStatus& classifyObjects(Susy::SusyNtObject* susyNt, SusyNtSys sys);
+    /// set the OverlapSurvivor bit of the objects kept by the overlap removal, and the Signal bit of the signal ones
+    void markOverlapSurvivors(const ElectronVector& baseElectrons, const MuonVector& baseMuons, const JetVector& baseJets,
+                              const TauVector& baseTaus, const PhotonVector& basePhotons);
+    const Susy::ObjectStatus& objectStatus() const { return m_objectStatus; }
+    /// forget the bits of the last classifyObjects() (e.g. at the beginning of an event)
+    void clearObjectStatus() { m_objectStatus.clear(); }
+
 
     /// Signal objects
     ElectronVector getSignalElectrons(const ElectronVector& baseElecs);
@@ -235,6 +274,12 @@ protected:
     AnalysisType m_anaType;    ///< Analysis type. currently 2-lep or 3-lep
     bool m_doSFOS;             ///< toggle to set whether to remove SFOS pairs from baseline leptons (set based on AnalysisType)
     int n_warning;
+    /// warn, once per systematic, that sys is not in the input and the nominal is used
+    void warnMissingSys(SusyNtSys sys);
+    bool m_sysStripped;                ///< the input was written with SusyNtSlimmer::setSystematicsToKeep
+    std::set<SusyNtSys> m_keptSys;     ///< the systematics kept in the input, if m_sysStripped
+    std::set<SusyNtSys> m_warnedSys;   ///< the missing systematics already reported
+    Susy::ObjectStatus m_objectStatus; //! bits of the objects of the last classifyObjects() (transient)
 };
 
 #endif
@@ -0,0 +1,133 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_SystematicHistograms_h
+#define SusyNtuple_SystematicHistograms_h
+
+#include "SusyNtuple/HistogramSet.h"
+#include "SusyNtuple/SusyNtSys.h"
+
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class TH1F;
+
+namespace Susy {
+
+///  1D histograms with one weighted content per systematic variation
+/**
+   Filling the same observable for many weight systematics with one
+   TH1 per variation costs one bin search (and the TH1 statistics) per
+   variation. Here each bin keeps the sums of all the variations next
+   to each other: a fill finds the bin once, then adds the weight
+   vector of the event.
+
+   The weights are usually set once per event, and the fills buffered
+   with a FillBuffer:
+   \code
+   SystematicHistograms histos({NtSys::NOM, NtSys::PILEUP_UP, NtSys::PILEUP_DN});
+   const size_t hMet = histos.book("h_met", "MET;E_{T}^{miss} [GeV];Events", 50, 0.0, 500.0);
+   SystematicHistograms::FillBuffer buffer(histos);
+   ...
+   buffer.setWeights(systematicWeights());  // e.g. from SusyNtAna, one per variation
+   buffer.fill(hMet, met->Et);
+   ...
+   buffer.flush();
+   TH1F *hMetPileupUp = histos.toTH1F(hMet, 1);
+   \endcode
+   Not thread-safe: each thread fills its own SystematicHistograms,
+   combined afterwards with merge().
+ */
+class SystematicHistograms {
+
+public:
+    typedef HistogramSet::Definition Definition;
+
+    ///  (value, weight vector) fills, added to the histograms in batches
+    /**
+       The weight vector is stored once per setWeights() call, whatever
+       the number of fills that use it. The buffer is flushed when it
+       holds capacity fills, when it is destroyed, and with flush().
+     */
+    class FillBuffer {
+    public:
+        explicit FillBuffer(SystematicHistograms &histos, size_t capacity=1024);
+        ~FillBuffer() { flush(); }
+        /// weights of the following fills, one per variation (copied)
+        void setWeights(const std::vector<double> &weights);
+        void setWeights(const double *weights);
+        /// fill histogram id with x, with the current weights
+        void fill(size_t id, double x)
+        {
+            m_fills.push_back(Fill(id, x, m_current));
+            if(m_fills.size()>=m_capacity) flush();
+        }
+        /// add the buffered fills to the histograms
+        void flush();
+        size_t size() const { return m_fills.size(); }
+    private:
+        FillBuffer(const FillBuffer&);
+        FillBuffer& operator=(const FillBuffer&);
+        struct Fill {
+            size_t id;
+            double x;
+            size_t weights;     ///< offset in m_weights
+            Fill(size_t i, double v, size_t w) : id(i), x(v), weights(w) {}
+        };
+        SystematicHistograms &m_histos;
+        size_t m_capacity;
+        std::vector<Fill> m_fills;
+        std::vector<double> m_weights; ///< the weight vectors used by m_fills, one after the other
+        size_t m_current;              ///< offset of the current weights in m_weights
+    };
+
+    /// one variation per name; the first one is usually the nominal
+    explicit SystematicHistograms(const std::vector<std::string> &variations);
+    /// one variation per systematic, named after SusyNtSysNames
+    explicit SystematicHistograms(const std::vector<NtSys::SusyNtSys> &systematics);
+
+    size_t nVariations() const { return m_variations.size(); }
+    const std::string& variation(size_t v) const { return m_variations[v]; }
+    /// index of the variation called name, or nVariations()
+    size_t findVariation(const std::string &name) const;
+
+    /// book a histogram with nBins uniform bins in [low, high); return its id
+    size_t book(const std::string &name, const std::string &title, int nBins, double low, double high,
+                const std::string &titleX="", const std::string &titleY="");
+    /// same, with the nBins+1 bin edges
+    size_t book(const std::string &name, const std::string &title, const std::vector<double> &edges,
+                const std::string &titleX="", const std::string &titleY="");
+    size_t nHistograms() const { return m_histograms.size(); }
+    const Definition& definition(size_t id) const { return m_histograms[id]; }
+    int nBins(size_t id) const { return m_histograms[id].nBins; }
+
+    /// add x to histogram id with one weight per variation (unbuffered)
+    void fill(size_t id, double x, const double *weights);
+    void fill(size_t id, double x, const std::vector<double> &weights) { fill(id, x, &weights[0]); }
+
+    double content(size_t id, int bin, size_t v) const { return m_sumw[cell(id, bin) + v]; }
+    double sumw2(size_t id, int bin, size_t v) const { return m_sumw2[cell(id, bin) + v]; }
+    uint64_t entries(size_t id) const { return m_entries[id]; }
+    /// new TH1F with the contents of variation v, named <name>_<variation> (owned by the caller)
+    TH1F* toTH1F(size_t id, size_t v) const;
+
+    /// add the contents of other; false (and nothing added) if the histograms or variations differ
+    bool merge(const SystematicHistograms &other);
+    void clear();
+
+private:
+    size_t add(const Definition &d);
+    /// offset of the first variation of bin
+    size_t cell(size_t id, int bin) const { return (m_offsets[id] + bin)*m_variations.size(); }
+
+    std::vector<std::string> m_variations;
+    std::vector<Definition> m_histograms;
+    std::vector<size_t> m_offsets;      ///< first bin of each histogram
+    std::vector<double> m_sumw;         ///< [(offset + bin)*nVariations + variation]
+    std::vector<double> m_sumw2;
+    std::vector<uint64_t> m_entries;
+};
+
+} // Susy
+
+#endif
@@ -3,10 +3,16 @@
 #define SUSYNTUPLE_TAUSELECTOR_H
 
 #include "SusyNtuple/AnalysisType.h"
+#include "SusyNtuple/Tau.h"
+#include "SusyNtuple/SusyDefs.h" // TauVector
+#include "SusyNtuple/vec_utils.h"
+#include "SusyNtuple/ObjectStatus.h"
 
-namespace Susy {
+#include <cstdlib>
+#include <cmath>
+#include <typeinfo>
 
-class Tau;
+namespace Susy {
 
 /// A class to select tau
 /**
@@ -18,6 +24,10 @@ class Tau;
 
    The analysis-specific selector should be instantiated with TauSelector::build().
 
+   As for MuonSelector, the analysis-specific criteria are inline
+   policies (e.g. TauPolicy_4Lep) and build() returns TauSelectorT
+   adapters.
+
    For details on the design and implementation of this class, see the
    documentation for JetSelector.
 
@@ -46,6 +56,12 @@ public:
     virtual bool isSignal(const Tau& tau);
     /// wraps above
     virtual bool isSignal(const Tau* tau) { return isSignal(*tau); }
+    /// append to out the taus of in passing isBaseline()
+    virtual void selectBaseline(const TauVector &in, TauVector &out);
+    /// append to out the taus of in passing isSignal()
+    virtual void selectSignal(const TauVector &in, TauVector &out);
+    /// set the Baseline and PassSignal bits of the taus in status (see ObjectStatus)
+    virtual void classify(ObjectStatus::Collection<Tau> &status);
 
 protected :
     /// whether it should be verbose
@@ -55,50 +71,118 @@ protected :
 
 //----------------------------------------------------------
 //
-// End generic selector, begin analysis-specific ones
+// End generic selector, begin compile-time policies
 //
 //----------------------------------------------------------
 
-/// implements tau selection for ATL-COM-PHYS-2013-911
-// Ana_2Lep
-class TauSelector_2Lep : public TauSelector
+/// generic tau criteria, as inline static functions
+/**
+   Self is the analysis policy deriving from TauCriteria (CRTP); see
+   MuonCriteria.
+*/
+template<class Self>
+struct TauCriteria
 {
+    static bool isBaseline(const Tau &tau)
+    {
+        return ( (std::abs(tau.Eta()) < 2.5) &&
+                 (tau.nTrack > 0) &&
+                 (tau.medium) );
+    }
+    static bool isSignal(const Tau &tau)
+    {
+        return (Self::isBaseline(tau) &&
+                std::abs(tau.Eta()) < 2.47 &&
+                tau.Pt() > 20);
+    }
 };
 
-/// implements tau selection for ATL-COM-PHYS-2013-888
-// Ana_3Lep
-class TauSelector_3Lep : public TauSelector
+/// TauSelector implemented by the compile-time Policy (see MuonSelectorT)
+template<class Policy, class Self=void>
+class TauSelectorT : public TauSelector
 {
+public:
+    typedef Policy policy_type;
+    using TauSelector::isBaseline;
+    using TauSelector::isSignal;
+    bool isBaseline(const Tau& tau) override { return Policy::isBaseline(tau); }
+    bool isSignal(const Tau& tau) override { return Policy::isSignal(tau); }
+    bool isSignal(const Tau* tau) override { return tau && Policy::isSignal(*tau); }
+    void selectBaseline(const TauVector &in, TauVector &out) override
+    {
+        if(!usesPolicy()) return TauSelector::selectBaseline(in, out);
+        utils::appendIf(in, out, [](const Tau &tau) { return Policy::isBaseline(tau); });
+    }
+    void selectSignal(const TauVector &in, TauVector &out) override
+    {
+        if(!usesPolicy()) return TauSelector::selectSignal(in, out);
+        utils::appendIf(in, out, [](const Tau &tau) { return Policy::isSignal(tau); });
+    }
+    void classify(ObjectStatus::Collection<Tau> &status) override
+    {
+        if(!usesPolicy()) return TauSelector::classify(status);
+        const TauVector &in = status.objects();
+        std::vector<uint8_t> &bits = status.bits();
+        for(size_t i=0; i<in.size(); ++i) {
+            const Tau &o = *in[i];
+            bits[i] |= ((Policy::isBaseline(o) ? ObjectStatus::Baseline : 0) |
+                        (Policy::isSignal(o) ? ObjectStatus::PassSignal : 0));
+        }
+    }
+protected:
+    /// whether the per-object checks are the Policy ones (no subclass overrides them)
+    bool usesPolicy() const
+    { return typeid(*this)==typeid(TauSelectorT) || typeid(*this)==typeid(Self); }
 };
 
+//----------------------------------------------------------
+//
+// Analysis-specific policies and selectors
+//
+//----------------------------------------------------------
+
+/// generic tau selection
+struct TauPolicy : TauCriteria<TauPolicy> {};
+
+/// implements tau selection for ATL-COM-PHYS-2013-911
+// Ana_2Lep
+class TauSelector_2Lep : public TauSelectorT<TauPolicy, TauSelector_2Lep> {};
+
+/// implements tau selection for ATL-COM-PHYS-2013-888
+// Ana_3Lep
+class TauSelector_3Lep : public TauSelectorT<TauPolicy, TauSelector_3Lep> {};
+
 /// 4Leptons search
-class TauSelector_4Lep : public TauSelector
+struct TauPolicy_4Lep : TauCriteria<TauPolicy_4Lep>
 {
-	virtual bool isBaseline(const Tau& tau);
-    virtual bool isSignal(const Tau& tau);
+    static bool isBaseline(const Tau &tau)
+    {
+        return (tau.Pt() > 20.0                      &&
+                std::abs(tau.Eta()) < 2.47           &&
+                (tau.nTrack == 1 || tau.nTrack == 3) &&
+                std::abs(tau.q) == 1 );
+    }
+    static bool isSignal(const Tau &tau)
+    {
+        return (isBaseline(tau) &&
+                tau.medium);
+    }
 };
+class TauSelector_4Lep : public TauSelectorT<TauPolicy_4Lep, TauSelector_4Lep> {};
 
 /// implements tau selection for ATL-COM-PHYS-2014-221
 // Ana_2LepWH
-class TauSelector_2LepWH : public TauSelector
-{
-};
+class TauSelector_2LepWH : public TauSelectorT<TauPolicy, TauSelector_2LepWH> {};
 
 /// implements tau selection from https://twiki.cern.ch/twiki/bin/viewauth/AtlasProtected/SUSYSameSignLeptonsJetsRun2
 // Ana_SS3L
-class TauSelector_SS3L : public TauSelector
-{
-};
+class TauSelector_SS3L : public TauSelectorT<TauPolicy, TauSelector_SS3L> {};
 
 /// implements tau selection from https://twiki.cern.ch/twiki/bin/view/AtlasProtected/DirectStop2Lepton
 // Ana_Stop2L
-class TauSelector_Stop2L : public TauSelector
-{
-};
+class TauSelector_Stop2L : public TauSelectorT<TauPolicy, TauSelector_Stop2L> {};
 
 // Ana_WWBB
-class TauSelector_WWBB : public TauSelector
-{
-};
+class TauSelector_WWBB : public TauSelectorT<TauPolicy, TauSelector_WWBB> {};
 } // namespace Susy
 #endif
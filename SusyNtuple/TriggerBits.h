@@ -0,0 +1,76 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_TriggerBits_h
+#define SusyNtuple_TriggerBits_h
+
+#include "Rtypes.h"
+
+#include <cstddef>
+
+class TBits;
+
+namespace Susy {
+
+///  Fixed-width set of trigger bits, stored inline as one 64-bit word
+/**
+   Replaces the TBits used for Event::trigBits and Lepton::trigBits up
+   to Event v39 and Lepton v25: no heap allocation, and testing several
+   triggers at once is one AND of the word with a mask (see any() and
+   all()). The bit numbers are the trigger indices of
+   TriggerTools::getTrigNames(). Older files are converted on reading
+   with fromTBits() (see the read rules in LinkDef.h).
+
+   The TBits methods used by the analyses (TestBitNumber,
+   SetBitNumber, ResetAllBits, GetNbits) are kept, so that existing
+   code compiles unchanged.
+ */
+class TriggerBits {
+
+public:
+    static const size_t nBits = 64;
+
+    TriggerBits() : m_word(0) {}
+    explicit TriggerBits(ULong64_t word) : m_word(word) {}
+
+    /// mask with only bit set, 0 if bit is out of range
+    static ULong64_t mask(size_t bit) { return bit<nBits ? (ULong64_t(1) << bit) : 0; }
+
+    bool test(size_t bit) const { return (m_word & mask(bit))!=0; }
+    TriggerBits& set(size_t bit, bool value=true)
+    {
+        if(value) m_word |= mask(bit);
+        else      m_word &= ~mask(bit);
+        return *this;
+    }
+    TriggerBits& reset() { m_word = 0; return *this; }
+    ULong64_t word() const { return m_word; }
+    /// whether at least one of the bits of mask is set
+    bool any(ULong64_t mask) const { return (m_word & mask)!=0; }
+    /// whether all the bits of mask are set
+    bool all(ULong64_t mask) const { return (m_word & mask)==mask; }
+    bool none() const { return m_word==0; }
+    /// number of bits set
+    size_t count() const { return __builtin_popcountll(m_word); }
+
+    /// copy the bits of an old-style TBits; returns false if some bits beyond nBits were set (they are dropped)
+    bool fromTBits(const TBits &bits);
+
+    bool operator==(const TriggerBits &rhs) const { return m_word==rhs.m_word; }
+    bool operator!=(const TriggerBits &rhs) const { return m_word!=rhs.m_word; }
+
+    // TBits interface
+    Bool_t TestBitNumber(UInt_t bit) const { return test(bit); }
+    void SetBitNumber(UInt_t bit, Bool_t value=kTRUE) { set(bit, value); }
+    void ResetBitNumber(UInt_t bit) { set(bit, false); }
+    void ResetAllBits(Bool_t=kFALSE) { reset(); }
+    UInt_t GetNbits() const { return nBits; }
+    UInt_t CountBits() const { return count(); }
+
+private:
+    ULong64_t m_word; ///< bit i is trigger i
+
+    ClassDefNV(TriggerBits, 1);
+};
+
+} // Susy
+
+#endif
@@ -5,7 +5,7 @@
 #include <iostream>
 #include <vector>
 #include <map>
-#include "TBits.h"
+#include "SusyNtuple/TriggerBits.h"
 
 namespace Susy {
     class Event;
@@ -21,6 +21,53 @@ typedef uint32_t DileptonTrigTuple; // give 24 bits for trigger idx, 4+4 bits fo
 const float DILEPTON_TRIG_MATCH_ELE_PT = 17.; // GeV
 const float DILEPTON_TRIG_MATCH_MUO_PT = 17.; // GeV
 
+///  A trigger requirement compiled into bit masks, see TriggerTools::compile()
+/**
+   The event passes if it fired at least one trigger of 'any' and all
+   the triggers of 'all'; an empty mask never passes. Each check is a
+   couple of word operations on the TriggerBits.
+ */
+struct TriggerMask {
+    ULong64_t any; ///< at least one of these triggers (ignored if 0 and 'all' is not empty)
+    ULong64_t all; ///< all of these triggers
+    TriggerMask(ULong64_t anyOf=0, ULong64_t allOf=0) : any(anyOf), all(allOf) {}
+    bool empty() const { return any==0 && all==0; }
+    /// whether the event bits pass the requirement
+    bool pass(const Susy::TriggerBits &event) const
+    {
+        return !empty() && event.all(all) && (any==0 || event.any(any));
+    }
+    /// whether the lepton is matched to one of the triggers of the requirement that fired in the event
+    bool match(const Susy::TriggerBits &event, const Susy::TriggerBits &lepton) const
+    {
+        return (event.word() & lepton.word() & (any | all))!=0;
+    }
+};
+
+///  TriggerMask depending on Event::treatAsYear
+/**
+   \code
+   TriggerTools &tt = nttools().triggerTool();
+   YearTriggerMask singleLep;
+   singleLep.set(2015, tt.compile({"HLT_mu20_iloose_L1MU15", "HLT_e24_lhmedium_L1EM20VH"}))
+            .set(2016, tt.compile({"HLT_mu26_ivarmedium", "HLT_e26_lhtight_nod0_ivarloose"}));
+   ...
+   if(singleLep.pass(*nt.evt())) { ... }
+   \endcode
+   Years without a mask never pass.
+ */
+class YearTriggerMask {
+public:
+    YearTriggerMask& set(int year, const TriggerMask &mask);
+    /// mask for year, an empty one if it was not set
+    const TriggerMask& forYear(int year) const;
+    bool pass(const Susy::Event &event) const;
+    /// whether the lepton is matched to one of the triggers of the event's year that fired
+    bool match(const Susy::Event &event, const Susy::Lepton &lepton) const;
+private:
+    std::vector<std::pair<int, TriggerMask> > m_masks; ///< few years: linear lookup
+};
+
 class TriggerTools {
     public :
         
@@ -60,7 +107,15 @@ class TriggerTools {
         static const std::vector<std::string> met_triggers();
     
         // Method to test whether a given trigger is passed
-        bool passTrigger(const TBits& triggerbits, const std::string &triggerName) const;
+        bool passTrigger(const Susy::TriggerBits& triggerbits, const std::string &triggerName) const;
+
+        /// Compile "any of anyOf and all of allOf" into masks; requires the trigger map (see init())
+        /**
+           e.g. compile(single_muo_triggers()) for any single-muon
+           trigger. Unknown triggers are fatal, as in passTrigger().
+         */
+        TriggerMask compile(const std::vector<std::string> &anyOf,
+                            const std::vector<std::string> &allOf=std::vector<std::string>()) const;
 
         // Dilepton Trigger Match
         static const float ele_match_pt() { return DILEPTON_TRIG_MATCH_ELE_PT; }
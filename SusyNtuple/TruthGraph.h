@@ -0,0 +1,131 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_TruthGraph_h
+#define SusyNtuple_TruthGraph_h
+
+#include "SusyNtuple/mc_truth_utils.h"
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+namespace Susy {
+namespace mc {
+
+///  Parent/child graph of the truth record of one event, for repeated ancestry and decay queries
+/**
+   The truth record is stored as a pdg per particle and, per particle,
+   a vector with the indices of its parents (and of its children).
+   Walking these vectors (e.g. with IntermediateParentWalker) costs a
+   scan per query. This class converts them once per event into
+   contiguous (CSR) arrays, and precomputes:
+   - the first parent with the same pdg (self-copy) and the first copy
+     of each particle, so that parentPdg() is O(1)
+   - optionally (buildAncestry()) the set of ancestors of each
+     particle as a bitset, so that isAncestor() is O(1); it takes
+     n^2/8 bytes for n particles.
+   The children are those stored in the record if given, otherwise
+   the inverse of the parent links. Indices outside the record are
+   dropped (see nInvalidIndices()); cycles in the parent links are
+   tolerated.
+
+   Usage:
+   \code
+   TruthGraph graph;  // reused from one event to the next
+   ...
+   graph.build(*pdgs, *parentIndices, *childrenIndices);
+   graph.buildAncestry();
+   for(int i=0; i<int(graph.size()); ++i)
+       if(graph.isDecayingW(i) && graph.isAncestor(iTop, i)) ...
+   extractor.update(graph);          // WhTruthExtractor
+   kin::eventHasSusyPropagators(graph);
+   \endcode
+ */
+class TruthGraph {
+
+public:
+    /// the parents or children of a particle
+    class Range {
+    public:
+        Range(const int *b, const int *e) : m_begin(b), m_end(e) {}
+        const int* begin() const { return m_begin; }
+        const int* end() const { return m_end; }
+        size_t size() const { return m_end - m_begin; }
+        bool empty() const { return m_begin==m_end; }
+        int operator[](size_t i) const { return m_begin[i]; }
+    private:
+        const int *m_begin;
+        const int *m_end;
+    };
+
+    TruthGraph();
+    /// build(pdgs, parentIndices)
+    TruthGraph(const vint_t &pdgs, const vvint_t &parentIndices);
+    /// build(pdgs, parentIndices, childrenIndices)
+    TruthGraph(const vint_t &pdgs, const vvint_t &parentIndices, const vvint_t &childrenIndices);
+
+    /// build the graph of an event; the children are the inverse of the parent links
+    void build(const vint_t &pdgs, const vvint_t &parentIndices);
+    /// same, with the children stored in the record
+    void build(const vint_t &pdgs, const vvint_t &parentIndices, const vvint_t &childrenIndices);
+    /// precompute the ancestors of each particle, for O(1) isAncestor()
+    void buildAncestry();
+    bool hasAncestry() const { return m_hasAncestry; }
+
+    size_t size() const { return m_pdgs.size(); }
+    int pdg(int i) const { return m_pdgs[i]; }
+    const vint_t& pdgs() const { return m_pdgs; }
+    Range parents(int i) const { return range(m_parentOffsets, m_parents, i); }
+    Range children(int i) const { return range(m_childOffsets, m_children, i); }
+    /// number of parent or child indices outside the record, dropped by build()
+    size_t nInvalidIndices() const { return m_nInvalid; }
+    /// whether the parent links contain a cycle
+    bool hasCycle() const { return m_hasCycle; }
+
+    /// whether a is an ancestor of i; O(1) after buildAncestry(), a walk up the parents otherwise
+    bool isAncestor(int a, int i) const;
+    bool isDescendant(int i, int a) const { return isAncestor(a, i); }
+    /// the ancestors of i, in increasing index order
+    vint_t ancestors(int i) const;
+    /// the first parent of i with the same pdg; -1 if none
+    int selfParent(int i) const { return m_selfParent[i]; }
+    /// the earliest copy of i, going up through selfParent()
+    int firstCopy(int i) const { return m_firstCopy[i]; }
+    /// pdg of the first parent of the first copy of i, -999 if none; same as determineParentPdg()
+    int parentPdg(int i) const;
+
+    /// SM top decaying to b/d/s + W (+ gluons); same as IsSmTopIndex
+    bool isSmTop(int i) const;
+    /// W that is not an intermediate copy and decays to quarks or leptons (+ photons); same as IsDecayingWIndex
+    bool isDecayingW(int i) const;
+
+private:
+    static Range range(const std::vector<int> &offsets, const std::vector<int> &flat, int i)
+    { return Range(flat.data() + offsets[i], flat.data() + offsets[i+1]); }
+    /// store links in CSR form, dropping the invalid indices
+    void fillLinks(const vvint_t &links, std::vector<int> &offsets, std::vector<int> &flat);
+    /// the children as the inverse of the parent links
+    void invertParents();
+    /// common part of build(): self-copies and the order in which the parents come first
+    void buildCopies();
+    bool testAncestor(int a, int i) const
+    { return (m_ancestors[static_cast<size_t>(i)*m_words + a/64] >> (a%64)) & 1; }
+
+    vint_t m_pdgs;
+    std::vector<int> m_parentOffsets;   ///< parents of i: m_parents[m_parentOffsets[i], m_parentOffsets[i+1])
+    std::vector<int> m_parents;
+    std::vector<int> m_childOffsets;
+    std::vector<int> m_children;
+    std::vector<int> m_selfParent;
+    std::vector<int> m_firstCopy;
+    std::vector<int> m_order;           ///< the particles, parents before children (except on cycles)
+    size_t m_words;                     ///< 64-bit words per ancestor bitset
+    std::vector<uint64_t> m_ancestors;  ///< bit a of row i: a is an ancestor of i
+    size_t m_nInvalid;
+    bool m_hasCycle;
+    bool m_hasAncestry;
+};
+
+} // mc
+} // Susy
+
+#endif
@@ -73,6 +73,16 @@ namespace D3PDReader {
       /// Set the "activity level" of the variable
       void SetActive( ::Bool_t active = kTRUE );
 
+      /// Get the basket size of the output branch
+      ::Int_t GetBasketSize() const;
+      /// Set the basket size of the output branch (before WriteTo)
+      void SetBasketSize( ::Int_t size );
+
+      /// Get the split level of the output branch of an object
+      ::Int_t GetSplitLevel() const;
+      /// Set the split level of the output branch of an object (before WriteTo)
+      void SetSplitLevel( ::Int_t level );
+
       /// Check if the variable is available in the input
       virtual ::Bool_t IsAvailable() const;
 
@@ -108,6 +118,8 @@ namespace D3PDReader {
    private:
       ::TString fName; ///< Name of the branch to handle
       ::Bool_t fActive; ///< Flag telling if the variable can be written to the output
+      ::Int_t fBasketSize; ///< Basket size of the output branch
+      ::Int_t fSplitLevel; ///< Split level of the output branch (objects only)
 
       ::TString fType; ///< Variable type
       mutable std::vector< ::Long64_t > fEntriesRead; ///< Number of read entries for each tree
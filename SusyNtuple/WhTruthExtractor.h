@@ -3,6 +3,7 @@
 #define WHTRUTHEXTRACTOR_H
 
 #include "SusyNtuple/mc_truth_utils.h"
+#include "SusyNtuple/TruthGraph.h"
 
 #include <vector>
 #include <string>
@@ -28,6 +29,8 @@ class WhTruthExtractor {
  public:
   WhTruthExtractor();
   Susy::mc::Hdecays update(const vint_t* pdg, const vvint_t *childIndex, const vvint_t *parentIndex);
+  //! same as above, from the truth graph of the event (built once, shared with the other truth queries)
+  Susy::mc::Hdecays update(const Susy::mc::TruthGraph &graph);
   Susy::mc::Hdecays decay() const {return decay_;}
   void printStatus() const;
   //! indices of relevant particles (top, W, and their children) in a MC@NLO ttbar event
@@ -37,11 +40,13 @@ class WhTruthExtractor {
    */
   static vint_t ttbarMcAtNloParticles(const vint_t *pdgs,
                                       const vvint_t *childrenIndices);
+  static vint_t ttbarMcAtNloParticles(const Susy::mc::TruthGraph &graph);
   /// indices of the relevant particle for a higgs event (H, its parents, its children)
   /**
      Internally calls @update()
   */
  vint_t higgsEventParticleIndices(const vint_t* pdg, const vvint_t *childIndex, const vvint_t *parentIndex);
+ vint_t higgsEventParticleIndices(const Susy::mc::TruthGraph &graph);
  public:
   bool verbose_;
   const vint_t pdgsPbAb_;
@@ -52,8 +57,8 @@ class WhTruthExtractor {
                          const vvint_t &childIndex, const vvint_t &parentIndex);
  private:
   Susy::mc::vint_t findHiggsIndices(const vint_t &pdg);
-  void buildHiggsChildrenPgds(const vint_t &pdgs, const vvint_t &childIndices);
-  void buildHiggsParentsPgds(const vint_t &pdgs, const vvint_t &parentIndices);
+  void buildHiggsChildrenPgds(const Susy::mc::TruthGraph &graph);
+  void buildHiggsParentsPgds(const Susy::mc::TruthGraph &graph);
   bool isBoringHiggs(size_t iHiggs) const; //!< intermediate higgs have < 2 children or another higgs as child
   int firstInterestingHiggs() const; //!< internal index 1st interesting higgs; -1 if none
   Susy::mc::Hdecays decayType(size_t iHiggs) const; //!< classify the decay of the i^th higgs
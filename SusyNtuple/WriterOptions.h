@@ -0,0 +1,107 @@
+//  -*- c++ -*-
+#ifndef SusyNtuple_WriterOptions_h
+#define SusyNtuple_WriterOptions_h
+
+#include "Rtypes.h"
+
+#include <map>
+#include <string>
+
+class TFile;
+class TTree;
+
+namespace Susy {
+
+class SusyNtObject;
+
+///  Compression and basket/cluster layout of an output susyNt tree
+/**
+   By default the susyNt branches are written with basket size 32000,
+   unsplit (split level 0), with the compression and auto-flush
+   defaults of ROOT. These options change them:
+   - compression algorithm (ZLIB, LZMA, LZ4, ZSTD) and level
+   - basket size, for all the branches or per branch (collection)
+   - auto-flush: the cluster size, in entries (>0) or in bytes (<0)
+   - split level of the object branches (e.g. 99: one sub-branch per
+     data member, so that a reader only decompresses the members it reads)
+
+   The options can be given as a string, e.g. on the command line:
+   \code
+   WriterOptions opts;
+   if(!opts.parse("zstd:5,basket=64000,electrons.basket=128000,flush=-30000000,split=99")) return 1;
+   TFile *file = TFile::Open("out.root", "recreate");
+   opts.apply(file);                  // before creating the tree
+   TTree *tree = new TTree("susyNt", "susyNt");
+   opts.apply(tree);
+   opts.apply(nt);                    // before nt.WriteTo(tree)
+   nt.WriteTo(tree);
+   \endcode
+   The options that are not set keep the current behaviour.
+   See SusyNtSlimmer::setWriterOptions and the -w option of SusyNtBench.
+ */
+class WriterOptions {
+
+public:
+    /// compression algorithms, numbered as ROOT::ECompressionAlgorithm
+    enum Algorithm {
+        Global = 0,     ///< ROOT's default
+        Zlib = 1,
+        Lzma = 2,
+        Lz4 = 4,
+        Zstd = 5
+    };
+
+    WriterOptions();
+
+    /// compression algorithm and level (0: no compression)
+    WriterOptions& setCompression(Algorithm algorithm, int level);
+    /// basket size of all the branches
+    WriterOptions& setBasketSize(int bytes);
+    /// basket size of one branch (e.g. "electrons"); takes precedence over setBasketSize(bytes)
+    WriterOptions& setBasketSize(const std::string &branch, int bytes);
+    /// TTree::SetAutoFlush: >0 entries per cluster, <0 bytes per cluster, 0 disabled
+    WriterOptions& setAutoFlush(Long64_t value);
+    /// split level of the object branches (0: unsplit)
+    WriterOptions& setSplitLevel(int level);
+
+    /// set the options from a comma-separated list (see the class doc); false (and a message) if invalid
+    /**
+       The items are: '<algorithm>[:<level>]' with algorithm one of
+       global, zlib, lzma, lz4, zstd, or 'none'; 'basket=<bytes>';
+       '<branch>.basket=<bytes>'; 'flush=<value>'; 'split=<level>'.
+     */
+    bool parse(const std::string &options);
+    /// the options in the format of parse(); "default" if none is set
+    std::string str() const;
+
+    /// the ROOT compression settings (100*algorithm+level); -1 if not set
+    int compressionSettings() const { return m_compression; }
+    /// basket size of branch; -1 if not set
+    int basketSize(const std::string &branch) const;
+    /// auto-flush value; false if not set
+    bool autoFlush(Long64_t &value) const { value = m_autoFlush; return m_hasAutoFlush; }
+    /// split level; -1 if not set
+    int splitLevel() const { return m_splitLevel; }
+
+    /// set the compression of file (before creating its trees)
+    void apply(TFile* file) const;
+    /// set the auto-flush of tree
+    void apply(TTree* tree) const;
+    /// set the basket size and split level of the branches of nt (before nt.WriteTo)
+    void apply(SusyNtObject &nt) const;
+
+    /// name used by parse() and str(), e.g. "zstd"
+    static std::string algorithmName(Algorithm algorithm);
+
+private:
+    int m_compression;
+    int m_basketSize;
+    std::map<std::string, int> m_branchBasketSize;
+    bool m_hasAutoFlush;
+    Long64_t m_autoFlush;
+    int m_splitLevel;
+};
+
+} // Susy
+
+#endif
@@ -54,7 +54,8 @@ enum PdgIds{
 std::string decayToString(const Hdecays &d);
 //! find the pdg of the parent
 /*!
-  Useful when there are intermediate duplicates and one needs to navigate up the decay chain
+  Useful when there are intermediate duplicates and one needs to navigate up the decay chain.
+  For many queries on the same event, see TruthGraph::parentPdg().
 */
 int determineParentPdg(const vint_t *pdgs, const vvint_t *parentsIndices, const int &particleIndex);
 //! functor that navigates up the chain when there are intermediate particles
@@ -0,0 +1,65 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef SUSY_TEST_UTILS_H
+#define SUSY_TEST_UTILS_H
+
+/*
+  Checks for the test executables (util/test_*.cxx)
+
+  A failing check is printed with its expression, its location and,
+  for SUSYNT_CHECK_EQUAL, the two values; the last line is
+  "<name>: success" or "<name>: FAILED", and the exit code is 0 or 1:
+  \code
+  Susy::utils::TestReport test("test_Cutflow");
+  SUSYNT_CHECK(test, cutflow.nCuts()==3);
+  SUSYNT_CHECK_EQUAL(test, cutflow.weighted(2, 1), 5.0);
+  return test.finish();
+  \endcode
+*/
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+namespace Susy{
+namespace utils{
+
+class TestReport {
+public:
+    explicit TestReport(const std::string &name);
+    /// record a check; print expression and location when it fails; return pass
+    bool check(bool pass, const std::string &expression, const char *file, int line);
+    /// record the check a==b; print the two values when it fails
+    template < class A, class B >
+    bool checkEqual(A a, B b, const char *exprA, const char *exprB, const char *file, int line) {
+        const bool pass = (a==b);
+        if(pass && !m_verbose) { m_nChecks++; return true; }
+        std::ostringstream expression;
+        expression<<exprA<<" == "<<exprB;
+        if(!pass) expression<<" ("<<a<<" vs "<<b<<")";
+        return check(pass, expression.str(), file, line);
+    }
+    /// toggle the printout of the checks that pass
+    TestReport& setVerbose(bool v=true) { m_verbose = v; return *this; }
+    bool verbose() const { return m_verbose; }
+    const std::string& name() const { return m_name; }
+    bool success() const { return m_nFailed==0; }
+    size_t nChecks() const { return m_nChecks; }
+    size_t nFailed() const { return m_nFailed; }
+    /// print the outcome; return the exit code of the test (0 on success)
+    int finish() const;
+private:
+    std::string m_name;
+    size_t m_nChecks;
+    size_t m_nFailed;
+    bool m_verbose;
+};
+
+} // utils
+} // susy
+
+/// record the outcome of expr in the TestReport test
+#define SUSYNT_CHECK(test, expr) (test).check((expr), #expr, __FILE__, __LINE__)
+/// record whether a==b in the TestReport test, with the values when they differ
+#define SUSYNT_CHECK_EQUAL(test, a, b) (test).checkEqual((a), (b), #a, #b, __FILE__, __LINE__)
+
+#endif
@@ -61,6 +61,16 @@ Container<A, Allocator> filter(Container<A, Allocator> const & container, Predic
   return filtered;
 }
 
+//! append to out the non-null pointers of in whose object passes pred
+/**
+   Used by the policy-based selectors (e.g. MuonSelectorT), where pred
+   is a lambda calling the inline selection function.
+*/
+template < typename T, typename Predicate >
+void appendIf(const std::vector<T*> &in, std::vector<T*> &out, Predicate const & pred) {
+  for(size_t i=0; i<in.size(); ++i)
+    if(in[i] && pred(*in[i])) out.push_back(in[i]);
+}
 
 } // utils
 } // susy
@@ -1,6 +1,7 @@
 //SusyNtuple
 #include "SusyNtuple/Susy2LepCutflow.h"
 #include "SusyNtuple/ChainHelper.h"
+#include "SusyNtuple/ChainPrefetchDriver.h"
 #include "SusyNtuple/string_utils.h"
 
 //std/stl
@@ -34,10 +35,15 @@ void help()
     cout << "   -n          number of events to process (default: all)" << endl;
     cout << "   -d          debug level (integer) (default: 0)" << endl;
     cout << "   -i          input file (ROOT file, *.txt file, or directory)" << endl;
+    cout << "   -t          time the stages of the event loop" << endl;
+    cout << "   -c          read the hardware counters for each stage, print them every N events (0: at the end only)" << endl;
+    cout << "   -o          write the cutflows to this text file (c.f. SusyNtuple/Cutflow.h)" << endl;
+    cout << "   -p          open and warm up the next input file in the background (c.f. SusyNtuple/ChainPrefetchDriver.h)" << endl;
     cout << "   -h          print this help message" << endl;
     cout << endl;
     cout << "  Example Usage:" << endl;
     cout << "   Susy2LepCF -i susyNt.root -n 500" << endl;
+    cout << "   Susy2LepCF -i filelist.txt -p" << endl;
     cout << "----------------------------------------------------------" << endl;
 }
 
@@ -51,11 +57,19 @@ int main(int argc, char** argv)
     int n_events = -1;
     int dbg = 0;
     string input = "";
+    bool time_stages = false;
+    int perf_every = -1;
+    string cutflow_output = "";
+    bool prefetch = false;
 
     for(int i = 1; i < argc; i++) {
         if      (strcmp(argv[i], "-n") == 0) n_events = atoi(argv[++i]);
         else if (strcmp(argv[i], "-d") == 0) dbg = atoi(argv[++i]);
         else if (strcmp(argv[i], "-i") == 0) input = argv[++i];
+        else if (strcmp(argv[i], "-t") == 0) time_stages = true;
+        else if (strcmp(argv[i], "-c") == 0) perf_every = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-o") == 0) cutflow_output = argv[++i];
+        else if (strcmp(argv[i], "-p") == 0) prefetch = true;
         else if (strcmp(argv[i], "-h") == 0) { help(); return 0; }
         else {
             cout << "Susy2LepCF    Unknown command line argument '" << argv[i] << "', exiting" << endl;
@@ -96,8 +110,11 @@ int main(int argc, char** argv)
     analysis->setAnaType(AnalysisType::Ana_2Lep);
 
     analysis->set_debug(dbg);
+    analysis->setStageTiming(time_stages); // per-stage latencies printed at the end (c.f. SusyNtuple/SusyNtAna.h)
+    if(perf_every>=0) analysis->setPerfCounters(true, perf_every);
     analysis->setSampleName(ChainHelper::sampleName(input, dbg>0)); // SusyNtAna setSampleName (c.f. SusyNtuple/SusyNtAna.h)
     analysis->set_chain(chain); // propagate the TChain to the analysis
+    analysis->set_cutflow_output(cutflow_output);
 
     // for using the TriggerTools (c.f. SusyNtuple/TriggerTools.h) we
     // must provide the first file in our chain to initialize the
@@ -116,8 +133,15 @@ int main(int argc, char** argv)
     cout << "---------------------------------------------------------" << endl;
 
     
-    // call TChain Process to star the TSelector looper over the input TChain
-    if(n_events > 0) chain->Process(analysis, input.c_str(), n_events);
+    // call TChain Process to star the TSelector looper over the input TChain;
+    // or run the same loop with the ChainPrefetchDriver, which opens the
+    // next file of the chain while the current one is being processed
+    if(n_events > 0 && prefetch) {
+        Susy::ChainPrefetchDriver driver(chain);
+        driver.process(analysis, input.c_str(), n_events);
+        driver.print(cout);
+    }
+    else if(n_events > 0) chain->Process(analysis, input.c_str(), n_events);
 
     cout << endl;
     cout << "Susy2LepCF    Analysis loop done" << endl;
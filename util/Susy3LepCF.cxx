@@ -38,6 +38,11 @@ void help()
   cout << "  -S selection region"               << endl;
   cout << "     defaults: sr1"                  << endl;
 
+  cout << "  -t time the stages of the event loop" << endl;
+
+  cout << "  -c read the hardware counters for each stage, print them every N events" << endl;
+  cout << "     defaults: -1 (off); 0 prints them at the end only" << endl;
+
   cout << "  -h print this help"                << endl;
 }
 
@@ -50,6 +55,8 @@ int main(int argc, char** argv)
   string sample;
   string input;
   string sel = "sr1";  
+  bool timeStages = false;
+  int perfEvery = -1;
  
   cout << "Susy3LepCF" << endl;
   cout << endl;
@@ -62,6 +69,8 @@ int main(int argc, char** argv)
     else if (strcmp(argv[i], "-i") == 0) input = argv[++i];
     else if (strcmp(argv[i], "-s") == 0) sample = argv[++i];
     else if (strcmp(argv[i], "-S") == 0) sel = argv[++i];
+    else if (strcmp(argv[i], "-t") == 0) timeStages = true;
+    else if (strcmp(argv[i], "-c") == 0) perfEvery = atoi(argv[++i]);
     else
     {
       help();
@@ -95,6 +104,8 @@ int main(int argc, char** argv)
   // Build the TSelector
   Susy3LepCutflow* susyAna = new Susy3LepCutflow();
   susyAna->setDebug(dbg);
+  susyAna->setStageTiming(timeStages);
+  if(perfEvery>=0) susyAna->setPerfCounters(true, perfEvery);
   susyAna->setSampleName(ChainHelper::sampleName(input, verbose));
   susyAna->setSelection(sel);
   susyAna->nttools().initTriggerTool(ChainHelper::firstFile(input, dbg>0));
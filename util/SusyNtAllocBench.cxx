@@ -0,0 +1,107 @@
+//SusyNtuple
+#include "SusyNtuple/SusyNtObject.h"
+#include "SusyNtuple/ChainHelper.h"
+#include "SusyNtuple/AllocationCounter.h"
+
+//std/stl
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+using namespace std;
+
+//ROOT
+#include "TChain.h"
+#include "TStopwatch.h"
+
+SUSYNT_DEFINE_COUNTING_OPERATOR_NEW
+
+//////////////////////////////////////////////////////
+//
+// SusyNtAllocBench
+//
+// Read all the branches of a susyNt and report the
+// number of heap allocations per event, with the
+// default ROOT streamers and with the objects' storage
+// being reused across events
+// (SusyNtObject::SetReuseStorage)
+//
+//////////////////////////////////////////////////////
+
+void help()
+{
+    cout << "----------------------------------------------------------" << endl;
+    cout << " SusyNtAllocBench" << endl;
+    cout << endl;
+    cout << "  Options:" << endl;
+    cout << "   -i          input file (ROOT file, *.txt file, or directory)" << endl;
+    cout << "   -n          number of events to read (default: all)" << endl;
+    cout << "   -h          print this help message" << endl;
+    cout << "----------------------------------------------------------" << endl;
+}
+
+/// read the first nEntries with all the branches; print the allocations per event
+void readAll(TChain* chain, Long64_t nEntries, const string &label)
+{
+    Long64_t entry = 0;
+    Susy::SusyNtObject nt(entry);
+    nt.ReadFrom(chain);
+    vector<D3PDReader::VarHandleBase*> vars = nt.handles();
+    // first entry outside of the count: connect the branches, build the caches
+    entry = chain->LoadTree(0);
+    for(size_t i=0; i<vars.size(); ++i) if(vars[i]->IsAvailable()) vars[i]->ReadCurrentEntry();
+
+    TStopwatch timer;
+    Susy::AllocationCounter counter;
+    Long64_t nRead = 0;
+    for(Long64_t iEntry=1; iEntry<nEntries; ++iEntry) {
+        entry = chain->LoadTree(iEntry);
+        if(entry<0) break;
+        for(size_t i=0; i<vars.size(); ++i) if(vars[i]->IsAvailable()) vars[i]->ReadCurrentEntry();
+        nRead++;
+    }
+    timer.Stop();
+    double n = (nRead>0 ? nRead : 1);
+    cout << "SusyNtAllocBench    " << setw(8) << label
+         << "  events " << nRead
+         << "  allocations/event " << fixed << setprecision(1) << counter.allocations()/n
+         << "  bytes/event " << counter.bytes()/n
+         << "  cpu time/event [us] " << 1.0e6*timer.CpuTime()/n
+         << endl;
+}
+
+int main(int argc, char** argv)
+{
+    Long64_t n_events = -1;
+    string input = "";
+
+    for(int i = 1; i < argc; i++) {
+        if      (strcmp(argv[i], "-n") == 0) n_events = atoll(argv[++i]);
+        else if (strcmp(argv[i], "-i") == 0) input = argv[++i];
+        else if (strcmp(argv[i], "-h") == 0) { help(); return 0; }
+        else {
+            cout << "SusyNtAllocBench    Unknown command line argument '" << argv[i] << "', exiting" << endl;
+            help();
+            return 1;
+        }
+    } // i
+
+    if(input.empty()) {
+        cout << "SusyNtAllocBench    You must specify an input" << endl;
+        return 1;
+    }
+
+    TChain* chain = new TChain("susyNt");
+    ChainHelper::addInput(chain, input, false);
+    Long64_t n_entries = chain->GetEntries();
+    if(n_events < 0 || n_events > n_entries) n_events = n_entries;
+
+    Susy::SusyNtObject::SetReuseStorage(false);
+    readAll(chain, n_events, "default");
+    Susy::SusyNtObject::SetReuseStorage(true);
+    readAll(chain, n_events, "reuse");
+
+    delete chain;
+    return 0;
+}
@@ -0,0 +1,447 @@
+//SusyNtuple
+#include "SusyNtuple/Susy2LepCutflow.h"
+#include "SusyNtuple/Susy3LepCutflow.h"
+#include "SusyNtuple/SusyLepTrigExample.h"
+#include "SusyNtuple/SusyNtGenerator.h"
+#include "SusyNtuple/SusyNtSlimmer.h"
+#include "SusyNtuple/WriterOptions.h"
+#include "SusyNtuple/ChainHelper.h"
+#include "SusyNtuple/BenchmarkReport.h"
+#include "SusyNtuple/StageTimer.h"
+#include "SusyNtuple/AllocationCounter.h"
+#include "SusyNtuple/string_utils.h"
+
+//std/stl
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+//ROOT
+#include "TChain.h"
+#include "TFile.h"
+#include "TSystem.h"
+
+//POSIX
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+SUSYNT_DEFINE_COUNTING_OPERATOR_NEW
+
+//////////////////////////////////////////////////////
+//
+// SusyNtBench
+//
+// Run the example analyses (Susy2LepCF, Susy3LepCF,
+// SusyLepTrig) over a fixed synthetic dataset (see
+// Susy::SusyNtGenerator) and report the throughput,
+// peak memory, bytes read and heap allocations.
+// Each analysis runs in its own child process, so
+// that the peak RSS of one does not hide the next.
+// The results can be compared to a baseline JSON
+// file written by a previous run; the exit code is 2
+// if any metric is worse than the baseline by more
+// than its tolerance.
+//
+// With -w the dataset is first rewritten with each of
+// the given output layouts (compression, basket size,
+// auto-flush, split level; see Susy::WriterOptions),
+// and the file size, the write and full-read speed
+// and the analyses are measured for each layout.
+//
+//////////////////////////////////////////////////////
+
+void help()
+{
+    cout << "----------------------------------------------------------" << endl;
+    cout << " SusyNtBench" << endl;
+    cout << endl;
+    cout << "  Options:" << endl;
+    cout << "   -i          input susyNt (default: generate susyNt_bench.root if missing)" << endl;
+    cout << "   -n          number of events of the generated dataset (default: 20000)" << endl;
+    cout << "   -s          random seed of the generated dataset (default: 4357)" << endl;
+    cout << "   --regenerate  write the generated dataset even if the file exists" << endl;
+    cout << "   -a          comma-separated analyses (default: Susy2LepCF,Susy3LepCF,SusyLepTrig)" << endl;
+    cout << "   -r          repetitions per analysis, the fastest one is kept (default: 3)" << endl;
+    cout << "   -o          write the results to this JSON file" << endl;
+    cout << "   -l          label stored in the JSON file (e.g. the release)" << endl;
+    cout << "   -b          baseline JSON file to compare with" << endl;
+    cout << "   -T          relative tolerance of all metrics (default: 0.10)," << endl;
+    cout << "               or of one metric with metric=value (e.g. -T peak_rss_mb=0.05)" << endl;
+    cout << "   -w          semicolon-separated output layouts to compare, e.g. 'zlib:1;lz4:4;zstd:5,split=99'" << endl;
+    cout << "               (see Susy::WriterOptions; 'default' is the current layout)" << endl;
+    cout << "   -v          print the output of the analyses" << endl;
+    cout << "   -h          print this help message" << endl;
+    cout << endl;
+    cout << "  Example Usage:" << endl;
+    cout << "   SusyNtBench -o baseline.json -l SusyNtuple-00-07-00" << endl;
+    cout << "   SusyNtBench -b baseline.json -T 0.05 -T events_per_s=0.15" << endl;
+    cout << "   SusyNtBench -w 'default;lz4:4;zstd:5;zstd:5,split=99,flush=-30000000' -a Susy2LepCF -o layouts.json" << endl;
+    cout << "----------------------------------------------------------" << endl;
+}
+
+/// measurements of one analysis job
+struct JobResult {
+    double events;
+    double seconds;
+    double bytesRead;
+    double allocations;
+    double peakRssKb;
+    JobResult() : events(0), seconds(0), bytesRead(0), allocations(0), peakRssKb(0) {}
+};
+
+/// build and configure the analysis as its executable in util/ does; 0 if unknown
+TSelector* buildAnalysis(const string &name, TChain* chain, const string &input)
+{
+    if(name=="Susy2LepCF") {
+        Susy2LepCutflow* ana = new Susy2LepCutflow();
+        ana->setAnaType(AnalysisType::Ana_2Lep);
+        ana->setSampleName(ChainHelper::sampleName(input, false));
+        ana->set_chain(chain);
+        ana->nttools().initTriggerTool(ChainHelper::firstFile(input, false));
+        return ana;
+    }
+    if(name=="Susy3LepCF") {
+        Susy3LepCutflow* ana = new Susy3LepCutflow();
+        ana->setSampleName(ChainHelper::sampleName(input, false));
+        ana->setSelection("sr1");
+        ana->nttools().initTriggerTool(ChainHelper::firstFile(input, false));
+        return ana;
+    }
+    if(name=="SusyLepTrig") {
+        SusyLepTrigExample* ana = new SusyLepTrigExample();
+        ana->set_chain(chain);
+        ana->set_pt_thresholds(25, 20);
+        ana->setAnaType(AnalysisType::Ana_Stop2L);
+        ana->nttools().initTriggerTool(ChainHelper::firstFile(input, false));
+        return ana;
+    }
+    return 0;
+}
+
+/// run job in a child process; it writes "key value" lines to the file descriptor it gets
+/**
+   Return false if the child fails; the peak RSS of the child is
+   stored in result.peakRssKb.
+ */
+bool runInChild(const function<bool(int)> &job, bool verbose, string &output, JobResult &result)
+{
+    int fds[2];
+    if(pipe(fds)!=0) { perror("SusyNtBench    pipe"); return false; }
+    cout.flush();
+    pid_t pid = fork();
+    if(pid<0) { perror("SusyNtBench    fork"); return false; }
+    if(pid==0) {
+        close(fds[0]);
+        if(!verbose) {
+            int devnull = open("/dev/null", O_WRONLY);
+            if(devnull>=0) { dup2(devnull, STDOUT_FILENO); close(devnull); }
+        }
+        bool ok = job(fds[1]);
+        cout.flush();
+        close(fds[1]);
+        _exit(ok ? 0 : 1);
+    }
+    close(fds[1]);
+    output.clear();
+    char buffer[256];
+    ssize_t n = 0;
+    while((n = read(fds[0], buffer, sizeof(buffer)))>0) output.append(buffer, n);
+    close(fds[0]);
+    int status = 0;
+    struct rusage usage;
+    if(wait4(pid, &status, 0, &usage)<0) { perror("SusyNtBench    wait4"); return false; }
+#ifdef __APPLE__
+    result.peakRssKb = usage.ru_maxrss/1024.0; // bytes on macOS
+#else
+    result.peakRssKb = usage.ru_maxrss;
+#endif
+    return WIFEXITED(status) && WEXITSTATUS(status)==0;
+}
+
+/// write one "key value" line to fd
+void writeValue(int fd, const char* key, double value)
+{
+    char line[128];
+    int n = snprintf(line, sizeof(line), "%s %.17g\n", key, value);
+    if(n>0 && write(fd, line, n)!=n) perror("SusyNtBench    write");
+}
+
+/// parse the "key value" lines written by a job; false if it processed no event
+bool readValues(const string &output, JobResult &result)
+{
+    istringstream values(output);
+    string key;
+    double value = 0;
+    while(values>>key>>value) {
+        if     (key=="events") result.events = value;
+        else if(key=="seconds") result.seconds = value;
+        else if(key=="bytes") result.bytesRead = value;
+        else if(key=="allocations") result.allocations = value;
+    }
+    return result.events>0 && result.seconds>0;
+}
+
+/// run the analysis once over all the events of input
+bool benchmark(const string &name, const string &input, bool verbose, JobResult &result)
+{
+    string output;
+    bool ok = runInChild([&](int fd) {
+            TChain* chain = new TChain("susyNt");
+            ChainHelper::addInput(chain, input, false);
+            Long64_t nEntries = chain->GetEntries();
+            TSelector* ana = buildAnalysis(name, chain, input);
+            if(!ana || nEntries<=0) return false;
+            Long64_t bytesBefore = TFile::GetFileBytesRead();
+            Susy::AllocationCounter counter;
+            uint64_t start = Susy::StageTimer::now();
+            Long64_t nProcessed = chain->Process(ana, input.c_str(), nEntries);
+            uint64_t stop = Susy::StageTimer::now();
+            writeValue(fd, "events", nEntries);
+            writeValue(fd, "seconds", 1.0e-9*(stop-start));
+            writeValue(fd, "bytes", TFile::GetFileBytesRead()-bytesBefore);
+            writeValue(fd, "allocations", counter.allocations());
+            return nProcessed>=0;
+        }, verbose, output, result);
+    return ok && readValues(output, result);
+}
+
+/// write a copy of input with the output layout options, as SusyNtSlim does
+bool writeLayout(const string &input, const string &output, const Susy::WriterOptions &options,
+                 bool verbose, JobResult &result)
+{
+    string values;
+    bool ok = runInChild([&](int fd) {
+            TChain* chain = new TChain("susyNt");
+            ChainHelper::addInput(chain, input, false);
+            Susy::SusyNtSlimmer slimmer;
+            slimmer.setOutputFilename(output).setWriterOptions(options);
+            uint64_t start = Susy::StageTimer::now();
+            Long64_t nWritten = slimmer.process(chain);
+            uint64_t stop = Susy::StageTimer::now();
+            writeValue(fd, "events", nWritten);
+            writeValue(fd, "seconds", 1.0e-9*(stop-start));
+            return nWritten>0;
+        }, verbose, values, result);
+    return ok && readValues(values, result);
+}
+
+/// read all the branches of all the events of input
+bool readAll(const string &input, bool verbose, JobResult &result)
+{
+    string output;
+    bool ok = runInChild([&](int fd) {
+            TChain* chain = new TChain("susyNt");
+            ChainHelper::addInput(chain, input, false);
+            Long64_t nEntries = chain->GetEntries();
+            Long64_t entry = 0;
+            Susy::SusyNtObject nt(entry);
+            nt.ReadFrom(chain);
+            nt.SetActive();
+            Long64_t bytesBefore = TFile::GetFileBytesRead();
+            Susy::AllocationCounter counter;
+            uint64_t start = Susy::StageTimer::now();
+            for(Long64_t i=0; i<nEntries; ++i) {
+                entry = chain->LoadTree(i);
+                if(entry<0) return false;
+                nt.ReadActive();
+            }
+            uint64_t stop = Susy::StageTimer::now();
+            writeValue(fd, "events", nEntries);
+            writeValue(fd, "seconds", 1.0e-9*(stop-start));
+            writeValue(fd, "bytes", TFile::GetFileBytesRead()-bytesBefore);
+            writeValue(fd, "allocations", counter.allocations());
+            return nEntries>0;
+        }, verbose, output, result);
+    return ok && readValues(output, result);
+}
+
+/// fastest of repetitions runs of job; the peak RSS is the smallest one
+bool bestOf(int repetitions, const function<bool(JobResult&)> &job, JobResult &best)
+{
+    double minRssKb = 0;
+    for(int r=0; r<repetitions; ++r) {
+        JobResult result;
+        if(!job(result)) return false;
+        if(r==0 || result.seconds<best.seconds) best = result;
+        if(r==0 || result.peakRssKb<minRssKb) minRssKb = result.peakRssKb;
+    }
+    best.peakRssKb = minRssKb;
+    return true;
+}
+
+/// add the metrics of one analysis run to report
+void addAnalysis(Susy::BenchmarkReport &report, const string &name, const JobResult &best)
+{
+    report.add(name, "events", best.events);
+    report.add(name, "events_per_s", best.events/best.seconds);
+    report.add(name, "peak_rss_mb", best.peakRssKb/1024.0);
+    report.add(name, "bytes_read_per_event", best.bytesRead/best.events);
+    report.add(name, "allocs_per_event", best.allocations/best.events);
+}
+
+int main(int argc, char** argv)
+{
+    string input = "";
+    string generated = "susyNt_bench.root";
+    Long64_t n_generated = 20000;
+    int seed = 4357;
+    bool regenerate = false;
+    string analyses = "Susy2LepCF,Susy3LepCF,SusyLepTrig";
+    int repetitions = 3;
+    string output = "";
+    string label = "";
+    string baseline_file = "";
+    vector<string> tolerance_args;
+    vector<Susy::WriterOptions> layouts;
+    bool verbose = false;
+
+    for(int i = 1; i < argc; i++) {
+        if      (strcmp(argv[i], "-i") == 0) input = argv[++i];
+        else if (strcmp(argv[i], "-n") == 0) n_generated = atoll(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0) seed = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--regenerate") == 0) regenerate = true;
+        else if (strcmp(argv[i], "-a") == 0) analyses = argv[++i];
+        else if (strcmp(argv[i], "-r") == 0) repetitions = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-o") == 0) output = argv[++i];
+        else if (strcmp(argv[i], "-l") == 0) label = argv[++i];
+        else if (strcmp(argv[i], "-b") == 0) baseline_file = argv[++i];
+        else if (strcmp(argv[i], "-T") == 0) tolerance_args.push_back(argv[++i]);
+        else if (strcmp(argv[i], "-w") == 0) {
+            vector<string> specs = Susy::utils::tokenizeString(argv[++i], ';');
+            for(size_t l=0; l<specs.size(); ++l) {
+                Susy::WriterOptions layout;
+                if(!layout.parse(specs[l])) {
+                    cout << "SusyNtBench    Invalid layout '" << specs[l] << "', exiting" << endl;
+                    return 1;
+                }
+                layouts.push_back(layout);
+            }
+        }
+        else if (strcmp(argv[i], "-v") == 0) verbose = true;
+        else if (strcmp(argv[i], "-h") == 0) { help(); return 0; }
+        else {
+            cout << "SusyNtBench    Unknown command line argument '" << argv[i] << "', exiting" << endl;
+            help();
+            return 1;
+        }
+    } // i
+
+    // metrics compared to the baseline, and the direction in which they improve
+    typedef Susy::BenchmarkReport::Tolerance Tolerance;
+    Susy::BenchmarkReport::Tolerances tolerances;
+    tolerances["events_per_s"] = Tolerance(0.10, true);
+    tolerances["peak_rss_mb"] = Tolerance(0.10, false);
+    tolerances["bytes_read_per_event"] = Tolerance(0.10, false);
+    tolerances["allocs_per_event"] = Tolerance(0.10, false);
+    tolerances["file_bytes_per_event"] = Tolerance(0.10, false);
+    tolerances["read_events_per_s"] = Tolerance(0.10, true);
+    for(size_t i=0; i<tolerance_args.size(); ++i) {
+        const string &arg = tolerance_args[i];
+        size_t eq = arg.find('=');
+        if(eq==string::npos) {
+            for(auto &t : tolerances) t.second.fraction = atof(arg.c_str());
+        } else if(tolerances.count(arg.substr(0, eq))) {
+            tolerances[arg.substr(0, eq)].fraction = atof(arg.substr(eq+1).c_str());
+        } else {
+            cout << "SusyNtBench    Unknown metric in '-T " << arg << "', exiting" << endl;
+            return 1;
+        }
+    }
+
+    // the fixed synthetic dataset, generated in a child to keep this process small
+    if(input.empty()) {
+        input = generated;
+        if(regenerate || gSystem->AccessPathName(generated.c_str())) {
+            cout << "SusyNtBench    generating " << n_generated << " events (seed " << seed << ") into " << generated << endl;
+            string unused;
+            JobResult job;
+            bool ok = runInChild([&](int) {
+                    Susy::SusyNtGenerator generator;
+                    return generator.setOutputFilename(generated).setNumberOfEvents(n_generated)
+                        .setSeed(seed).generate()==n_generated;
+                }, verbose, unused, job);
+            if(!ok) {
+                cout << "SusyNtBench    cannot generate " << generated << ", exiting" << endl;
+                return 1;
+            }
+        } else {
+            cout << "SusyNtBench    using the existing " << generated << " (--regenerate to rewrite it)" << endl;
+        }
+    }
+
+    Susy::BenchmarkReport report("SusyNtBench");
+    report.setLabel(label);
+    vector<string> names = Susy::utils::tokenizeString(analyses, ',');
+    if(layouts.empty()) {
+        for(size_t a=0; a<names.size(); ++a) {
+            const string &name = names[a];
+            JobResult best;
+            if(!bestOf(repetitions, [&](JobResult &r) { return benchmark(name, input, verbose, r); }, best)) {
+                cout << "SusyNtBench    " << name << " failed, exiting" << endl;
+                return 1;
+            }
+            addAnalysis(report, name, best);
+            cout << "SusyNtBench    " << name << " done" << endl;
+        }
+    }
+    for(size_t l=0; l<layouts.size(); ++l) {
+        // each layout is a copy of the dataset, removed once measured
+        const string layout = layouts[l].str();
+        const string file = "susyNt_bench_layout" + to_string(l) + ".root";
+        const string row = "layout " + layout;
+        JobResult written, read;
+        FileStat_t stat;
+        bool ok = (writeLayout(input, file, layouts[l], verbose, written) &&
+                   gSystem->GetPathInfo(file.c_str(), stat)==0 &&
+                   bestOf(repetitions, [&](JobResult &r) { return readAll(file, verbose, r); }, read));
+        if(ok) {
+            report.add(row, "file_mb", stat.fSize/1048576.0);
+            report.add(row, "file_bytes_per_event", double(stat.fSize)/written.events);
+            report.add(row, "write_events_per_s", written.events/written.seconds);
+            report.add(row, "read_events_per_s", read.events/read.seconds);
+            report.add(row, "read_mb_per_s", read.bytesRead/1048576.0/read.seconds);
+            report.add(row, "read_allocs_per_event", read.allocations/read.events);
+        }
+        for(size_t a=0; ok && a<names.size(); ++a) {
+            JobResult best;
+            ok = bestOf(repetitions, [&](JobResult &r) { return benchmark(names[a], file, verbose, r); }, best);
+            if(ok) addAnalysis(report, names[a] + " @ " + layout, best);
+        }
+        gSystem->Unlink(file.c_str());
+        if(!ok) {
+            cout << "SusyNtBench    layout '" << layout << "' failed, exiting" << endl;
+            return 1;
+        }
+        cout << "SusyNtBench    layout '" << layout << "' done" << endl;
+    }
+    cout << endl;
+    report.print(cout);
+    if(!output.empty() && report.writeJson(output))
+        cout << "SusyNtBench    results written to " << output << endl;
+
+    if(baseline_file.empty()) return 0;
+    Susy::BenchmarkReport baseline;
+    if(!baseline.readJson(baseline_file)) return 1;
+    vector<Susy::BenchmarkReport::Regression> regressions = report.compare(baseline, tolerances);
+    cout << endl;
+    cout << "SusyNtBench    comparison with " << baseline_file
+         << (baseline.label().empty() ? "" : " ("+baseline.label()+")") << endl;
+    for(size_t i=0; i<regressions.size(); ++i) {
+        const Susy::BenchmarkReport::Regression &r = regressions[i];
+        char change[32];
+        snprintf(change, sizeof(change), "%+.1f%%", 100.0*r.change);
+        cout << "SusyNtBench    REGRESSION " << r.name << " " << r.metric << ": "
+             << r.value << " vs " << r.baseline << " (" << change
+             << ", tolerance " << 100.0*tolerances[r.metric].fraction << "%)" << endl;
+    }
+    if(regressions.empty()) cout << "SusyNtBench    no regression" << endl;
+    return regressions.empty() ? 0 : 2;
+}
@@ -0,0 +1,77 @@
+//SusyNtuple
+#include "SusyNtuple/SusyNtGenerator.h"
+
+//std/stl
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+using namespace std;
+
+//////////////////////////////////////////////////////
+//
+// SusyNtGen
+//
+// Write a synthetic susyNt file (see
+// Susy::SusyNtGenerator), to run the examples and
+// the benchmarks without any external data
+//
+//////////////////////////////////////////////////////
+
+void help()
+{
+    cout << "----------------------------------------------------------" << endl;
+    cout << " SusyNtGen" << endl;
+    cout << endl;
+    cout << "  Options:" << endl;
+    cout << "   -o          output file (default: susyNt_synthetic.root)" << endl;
+    cout << "   -n          number of events (default: 10000)" << endl;
+    cout << "   -s          random seed (default: 4357)" << endl;
+    cout << "   -d          MC dataset id (default: 410009)" << endl;
+    cout << "   --data      write data events instead of MC" << endl;
+    cout << "   --ele       mean number of electrons per event (default: 1.2)" << endl;
+    cout << "   --muo       mean number of muons per event (default: 1.2)" << endl;
+    cout << "   --jet       mean number of jets per event (default: 4.0)" << endl;
+    cout << "   --tau       mean number of taus per event (default: 0.5)" << endl;
+    cout << "   --pho       mean number of photons per event (default: 0.3)" << endl;
+    cout << "   --no-sys    do not write the systematic variations" << endl;
+    cout << "   -v          verbose" << endl;
+    cout << "   -h          print this help message" << endl;
+    cout << endl;
+    cout << "  Example Usage:" << endl;
+    cout << "   SusyNtGen -o synthetic.root -n 100000 --jet 6" << endl;
+    cout << "----------------------------------------------------------" << endl;
+}
+
+int main(int argc, char** argv)
+{
+    Susy::SusyNtGenerator generator;
+    string output = "susyNt_synthetic.root";
+    bool verbose = false;
+
+    for(int i = 1; i < argc; i++) {
+        if      (strcmp(argv[i], "-o") == 0) output = argv[++i];
+        else if (strcmp(argv[i], "-n") == 0) generator.setNumberOfEvents(atoll(argv[++i]));
+        else if (strcmp(argv[i], "-s") == 0) generator.setSeed(atoi(argv[++i]));
+        else if (strcmp(argv[i], "-d") == 0) generator.setMcChannel(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--data") == 0) generator.setIsMC(false);
+        else if (strcmp(argv[i], "--ele") == 0) generator.setMeanElectrons(atof(argv[++i]));
+        else if (strcmp(argv[i], "--muo") == 0) generator.setMeanMuons(atof(argv[++i]));
+        else if (strcmp(argv[i], "--jet") == 0) generator.setMeanJets(atof(argv[++i]));
+        else if (strcmp(argv[i], "--tau") == 0) generator.setMeanTaus(atof(argv[++i]));
+        else if (strcmp(argv[i], "--pho") == 0) generator.setMeanPhotons(atof(argv[++i]));
+        else if (strcmp(argv[i], "--no-sys") == 0) generator.setSystematics(false);
+        else if (strcmp(argv[i], "-v") == 0) verbose = true;
+        else if (strcmp(argv[i], "-h") == 0) { help(); return 0; }
+        else {
+            cout << "SusyNtGen    Unknown command line argument '" << argv[i] << "', exiting" << endl;
+            help();
+            return 1;
+        }
+    } // i
+
+    Long64_t n_written = generator.setOutputFilename(output).setVerbose(verbose).generate();
+    if(n_written < 0) return 1;
+    cout << "SusyNtGen    " << n_written << " events written to " << output << endl;
+    return 0;
+}
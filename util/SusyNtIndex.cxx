@@ -0,0 +1,113 @@
+//SusyNtuple
+#include "SusyNtuple/ChainHelper.h"
+#include "SusyNtuple/RunEventIndex.h"
+#include "SusyNtuple/RunEventIndexBuilder.h"
+
+//std/stl
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+using namespace std;
+
+//ROOT
+#include "TChain.h"
+
+//////////////////////////////////////////////////////
+//
+// SusyNtIndex
+//
+// Build the run:event -> file:entry index of a susyNt
+// dataset (see Susy::RunEventIndex), and optionally
+// report the duplicate events within the dataset or
+// the events it has in common with another index.
+//
+//////////////////////////////////////////////////////
+
+void help()
+{
+    cout << "----------------------------------------------------------" << endl;
+    cout << " SusyNtIndex" << endl;
+    cout << endl;
+    cout << "  Options:" << endl;
+    cout << "   -i          input (ROOT file, *.txt file, directory, or existing index)" << endl;
+    cout << "   -o          output index file" << endl;
+    cout << "   -j          number of threads (default: one per core)" << endl;
+    cout << "   -c          other index: print the events that are in both" << endl;
+    cout << "   -d          print the duplicate events" << endl;
+    cout << "   -v          verbose" << endl;
+    cout << "   -h          print this help message" << endl;
+    cout << "----------------------------------------------------------" << endl;
+}
+
+void printPairs(const vector<Susy::RunEventIndex::RecordPair> &pairs,
+                const Susy::RunEventIndex &a, const Susy::RunEventIndex &b)
+{
+    for(size_t i=0; i<pairs.size(); ++i) {
+        const Susy::RunEventRecord &ra = pairs[i].first;
+        const Susy::RunEventRecord &rb = pairs[i].second;
+        cout << "  run " << ra.run << " event " << ra.event
+             << " : " << a.file(ra.file).name << " entry " << ra.entry
+             << " , " << b.file(rb.file).name << " entry " << rb.entry
+             << endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    string input = "";
+    string output = "";
+    string other = "";
+    unsigned int n_threads = 0;
+    bool print_duplicates = false;
+    bool verbose = false;
+
+    for(int i = 1; i < argc; i++) {
+        if      (strcmp(argv[i], "-i") == 0) input = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0) output = argv[++i];
+        else if (strcmp(argv[i], "-j") == 0) n_threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-c") == 0) other = argv[++i];
+        else if (strcmp(argv[i], "-d") == 0) print_duplicates = true;
+        else if (strcmp(argv[i], "-v") == 0) verbose = true;
+        else if (strcmp(argv[i], "-h") == 0) { help(); return 0; }
+        else {
+            cout << "SusyNtIndex    Unknown command line argument '" << argv[i] << "', exiting" << endl;
+            help();
+            return 1;
+        }
+    } // i
+
+    if(input.empty()) {
+        cout << "SusyNtIndex    You must specify an input" << endl;
+        return 1;
+    }
+
+    Susy::RunEventIndex index;
+    if(Susy::RunEventIndex::isIndexFile(input)) {
+        if(!index.read(input)) return 1;
+    } else {
+        TChain* chain = new TChain("susyNt");
+        ChainHelper::addInput(chain, input, verbose);
+        Susy::RunEventIndexBuilder builder(chain);
+        if(!builder.setThreads(n_threads).setVerbose(verbose).build(index))
+            cout << "SusyNtIndex    WARNING some files could not be read" << endl;
+        delete chain;
+    }
+    cout << "SusyNtIndex    " << index.size() << " events in " << index.nFiles() << " files" << endl;
+
+    if(!output.empty() && !index.write(output)) return 1;
+
+    vector<Susy::RunEventIndex::RecordPair> duplicates = index.duplicates();
+    cout << "SusyNtIndex    " << duplicates.size() << " duplicate events" << endl;
+    if(print_duplicates) printPairs(duplicates, index, index);
+
+    if(!other.empty()) {
+        Susy::RunEventIndex otherIndex;
+        if(!otherIndex.read(other)) return 1;
+        vector<Susy::RunEventIndex::RecordPair> common = Susy::RunEventIndex::commonEvents(index, otherIndex);
+        cout << "SusyNtIndex    " << common.size() << " events also in " << other << endl;
+        printPairs(common, index, otherIndex);
+    }
+    return 0;
+}
@@ -0,0 +1,409 @@
+//SusyNtuple
+#include "SusyNtuple/SusyNtGenerator.h"
+#include "SusyNtuple/SusyNtTools.h"
+#include "SusyNtuple/KinematicTools.h"
+#include "SusyNtuple/MCWeighter.h"
+#include "SusyNtuple/BenchmarkReport.h"
+#include "SusyNtuple/StageTimer.h"
+#include "SusyNtuple/AllocationCounter.h"
+#include "SusyNtuple/SystematicHistograms.h"
+#include "SusyNtuple/string_utils.h"
+
+//std/stl
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+//ROOT
+#include "TH1F.h"
+#include "TTree.h"
+#include "TVector3.h"
+
+SUSYNT_DEFINE_COUNTING_OPERATOR_NEW
+
+//////////////////////////////////////////////////////
+//
+// SusyNtMicroBench
+//
+// Time the hot functions of the event loop (object
+// selection, overlap removal for each AnalysisType,
+// kinematic variables, trigger access and MC
+// weight) on synthetic events generated in memory
+// (see Susy::SusyNtGenerator), as a function of the
+// object multiplicity. The results can be written
+// as JSON to track the throughput across releases.
+//
+//////////////////////////////////////////////////////
+
+void help()
+{
+    cout << "----------------------------------------------------------" << endl;
+    cout << " SusyNtMicroBench" << endl;
+    cout << endl;
+    cout << "  Options:" << endl;
+    cout << "   -m          comma-separated multiplicities (default: 1,2,4,8)" << endl;
+    cout << "               multiplicity m: mean of m electrons, m muons, 2m jets, m/2 taus, m/2 photons" << endl;
+    cout << "   -n          number of events generated per multiplicity (default: 2000)" << endl;
+    cout << "   -t          minimum time per benchmark, in seconds (default: 0.2)" << endl;
+    cout << "   -s          random seed (default: 4357)" << endl;
+    cout << "   -b          run only the benchmarks whose name contains this string" << endl;
+    cout << "   -o          write the results to this JSON file" << endl;
+    cout << "   -l          label stored in the JSON file (e.g. the release)" << endl;
+    cout << "   --no-weight skip MCWeighter (it needs the SUSYTools cross-section files)" << endl;
+    cout << "   -h          print this help message" << endl;
+    cout << endl;
+    cout << "  Example Usage:" << endl;
+    cout << "   SusyNtMicroBench -m 2,4 -b overlap -o micro.json -l SusyNtuple-00-07-00" << endl;
+    cout << "----------------------------------------------------------" << endl;
+}
+
+/// the objects of one synthetic event
+struct SampleEvent {
+    Susy::Event evt;
+    vector<Susy::Electron> ele;
+    vector<Susy::Muon> muo;
+    vector<Susy::Jet> jet;
+    vector<Susy::Tau> tau;
+    vector<Susy::Photon> pho;
+    vector<Susy::Met> met;
+};
+
+/// pointers to the objects of one event, at each selection step
+struct EventObjects {
+    ElectronVector preElectrons, baseElectrons, signalElectrons;
+    MuonVector preMuons, baseMuons, signalMuons;
+    JetVector preJets, baseJets, signalJets;
+    TauVector preTaus, baseTaus, signalTaus;
+    PhotonVector prePhotons, basePhotons, signalPhotons;
+    LeptonVector baseLeptons, signalLeptons;
+    Susy::Met* met;
+};
+
+/// prevent the compiler from dropping the computations being timed
+volatile double sink = 0;
+
+/// number of calls made for event i (0 if the event was skipped)
+typedef std::function<int (size_t)> BenchmarkFunction;
+
+struct Bench {
+    BenchmarkReport* report;
+    string filter;
+    double minSeconds;
+
+    /// run fn over all the events until minSeconds have passed; report the time per call
+    void run(const string &name, int multiplicity, size_t nEvents, BenchmarkFunction fn)
+    {
+        std::ostringstream fullName;
+        fullName << name << "/m=" << multiplicity;
+        if(!filter.empty() && fullName.str().find(filter)==string::npos) return;
+        for(size_t i=0; i<nEvents; ++i) fn(i); // warm-up
+        uint64_t calls = 0, bestPass = 0;
+        double bestNsPerCall = std::numeric_limits<double>::max();
+        Susy::AllocationCounter allocations;
+        const uint64_t start = Susy::StageTimer::now();
+        uint64_t elapsed = 0;
+        do {
+            const uint64_t passStart = Susy::StageTimer::now();
+            uint64_t passCalls = 0;
+            for(size_t i=0; i<nEvents; ++i) passCalls += fn(i);
+            const uint64_t passEnd = Susy::StageTimer::now();
+            calls += passCalls;
+            if(passCalls && double(passEnd-passStart)/passCalls<bestNsPerCall) {
+                bestNsPerCall = double(passEnd-passStart)/passCalls;
+                bestPass = passCalls;
+            }
+            elapsed = passEnd - start;
+        } while(elapsed < 1.0e9*minSeconds && calls>0);
+        const uint64_t nAllocations = allocations.allocations();
+        const double n = (calls ? calls : 1);
+        report->add(fullName.str(), "multiplicity", multiplicity);
+        report->add(fullName.str(), "calls", calls);
+        report->add(fullName.str(), "ns_per_call", elapsed/n);
+        report->add(fullName.str(), "best_ns_per_call", bestPass ? bestNsPerCall : 0.0);
+        report->add(fullName.str(), "calls_per_s", calls ? 1.0e9*calls/elapsed : 0.0);
+        report->add(fullName.str(), "allocs_per_call", nAllocations/n);
+    }
+};
+
+/// generate nEvents events with the given multiplicity; return the "trig" histogram
+TH1F* generateSample(vector<SampleEvent> &sample, size_t nEvents, int multiplicity, unsigned int seed)
+{
+    Susy::SusyNtGenerator generator;
+    generator.setSeed(seed).setNumberOfEvents(nEvents)
+        .setMeanElectrons(multiplicity).setMeanMuons(multiplicity).setMeanJets(2.0*multiplicity)
+        .setMeanTaus(0.5*multiplicity).setMeanPhotons(0.5*multiplicity);
+    sample.assign(nEvents, SampleEvent());
+    for(size_t i=0; i<nEvents; ++i) {
+        generator.generateEvent();
+        Susy::SusyNtObject &nt = generator.nt();
+        SampleEvent &s = sample[i];
+        s.evt = *nt.evt();
+        s.ele = *nt.ele();
+        s.muo = *nt.muo();
+        s.jet = *nt.jet();
+        s.tau = *nt.tau();
+        s.pho = *nt.pho();
+        s.met = *nt.met();
+    }
+    return generator.triggerHistogram();
+}
+
+/// pre, baseline (after overlap removal) and signal objects of each event, for the given analysis
+void selectObjects(vector<SampleEvent> &sample, vector<EventObjects> &objects, SusyNtTools &tools)
+{
+    objects.assign(sample.size(), EventObjects());
+    for(size_t i=0; i<sample.size(); ++i) {
+        SampleEvent &s = sample[i];
+        EventObjects &o = objects[i];
+        for(size_t j=0; j<s.ele.size(); ++j) o.preElectrons.push_back(&s.ele[j]);
+        for(size_t j=0; j<s.muo.size(); ++j) o.preMuons.push_back(&s.muo[j]);
+        for(size_t j=0; j<s.jet.size(); ++j) o.preJets.push_back(&s.jet[j]);
+        for(size_t j=0; j<s.tau.size(); ++j) o.preTaus.push_back(&s.tau[j]);
+        for(size_t j=0; j<s.pho.size(); ++j) o.prePhotons.push_back(&s.pho[j]);
+        tools.getBaselineObjects(o.preElectrons, o.preMuons, o.preJets, o.preTaus, o.prePhotons,
+                                 o.baseElectrons, o.baseMuons, o.baseJets, o.baseTaus, o.basePhotons);
+        tools.overlapTool().performOverlap(o.baseElectrons, o.baseMuons, o.baseJets, o.baseTaus, o.basePhotons);
+        tools.getSignalObjects(o.baseElectrons, o.baseMuons, o.baseJets, o.baseTaus, o.basePhotons,
+                               o.signalElectrons, o.signalMuons, o.signalJets, o.signalTaus, o.signalPhotons);
+        tools.buildLeptons(o.baseLeptons, o.baseElectrons, o.baseMuons);
+        tools.buildLeptons(o.signalLeptons, o.signalElectrons, o.signalMuons);
+        o.met = (s.met.empty() ? 0 : &s.met[0]);
+    }
+}
+
+/// dilepton trigger of the flavour of the two leading leptons (electron first)
+string dileptonTrigger(const Susy::Lepton* l0, const Susy::Lepton* l1)
+{
+    if(l0->isEle() && l1->isEle()) return TriggerTools::di_ele_triggers().at(0);
+    if(l0->isMu() && l1->isMu()) return TriggerTools::di_muo_triggers().at(0);
+    return TriggerTools::ele_muo_triggers().at(0);
+}
+
+int main(int argc, char** argv)
+{
+    vector<int> multiplicities = {1, 2, 4, 8};
+    size_t n_events = 2000;
+    unsigned int seed = 4357;
+    string output = "";
+    string label = "";
+    bool do_weight = true;
+    BenchmarkReport report("SusyNtMicroBench");
+    Bench bench = {&report, "", 0.2};
+
+    for(int i = 1; i < argc; i++) {
+        if      (strcmp(argv[i], "-m") == 0) {
+            multiplicities.clear();
+            for(const string &m : Susy::utils::tokenizeString(argv[++i], ',')) multiplicities.push_back(atoi(m.c_str()));
+        }
+        else if (strcmp(argv[i], "-n") == 0) n_events = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-t") == 0) bench.minSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0) seed = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-b") == 0) bench.filter = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0) output = argv[++i];
+        else if (strcmp(argv[i], "-l") == 0) label = argv[++i];
+        else if (strcmp(argv[i], "--no-weight") == 0) do_weight = false;
+        else if (strcmp(argv[i], "-h") == 0) { help(); return 0; }
+        else {
+            cout << "SusyNtMicroBench    Unknown command line argument '" << argv[i] << "', exiting" << endl;
+            help();
+            return 1;
+        }
+    } // i
+    report.setLabel(label);
+
+    const vector<AnalysisType> analyses = {AnalysisType::Ana_2Lep, AnalysisType::Ana_3Lep, AnalysisType::Ana_4Lep,
+                                           AnalysisType::Ana_2LepWH, AnalysisType::Ana_SS3L,
+                                           AnalysisType::Ana_Stop2L, AnalysisType::Ana_WWBB};
+    const vector<string> triggers = TriggerTools::getTrigNames();
+
+    for(int m : multiplicities) {
+        vector<SampleEvent> sample;
+        TH1F* trig = generateSample(sample, n_events, m, seed);
+        const size_t n = sample.size();
+
+        // selection, with the 2L analysis settings
+        SusyNtTools tools;
+        tools.setAnaType(AnalysisType::Ana_2Lep);
+        tools.triggerTool().buildTriggerMap(trig);
+        vector<EventObjects> objects;
+        selectObjects(sample, objects, tools);
+        EventObjects scratch;
+
+        bench.run("baseline", m, n, [&](size_t i) {
+                const EventObjects &o = objects[i];
+                tools.getBaselineObjects(o.preElectrons, o.preMuons, o.preJets, o.preTaus, o.prePhotons,
+                                         scratch.baseElectrons, scratch.baseMuons, scratch.baseJets,
+                                         scratch.baseTaus, scratch.basePhotons);
+                sink = sink + scratch.baseJets.size();
+                return 1;
+            });
+        bench.run("signal", m, n, [&](size_t i) {
+                const EventObjects &o = objects[i];
+                tools.getSignalObjects(o.baseElectrons, o.baseMuons, o.baseJets, o.baseTaus, o.basePhotons,
+                                       scratch.signalElectrons, scratch.signalMuons, scratch.signalJets,
+                                       scratch.signalTaus, scratch.signalPhotons);
+                sink = sink + scratch.signalJets.size();
+                return 1;
+            });
+
+        // overlap removal of each analysis, on its own baseline objects (the input copy is included)
+        for(AnalysisType a : analyses) {
+            SusyNtTools anaTools;
+            anaTools.setAnaType(a);
+            vector<EventObjects> anaObjects(n);
+            for(size_t i=0; i<n; ++i) {
+                const EventObjects &o = objects[i];
+                EventObjects &b = anaObjects[i];
+                anaTools.getBaselineObjects(o.preElectrons, o.preMuons, o.preJets, o.preTaus, o.prePhotons,
+                                            b.baseElectrons, b.baseMuons, b.baseJets, b.baseTaus, b.basePhotons);
+            }
+            OverlapTools &overlap = anaTools.overlapTool();
+            bench.run("overlap/" + AnalysisType2str(a), m, n, [&](size_t i) {
+                    const EventObjects &b = anaObjects[i];
+                    scratch.baseElectrons = b.baseElectrons;
+                    scratch.baseMuons = b.baseMuons;
+                    scratch.baseJets = b.baseJets;
+                    scratch.baseTaus = b.baseTaus;
+                    scratch.basePhotons = b.basePhotons;
+                    overlap.performOverlap(scratch.baseElectrons, scratch.baseMuons, scratch.baseJets,
+                                           scratch.baseTaus, scratch.basePhotons);
+                    sink = sink + scratch.baseJets.size();
+                    return 1;
+                });
+        }
+
+        // kinematics, on the baseline leptons
+        bench.run("kin/Mll", m, n, [&](size_t i) {
+                const LeptonVector &l = objects[i].baseLeptons;
+                if(l.size()<2) return 0;
+                sink = sink + kin::Mll(l[0], l[1]);
+                return 1;
+            });
+        bench.run("kin/hasZ", m, n, [&](size_t i) {
+                sink = sink + kin::hasZ(objects[i].baseLeptons);
+                return 1;
+            });
+        bench.run("kin/findBestZ", m, n, [&](size_t i) {
+                uint l0 = 0, l1 = 0;
+                sink = sink + kin::findBestZ(l0, l1, objects[i].baseLeptons);
+                return 1;
+            });
+        bench.run("kin/getMetRel", m, n, [&](size_t i) {
+                const EventObjects &o = objects[i];
+                if(!o.met) return 0;
+                sink = sink + kin::getMetRel(o.met, o.baseLeptons, o.signalJets);
+                return 1;
+            });
+        bench.run("kin/superRazor", m, n, [&](size_t i) {
+                const EventObjects &o = objects[i];
+                if(!o.met || o.baseLeptons.size()<2) return 0;
+                TVector3 vBETA_z, pT_CM, vBETA_T_CMtoR, vBETA_R;
+                double SHATR, dphi_LL_vBETA_T, dphi_L1_L2, gamma_R, dphi_vBETA_R_vBETA_T, MDELTAR, costhetaRp1;
+                kin::superRazor(o.baseLeptons, o.met, vBETA_z, pT_CM, vBETA_T_CMtoR, vBETA_R,
+                                SHATR, dphi_LL_vBETA_T, dphi_L1_L2, gamma_R, dphi_vBETA_R_vBETA_T, MDELTAR, costhetaRp1);
+                sink = sink + MDELTAR;
+                return 1;
+            });
+        bench.run("kin/getMT2", m, n, [&](size_t i) {
+                const EventObjects &o = objects[i];
+                if(!o.met || o.baseLeptons.size()<2) return 0;
+                sink = sink + kin::getMT2(o.baseLeptons, o.met);
+                return 1;
+            });
+
+        // trigger access: every trigger of the event, and the dilepton matching of the two leading leptons
+        TriggerTools &triggerTool = tools.triggerTool();
+        bench.run("trigger/passTrigger", m, n, [&](size_t i) {
+                const Susy::TriggerBits &bits = sample[i].evt.trigBits;
+                int fired = 0;
+                for(size_t t=0; t<triggers.size(); ++t) fired += triggerTool.passTrigger(bits, triggers[t]);
+                sink = sink + fired;
+                return int(triggers.size());
+            });
+        // "any single-lepton trigger": string lookups vs a compiled mask
+        vector<string> singleLepton = TriggerTools::single_muo_triggers();
+        const vector<string> singleEle = TriggerTools::single_ele_triggers();
+        singleLepton.insert(singleLepton.end(), singleEle.begin(), singleEle.end());
+        const TriggerMask singleLeptonMask = triggerTool.compile(singleLepton);
+        bench.run("trigger/anyOf_strings", m, n, [&](size_t i) {
+                const Susy::TriggerBits &bits = sample[i].evt.trigBits;
+                bool fired = false;
+                for(size_t t=0; t<singleLepton.size() && !fired; ++t) fired = triggerTool.passTrigger(bits, singleLepton[t]);
+                sink = sink + fired;
+                return 1;
+            });
+        bench.run("trigger/anyOf_mask", m, n, [&](size_t i) {
+                sink = sink + singleLeptonMask.pass(sample[i].evt.trigBits);
+                return 1;
+            });
+        bench.run("trigger/dilepton_trigger_match", m, n, [&](size_t i) {
+                const LeptonVector &l = objects[i].baseLeptons;
+                if(l.size()<2) return 0;
+                Susy::Lepton *l0 = l[0], *l1 = l[1];
+                if(l1->isEle() && !l0->isEle()) std::swap(l0, l1); // electron first
+                sink = sink + triggerTool.dilepton_trigger_match(&sample[i].evt, l0, l1, dileptonTrigger(l0, l1));
+                return 1;
+            });
+
+        // one observable for 100 weight variations: one TH1F each, or one multi-weight fill
+        {
+            const size_t n_variations = 100;
+            vector<string> variations;
+            vector<TH1F*> per_variation;
+            for(size_t v = 0; v < n_variations; v++) {
+                variations.push_back("var" + to_string(v));
+                per_variation.push_back(new TH1F(("h_met_" + variations.back()).c_str(), "", 50, 0.0, 500.0));
+                per_variation.back()->SetDirectory(0);
+            }
+            Susy::SystematicHistograms multi(variations);
+            const size_t h_met = multi.book("h_met", "", 50, 0.0, 500.0);
+            Susy::SystematicHistograms::FillBuffer buffer(multi);
+            vector<double> weights(n_variations);
+            for(size_t v = 0; v < n_variations; v++) weights[v] = 1.0 + 0.01*v;
+            auto met_of = [&](size_t i) { return sample[i].met.empty() ? 0.0 : sample[i].met[0].Et; };
+            bench.run("hist/perSys_TH1F", m, n, [&](size_t i) {
+                    const double met = met_of(i);
+                    for(size_t v = 0; v < n_variations; v++) per_variation[v]->Fill(met, weights[v]);
+                    return 1;
+                });
+            bench.run("hist/perSys_buffer", m, n, [&](size_t i) {
+                    buffer.setWeights(weights);
+                    buffer.fill(h_met, met_of(i));
+                    return 1;
+                });
+            buffer.flush();
+            sink = sink + multi.content(h_met, 1, 0);
+            for(auto h : per_variation) delete h;
+        }
+
+        // MC weight, with the sumw of an in-memory tree
+        if(do_weight) {
+            TTree tree("susyNt", "susyNt");
+            tree.SetDirectory(0);
+            Susy::SusyNtObject writer;
+            writer.evt.SetActive(true);
+            writer.WriteTo(&tree);
+            *writer.evt() = sample[0].evt;
+            tree.Fill();
+            MCWeighter weighter(&tree);
+            bench.run("weight/getMCWeight", m, n, [&](size_t i) {
+                    sink = sink + weighter.getMCWeight(&sample[i].evt, 1000.0, Susy::NtSys::NOM);
+                    return 1;
+                });
+        }
+        delete trig;
+    }
+
+    report.print(cout);
+    if(!output.empty()) {
+        if(!report.writeJson(output)) return 1;
+        cout << "SusyNtMicroBench    results written to " << output << endl;
+    }
+    return 0;
+}
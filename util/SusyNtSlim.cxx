@@ -0,0 +1,155 @@
+//SusyNtuple
+#include "SusyNtuple/SusyNtSlimmer.h"
+#include "SusyNtuple/ChainHelper.h"
+#include "SusyNtuple/string_utils.h"
+#include "SusyNtuple/SusyNtSys.h"
+#include "SusyNtuple/WriterOptions.h"
+
+//std/stl
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+using namespace std;
+
+//ROOT
+#include "TChain.h"
+
+//////////////////////////////////////////////////////
+//
+// SusyNtSlim
+//
+// Write a reduced susyNt file, keeping only some
+// of the branches, only the events with enough
+// leptons and only some of the systematic variations
+//
+//////////////////////////////////////////////////////
+
+
+void help()
+{
+    cout << "----------------------------------------------------------" << endl;
+    cout << " SusyNtSlim" << endl;
+    cout << endl;
+    cout << "  Options:" << endl;
+    cout << "   -i          input file (ROOT file, *.txt file, or directory)" << endl;
+    cout << "   -o          output file (default: susyNt_slim.root)" << endl;
+    cout << "   -n          number of events to process (default: all)" << endl;
+    cout << "   -k          comma-separated list of branches to keep (default: all)" << endl;
+    cout << "   -x          comma-separated list of branches to drop (default: none)" << endl;
+    cout << "   --no-truth  drop the truth branches" << endl;
+    cout << "   -l          minimum number of electrons+muons stored in the event (default: 0)" << endl;
+    cout << "   -s          comma-separated list of systematics to keep, e.g. 'JER,EL_EFF_ID_TOTAL_Uncorr_UP'" << endl;
+    cout << "               (default: all; NOM is always kept)" << endl;
+    cout << "   -a          write on a background thread, with this many events in flight (default: 0, synchronous)" << endl;
+    cout << "   -j          with -a, number of ROOT threads compressing the baskets (default: 0)" << endl;
+    cout << "   -c          output layout, e.g. 'zstd:5,basket=64000,flush=-30000000,split=99'" << endl;
+    cout << "               (default: as written by SusyNtObject; see Susy::WriterOptions)" << endl;
+    cout << "   -v          verbose" << endl;
+    cout << "   -h          print this help message" << endl;
+    cout << endl;
+    cout << "  Example Usage:" << endl;
+    cout << "   SusyNtSlim -i susyNt.root -o slim.root --no-truth -l 2" << endl;
+    cout << "   SusyNtSlim -i susyNt.root -o slim.root -s NOM" << endl;
+    cout << "   SusyNtSlim -i susyNt.root -o slim.root --no-truth -a 64 -j 4" << endl;
+    cout << "   SusyNtSlim -i susyNt.root -o slim.root -c lz4:4,split=99" << endl;
+    cout << "----------------------------------------------------------" << endl;
+}
+
+int main(int argc, char** argv)
+{
+
+    /////////////////////////
+    // cmd line options
+    /////////////////////////
+
+    Long64_t n_events = -1;
+    int min_leptons = 0;
+    bool verbose = false;
+    string input = "";
+    string output = "susyNt_slim.root";
+    vector<string> keep;
+    vector<string> drop;
+    bool strip_sys = false;
+    vector<Susy::NtSys::SusyNtSys> systematics;
+    size_t async_queue = 0;
+    unsigned int imt_threads = 0;
+    Susy::WriterOptions writer_options;
+
+    for(int i = 1; i < argc; i++) {
+        if      (strcmp(argv[i], "-n") == 0) n_events = atoll(argv[++i]);
+        else if (strcmp(argv[i], "-i") == 0) input = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0) output = argv[++i];
+        else if (strcmp(argv[i], "-k") == 0) keep = Susy::utils::tokenizeString(argv[++i], ',');
+        else if (strcmp(argv[i], "-x") == 0) {
+            vector<string> tokens = Susy::utils::tokenizeString(argv[++i], ',');
+            drop.insert(drop.end(), tokens.begin(), tokens.end());
+        }
+        else if (strcmp(argv[i], "--no-truth") == 0) {
+            drop.push_back("truthParticles");
+            drop.push_back("truthJets");
+            drop.push_back("truthMet");
+        }
+        else if (strcmp(argv[i], "-l") == 0) min_leptons = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0) {
+            strip_sys = true;
+            vector<string> names = Susy::utils::tokenizeString(argv[++i], ',');
+            for(const string &name : names) {
+                bool found = false;
+                for(const auto &sys : Susy::NtSys::SusyNtSysNames) {
+                    if(sys.second == name) { systematics.push_back(sys.first); found = true; break; }
+                }
+                if(!found) {
+                    cout << "SusyNtSlim    Unknown systematic '" << name << "', exiting" << endl;
+                    return 1;
+                }
+            }
+        }
+        else if (strcmp(argv[i], "-a") == 0) async_queue = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-j") == 0) imt_threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-c") == 0) {
+            if(!writer_options.parse(argv[++i])) {
+                cout << "SusyNtSlim    Invalid output layout '" << argv[i] << "', exiting" << endl;
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-v") == 0) verbose = true;
+        else if (strcmp(argv[i], "-h") == 0) { help(); return 0; }
+        else {
+            cout << "SusyNtSlim    Unknown command line argument '" << argv[i] << "', exiting" << endl;
+            help();
+            return 1;
+        }
+    } // i
+
+    if(input.empty()) {
+        cout << "SusyNtSlim    You must specify an input" << endl;
+        return 1;
+    }
+
+    TChain* chain = new TChain("susyNt");
+    ChainHelper::addInput(chain, input, verbose);
+
+    Susy::SusyNtSlimmer slimmer;
+    slimmer.setOutputFilename(output)
+           .setBranchesToKeep(keep)
+           .setBranchesToDrop(drop)
+           .setAsyncWrite(async_queue, imt_threads)
+           .setWriterOptions(writer_options)
+           .setVerbose(verbose);
+    if(strip_sys) slimmer.setSystematicsToKeep(systematics);
+    if(min_leptons > 0) {
+        // only the electron and muon branches are read to decide whether to keep the event
+        slimmer.setEventFilter([min_leptons](Susy::SusyNtObject &nt) {
+                return int(nt.ele()->size() + nt.muo()->size()) >= min_leptons;
+            });
+    }
+
+    Long64_t n_written = slimmer.process(chain, n_events);
+
+    cout << "SusyNtSlim    Wrote " << n_written << " out of " << slimmer.nRead()
+         << " events to " << output << endl;
+
+    delete chain;
+    return (n_written < 0 ? 1 : 0);
+}
@@ -7,6 +7,9 @@
 #include "SusyNtuple/SusyNtAna.h"
 #include "SusyNtuple/SusyDefs.h"
 #include "SusyNtuple/ChainHelper.h"
+#include "SusyNtuple/EntryRangeDriver.h"
+#include "SusyNtuple/PickEventList.h"
+#include "SusyNtuple/RunEventIndex.h"
 #include "SusyNtuple/string_utils.h"
 
 using namespace std;
@@ -23,7 +26,7 @@ void help()
   cout << "  -n number of events to process"    << endl;
   cout << "     defaults: -1 (all events)"      << endl;
 
-  cout << "  -k number of events to skip"       << endl;
+  cout << "  -k number of events to skip (with -p, the picked events before this entry)" << endl;
   cout << "     defaults: 0"                    << endl;
 
   cout << "  -d debug printout level"           << endl;
@@ -35,6 +38,12 @@ void help()
   cout << "  -s sample name, for naming files"  << endl;
   cout << "     defaults: ntuple sample name"   << endl;
 
+  cout << "  -p file with run:event pairs to pick"<< endl;
+  cout << "     defaults: '' (all events)"      << endl;
+
+  cout << "  -x run:event index of the input (from SusyNtIndex), used with -p" << endl;
+  cout << "     defaults: '' (scan the event branch)" << endl;
+
   cout << "  -h print this help"                << endl;
 }
 
@@ -47,6 +56,8 @@ int main(int argc, char** argv)
   int dbg = 0;
   string sample;
   string input;
+  string pickFile;
+  string indexFile;
   
   cout << "SusyNtTest" << endl;
   cout << endl;
@@ -58,6 +69,8 @@ int main(int argc, char** argv)
     else if (strcmp(argv[i], "-d") == 0) dbg = atoi(argv[++i]);
     else if (strcmp(argv[i], "-i") == 0) input = argv[++i];
     else if (strcmp(argv[i], "-s") == 0) sample = argv[++i];
+    else if (strcmp(argv[i], "-p") == 0) pickFile = argv[++i];
+    else if (strcmp(argv[i], "-x") == 0) indexFile = argv[++i];
     else {
         cout<<"unknown opt '"<<argv[i]<<"'"<<endl;
         help();
@@ -73,6 +86,8 @@ int main(int argc, char** argv)
   cout << "  nSkip   " << nSkip    << endl;
   cout << "  dbg     " << dbg      << endl;
   cout << "  input   " << input    << endl;
+  if(!pickFile.empty())
+  cout << "  pick    " << pickFile << endl;
   cout << endl;
 
   // Build the input chain
@@ -90,7 +105,22 @@ int main(int argc, char** argv)
   cout << endl;
   cout << "Total entries:   " << nEntries << endl;
   cout << "Process entries: " << nEvt << endl;
-  chain->Process(susyAna, sample.c_str(), nEvt, nSkip);
+  if(pickFile.empty()) {
+    chain->Process(susyAna, sample.c_str(), nEvt, nSkip);
+  } else {
+    // find the picked events reading only the event branch, then process only those entries
+    Susy::PickEventList pick;
+    pick.setVerbose(dbg>0);
+    if(!pick.read(pickFile)) return 1;
+    Susy::EventlistCache entries;
+    Susy::RunEventIndex index;
+    if(!indexFile.empty() && index.read(indexFile))
+      index.select(pick, entries);
+    else
+      Susy::EntryRangeDriver::selectEvents(chain, pick, entries, dbg>0);
+    Susy::EntryRangeDriver driver(chain, entries);
+    driver.setVerbose(dbg>0).process(susyAna, sample.c_str(), nEvt, nSkip);
+  }
 
   cout << endl;
   cout << "SusyNtTest job done" << endl;
@@ -0,0 +1,77 @@
+#include "SusyNtuple/AsyncWriter.h"
+#include "SusyNtuple/test_utils.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using Susy::AsyncWriter;
+
+/**
+   Test AsyncWriter: entries written through the slots by a slow
+   writer thread must arrive complete and in order, with the event
+   loop waiting when all the slots are in use; without start() the
+   tasks run synchronously.
+ */
+
+//----------------------------------------------------------
+/// write nEntries through writer, each one a vector of size i%7 filled with i; return the output
+vector<vector<int> > writeEntries(AsyncWriter &writer, int nEntries, bool slow)
+{
+    vector<vector<int> > slots(writer.capacity());
+    vector<vector<int> > output;
+    for(int i=0; i<nEntries; ++i) {
+        const size_t slot = writer.acquire();
+        slots[slot].assign(i%7, i);
+        writer.submit(slot, [&output, &slots, slot, slow]() {
+                if(slow) std::this_thread::sleep_for(std::chrono::microseconds(50));
+                output.push_back(vector<int>());
+                output.back().swap(slots[slot]);
+            });
+    }
+    writer.finish();
+    return output;
+}
+//----------------------------------------------------------
+bool sameEntries(const vector<vector<int> > &output, int nEntries)
+{
+    bool same = static_cast<int>(output.size())==nEntries;
+    for(int i=0; same && i<nEntries; ++i) same = output[i]==vector<int>(i%7, i);
+    return same;
+}
+//----------------------------------------------------------
+int main(int argc, char **argv)
+{
+    Susy::utils::TestReport test("test_AsyncWriter");
+    const int nEntries = 2000;
+
+    AsyncWriter async(4);
+    SUSYNT_CHECK(test, async.start());
+    SUSYNT_CHECK(test, async.running());
+    SUSYNT_CHECK(test, sameEntries(writeEntries(async, nEntries, true), nEntries));
+    SUSYNT_CHECK(test, !async.running());
+    SUSYNT_CHECK_EQUAL(test, async.nTasks(), static_cast<uint64_t>(nEntries));
+    // the writer is slower than the loop
+    SUSYNT_CHECK(test, async.nStalls()>0);
+    SUSYNT_CHECK(test, async.stallNs()>0);
+
+    AsyncWriter sync(4);
+    SUSYNT_CHECK(test, sameEntries(writeEntries(sync, nEntries, false), nEntries));
+    SUSYNT_CHECK_EQUAL(test, sync.nTasks(), static_cast<uint64_t>(nEntries));
+    SUSYNT_CHECK_EQUAL(test, sync.nStalls(), 0u);
+
+    // finish() is also called by the destructor
+    int nPushed = 0;
+    {
+        AsyncWriter writer(2);
+        writer.start();
+        for(int i=0; i<100; ++i) writer.push([&nPushed]() { nPushed++; });
+    }
+    SUSYNT_CHECK_EQUAL(test, nPushed, 100);
+    if(argc>1) async.print(cout);
+
+    return test.finish();
+}
+//----------------------------------------------------------
@@ -0,0 +1,69 @@
+#include "SusyNtuple/BenchmarkReport.h"
+#include "SusyNtuple/test_utils.h"
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+using namespace std;
+using Susy::BenchmarkReport;
+using Susy::utils::TestReport;
+
+/**
+   Test BenchmarkReport: write a report as JSON, read it back, and
+   compare it to a baseline with per-metric tolerances.
+ */
+
+//----------------------------------------------------------
+int main(int argc, char **argv)
+{
+    TestReport test("test_BenchmarkReport");
+    BenchmarkReport baseline("SusyNtBench");
+    baseline.setLabel("with \"quotes\"");
+    baseline.add("Susy2LepCF", "events_per_s", 20000);
+    baseline.add("Susy2LepCF", "peak_rss_mb", 300);
+    baseline.add("Susy2LepCF", "allocs_per_event", 12.5);
+    baseline.add("Susy3LepCF", "events_per_s", 15000);
+    baseline.add("Susy3LepCF", "bytes_per_event", numeric_limits<double>::infinity());
+
+    stringstream json;
+    baseline.writeJson(json);
+    BenchmarkReport read;
+    SUSYNT_CHECK(test, read.readJson(json));
+    SUSYNT_CHECK_EQUAL(test, read.suite(), "SusyNtBench");
+    SUSYNT_CHECK_EQUAL(test, read.label(), baseline.label());
+    SUSYNT_CHECK_EQUAL(test, read.size(), 2u);
+    if(SUSYNT_CHECK(test, read.find("Susy2LepCF")!=0) && SUSYNT_CHECK(test, read.find("Susy3LepCF")!=0)) {
+        SUSYNT_CHECK_EQUAL(test, read.find("Susy2LepCF")->metrics.size(), 3u);
+        SUSYNT_CHECK_EQUAL(test, *read.find("Susy2LepCF")->value("allocs_per_event"), 12.5);
+        SUSYNT_CHECK(test, std::isnan(*read.find("Susy3LepCF")->value("bytes_per_event")));
+        SUSYNT_CHECK(test, read.find("Susy2LepCF")->value("bytes_per_event")==0);
+    }
+    stringstream broken("{\"suite\": \"x\", \"results\": [{\"name\": \"a\", \"m\": }]}");
+    SUSYNT_CHECK(test, !read.readJson(broken));
+    SUSYNT_CHECK_EQUAL(test, read.size(), 2u);
+
+    BenchmarkReport current("SusyNtBench");
+    current.add("Susy2LepCF", "events_per_s", 17000);     // 15% slower
+    current.add("Susy2LepCF", "peak_rss_mb", 320);        // 6.7% more memory
+    current.add("Susy2LepCF", "allocs_per_event", 10.0);  // better
+    current.add("Susy3LepCF", "events_per_s", 16000);     // better
+    current.add("SusyLepTrig", "events_per_s", 1);        // not in the baseline
+    BenchmarkReport::Tolerances tolerances;
+    tolerances["events_per_s"] = BenchmarkReport::Tolerance(0.10, true);
+    tolerances["peak_rss_mb"] = BenchmarkReport::Tolerance(0.05, false);
+    tolerances["allocs_per_event"] = BenchmarkReport::Tolerance(0.0, false);
+    vector<BenchmarkReport::Regression> regressions = current.compare(read, tolerances);
+    if(SUSYNT_CHECK_EQUAL(test, regressions.size(), 2u)) {
+        SUSYNT_CHECK_EQUAL(test, regressions[0].metric, "events_per_s");
+        SUSYNT_CHECK_EQUAL(test, regressions[1].metric, "peak_rss_mb");
+        SUSYNT_CHECK(test, fabs(regressions[0].change+0.15)<1e-9);
+    }
+    tolerances["events_per_s"].fraction = 0.2;
+    tolerances["peak_rss_mb"].fraction = 0.1;
+    SUSYNT_CHECK(test, current.compare(read, tolerances).empty());
+
+    return test.finish();
+}
+//----------------------------------------------------------
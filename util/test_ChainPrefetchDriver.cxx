@@ -0,0 +1,152 @@
+#include "SusyNtuple/ChainPrefetchDriver.h"
+#include "SusyNtuple/SusyNtGenerator.h"
+#include "SusyNtuple/SusyNtObject.h"
+#include "SusyNtuple/test_utils.h"
+
+#include "TChain.h"
+#include "TFile.h"
+#include "TH1F.h"
+#include "TObject.h"
+#include "TSelector.h"
+
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using Susy::ChainPrefetchDriver;
+using Susy::SusyNtGenerator;
+using Susy::utils::TestReport;
+
+/**
+   Test ChainPrefetchDriver: on a chain of synthetic files (one of them
+   empty, one with different "trig" labels), the same selector run
+   through TChain::Process and through the driver, with and without the
+   background warm-up, sees the same events from the same files, with
+   the same Notify calls per file; also when the loop stops in the
+   middle of a file. The files with different trigger labels are
+   counted.
+ */
+
+const string treename = "susyNt";
+const string dirname = "/tmp/";
+/// events in each file
+const Long64_t fileEntries[] = {300, 0, 200, 150};
+const size_t nFiles = sizeof(fileEntries)/sizeof(Long64_t);
+const size_t emptyFile = 1;
+/// the file whose "trig" histogram has a renamed trigger
+const size_t relabeledFile = 3;
+
+//----------------------------------------------------------
+/// records the events and the Notify calls, per file
+class RecordingSelector : public TSelector
+{
+public:
+    RecordingSelector() : m_tree(0), m_entry(0), m_nt(m_entry), m_nBegin(0), m_nTerminate(0) {}
+    Int_t Version() const override { return 2; }
+    void Begin(TTree*) override { m_nBegin++; }
+    void Init(TTree* tree) override { m_tree = tree; m_nt.ReadFrom(tree); }
+    Bool_t Notify() override { m_notify[currentFile()]++; return kTRUE; }
+    Bool_t Process(Long64_t entry) override
+    {
+        m_entry = entry;
+        m_events.push_back(make_pair(currentFile(), m_nt.evt()->eventNumber));
+        m_entries[currentFile()]++;
+        return kTRUE;
+    }
+    void Terminate() override { m_nTerminate++; }
+    string currentFile() const
+    {
+        TFile* file = (m_tree ? m_tree->GetCurrentFile() : 0);
+        return file ? file->GetName() : "";
+    }
+    bool sameAs(const RecordingSelector &other) const
+    {
+        return (m_events==other.m_events && m_entries==other.m_entries && m_notify==other.m_notify &&
+                m_nBegin==other.m_nBegin && m_nTerminate==other.m_nTerminate);
+    }
+    TTree* m_tree;
+    Long64_t m_entry;
+    Susy::SusyNtObject m_nt;
+    vector<pair<string, unsigned int> > m_events;
+    map<string, Long64_t> m_entries;
+    map<string, int> m_notify;
+    int m_nBegin;
+    int m_nTerminate;
+};
+//----------------------------------------------------------
+string filename(size_t i)
+{
+    return dirname + "dummy_prefetch_" + to_string(i) + ".root";
+}
+//----------------------------------------------------------
+bool writeFiles(TestReport &test)
+{
+    for(size_t i=0; i<nFiles; ++i) {
+        SusyNtGenerator generator;
+        generator.setOutputFilename(filename(i)).setNumberOfEvents(fileEntries[i]).setSeed(1234+i);
+        SUSYNT_CHECK_EQUAL(test, generator.generate(), fileEntries[i]);
+    }
+    TFile file(filename(relabeledFile).c_str(), "update");
+    TH1F* trig = dynamic_cast<TH1F*>(file.Get("trig"));
+    if(SUSYNT_CHECK(test, trig!=0)) {
+        trig->GetXaxis()->SetBinLabel(1, "HLT_renamed_trigger");
+        trig->Write(0, TObject::kOverwrite);
+    }
+    file.Close();
+    return test.success();
+}
+//----------------------------------------------------------
+TChain* makeChain()
+{
+    TChain* chain = new TChain(treename.c_str());
+    for(size_t i=0; i<nFiles; ++i) chain->Add(filename(i).c_str());
+    chain->GetEntries(); // as the executables do before the loop
+    return chain;
+}
+//----------------------------------------------------------
+/// process the first nEntries with TChain::Process and with the driver (with and without warm-up)
+void sameLoop(TestReport &test, Long64_t nEntries, int expectedMismatches)
+{
+    RecordingSelector reference;
+    TChain* chain = makeChain();
+    const Long64_t nReference = chain->Process(&reference, "", nEntries<0 ? chain->GetEntries() : nEntries);
+    delete chain;
+    Long64_t expected = 0;
+    for(size_t i=0; i<nFiles; ++i) expected += fileEntries[i];
+    if(nEntries>=0 && nEntries<expected) expected = nEntries;
+    SUSYNT_CHECK_EQUAL(test, nReference, expected);
+    SUSYNT_CHECK_EQUAL(test, static_cast<Long64_t>(reference.m_events.size()), expected);
+    SUSYNT_CHECK(test, !reference.m_entries.count(filename(emptyFile)));
+    SUSYNT_CHECK(test, !reference.m_notify.count(filename(emptyFile)));
+    for(int prefetch=0; prefetch<2; ++prefetch) {
+        RecordingSelector selector;
+        chain = makeChain();
+        ChainPrefetchDriver driver(chain);
+        driver.setPrefetch(prefetch).setVerbose(test.verbose());
+        const Long64_t nProcessed = driver.process(&selector, "", nEntries);
+        delete chain;
+        if(!SUSYNT_CHECK(test, nProcessed==nReference && selector.sameAs(reference)))
+            cout<<"test_ChainPrefetchDriver: "<<nEntries<<" entries, prefetch "<<prefetch<<" differs"<<endl;
+        SUSYNT_CHECK_EQUAL(test, driver.nTriggerMismatches(), expectedMismatches);
+    }
+}
+//----------------------------------------------------------
+int main(int argc, char **argv)
+{
+    TestReport test("test_ChainPrefetchDriver");
+    test.setVerbose(argc>1);
+    if(writeFiles(test)) {
+        sameLoop(test, -1, 1);
+        // stop in the middle of the third file, before the one with different trigger labels
+        sameLoop(test, 400, 0);
+        // stop in the middle of the last file
+        sameLoop(test, 600, 1);
+    }
+    for(size_t i=0; i<nFiles; ++i) remove(filename(i).c_str());
+    return test.finish();
+}
+//----------------------------------------------------------
@@ -0,0 +1,154 @@
+#include "SusyNtuple/Cutflow.h"
+#include "SusyNtuple/test_utils.h"
+
+#include "TH1F.h"
+
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using Susy::Cutflow;
+using Susy::RegionSet;
+using Susy::utils::TestReport;
+
+/**
+   Test Cutflow: sequential counting with weight stages and columns,
+   merging, and the write()/read() roundtrip. Test RegionSet: region
+   yields and N-1 histograms from the same mask.
+ */
+
+//----------------------------------------------------------
+Cutflow makeCutflow()
+{
+    Cutflow cutflow("test");
+    cutflow.addCut("cleaning");
+    cutflow.addCut("two leptons");
+    cutflow.addCut("b-veto", 1);
+    cutflow.addColumn("EE");
+    cutflow.addColumn("MM");
+    return cutflow;
+}
+//----------------------------------------------------------
+int main(int argc, char **argv)
+{
+    TestReport test("test_Cutflow");
+    Cutflow cutflow = makeCutflow();
+    const Cutflow::Mask all = Cutflow::bit(0) | Cutflow::bit(1) | Cutflow::bit(2);
+    SUSYNT_CHECK_EQUAL(test, Cutflow::nPassed(0), 0u);
+    SUSYNT_CHECK_EQUAL(test, Cutflow::nPassed(Cutflow::bit(1)), 0u);
+    SUSYNT_CHECK_EQUAL(test, Cutflow::nPassed(all), 3u);
+    SUSYNT_CHECK_EQUAL(test, Cutflow::nPassed(~Cutflow::Mask(0)), Cutflow::maxCuts);
+    cutflow.fill(all, {2.0, 0.5}, 0);                         // counted everywhere, b-veto with 0.5
+    cutflow.fill(Cutflow::bit(0) | Cutflow::bit(2), 3.0, 0);  // fails "two leptons"
+    cutflow.fill(Cutflow::bit(1) | Cutflow::bit(2), 1.0, 1);  // fails "cleaning": not counted
+    cutflow.fillAll(4.0, 1);
+    SUSYNT_CHECK_EQUAL(test, cutflow.raw(0, 0), 2u);
+    SUSYNT_CHECK_EQUAL(test, cutflow.weighted(0, 0), 5.0);
+    SUSYNT_CHECK_EQUAL(test, cutflow.sumw2(0, 0), 13.0);
+    SUSYNT_CHECK_EQUAL(test, cutflow.raw(1, 0), 1u);
+    SUSYNT_CHECK_EQUAL(test, cutflow.weighted(1, 0), 2.0);
+    SUSYNT_CHECK_EQUAL(test, cutflow.raw(2, 0), 1u);
+    SUSYNT_CHECK_EQUAL(test, cutflow.weighted(2, 0), 0.5);
+    SUSYNT_CHECK_EQUAL(test, cutflow.sumw2(2, 0), 0.25);
+    SUSYNT_CHECK_EQUAL(test, cutflow.raw(0, 1), 1u);
+    SUSYNT_CHECK_EQUAL(test, cutflow.raw(2, 1), 1u);
+    SUSYNT_CHECK_EQUAL(test, cutflow.weighted(2, 1), 4.0);
+    SUSYNT_CHECK_EQUAL(test, cutflow.findCut("b-veto"), 2u);
+    SUSYNT_CHECK_EQUAL(test, cutflow.findCut("none"), cutflow.nCuts());
+
+    // merge, e.g. from another thread
+    Cutflow other = makeCutflow();
+    other.fill(all, 1.0, 1);
+    SUSYNT_CHECK(test, cutflow.merge(other));
+    SUSYNT_CHECK_EQUAL(test, cutflow.raw(2, 1), 2u);
+    SUSYNT_CHECK_EQUAL(test, cutflow.weighted(2, 1), 5.0);
+    Cutflow different("different");
+    different.addCut("cleaning");
+    SUSYNT_CHECK(test, !cutflow.merge(different));
+    // same cuts, but a different stage or different columns
+    Cutflow unstaged("test"), recolumned("test");
+    unstaged.addCut("cleaning"); unstaged.addCut("two leptons"); unstaged.addCut("b-veto");
+    unstaged.addColumn("EE"); unstaged.addColumn("MM");
+    recolumned.addCut("cleaning"); recolumned.addCut("two leptons"); recolumned.addCut("b-veto", 1);
+    recolumned.addColumn("EE"); recolumned.addColumn("EM");
+    SUSYNT_CHECK(test, !cutflow.merge(unstaged));
+    SUSYNT_CHECK(test, !cutflow.merge(recolumned));
+    SUSYNT_CHECK_EQUAL(test, cutflow.raw(0, 0), 2u);
+
+    // write and read back
+    stringstream text;
+    cutflow.write(text);
+    Cutflow copy;
+    SUSYNT_CHECK(test, copy.read(text));
+    SUSYNT_CHECK_EQUAL(test, copy.name(), "test");
+    SUSYNT_CHECK_EQUAL(test, copy.nCuts(), 3u);
+    SUSYNT_CHECK_EQUAL(test, copy.nColumns(), 2u);
+    for(size_t cut=0; cut<3; ++cut)
+        for(size_t column=0; column<2; ++column) {
+            SUSYNT_CHECK_EQUAL(test, copy.raw(cut, column), cutflow.raw(cut, column));
+            SUSYNT_CHECK_EQUAL(test, copy.weighted(cut, column), cutflow.weighted(cut, column));
+            SUSYNT_CHECK_EQUAL(test, copy.sumw2(cut, column), cutflow.sumw2(cut, column));
+        }
+    stringstream broken("cutflow\ttest\ncut\tx\tcleaning\nend\n");
+    SUSYNT_CHECK(test, !copy.read(broken));
+    SUSYNT_CHECK_EQUAL(test, copy.nCuts(), 3u);
+    if(argc>1) cutflow.print(cout);
+
+    // regions from one mask: SR needs all three cuts, CR needs "os" and fails "b-veto"
+    RegionSet regions("regions");
+    const size_t os = regions.addCut("os");
+    const size_t met = regions.addCut("met");
+    const size_t bveto = regions.addCut("b-veto");
+    const size_t nobveto = regions.addCut("!b-veto");
+    const size_t sr = regions.addRegion("SR", {"os", "met", "b-veto"}, 1);
+    const size_t cr = regions.addRegion("CR", RegionSet::bit(os) | RegionSet::bit(nobveto));
+    SUSYNT_CHECK_EQUAL(test, regions.addRegion("unknown", {"os", "none"}), regions.nRegions());
+    SUSYNT_CHECK_EQUAL(test, regions.nRegions(), 2u);
+    TH1F metNMinusOne("met_nminusone", "", 10, 0.0, 200.0);
+    regions.addNMinusOne(sr, met, &metNMinusOne);
+    double values[4] = {0.0, 50.0, 0.0, 0.0};
+    regions.fill(RegionSet::bit(os) | RegionSet::bit(bveto), {2.0, 0.5}, 0, values); // fails met only
+    values[met] = 150.0;
+    regions.fill(RegionSet::bit(os) | RegionSet::bit(met) | RegionSet::bit(bveto), {2.0, 0.5}, 0, values);
+    regions.fill(RegionSet::bit(os) | RegionSet::bit(met) | RegionSet::bit(nobveto), 3.0, 0, values);
+    regions.fill(RegionSet::bit(met) | RegionSet::bit(bveto), 1.0, 0, values);  // fails two cuts of SR
+    SUSYNT_CHECK_EQUAL(test, regions.raw(sr), 1u);
+    SUSYNT_CHECK_EQUAL(test, regions.weighted(sr), 0.5);
+    SUSYNT_CHECK_EQUAL(test, regions.sumw2(sr), 0.25);
+    SUSYNT_CHECK_EQUAL(test, regions.raw(cr), 1u);
+    SUSYNT_CHECK_EQUAL(test, regions.weighted(cr), 3.0);
+    SUSYNT_CHECK(test, regions.pass(cr, RegionSet::bit(os) | RegionSet::bit(nobveto)));
+    SUSYNT_CHECK_EQUAL(test, regions.failed(sr, RegionSet::bit(os)), (RegionSet::bit(met) | RegionSet::bit(bveto)));
+    SUSYNT_CHECK_EQUAL(test, metNMinusOne.GetEntries(), 2);
+    SUSYNT_CHECK_EQUAL(test, metNMinusOne.GetSumOfWeights(), 1.0);
+
+    RegionSet otherRegions = regions;
+    SUSYNT_CHECK(test, regions.merge(otherRegions));
+    SUSYNT_CHECK_EQUAL(test, regions.raw(sr), 2u);
+    SUSYNT_CHECK_EQUAL(test, regions.weighted(cr), 6.0);
+    // same cuts and masks, but a renamed region or a different stage
+    RegionSet renamed("regions"), restaged("regions");
+    for(size_t cut=0; cut<regions.nCuts(); ++cut) { renamed.addCut(regions.cut(cut)); restaged.addCut(regions.cut(cut)); }
+    renamed.addRegion("SR-renamed", regions.required(sr), 1);
+    renamed.addRegion("CR", regions.required(cr));
+    restaged.addRegion("SR", regions.required(sr));
+    restaged.addRegion("CR", regions.required(cr));
+    SUSYNT_CHECK(test, !regions.merge(renamed));
+    SUSYNT_CHECK(test, !regions.merge(restaged));
+    SUSYNT_CHECK_EQUAL(test, regions.raw(sr), 2u);
+    stringstream regionText;
+    regions.write(regionText);
+    RegionSet regionCopy;
+    SUSYNT_CHECK(test, regionCopy.read(regionText));
+    SUSYNT_CHECK_EQUAL(test, regionCopy.nRegions(), 2u);
+    SUSYNT_CHECK_EQUAL(test, regionCopy.nCuts(), 4u);
+    SUSYNT_CHECK_EQUAL(test, regionCopy.required(cr), regions.required(cr));
+    SUSYNT_CHECK_EQUAL(test, regionCopy.region(sr), "SR");
+    SUSYNT_CHECK_EQUAL(test, regionCopy.raw(sr), 2u);
+    SUSYNT_CHECK_EQUAL(test, regionCopy.weighted(sr), 1.0);
+    SUSYNT_CHECK_EQUAL(test, regionCopy.sumw2(cr), 18.0);
+    if(argc>1) regions.print(cout);
+
+    return test.finish();
+}
+//----------------------------------------------------------
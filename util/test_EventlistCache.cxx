@@ -0,0 +1,54 @@
+#include "SusyNtuple/EventlistCache.h"
+#include "SusyNtuple/test_utils.h"
+
+#include <iostream>
+#include <string>
+
+using namespace std;
+using Susy::EntryRange;
+using Susy::EventlistCache;
+using Susy::utils::TestReport;
+
+/**
+   Test EventlistCache: fill a selection for two files (with some
+   entries out of order), write it, map it back and check it.
+ */
+
+const string cacheFilename = "/tmp/dummy_eventlist_cache.evl";
+//----------------------------------------------------------
+int main(int argc, char **argv)
+{
+    const uint64_t nEntries = 1000;
+    uint64_t keyA = EventlistCache::fileKey("/tmp/dummy_dir/file0.root", nEntries);
+    uint64_t keyB = EventlistCache::fileKey("/some/other/dir/file1.root", nEntries);
+
+    EventlistCache cache;
+    for(uint64_t e=0; e<nEntries; e+=3) cache.add(keyA, nEntries, e);
+    for(uint64_t e=100; e<200; ++e)     cache.add(keyB, nEntries, e);
+    cache.add(keyB, nEntries, 50).add(keyB, nEntries, 99).add(keyB, nEntries, 500);
+
+    TestReport test("test_EventlistCache");
+    SUSYNT_CHECK(test, cache.write(cacheFilename));
+    EventlistCache mapped;
+    SUSYNT_CHECK(test, EventlistCache::isCacheFile(cacheFilename));
+    SUSYNT_CHECK(test, mapped.read(cacheFilename));
+    SUSYNT_CHECK_EQUAL(test, mapped.nFiles(), 2u);
+    SUSYNT_CHECK_EQUAL(test, mapped.nSelected(), cache.nSelected());
+    size_t nWrongA = 0, nWrongB = 0;
+    for(uint64_t e=0; e<nEntries; ++e) {
+        if(mapped.contains(keyA, e) != (e%3==0)) nWrongA++;
+        if(mapped.contains(keyB, e) != ((e>=99 && e<200) || e==50 || e==500)) nWrongB++;
+    }
+    SUSYNT_CHECK_EQUAL(test, nWrongA, 0u);
+    SUSYNT_CHECK_EQUAL(test, nWrongB, 0u);
+    EventlistCache::FileSelection sel;
+    SUSYNT_CHECK(test, mapped.find(keyB, sel));
+    SUSYNT_CHECK_EQUAL(test, sel.nRanges(), 3u);
+    for(const EntryRange* r=sel.begin(); r!=sel.end(); ++r)
+        cout<<"file1 range ["<<r->first<<", "<<r->end<<")"<<endl;
+    // the key depends only on the basename, not on the directory
+    SUSYNT_CHECK(test, mapped.contains(EventlistCache::fileKey("file0.root", nEntries), 0));
+
+    return test.finish();
+}
+//----------------------------------------------------------
@@ -1,4 +1,5 @@
 #include "SusyNtuple/EventlistHandler.h"
+#include "SusyNtuple/EntryRangeDriver.h"
 #include "SusyNtuple/Susy2LepCutflow.h"
 #include "SusyNtuple/ChainHelper.h"
 #include "SusyNtuple/string_utils.h"
@@ -23,10 +24,13 @@ public:
     virtual void    Begin(TTree *tree)
         {        
             Susy2LepCutflow::Begin(tree);
+            // entries are cached per input file, so the handler needs to know which tree we are reading
+            m_eventList.setInputTree(tree);
             // check if the event list is there; if so, fetch it and loop only on those events
-            m_useExistingList = m_eventList.cacheDoesExists();
+            // (it might have been already fetched to drive the loop, see main())
+            m_useExistingList = (m_eventList.cache().isMapped() ||
+                                 (m_eventList.cacheDoesExists() && m_eventList.fetchCache()));
             if(m_useExistingList) {
-                tree->SetEventList(m_eventList.fetchEventList());
                 cout<<"using existing event list from "<<m_eventList.cacheFilename()<<endl;
             }
         }
@@ -39,6 +43,9 @@ public:
         }
     virtual Bool_t  Process(Long64_t entry)
         {
+            // skip the entries that are not in the list; nothing has been read yet at this point
+            if(m_useExistingList && !m_eventList.isSelected(entry))
+                return kFALSE;
             // here the only additional step is to call 'addEvent' for the entries you want to process
             bool isSelectedEvent = Susy2LepCutflow::Process(entry);
             if(!m_useExistingList && isSelectedEvent)
@@ -96,14 +103,20 @@ int main(int argc, char **argv)
   DileptonCutflowWithList analysis;
   if(verbose) analysis.setDebug(1);
   analysis.setSampleName(ChainHelper::sampleName(inputRootFname, verbose));
-  analysis.m_eventList.setListName(sampleName); // can be anything; used to save the TEventList in the file
-  analysis.m_eventList.setCacheFilename("./cache/"+sampleName+"_list.root"); // can be any (root) path where you have r/w permission
+  analysis.m_eventList.setCacheFilename("./cache/"+sampleName+"_list.evl"); // can be any path where you have r/w permission
 
   TChain chain("susyNt");
   ChainHelper::addFile(&chain, inputRootFname);
   Long64_t nEntries = chain.GetEntries();
 
-  chain.Process(&analysis, sampleName.c_str()); 
+  Susy::EventlistHandler &eventList = analysis.m_eventList;
+  if(eventList.cacheDoesExists() && eventList.fetchCache()) {
+      // second pass: read only the clusters that contain the selected entries
+      Susy::EntryRangeDriver driver(&chain, eventList.cache());
+      driver.setVerbose(verbose).process(&analysis, sampleName.c_str());
+  } else {
+      chain.Process(&analysis, sampleName.c_str());
+  }
   cout<<"Total entries:   "<<nEntries<<endl;
   cout<<"Number of processed entries "<<analysis.m_nProcessedEntries<<endl;
 
@@ -0,0 +1,85 @@
+#include "SusyNtuple/HistogramSet.h"
+#include "SusyNtuple/test_utils.h"
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using Susy::HistogramSet;
+using Susy::utils::TestReport;
+
+/**
+   Test HistogramSet: check the binning, then fill from several
+   threads (with and without batching) and check that the merged
+   contents are the same, bit by bit, as filling the slots one after
+   the other.
+ */
+
+//----------------------------------------------------------
+/// value and weight of event i
+double value(size_t i) { return (i*7919 % 1000)*0.1 - 10.0; }
+double weight(size_t i) { return 0.5 + (i % 13)*0.1; }
+//----------------------------------------------------------
+/// fill nEvents into histos, event i going to slot i%nSlots, with one thread per slot
+void fillThreads(HistogramSet &histos, size_t nSlots, size_t nEvents, size_t id)
+{
+    vector<thread> threads;
+    for(size_t slot=0; slot<nSlots; ++slot) {
+        threads.push_back(thread([&histos, slot, nSlots, nEvents, id]() {
+                    HistogramSet::Filler &filler = histos.filler(slot);
+                    for(size_t i=slot; i<nEvents; i+=nSlots) filler.fill(id, value(i), weight(i));
+                }));
+    }
+    for(size_t t=0; t<threads.size(); ++t) threads[t].join();
+    histos.merge();
+}
+//----------------------------------------------------------
+int main(int argc, char **argv)
+{
+    TestReport test("test_HistogramSet");
+    HistogramSet binning;
+    const size_t uniform = binning.book("uniform", "", 10, 0.0, 100.0);
+    const size_t variable = binning.book("variable", "", vector<double>{0.0, 10.0, 50.0, 100.0});
+    SUSYNT_CHECK_EQUAL(test, binning.findBin(uniform, -1.0), 0);
+    SUSYNT_CHECK_EQUAL(test, binning.findBin(uniform, 0.0), 1);
+    SUSYNT_CHECK_EQUAL(test, binning.findBin(uniform, 99.999), 10);
+    SUSYNT_CHECK_EQUAL(test, binning.findBin(uniform, 100.0), 11);
+    SUSYNT_CHECK_EQUAL(test, binning.findBin(variable, 10.0), 2);
+    SUSYNT_CHECK_EQUAL(test, binning.findBin(variable, 49.0), 2);
+    SUSYNT_CHECK_EQUAL(test, binning.findBin(variable, 100.0), 4);
+    SUSYNT_CHECK_EQUAL(test, binning.find("variable"), variable);
+
+    const size_t nSlots = 4, nEvents = 100000;
+    HistogramSet sequential;
+    const size_t h = sequential.book("h", "", 50, -5.0, 95.0);
+    for(size_t slot=0; slot<nSlots; ++slot)
+        for(size_t i=slot; i<nEvents; i+=nSlots) sequential.filler(slot).fill(h, value(i), weight(i));
+    sequential.merge();
+
+    for(size_t batch : {size_t(0), size_t(64)}) {
+        HistogramSet threaded;
+        threaded.book("h", "", 50, -5.0, 95.0);
+        threaded.setBatchSize(batch);
+        fillThreads(threaded, nSlots, nEvents, h);
+        SUSYNT_CHECK_EQUAL(test, threaded.entries(h), nEvents);
+        SUSYNT_CHECK_EQUAL(test, threaded.nFillers(), nSlots);
+        for(int bin=0; bin<=threaded.nBins(h)+1; ++bin) {
+            SUSYNT_CHECK_EQUAL(test, threaded.content(h, bin), sequential.content(h, bin));
+            SUSYNT_CHECK_EQUAL(test, threaded.sumw2(h, bin), sequential.sumw2(h, bin));
+        }
+        // merging again gives the same result; clear() drops everything
+        threaded.merge();
+        SUSYNT_CHECK_EQUAL(test, threaded.content(h, 1), sequential.content(h, 1));
+        threaded.clear();
+        threaded.merge();
+        SUSYNT_CHECK_EQUAL(test, threaded.entries(h), 0u);
+        SUSYNT_CHECK_EQUAL(test, threaded.content(h, 1), 0.0);
+    }
+    if(argc>1)
+        for(int bin=0; bin<=sequential.nBins(h)+1; ++bin)
+            cout<<bin<<" "<<sequential.content(h, bin)<<" +- "<<sequential.sumw2(h, bin)<<endl;
+
+    return test.finish();
+}
+//----------------------------------------------------------
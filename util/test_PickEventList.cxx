@@ -0,0 +1,63 @@
+#include "SusyNtuple/PickEventList.h"
+#include "SusyNtuple/test_utils.h"
+
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <string>
+
+using namespace std;
+using Susy::PickEventList;
+using Susy::utils::TestReport;
+
+/**
+   Test PickEventList: parse the supported formats, then write and
+   read back a list with a million events.
+ */
+
+const string pickFilename = "/tmp/dummy_pick_events.txt";
+//----------------------------------------------------------
+int main(int argc, char **argv)
+{
+    PickEventList pick;
+    const string text =
+        "# run event\n"
+        "300000 1\n"
+        "  300000\t2  \r\n"
+        "\n"
+        "300001:3\n"
+        "300001,4\n"
+        "300001 4\n"           // duplicate
+        "300002 5 6\n"         // malformed
+        "300002 99999999999\n" // malformed, overflow
+        "300002 0";            // no trailing newline
+    size_t nPairs = pick.parse(text.data(), text.data()+text.size());
+    TestReport test("test_PickEventList");
+    SUSYNT_CHECK_EQUAL(test, nPairs, 6u);
+    SUSYNT_CHECK_EQUAL(test, pick.size(), 5u);
+    SUSYNT_CHECK_EQUAL(test, pick.nMalformed(), 2u);
+    SUSYNT_CHECK_EQUAL(test, pick.nRuns(), 3u);
+    SUSYNT_CHECK(test, pick.contains(300000, 2));
+    SUSYNT_CHECK(test, pick.contains(300001, 3));
+    SUSYNT_CHECK(test, pick.contains(300002, 0));
+    SUSYNT_CHECK(test, !pick.contains(300002, 5));
+
+    const unsigned int nEvents = 1000000;
+    FILE* file = fopen(pickFilename.c_str(), "w");
+    if(SUSYNT_CHECK(test, file!=0)) {
+        for(unsigned int e=0; e<nEvents; ++e) fprintf(file, "%u %u\n", 310000 + e%10, 13*e);
+        fclose(file);
+    }
+    PickEventList large;
+    clock_t start = clock();
+    SUSYNT_CHECK(test, large.read(pickFilename));
+    double seconds = double(clock() - start)/CLOCKS_PER_SEC;
+    SUSYNT_CHECK_EQUAL(test, large.size(), nEvents);
+    SUSYNT_CHECK(test, large.contains(310003, 13*3));
+    SUSYNT_CHECK(test, !large.contains(310003, 13*4));
+    cout<<"read "<<large.size()<<" events in "<<seconds<<" s"<<endl;
+    remove(pickFilename.c_str());
+
+    return test.finish();
+}
+//----------------------------------------------------------
@@ -0,0 +1,136 @@
+#include "SusyNtuple/SusyNtGenerator.h"
+#include "SusyNtuple/SusyNtObject.h"
+#include "SusyNtuple/test_utils.h"
+
+#include "TBufferFile.h"
+#include "TChain.h"
+#include "TClass.h"
+#include "TFile.h"
+#include "TTree.h"
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using Susy::SusyNtGenerator;
+using Susy::SusyNtObject;
+using Susy::utils::TestReport;
+
+/**
+   Test ReuseStorageStreamer: a synthetic file read with and without
+   SusyNtObject::SetReuseStorage gives, event by event, the same
+   electrons, muons and jets (every persistent member, compared through
+   the bytes written by their streamers); also for a copy of the file
+   written while the streamer is installed.
+ */
+
+const string treename = "susyNt";
+const string filename = "/tmp/dummy_reuse_storage.root";
+const string copyFilename = "/tmp/dummy_reuse_storage_copy.root";
+const Long64_t nEvents = 500;
+
+/// the streamed bytes of each object of one collection, per event
+typedef vector<vector<string> > Serialized;
+
+//----------------------------------------------------------
+template <class T>
+vector<string> serialize(const vector<T> &objects)
+{
+    TClass *cls = TClass::GetClass(typeid(T));
+    vector<string> result;
+    for(size_t i=0; i<objects.size(); ++i) {
+        TBufferFile buffer(TBuffer::kWrite, 1024);
+        cls->Streamer(const_cast<T*>(&objects[i]), buffer);
+        result.push_back(string(buffer.Buffer(), buffer.Length()));
+    }
+    return result;
+}
+//----------------------------------------------------------
+/// read all the events of the file, with or without reusing the storage
+void readAll(const string &file, bool reuse, Serialized &ele, Serialized &muo, Serialized &jet)
+{
+    SusyNtObject::SetReuseStorage(reuse);
+    TChain chain(treename.c_str());
+    chain.Add(file.c_str());
+    Long64_t entry = 0;
+    SusyNtObject nt(entry);
+    nt.ReadFrom(&chain);
+    const Long64_t n = chain.GetEntries();
+    for(Long64_t i=0; i<n; ++i) {
+        entry = chain.LoadTree(i);
+        if(entry<0) break;
+        ele.push_back(serialize(*nt.ele()));
+        muo.push_back(serialize(*nt.muo()));
+        jet.push_back(serialize(*nt.jet()));
+    }
+    SusyNtObject::SetReuseStorage(false);
+}
+//----------------------------------------------------------
+/// the same objects in every event; the first difference is printed
+void sameObjects(TestReport &test, const Serialized &reference, const Serialized &other, const string &label)
+{
+    if(!SUSYNT_CHECK_EQUAL(test, other.size(), reference.size())) return;
+    size_t nDifferent = 0;
+    for(size_t iEvent=0; iEvent<reference.size(); ++iEvent) {
+        if(other[iEvent]==reference[iEvent]) continue;
+        if(nDifferent==0)
+            cout<<"test_ReuseStorage: "<<label<<" differ in event "<<iEvent
+                <<" ("<<other[iEvent].size()<<" vs "<<reference[iEvent].size()<<" objects)"<<endl;
+        nDifferent++;
+    }
+    if(!SUSYNT_CHECK_EQUAL(test, nDifferent, 0u))
+        cout<<"test_ReuseStorage: "<<label<<" differ in "<<nDifferent<<" events"<<endl;
+}
+//----------------------------------------------------------
+/// copy the tree entry by entry, reading and writing through the streamers
+bool writeCopy(bool reuse)
+{
+    SusyNtObject::SetReuseStorage(reuse);
+    TFile input(filename.c_str());
+    TTree* tree = dynamic_cast<TTree*>(input.Get(treename.c_str()));
+    bool success = false;
+    if(tree) {
+        TFile output(copyFilename.c_str(), "recreate");
+        TTree* copy = tree->CloneTree(-1);
+        success = (copy && copy->GetEntries()==tree->GetEntries());
+        output.Write();
+        output.Close();
+    }
+    input.Close();
+    SusyNtObject::SetReuseStorage(false);
+    return success;
+}
+//----------------------------------------------------------
+int main(int argc, char **argv)
+{
+    TestReport test("test_ReuseStorage");
+    test.setVerbose(argc>1);
+    SusyNtGenerator generator;
+    // several objects per event, with multiplicities going up and down
+    generator.setOutputFilename(filename).setNumberOfEvents(nEvents).setSeed(4321);
+    generator.setMeanElectrons(2).setMeanMuons(2).setMeanJets(6);
+    if(SUSYNT_CHECK_EQUAL(test, generator.generate(), nEvents)) {
+        Serialized ele, muo, jet;
+        readAll(filename, false, ele, muo, jet);
+        SUSYNT_CHECK_EQUAL(test, ele.size(), size_t(nEvents));
+        Serialized reusedEle, reusedMuo, reusedJet;
+        readAll(filename, true, reusedEle, reusedMuo, reusedJet);
+        sameObjects(test, ele, reusedEle, "electrons");
+        sameObjects(test, muo, reusedMuo, "muons");
+        sameObjects(test, jet, reusedJet, "jets");
+
+        if(SUSYNT_CHECK(test, writeCopy(true))) {
+            Serialized copyEle, copyMuo, copyJet;
+            readAll(copyFilename, false, copyEle, copyMuo, copyJet);
+            sameObjects(test, ele, copyEle, "electrons in the copy");
+            sameObjects(test, muo, copyMuo, "muons in the copy");
+            sameObjects(test, jet, copyJet, "jets in the copy");
+        }
+    }
+    remove(filename.c_str());
+    remove(copyFilename.c_str());
+    return test.finish();
+}
+//----------------------------------------------------------
@@ -0,0 +1,88 @@
+#include "SusyNtuple/RunEventIndex.h"
+#include "SusyNtuple/test_utils.h"
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+using namespace std;
+using Susy::EventlistCache;
+using Susy::PickEventList;
+using Susy::RunEventIndex;
+using Susy::RunEventRecord;
+using Susy::utils::TestReport;
+
+/**
+   Test RunEventIndex: index two fake datasets (with one duplicate
+   event and some events in common), write one of them, map it back,
+   look up events, pick some of them and compare the two datasets.
+ */
+
+const string indexFilename = "/tmp/dummy_run_event_index.idx";
+//----------------------------------------------------------
+int main(int argc, char **argv)
+{
+    const uint64_t nEntries = 1000;
+    RunEventIndex a;
+    uint32_t a0 = a.addFile("/data/A/file0.root", nEntries);
+    uint32_t a1 = a.addFile("/data/A/file1.root", nEntries);
+    for(uint64_t e=0; e<nEntries; ++e) {
+        a.add(300000, 2*e, a0, e);   // even events in file0
+        a.add(300001, 1000-e, a1, e); // decreasing events in file1
+    }
+    a.add(300000, 10, a1, 999);       // duplicate of entry 5 of file0
+
+    RunEventIndex b;
+    uint32_t b0 = b.addFile("/data/B/file0.root", 10);
+    for(uint64_t e=0; e<10; ++e) b.add(300001, e, b0, e); // events 1-9 are also in A
+
+    TestReport test("test_RunEventIndex");
+    SUSYNT_CHECK(test, a.write(indexFilename));
+    RunEventIndex mapped;
+    SUSYNT_CHECK(test, RunEventIndex::isIndexFile(indexFilename));
+    SUSYNT_CHECK(test, mapped.read(indexFilename));
+    SUSYNT_CHECK(test, mapped.isMapped());
+    SUSYNT_CHECK_EQUAL(test, mapped.size(), 2*nEntries+1);
+    SUSYNT_CHECK_EQUAL(test, mapped.nFiles(), 2u);
+    SUSYNT_CHECK_EQUAL(test, mapped.file(1).name, "/data/A/file1.root");
+
+    std::pair<const RunEventRecord*, const RunEventRecord*> found = mapped.find(300001, 1000);
+    if(SUSYNT_CHECK_EQUAL(test, found.second-found.first, 1)) {
+        SUSYNT_CHECK_EQUAL(test, found.first->file, a1);
+        SUSYNT_CHECK_EQUAL(test, found.first->entry, 0u);
+    }
+    found = mapped.find(300000, 10);
+    SUSYNT_CHECK_EQUAL(test, found.second-found.first, 2);
+    SUSYNT_CHECK(test, !mapped.contains(300000, 11));
+
+    vector<RunEventIndex::RecordPair> dups = mapped.duplicates();
+    if(SUSYNT_CHECK_EQUAL(test, dups.size(), 1u)) {
+        SUSYNT_CHECK_EQUAL(test, dups[0].first.entry, 5u);
+        SUSYNT_CHECK_EQUAL(test, dups[0].second.entry, 999u);
+    }
+    vector<RunEventIndex::RecordPair> common = RunEventIndex::commonEvents(mapped, b);
+    if(SUSYNT_CHECK_EQUAL(test, common.size(), 9u)) {
+        SUSYNT_CHECK_EQUAL(test, common[0].first.event, 1u);
+        SUSYNT_CHECK_EQUAL(test, common[0].first.entry, 999u);
+    }
+
+    PickEventList pick;
+    pick.add(300000, 4).add(300001, 999).add(300000, 10).add(310000, 1);
+    EventlistCache entries;
+    SUSYNT_CHECK_EQUAL(test, mapped.select(pick, entries), 4u);
+    SUSYNT_CHECK_EQUAL(test, entries.nSelected(), 4u);
+    SUSYNT_CHECK(test, entries.contains(EventlistCache::fileKey("file0.root", nEntries), 2));
+    SUSYNT_CHECK(test, entries.contains(EventlistCache::fileKey("file1.root", nEntries), 1));
+
+    mapped.merge(b);
+    SUSYNT_CHECK(test, !mapped.isMapped());
+    SUSYNT_CHECK_EQUAL(test, mapped.size(), 2*nEntries+11);
+    SUSYNT_CHECK_EQUAL(test, mapped.nFiles(), 3u);
+    SUSYNT_CHECK_EQUAL(test, mapped.duplicates().size(), 10u);
+    if(SUSYNT_CHECK(test, mapped.contains(300001, 0)))
+        SUSYNT_CHECK_EQUAL(test, mapped.find(300001, 0).first->file, 2u);
+    remove(indexFilename.c_str());
+
+    return test.finish();
+}
+//----------------------------------------------------------
@@ -0,0 +1,80 @@
+#include "SusyNtuple/RunEventSet.h"
+#include "SusyNtuple/test_utils.h"
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using Susy::RunEventSet;
+using Susy::ConcurrentRunEventSet;
+using Susy::utils::TestReport;
+
+/**
+   Test RunEventSet: insert events from a few runs (including event
+   number 0 and duplicates), with and without spilling to disk, and
+   from several threads with ConcurrentRunEventSet.
+ */
+
+//----------------------------------------------------------
+void fillAndCheck(TestReport &test, RunEventSet &events)
+{
+    const uint32_t nEvents = 100000;
+    size_t nRejected = 0;
+    for(uint32_t run=300000; run<300003; ++run)
+        for(uint32_t e=0; e<nEvents; ++e)
+            if(!events.insert(run, 7*e)) nRejected++;
+    SUSYNT_CHECK_EQUAL(test, nRejected, 0u);
+    // duplicates are rejected
+    SUSYNT_CHECK(test, !events.insert(300001, 0));
+    SUSYNT_CHECK(test, !events.insert(300002, 7*(nEvents-1)));
+    size_t nMissing = 0, nExtra = 0;
+    for(uint32_t run=300000; run<300003; ++run)
+        for(uint32_t e=0; e<nEvents; ++e) {
+            if(!events.contains(run, 7*e)) nMissing++;
+            if(events.contains(run, 7*e+1)) nExtra++;
+        }
+    SUSYNT_CHECK_EQUAL(test, nMissing, 0u);
+    SUSYNT_CHECK_EQUAL(test, nExtra, 0u);
+    SUSYNT_CHECK(test, !events.contains(299999, 0));
+    SUSYNT_CHECK_EQUAL(test, events.size(), 3*nEvents);
+    SUSYNT_CHECK_EQUAL(test, events.nRuns(), 3u);
+}
+//----------------------------------------------------------
+int main(int argc, char **argv)
+{
+    TestReport test("test_RunEventSet");
+    RunEventSet inMemory;
+    fillAndCheck(test, inMemory);
+    cout<<"in memory: "<<inMemory.size()<<" events, "
+        <<double(inMemory.memoryUsage())/inMemory.size()<<" bytes/event"<<endl;
+
+    RunEventSet spilled;
+    spilled.setSpill("/tmp", 64*1024);
+    fillAndCheck(test, spilled);
+    SUSYNT_CHECK(test, spilled.nSpilled()>0);
+    SUSYNT_CHECK(test, spilled.memoryUsage()<=64*1024);
+    cout<<"spilled: "<<spilled.nSpilled()<<" of "<<spilled.size()<<" events on disk"<<endl;
+
+    ConcurrentRunEventSet concurrent;
+    const int nThreads = 4;
+    const uint32_t nEvents = 50000;
+    vector<int> nInserted(nThreads, 0);
+    vector<thread> threads;
+    for(int t=0; t<nThreads; ++t) {
+        // every thread tries to insert the same events: each event must be accepted exactly once
+        threads.push_back(thread([&concurrent, &nInserted, t, nEvents]() {
+                    for(uint32_t e=0; e<nEvents; ++e)
+                        if(concurrent.insert(310000 + e%2, e)) nInserted[t]++;
+                }));
+    }
+    for(size_t t=0; t<threads.size(); ++t) threads[t].join();
+    int nTotal = 0;
+    for(int t=0; t<nThreads; ++t) nTotal += nInserted[t];
+    SUSYNT_CHECK_EQUAL(test, nTotal, int(nEvents));
+    SUSYNT_CHECK_EQUAL(test, concurrent.size(), nEvents);
+    SUSYNT_CHECK(test, concurrent.contains(310001, 1));
+
+    return test.finish();
+}
+//----------------------------------------------------------
@@ -0,0 +1,332 @@
+#include "SusyNtuple/SusyNtGenerator.h"
+#include "SusyNtuple/ElectronSelector.h"
+#include "SusyNtuple/MuonSelector.h"
+#include "SusyNtuple/JetSelector.h"
+#include "SusyNtuple/TauSelector.h"
+#include "SusyNtuple/PhotonSelector.h"
+#include "SusyNtuple/test_utils.h"
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Susy;
+using Susy::utils::TestReport;
+
+/**
+   Test the policy-based selectors on synthetic events: for each
+   analysis, the selectBaseline()/selectSignal() loops must agree with
+   the per-object virtual calls, and the generic policies must agree
+   with the vanilla (virtual) selectors. The bits set by classify()
+   must select the same objects. Hand-made objects probing the pt, eta,
+   ID, isolation and impact parameter thresholds must be selected as
+   they were by the selectors before the policies were introduced, and
+   a subclass of an analysis selector must be used by the loops.
+ */
+
+const AnalysisType analyses[] = {AnalysisType::Ana_2Lep, AnalysisType::Ana_3Lep, AnalysisType::Ana_4Lep,
+                                 AnalysisType::Ana_2LepWH, AnalysisType::Ana_SS3L, AnalysisType::Ana_Stop2L,
+                                 AnalysisType::Ana_WWBB};
+const size_t nAnalyses = sizeof(analyses)/sizeof(AnalysisType);
+
+/// pointers to the objects in v
+template<class T>
+vector<T*> pointers(vector<T> &v)
+{
+    vector<T*> result;
+    for(size_t i=0; i<v.size(); ++i) result.push_back(&v[i]);
+    return result;
+}
+
+/// whether the batch selection of s agrees with its per-object isBaseline/isSignal
+template<class Selector, class T>
+bool consistent(Selector &s, const vector<T*> &objects)
+{
+    vector<T*> baseline, signal, expectedBaseline, expectedSignal;
+    s.selectBaseline(objects, baseline);
+    s.selectSignal(objects, signal);
+    for(size_t i=0; i<objects.size(); ++i) {
+        if(s.isBaseline(objects[i])) expectedBaseline.push_back(objects[i]);
+        if(s.isSignal(objects[i])) expectedSignal.push_back(objects[i]);
+    }
+    return baseline==expectedBaseline && signal==expectedSignal;
+}
+
+/// whether the bits from classify() select the same objects as s
+template<class Selector, class T>
+bool classified(Selector &s, vector<T> &nt, const vector<T*> &objects)
+{
+    ObjectStatus::Collection<T> status;
+    status.reset(objects, nt.empty() ? 0 : &nt.front());
+    s.classify(status);
+    vector<T*> baseline, signal, expectedBaseline, expectedSignal;
+    status.select(ObjectStatus::Baseline, baseline);
+    status.select(ObjectStatus::PassSignal, signal);
+    s.selectBaseline(objects, expectedBaseline);
+    s.selectSignal(objects, expectedSignal);
+    bool allContained = true;
+    for(size_t i=0; i<objects.size(); ++i) allContained = allContained && status.contains(objects[i]);
+    return allContained && baseline==expectedBaseline && signal==expectedSignal;
+}
+
+/// whether two selectors select the same objects
+template<class Selector, class T>
+bool same(Selector &a, Selector &b, const vector<T*> &objects)
+{
+    vector<T*> baseA, sigA, baseB, sigB;
+    a.selectBaseline(objects, baseA);
+    a.selectSignal(objects, sigA);
+    b.selectBaseline(objects, baseB);
+    b.selectSignal(objects, sigB);
+    return baseA==baseB && sigA==sigB;
+}
+
+/// whether obj is selected by each analysis selector as expected
+/**
+   baseline and signal hold the decisions of the selectors before the
+   policies, one '0' or '1' per analysis in the order of analyses[].
+*/
+template<class Selector, class T>
+bool expected(T &obj, const char *baseline, const char *signal, const string &probe)
+{
+    bool success = true;
+    const vector<T*> objects(1, &obj);
+    for(size_t i=0; i<nAnalyses; ++i) {
+        unique_ptr<Selector> s(Selector::build(analyses[i], false));
+        vector<T*> selBaseline, selSignal;
+        s->selectBaseline(objects, selBaseline);
+        s->selectSignal(objects, selSignal);
+        const bool expBaseline = baseline[i]=='1', expSignal = signal[i]=='1';
+        const bool pass = (s->isBaseline(&obj)==expBaseline && s->isSignal(&obj)==expSignal &&
+                           selBaseline.size()==size_t(expBaseline) && selSignal.size()==size_t(expSignal));
+        if(!pass) cout<<"test_SelectorPolicy: "<<probe<<" differs for "<<AnalysisType2str(analyses[i])<<endl;
+        success = success && pass;
+    }
+    return success;
+}
+
+/// pt 30, eta 0.5 muon passing all the criteria
+Muon goodMuon()
+{
+    Muon mu;
+    mu.SetPtEtaPhiM(30.0, 0.5, 0.0, 0.106);
+    mu.medium = mu.isoGradientLoose = mu.isoFixedCutTightTrackOnly = true;
+    return mu;
+}
+
+/// pt 30, eta 0.5 electron passing all the criteria
+Electron goodElectron()
+{
+    Electron el;
+    el.SetPtEtaPhiM(30.0, 0.5, 0.0, 0.000511);
+    el.clusEta = el.clusEtaBE = el.trackEta = 0.5;
+    el.looseLLH = el.looseLLHBLayer = el.mediumLLH = el.tightLLH = el.passOQBadClusElectron = true;
+    el.isoGradientLoose = el.isoFixedCutTightTrackOnly = true;
+    return el;
+}
+
+/// central light jet
+Jet goodJet(float pt=30.0, float eta=0.5, float jvt=0.9, float mv2c10=0.0)
+{
+    Jet jet;
+    jet.SetPtEtaPhiM(pt, eta, 0.0, 5.0);
+    jet.detEta = eta;
+    jet.jvt = jvt;
+    jet.mv2c10 = mv2c10;
+    return jet;
+}
+
+/// pt 30, eta 0.5 one-prong tau
+Tau goodTau()
+{
+    Tau tau;
+    tau.SetPtEtaPhiM(30.0, 0.5, 0.0, 1.777);
+    tau.nTrack = 1;
+    tau.q = 1;
+    tau.medium = true;
+    return tau;
+}
+
+/// pt 30, eta 0.5 photon passing all the criteria
+Photon goodPhoton()
+{
+    Photon ph;
+    ph.SetPtEtaPhiM(30.0, 0.5, 0.0, 0.0);
+    ph.clusEta = ph.clusEtaBE = 0.5;
+    ph.tight = ph.authorPhoton = ph.isoFixedCutTight = true;
+    return ph;
+}
+
+/// the pre-refactor thresholds, probed one at a time
+void expectedThresholds(TestReport &test)
+{
+    Muon mu = goodMuon();
+    SUSYNT_CHECK(test, expected<MuonSelector>(mu, "1111111", "1111111", "muon"));
+    mu = goodMuon(); mu.SetPtEtaPhiM(30.0, 2.45, 0.0, 0.106);
+    SUSYNT_CHECK(test, expected<MuonSelector>(mu, "0010100", "0010100", "muon eta 2.45"));
+    mu = goodMuon(); mu.isoGradientLoose = false;
+    SUSYNT_CHECK(test, expected<MuonSelector>(mu, "1111111", "0101101", "muon !isoGradientLoose"));
+    mu = goodMuon(); mu.isoFixedCutTightTrackOnly = false;
+    SUSYNT_CHECK(test, expected<MuonSelector>(mu, "1111111", "1011110", "muon !isoFixedCutTightTrackOnly"));
+    mu = goodMuon(); mu.ptvarcone30 = 0.1*mu.Pt();
+    SUSYNT_CHECK(test, expected<MuonSelector>(mu, "1111111", "1110011", "muon ptvarcone30"));
+    mu = goodMuon(); mu.d0sigBSCorr = 4.0;
+    SUSYNT_CHECK(test, expected<MuonSelector>(mu, "1111111", "0000000", "muon d0sig 4"));
+    mu = goodMuon(); mu.SetPtEtaPhiM(9.0, 0.5, 0.0, 0.106);
+    SUSYNT_CHECK(test, expected<MuonSelector>(mu, "0000000", "0000000", "muon pt 9"));
+
+    Electron el = goodElectron();
+    SUSYNT_CHECK(test, expected<ElectronSelector>(el, "1111111", "1111111", "electron"));
+    el = goodElectron(); el.d0sigBSCorr = 4.0;
+    SUSYNT_CHECK(test, expected<ElectronSelector>(el, "1111111", "1110100", "electron d0sig 4"));
+    el = goodElectron(); el.tightLLH = false;
+    SUSYNT_CHECK(test, expected<ElectronSelector>(el, "1111111", "1010011", "electron !tightLLH"));
+    el = goodElectron(); el.clusEtaBE = 1.4;
+    SUSYNT_CHECK(test, expected<ElectronSelector>(el, "1111011", "1111010", "electron in crack"));
+    el = goodElectron(); el.looseLLHBLayer = false;
+    SUSYNT_CHECK(test, expected<ElectronSelector>(el, "0000100", "0101100", "electron !looseLLHBLayer"));
+
+    Jet jet = goodJet();
+    SUSYNT_CHECK(test, expected<JetSelector>(jet, "1111111", "1111111", "jet"));
+    jet = goodJet(25.0, 2.6, 0.0);
+    SUSYNT_CHECK(test, expected<JetSelector>(jet, "1111111", "0000111", "jet eta 2.6"));
+    jet = goodJet(35.0, 3.0);
+    SUSYNT_CHECK(test, expected<JetSelector>(jet, "1111111", "1111000", "jet eta 3.0"));
+    jet = goodJet(30.0, 0.5, 0.1);
+    SUSYNT_CHECK(test, expected<JetSelector>(jet, "1111111", "0000000", "jet jvt 0.1"));
+    jet = goodJet(15.0);
+    SUSYNT_CHECK(test, expected<JetSelector>(jet, "0000000", "0000000", "jet pt 15"));
+    const float mv2c10[] = {0.5, 0.7};
+    const char *centralB[] = {"0000001", "1111011"};
+    for(size_t iMv=0; iMv<2; ++iMv) {
+        jet = goodJet(30.0, 0.5, 0.9, mv2c10[iMv]);
+        for(size_t i=0; i<nAnalyses; ++i) {
+            unique_ptr<JetSelector> s(JetSelector::build(analyses[i], false));
+            const bool isCB = centralB[iMv][i]=='1';
+            const JetVector jets(1, &jet);
+            const bool pass = (s->isCentralB(&jet)==isCB && s->count_CB_jets(jets)==size_t(isCB) &&
+                               s->isCentralLight(&jet)==!isCB);
+            if(!SUSYNT_CHECK(test, pass))
+                cout<<"test_SelectorPolicy: jet mv2c10 "<<mv2c10[iMv]<<" differs for "<<AnalysisType2str(analyses[i])<<endl;
+        }
+    }
+
+    Tau tau = goodTau();
+    SUSYNT_CHECK(test, expected<TauSelector>(tau, "1111111", "1111111", "tau"));
+    tau = goodTau(); tau.medium = false;
+    SUSYNT_CHECK(test, expected<TauSelector>(tau, "0010000", "0000000", "tau !medium"));
+    tau = goodTau(); tau.SetPtEtaPhiM(15.0, 0.5, 0.0, 1.777);
+    SUSYNT_CHECK(test, expected<TauSelector>(tau, "1101111", "0000000", "tau pt 15"));
+    tau = goodTau(); tau.nTrack = 2;
+    SUSYNT_CHECK(test, expected<TauSelector>(tau, "1101111", "1101111", "tau nTrack 2"));
+
+    Photon ph = goodPhoton();
+    SUSYNT_CHECK(test, expected<PhotonSelector>(ph, "1111111", "1111111", "photon"));
+    ph = goodPhoton(); ph.isoFixedCutTight = false;
+    SUSYNT_CHECK(test, expected<PhotonSelector>(ph, "1111111", "0000000", "photon !isoFixedCutTight"));
+    ph = goodPhoton(); ph.SetPtEtaPhiM(20.0, 0.5, 0.0, 0.0);
+    SUSYNT_CHECK(test, expected<PhotonSelector>(ph, "0000000", "0000000", "photon pt 20"));
+}
+
+/// an analysis selector tweaked by overriding a per-object cut
+class MuonSelector_3LepHighPt : public MuonSelector_3Lep
+{
+public:
+    bool isSignal(const Muon* mu) override { return MuonSelector_3Lep::isSignal(mu) && mu->Pt()>25.0; }
+};
+
+/// an analysis selector tweaked by overriding a per-object cut
+class JetSelector_2LepCentral : public JetSelector_2Lep
+{
+public:
+    bool isCentralLight(const Jet* jet) override { return JetSelector_2Lep::isCentralLight(jet) && std::fabs(jet->detEta)<1.0; }
+};
+
+//----------------------------------------------------------
+int main(int argc, char **argv)
+{
+    TestReport test("test_SelectorPolicy");
+    SusyNtGenerator generator;
+    generator.setMeanElectrons(3).setMeanMuons(3).setMeanJets(8).setMeanTaus(2).setMeanPhotons(2);
+    MuonSelector vanillaMuon;
+    MuonSelectorT<MuonPolicy> genericMuon;
+    ElectronSelector vanillaElectron;
+    ElectronSelectorT<ElectronPolicy> genericElectron;
+    JetSelector vanillaJet;
+    JetSelectorT<JetPolicy> genericJet;
+    MuonSelector_3LepHighPt highPtMuon;
+    JetSelector_2LepCentral centralJet;
+    size_t nSelected = 0;
+    for(int iEvent=0; iEvent<200; ++iEvent) {
+        generator.generateEvent();
+        SusyNtObject &nt = generator.nt();
+        ElectronVector electrons = pointers(*nt.ele());
+        MuonVector muons = pointers(*nt.muo());
+        JetVector jets = pointers(*nt.jet());
+        TauVector taus = pointers(*nt.tau());
+        PhotonVector photons = pointers(*nt.pho());
+        for(const AnalysisType &a : analyses) {
+            unique_ptr<ElectronSelector> e(ElectronSelector::build(a, false));
+            unique_ptr<MuonSelector> m(MuonSelector::build(a, false));
+            unique_ptr<JetSelector> j(JetSelector::build(a, false));
+            unique_ptr<TauSelector> t(TauSelector::build(a, false));
+            unique_ptr<PhotonSelector> p(PhotonSelector::build(a, false));
+            SUSYNT_CHECK(test, consistent(*e, electrons));
+            SUSYNT_CHECK(test, consistent(*m, muons));
+            SUSYNT_CHECK(test, consistent(*j, jets));
+            SUSYNT_CHECK(test, consistent(*t, taus));
+            SUSYNT_CHECK(test, consistent(*p, photons));
+            size_t nCL = 0, nCB = 0, nF = 0;
+            for(size_t i=0; i<jets.size(); ++i) {
+                nCL += j->isCentralLight(jets[i]);
+                nCB += j->isCentralB(jets[i]);
+                nF += j->isForward(jets[i]);
+            }
+            SUSYNT_CHECK_EQUAL(test, j->count_CL_jets(jets), nCL);
+            SUSYNT_CHECK_EQUAL(test, j->count_CB_jets(jets), nCB);
+            SUSYNT_CHECK_EQUAL(test, j->count_F_jets(jets), nF);
+            SUSYNT_CHECK(test, classified(*e, *nt.ele(), electrons));
+            SUSYNT_CHECK(test, classified(*m, *nt.muo(), muons));
+            SUSYNT_CHECK(test, classified(*j, *nt.jet(), jets));
+            SUSYNT_CHECK(test, classified(*t, *nt.tau(), taus));
+            SUSYNT_CHECK(test, classified(*p, *nt.pho(), photons));
+            ObjectStatus::Collection<Jet> jetStatus;
+            jetStatus.reset(jets, jets.empty() ? 0 : jets.front());
+            j->classify(jetStatus);
+            SUSYNT_CHECK_EQUAL(test, jetStatus.count(jets, ObjectStatus::CentralLight), static_cast<int>(nCL));
+            SUSYNT_CHECK_EQUAL(test, jetStatus.count(jets, ObjectStatus::CentralB), static_cast<int>(nCB));
+            SUSYNT_CHECK_EQUAL(test, jetStatus.count(jets, ObjectStatus::Forward), static_cast<int>(nF));
+            MuonVector signalMuons;
+            m->selectSignal(muons, signalMuons);
+            nSelected += signalMuons.size();
+        }
+        SUSYNT_CHECK(test, same<MuonSelector>(vanillaMuon, genericMuon, muons));
+        SUSYNT_CHECK(test, same<ElectronSelector>(vanillaElectron, genericElectron, electrons));
+        SUSYNT_CHECK(test, same<JetSelector>(vanillaJet, genericJet, jets));
+        SUSYNT_CHECK(test, consistent(highPtMuon, muons));
+        size_t nCL = 0;
+        for(size_t i=0; i<jets.size(); ++i) nCL += centralJet.isCentralLight(jets[i]);
+        SUSYNT_CHECK_EQUAL(test, centralJet.count_CL_jets(jets), nCL);
+    }
+    SUSYNT_CHECK(test, nSelected>0);
+
+    // the loops of a subclass use its overrides
+    Muon mu = goodMuon();
+    mu.SetPtEtaPhiM(20.0, 0.5, 0.0, 0.106);
+    MuonVector muons(1, &mu), signalMuons;
+    highPtMuon.selectSignal(muons, signalMuons);
+    SUSYNT_CHECK(test, signalMuons.empty());
+    SUSYNT_CHECK(test, MuonSelector_3Lep().isSignal(&mu));
+    Jet jet = goodJet(30.0, 1.5);
+    const JetVector jets(1, &jet);
+    SUSYNT_CHECK_EQUAL(test, centralJet.count_CL_jets(jets), 0u);
+    SUSYNT_CHECK_EQUAL(test, JetSelector_2Lep().count_CL_jets(jets), 1u);
+
+    expectedThresholds(test);
+
+    return test.finish();
+}
+//----------------------------------------------------------
@@ -0,0 +1,82 @@
+#include "SusyNtuple/StageTimer.h"
+#include "SusyNtuple/test_utils.h"
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using Susy::LatencyHistogram;
+using Susy::StageTimer;
+using Susy::utils::TestReport;
+
+/**
+   Test StageTimer: check the histogram binning and percentiles, then
+   record two stages from several threads (and with the hardware
+   counters, if available) and print the summary.
+ */
+
+//----------------------------------------------------------
+int main(int argc, char **argv)
+{
+    TestReport test("test_StageTimer");
+    // bins are contiguous and their upper edges increase
+    for(uint64_t ns=1; ns<(1ULL<<40); ns=ns*3/2+1) {
+        size_t b = LatencyHistogram::bin(ns);
+        SUSYNT_CHECK(test, ns<=LatencyHistogram::binUpperEdge(b));
+        SUSYNT_CHECK(test, (b==0 || ns>LatencyHistogram::binUpperEdge(b-1)));
+    }
+    SUSYNT_CHECK_EQUAL(test, LatencyHistogram::bin(~0ULL), LatencyHistogram::s_nBins-1);
+
+    LatencyHistogram h;
+    for(uint64_t ns=1; ns<=1000; ++ns) h.add(1000*ns); // 1 us to 1 ms, uniform
+    SUSYNT_CHECK_EQUAL(test, h.count(), 1000u);
+    SUSYNT_CHECK_EQUAL(test, h.min(), 1000u);
+    SUSYNT_CHECK_EQUAL(test, h.max(), 1000000u);
+    SUSYNT_CHECK(test, h.quantile(0.5)>=500000);
+    SUSYNT_CHECK(test, h.quantile(0.5)<550000);
+    SUSYNT_CHECK(test, h.quantile(0.99)>=990000);
+    SUSYNT_CHECK(test, h.quantile(0.99)<=1000000);
+
+    StageTimer timer;
+    int fast = timer.addStage("fast");
+    int slow = timer.addStage("slow");
+    SUSYNT_CHECK_EQUAL(test, timer.addStage("fast"), fast);
+    const int nThreads = 4;
+    const int nCalls = 1000;
+    vector<thread> threads;
+    for(int t=0; t<nThreads; ++t) {
+        threads.push_back(thread([&timer, fast, slow, nCalls]() {
+                    for(int i=0; i<nCalls; ++i) {
+                        StageTimer::Scope s(&timer, slow);
+                        { StageTimer::Scope f(&timer, fast); }
+                        { StageTimer::Scope none(0, fast); }
+                        volatile double x = 0;
+                        for(int j=0; j<1000; ++j) x += j;
+                    }
+                }));
+    }
+    for(size_t t=0; t<threads.size(); ++t) threads[t].join();
+    SUSYNT_CHECK_EQUAL(test, timer.summary(fast).count(), uint64_t(nThreads*nCalls));
+    SUSYNT_CHECK_EQUAL(test, timer.summary(slow).count(), uint64_t(nThreads*nCalls));
+    SUSYNT_CHECK(test, timer.summary(slow).total()>timer.summary(fast).total());
+    // hardware counters, when available (not in most virtual machines)
+    Susy::PerfCounters counters;
+    if(counters.open()) {
+        for(int i=0; i<100; ++i) {
+            StageTimer::Scope s(&timer, slow, &counters);
+            volatile double x = 0;
+            for(int j=0; j<10000; ++j) x += j;
+        }
+        Susy::PerfSample c = timer.counterSummary(slow);
+        SUSYNT_CHECK(test, c.instructions>100*10000);
+        SUSYNT_CHECK(test, c.ipc()>0);
+        cout<<"slow stage: "<<c.str()<<endl;
+    }
+    timer.print(cout);
+    timer.reset();
+    SUSYNT_CHECK_EQUAL(test, timer.summary(slow).count(), 0u);
+
+    return test.finish();
+}
+//----------------------------------------------------------
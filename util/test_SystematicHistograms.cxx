@@ -0,0 +1,93 @@
+#include "SusyNtuple/SystematicHistograms.h"
+#include "SusyNtuple/test_utils.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using Susy::HistogramSet;
+using Susy::SystematicHistograms;
+using Susy::utils::TestReport;
+namespace NtSys = Susy::NtSys;
+
+/**
+   Test SystematicHistograms: the buffered fills (with a buffer
+   flushed in the middle of events) must give the same contents as
+   the unbuffered ones, and as one HistogramSet histogram per
+   variation; then check merge().
+ */
+
+//----------------------------------------------------------
+int main(int argc, char **argv)
+{
+    TestReport test("test_SystematicHistograms");
+    const vector<NtSys::SusyNtSys> systematics = {NtSys::NOM, NtSys::PILEUP_UP, NtSys::PILEUP_DN,
+                                                  NtSys::XS_UP, NtSys::XS_DN};
+    SystematicHistograms buffered(systematics), direct(systematics);
+    const size_t nVariations = systematics.size();
+    SUSYNT_CHECK_EQUAL(test, buffered.nVariations(), nVariations);
+    SUSYNT_CHECK_EQUAL(test, buffered.findVariation("PILEUP_UP"), 1u);
+    const size_t hMet = buffered.book("h_met", "", 20, 0.0, 200.0);
+    const size_t hNJets = buffered.book("h_njets", "", vector<double>{0.0, 1.0, 2.0, 4.0, 10.0});
+    direct.book("h_met", "", 20, 0.0, 200.0);
+    direct.book("h_njets", "", vector<double>{0.0, 1.0, 2.0, 4.0, 10.0});
+    HistogramSet perVariation;
+    for(size_t v=0; v<nVariations; ++v) {
+        perVariation.book("h_met_" + buffered.variation(v), "", 20, 0.0, 200.0);
+        perVariation.book("h_njets_" + buffered.variation(v), "", vector<double>{0.0, 1.0, 2.0, 4.0, 10.0});
+    }
+
+    const size_t nEvents = 5000;
+    {
+        SystematicHistograms::FillBuffer buffer(buffered, 7); // small, to flush within events
+        vector<double> weights(nVariations);
+        for(size_t i=0; i<nEvents; ++i) {
+            for(size_t v=0; v<nVariations; ++v) weights[v] = 1.0 + 0.1*((i*(v+3)) % 17) - 0.5*(v==4);
+            const double met = (i*37 % 2300)*0.1 - 5.0;
+            buffer.setWeights(weights);
+            buffer.fill(hMet, met);
+            buffer.fill(hNJets, i % 11);
+            buffer.fill(hNJets, (i+5) % 11);
+            direct.fill(hMet, met, weights);
+            direct.fill(hNJets, i % 11, weights);
+            direct.fill(hNJets, (i+5) % 11, weights);
+            for(size_t v=0; v<nVariations; ++v) {
+                perVariation.fill(2*v, met, weights[v]);
+                perVariation.fill(2*v+1, i % 11, weights[v]);
+                perVariation.fill(2*v+1, (i+5) % 11, weights[v]);
+            }
+        }
+        SUSYNT_CHECK(test, buffer.size()<7);
+    } // the buffer is flushed here
+    perVariation.merge();
+    for(size_t id : {hMet, hNJets}) {
+        SUSYNT_CHECK_EQUAL(test, buffered.entries(id), direct.entries(id));
+        SUSYNT_CHECK_EQUAL(test, direct.entries(id), perVariation.entries(id));
+        for(int bin=0; bin<=buffered.nBins(id)+1; ++bin)
+            for(size_t v=0; v<nVariations; ++v) {
+                SUSYNT_CHECK_EQUAL(test, buffered.content(id, bin, v), direct.content(id, bin, v));
+                SUSYNT_CHECK_EQUAL(test, buffered.sumw2(id, bin, v), direct.sumw2(id, bin, v));
+                SUSYNT_CHECK_EQUAL(test, direct.content(id, bin, v), perVariation.content(2*v+id, bin));
+                SUSYNT_CHECK_EQUAL(test, direct.sumw2(id, bin, v), perVariation.sumw2(2*v+id, bin));
+            }
+    }
+    SUSYNT_CHECK(test, buffered.content(hMet, 0, 0)>0.0);
+    SUSYNT_CHECK(test, buffered.content(hMet, 21, 0)>0.0);
+
+    // merge
+    const double before = direct.content(hNJets, 3, 2);
+    SUSYNT_CHECK(test, direct.merge(buffered));
+    SUSYNT_CHECK_EQUAL(test, direct.content(hNJets, 3, 2), 2*before);
+    SystematicHistograms other({"NOM"});
+    other.book("h_met", "", 20, 0.0, 200.0);
+    SUSYNT_CHECK(test, !direct.merge(other));
+    direct.clear();
+    SUSYNT_CHECK_EQUAL(test, direct.entries(hMet), 0u);
+    SUSYNT_CHECK_EQUAL(test, direct.content(hNJets, 3, 2), 0.0);
+    if(argc>1)
+        for(int bin=0; bin<=buffered.nBins(hMet)+1; ++bin)
+            cout<<bin<<" "<<buffered.content(hMet, bin, 0)<<" "<<buffered.content(hMet, bin, 1)<<endl;
+
+    return test.finish();
+}
+//----------------------------------------------------------
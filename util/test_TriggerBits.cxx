@@ -0,0 +1,68 @@
+#include "SusyNtuple/TriggerBits.h"
+#include "SusyNtuple/test_utils.h"
+
+#include "TBits.h"
+
+#include <iostream>
+
+using namespace std;
+using Susy::TriggerBits;
+using Susy::utils::TestReport;
+
+/**
+   Test TriggerBits: single-bit access, masks, out-of-range bits, and
+   the conversion of the TBits stored in older files.
+ */
+
+//----------------------------------------------------------
+int main(int argc, char **argv)
+{
+    TestReport test("test_TriggerBits");
+    TriggerBits bits;
+    SUSYNT_CHECK(test, bits.none());
+    SUSYNT_CHECK_EQUAL(test, bits.count(), 0u);
+    SUSYNT_CHECK_EQUAL(test, bits.GetNbits(), 64u);
+    bits.set(0).set(5).set(63);
+    SUSYNT_CHECK(test, bits.test(0));
+    SUSYNT_CHECK(test, bits.test(5));
+    SUSYNT_CHECK(test, bits.test(63));
+    SUSYNT_CHECK(test, !bits.test(1));
+    SUSYNT_CHECK_EQUAL(test, bits.count(), 3u);
+    SUSYNT_CHECK(test, bits.TestBitNumber(5));
+    SUSYNT_CHECK(test, !bits.TestBitNumber(6));
+    // out-of-range bits are never set
+    bits.set(64).SetBitNumber(1000);
+    SUSYNT_CHECK(test, !bits.test(64));
+    SUSYNT_CHECK_EQUAL(test, bits.count(), 3u);
+    // masks
+    const ULong64_t m05 = TriggerBits::mask(0) | TriggerBits::mask(5);
+    const ULong64_t m16 = TriggerBits::mask(1) | TriggerBits::mask(6);
+    SUSYNT_CHECK(test, bits.all(m05));
+    SUSYNT_CHECK(test, bits.any(m05));
+    SUSYNT_CHECK(test, !bits.any(m16));
+    SUSYNT_CHECK(test, !bits.all(m05 | m16));
+    SUSYNT_CHECK(test, bits.any(m05 | m16));
+    bits.ResetBitNumber(5);
+    SUSYNT_CHECK(test, !bits.test(5));
+    SUSYNT_CHECK(test, !bits.all(m05));
+    SUSYNT_CHECK(test, bits.any(m05));
+    bits.reset();
+    SUSYNT_CHECK(test, bits.none());
+    SUSYNT_CHECK(test, bits==TriggerBits());
+    // conversion from TBits
+    TBits old(64);
+    old.SetBitNumber(3);
+    old.SetBitNumber(42);
+    SUSYNT_CHECK(test, bits.fromTBits(old));
+    SUSYNT_CHECK(test, bits.test(3));
+    SUSYNT_CHECK(test, bits.test(42));
+    SUSYNT_CHECK_EQUAL(test, bits.count(), 2u);
+    old.SetBitNumber(70);
+    SUSYNT_CHECK(test, !bits.fromTBits(old));
+    SUSYNT_CHECK(test, bits.test(3));
+    SUSYNT_CHECK(test, bits.test(42));
+    SUSYNT_CHECK_EQUAL(test, bits.count(), 2u);
+
+    return test.finish();
+}
+//----------------------------------------------------------
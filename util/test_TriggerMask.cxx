@@ -0,0 +1,72 @@
+#include "SusyNtuple/TriggerTools.h"
+#include "SusyNtuple/Event.h"
+#include "SusyNtuple/Muon.h"
+#include "SusyNtuple/test_utils.h"
+
+#include "TH1F.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using Susy::utils::TestReport;
+
+/**
+   Test the trigger masks compiled by TriggerTools: any-of/all-of
+   requirements, lepton matching, and switching with treatAsYear.
+ */
+
+//----------------------------------------------------------
+int main(int argc, char **argv)
+{
+    TestReport test("test_TriggerMask");
+    const vector<string> triggers = TriggerTools::getTrigNames();
+    TH1F histo("trig", "trig", triggers.size()+1, 0.0, triggers.size()+1);
+    histo.SetDirectory(0);
+    for(size_t i=0; i<triggers.size(); ++i) histo.GetXaxis()->SetBinLabel(i+1, triggers[i].c_str());
+    TriggerTools tt;
+    tt.buildTriggerMap(&histo);
+
+    const vector<string> singleMuo = TriggerTools::single_muo_triggers();
+    const vector<string> diMuo = TriggerTools::di_muo_triggers();
+    const TriggerMask anyMuo = tt.compile(singleMuo);
+    const TriggerMask both = tt.compile(vector<string>(), {singleMuo[0], diMuo[0]});
+    Susy::Event evt;
+    Susy::Muon muo;
+    SUSYNT_CHECK(test, !anyMuo.pass(evt.trigBits));
+    SUSYNT_CHECK(test, !TriggerMask().pass(evt.trigBits));
+    evt.trigBits.set(tt.idx_of_trigger(diMuo[0]));
+    SUSYNT_CHECK(test, !anyMuo.pass(evt.trigBits));
+    SUSYNT_CHECK(test, !both.pass(evt.trigBits));
+    evt.trigBits.set(tt.idx_of_trigger(singleMuo.back()));
+    SUSYNT_CHECK(test, anyMuo.pass(evt.trigBits));
+    SUSYNT_CHECK(test, !both.pass(evt.trigBits));
+    evt.trigBits.set(tt.idx_of_trigger(singleMuo[0]));
+    SUSYNT_CHECK(test, anyMuo.pass(evt.trigBits));
+    SUSYNT_CHECK(test, both.pass(evt.trigBits));
+    // the masks agree with passTrigger
+    bool anyFired = false;
+    for(const string &t : singleMuo) anyFired = anyFired || tt.passTrigger(evt.trigBits, t);
+    SUSYNT_CHECK_EQUAL(test, anyFired, anyMuo.pass(evt.trigBits));
+    // lepton matching: only to triggers of the requirement that fired
+    muo.trigBits.set(tt.idx_of_trigger(diMuo[0]));
+    SUSYNT_CHECK(test, !anyMuo.match(evt.trigBits, muo.trigBits));
+    muo.trigBits.set(tt.idx_of_trigger(singleMuo[0]));
+    SUSYNT_CHECK(test, anyMuo.match(evt.trigBits, muo.trigBits));
+    // year switching
+    YearTriggerMask byYear;
+    byYear.set(2015, tt.compile({diMuo[1]})).set(2016, anyMuo);
+    evt.treatAsYear = 2015;
+    SUSYNT_CHECK(test, !byYear.pass(evt));
+    SUSYNT_CHECK(test, !byYear.match(evt, muo));
+    evt.treatAsYear = 2016;
+    SUSYNT_CHECK(test, byYear.pass(evt));
+    SUSYNT_CHECK(test, byYear.match(evt, muo));
+    evt.treatAsYear = 2017;
+    SUSYNT_CHECK(test, !byYear.pass(evt));
+    SUSYNT_CHECK(test, byYear.forYear(2017).empty());
+
+    return test.finish();
+}
+//----------------------------------------------------------
@@ -0,0 +1,179 @@
+#include "SusyNtuple/TruthGraph.h"
+#include "SusyNtuple/mc_truth_utils.h"
+#include "SusyNtuple/test_utils.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using Susy::mc::TruthGraph;
+using Susy::mc::vint_t;
+using Susy::mc::vvint_t;
+using Susy::utils::TestReport;
+
+/**
+   Test TruthGraph: on a small hand-made record (copies of a top,
+   t->bW, W->lv, a Higgs) and on random records, the parent pdg, the
+   top and W classification and the ancestry queries agree with
+   determineParentPdg, IsSmTopIndex, IsDecayingWIndex and with a plain
+   walk up the parents; invalid indices are dropped and a record with a
+   cycle does not hang.
+ */
+
+//----------------------------------------------------------
+/// a walk up the parents, as a reference
+vint_t ancestorsByWalk(const vvint_t &parents, int i)
+{
+    vector<char> visited(parents.size(), 0);
+    vint_t result, stack(1, i);
+    while(!stack.empty()) {
+        const int c = stack.back();
+        stack.pop_back();
+        for(size_t j=0; j<parents[c].size(); ++j) {
+            const int p = parents[c][j];
+            if(!visited[p]) { visited[p] = 1; stack.push_back(p); result.push_back(p); }
+        }
+    }
+    sort(result.begin(), result.end());
+    return result;
+}
+//----------------------------------------------------------
+/// random record: the parents come earlier in a random order of the particles
+void randomRecord(int n, vint_t &pdgs, vvint_t &parents, vvint_t &children)
+{
+    const int choices[] = {1, 2, 3, 5, 6, -6, 11, -12, 13, 21, 22, 23, 24, -24, 25, 1000024};
+    const int nChoices = sizeof(choices)/sizeof(int);
+    vint_t order(n);
+    for(int i=0; i<n; ++i) order[i] = i;
+    for(int i=n-1; i>0; --i) swap(order[i], order[rand()%(i+1)]);
+    pdgs.assign(n, 0);
+    parents.assign(n, vint_t());
+    children.assign(n, vint_t());
+    for(int k=0; k<n; ++k) {
+        const int i = order[k];
+        pdgs[i] = choices[rand()%nChoices];
+        const int nPar = (k==0 ? 0 : rand()%3);
+        for(int j=0; j<nPar; ++j) {
+            const int p = order[rand()%k];
+            if(find(parents[i].begin(), parents[i].end(), p)!=parents[i].end()) continue;
+            parents[i].push_back(p);
+        }
+        // self-copies are frequent in the records
+        if(k>0 && rand()%3==0) {
+            pdgs[i] = pdgs[order[k-1]];
+            if(find(parents[i].begin(), parents[i].end(), order[k-1])==parents[i].end())
+                parents[i].push_back(order[k-1]);
+        }
+    }
+    for(int i=0; i<n; ++i)
+        for(size_t j=0; j<parents[i].size(); ++j) children[parents[i][j]].push_back(i);
+}
+//----------------------------------------------------------
+bool sameAsReference(TruthGraph &graph, const vint_t &pdgs, const vvint_t &parents, const vvint_t &children)
+{
+    bool success = true;
+    const int n = pdgs.size();
+    Susy::mc::IsSmTopIndex topFilter(&pdgs, &children);
+    Susy::mc::IsDecayingWIndex wFilter(&pdgs, &children);
+    vvint_t ancestors(n);
+    for(int i=0; i<n; ++i) {
+        ancestors[i] = ancestorsByWalk(parents, i);
+        success = success && graph.parentPdg(i)==Susy::mc::determineParentPdg(&pdgs, &parents, i);
+        success = success && graph.isSmTop(i)==topFilter(i) && graph.isDecayingW(i)==wFilter(i);
+        success = success && graph.children(i).size()==children[i].size();
+        success = success && equal(children[i].begin(), children[i].end(), graph.children(i).begin());
+    }
+    for(int withBitsets=0; withBitsets<2; ++withBitsets) {
+        if(withBitsets) graph.buildAncestry();
+        for(int i=0; i<n; ++i) {
+            success = success && graph.ancestors(i)==ancestors[i];
+            for(int a=0; a<n; ++a) {
+                const bool expected = binary_search(ancestors[i].begin(), ancestors[i].end(), a);
+                success = success && graph.isAncestor(a, i)==expected && graph.isDescendant(i, a)==expected;
+            }
+        }
+    }
+    return success;
+}
+//----------------------------------------------------------
+int main(int argc, char** argv)
+{
+    TestReport test("test_TruthGraph");
+    using namespace Susy::mc;
+
+    // 0,1: incoming gluons; 2,3: top and its copy; 4: b; 5,6: W and its copy; 7,8: mu nu;
+    // 9: Higgs, 10,11: its b bbar
+    const int pdgArr[] = {kPglu, kPglu, kPt, kPt, kPb, kPw, kPw, kAmu, kPvm, kPh, kPb, kAb};
+    const vint_t pdgs(pdgArr, pdgArr + sizeof(pdgArr)/sizeof(int));
+    vvint_t parents(pdgs.size());
+    parents[2].push_back(0); parents[2].push_back(1);
+    parents[3].push_back(2);
+    parents[4].push_back(3); parents[5].push_back(3);
+    parents[6].push_back(5);
+    parents[7].push_back(6); parents[8].push_back(6);
+    parents[9].push_back(0); parents[9].push_back(1);
+    parents[10].push_back(9); parents[11].push_back(9);
+    TruthGraph graph(pdgs, parents);
+    SUSYNT_CHECK_EQUAL(test, graph.size(), 12u);
+    SUSYNT_CHECK_EQUAL(test, graph.nInvalidIndices(), 0u);
+    SUSYNT_CHECK(test, !graph.hasCycle());
+    SUSYNT_CHECK_EQUAL(test, graph.firstCopy(3), 2);
+    SUSYNT_CHECK_EQUAL(test, graph.selfParent(3), 2);
+    SUSYNT_CHECK_EQUAL(test, graph.selfParent(2), -1);
+    SUSYNT_CHECK_EQUAL(test, graph.parentPdg(3), kPglu);
+    SUSYNT_CHECK_EQUAL(test, graph.parentPdg(6), kPt);
+    SUSYNT_CHECK_EQUAL(test, graph.parentPdg(0), -999);
+    SUSYNT_CHECK(test, graph.isSmTop(3));
+    SUSYNT_CHECK(test, !graph.isSmTop(2));
+    SUSYNT_CHECK(test, graph.isDecayingW(6));
+    SUSYNT_CHECK(test, !graph.isDecayingW(5));
+    SUSYNT_CHECK(test, graph.isAncestor(2, 8));
+    SUSYNT_CHECK(test, !graph.isAncestor(9, 8));
+    SUSYNT_CHECK(test, graph.isAncestor(1, 10));
+    graph.buildAncestry();
+    SUSYNT_CHECK(test, graph.hasAncestry());
+    SUSYNT_CHECK(test, graph.isAncestor(0, 7));
+    SUSYNT_CHECK(test, !graph.isAncestor(7, 0));
+    const int ancArr[] = {0, 1, 2, 3, 5, 6};
+    SUSYNT_CHECK(test, graph.ancestors(8)==vint_t(ancArr, ancArr + sizeof(ancArr)/sizeof(int)));
+
+    // random records, rebuilding the same graph
+    srand(12345);
+    for(int iEvent=0; iEvent<200; ++iEvent) {
+        vint_t rndPdgs;
+        vvint_t rndParents, rndChildren;
+        randomRecord(1 + rand()%150, rndPdgs, rndParents, rndChildren);
+        if(iEvent%2) graph.build(rndPdgs, rndParents);
+        else graph.build(rndPdgs, rndParents, rndChildren);
+        if(!SUSYNT_CHECK(test, sameAsReference(graph, rndPdgs, rndParents, rndChildren)))
+            cout<<"test_TruthGraph: event "<<iEvent<<" differs"<<endl;
+        SUSYNT_CHECK(test, !graph.hasCycle());
+    }
+
+    // indices outside the record are dropped; a short children vector means no children
+    vvint_t badParents(parents);
+    badParents[4].push_back(42);
+    badParents[5].push_back(-1);
+    graph.build(pdgs, badParents, vvint_t(3));
+    SUSYNT_CHECK_EQUAL(test, graph.nInvalidIndices(), 2u);
+    SUSYNT_CHECK_EQUAL(test, graph.parents(4).size(), 1u);
+    SUSYNT_CHECK(test, graph.children(5).empty());
+
+    // a cycle of copies (0 -> 1 -> 2 -> 0) terminates
+    const vint_t cyclePdgs(4, kPw);
+    vvint_t cycleParents(4);
+    cycleParents[0].push_back(2); cycleParents[1].push_back(0); cycleParents[2].push_back(1);
+    cycleParents[3].push_back(2);
+    graph.build(cyclePdgs, cycleParents);
+    graph.buildAncestry();
+    SUSYNT_CHECK(test, graph.hasCycle());
+    SUSYNT_CHECK(test, graph.isAncestor(0, 0));
+    SUSYNT_CHECK(test, graph.isAncestor(1, 3));
+    SUSYNT_CHECK_EQUAL(test, graph.ancestors(3).size(), 3u);
+    SUSYNT_CHECK_EQUAL(test, graph.parentPdg(3), kPw);
+
+    return test.finish();
+}
+//----------------------------------------------------------
@@ -0,0 +1,81 @@
+#include "SusyNtuple/WriterOptions.h"
+#include "SusyNtuple/SusyNtObject.h"
+#include "SusyNtuple/test_utils.h"
+
+#include <iostream>
+#include <string>
+
+using namespace std;
+using Susy::WriterOptions;
+using Susy::utils::TestReport;
+
+/**
+   Test WriterOptions: the parsed options give the expected ROOT
+   compression settings, basket sizes, auto-flush and split level,
+   str() can be parsed back, invalid options are rejected without
+   changing the current ones, and apply() sets the branches of a
+   SusyNtObject.
+ */
+
+//----------------------------------------------------------
+int main(int argc, char** argv)
+{
+    TestReport test("test_WriterOptions");
+
+    WriterOptions defaults;
+    Long64_t flush = 0;
+    SUSYNT_CHECK_EQUAL(test, defaults.str(), "default");
+    SUSYNT_CHECK_EQUAL(test, defaults.compressionSettings(), -1);
+    SUSYNT_CHECK_EQUAL(test, defaults.basketSize("electrons"), -1);
+    SUSYNT_CHECK_EQUAL(test, defaults.splitLevel(), -1);
+    SUSYNT_CHECK(test, !defaults.autoFlush(flush));
+
+    WriterOptions opts;
+    SUSYNT_CHECK(test, opts.parse("zstd:7, basket=64000,electrons.basket=128000,flush=-30000000,split=99"));
+    SUSYNT_CHECK_EQUAL(test, opts.compressionSettings(), 507);
+    SUSYNT_CHECK_EQUAL(test, opts.basketSize("electrons"), 128000);
+    SUSYNT_CHECK_EQUAL(test, opts.basketSize("jets"), 64000);
+    SUSYNT_CHECK(test, opts.autoFlush(flush));
+    SUSYNT_CHECK_EQUAL(test, flush, -30000000);
+    SUSYNT_CHECK_EQUAL(test, opts.splitLevel(), 99);
+
+    // str() is parsed back to the same options
+    WriterOptions copy;
+    SUSYNT_CHECK(test, copy.parse(opts.str()));
+    SUSYNT_CHECK_EQUAL(test, copy.str(), opts.str());
+    if(argc>1) cout<<"test_WriterOptions: "<<opts.str()<<endl;
+
+    // the default level of each algorithm, and no compression
+    WriterOptions lz4, zlib, none;
+    SUSYNT_CHECK(test, lz4.parse("lz4"));
+    SUSYNT_CHECK_EQUAL(test, lz4.compressionSettings(), 404);
+    SUSYNT_CHECK(test, zlib.parse("zlib:1"));
+    SUSYNT_CHECK_EQUAL(test, zlib.compressionSettings(), 101);
+    SUSYNT_CHECK(test, none.parse("none"));
+    SUSYNT_CHECK_EQUAL(test, none.compressionSettings(), 0);
+    SUSYNT_CHECK_EQUAL(test, none.str(), "none");
+
+    // invalid options leave the current ones unchanged
+    const string before = opts.str();
+    SUSYNT_CHECK(test, !opts.parse("zstd:12"));
+    SUSYNT_CHECK(test, !opts.parse("brotli:4"));
+    SUSYNT_CHECK(test, !opts.parse("split=100"));
+    SUSYNT_CHECK(test, !opts.parse("basket=0"));
+    SUSYNT_CHECK(test, !opts.parse("flush=many"));
+    SUSYNT_CHECK(test, !opts.parse("lz4,colour=1"));
+    SUSYNT_CHECK_EQUAL(test, opts.str(), before);
+
+    Susy::SusyNtObject nt;
+    opts.apply(nt);
+    SUSYNT_CHECK_EQUAL(test, nt.ele.GetBasketSize(), 128000);
+    SUSYNT_CHECK_EQUAL(test, nt.jet.GetBasketSize(), 64000);
+    SUSYNT_CHECK_EQUAL(test, nt.evt.GetSplitLevel(), 99);
+    SUSYNT_CHECK_EQUAL(test, nt.tpr.GetSplitLevel(), 99);
+    Susy::SusyNtObject unchanged;
+    defaults.apply(unchanged);
+    SUSYNT_CHECK_EQUAL(test, unchanged.ele.GetBasketSize(), 32000);
+    SUSYNT_CHECK_EQUAL(test, unchanged.ele.GetSplitLevel(), 0);
+
+    return test.finish();
+}
+//----------------------------------------------------------